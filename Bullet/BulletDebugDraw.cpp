@@ -215,4 +215,6 @@ void DrawDebugPhysics::DefineContract( Helium::TaskContract &rContract )
 {
 	rContract.ExecuteAfter<Helium::StandardDependencies::ProcessPhysics>();
 	rContract.ExecuteBefore<Helium::StandardDependencies::Render>();
+	rContract.ReadsComponents<BulletWorldComponent>();
+	rContract.WritesComponents<GraphicsManagerComponent>();
 }
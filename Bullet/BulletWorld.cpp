@@ -146,7 +146,15 @@ BulletWorld::~BulletWorld()
 	delete m_CollisionConfiguration;
 }
 
-void BulletWorld::Simulate( float dt )
+void BulletWorld::Simulate( float dt, bool bFixedStep )
 {
-	m_DynamicsWorld->stepSimulation(dt,10);
+	if ( bFixedStep )
+	{
+		// The caller is already stepping at a fixed rate, take exactly one step of that length
+		m_DynamicsWorld->stepSimulation(dt, 1, dt);
+	}
+	else
+	{
+		m_DynamicsWorld->stepSimulation(dt,10);
+	}
 }
@@ -28,7 +28,7 @@ namespace Helium
 
         btDynamicsWorld *GetBulletWorld() { return m_DynamicsWorld; }
 
-        void Simulate(float dt);
+        void Simulate(float dt, bool bFixedStep = false);
 
     private:
         btDefaultCollisionConfiguration *m_CollisionConfiguration;
@@ -4,6 +4,7 @@
 #include "Framework/WorldManager.h"
 #include "Framework/ComponentQuery.h"
 #include "Bullet/HasPhysicalContacts.h"
+#include "Bullet/BulletBodyComponent.h"
 #include "Framework/Entity.h"
 
 using namespace Helium;
@@ -42,9 +43,9 @@ void Helium::BulletWorldComponent::Initialize( const BulletWorldComponentDefinit
 	m_World->GetBulletWorld()->setWorldUserInfo(this);
 }
 
-void Helium::BulletWorldComponent::Simulate( float dt )
+void Helium::BulletWorldComponent::Simulate( float dt, bool bFixedStep )
 {
-	m_World->Simulate(dt);
+	m_World->Simulate(dt, bFixedStep);
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -73,7 +74,7 @@ void DoProcessPhysics( BulletWorldComponent *pComponent )
 	WorldManager* pWorldManager = WorldManager::GetInstance();
 	HELIUM_ASSERT( pWorldManager );
 
-	pComponent->Simulate( pWorldManager->GetFrameDeltaSeconds() );
+	pComponent->Simulate( pWorldManager->GetFrameDeltaSeconds(), pWorldManager->IsFixedTimeStepEnabled() );
 
 	for (ComponentIteratorT<HasPhysicalContactsComponent> iter( *pComponentManager ); iter.GetBaseComponent(); iter.Advance())
 	{
@@ -157,4 +158,7 @@ HELIUM_DEFINE_TASK( ProcessPhysics, (ForEachWorld< QueryComponents< BulletWorldC
 void ProcessPhysics::DefineContract( Helium::TaskContract &rContract )
 {
 	rContract.ExecutesWithin<Helium::StandardDependencies::ProcessPhysics>();
+	rContract.WritesComponents<BulletWorldComponent>();
+	rContract.WritesComponents<BulletBodyComponent>();
+	rContract.WritesComponents<HasPhysicalContactsComponent>();
 }
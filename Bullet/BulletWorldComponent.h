@@ -22,7 +22,7 @@ namespace Helium
 
 		void Initialize( const BulletWorldComponentDefinition &definition);
 
-		void Simulate(float dt);
+		void Simulate(float dt, bool bFixedStep = false);
 
 		BulletWorld *GetBulletWorld() { return m_World; }
 
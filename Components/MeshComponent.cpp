@@ -3,6 +3,7 @@
 
 #include "Framework/Entity.h"
 #include "Framework/World.h"
+#include "Framework/WorldManager.h"
 #include "Graphics/GraphicsManagerComponent.h"
 #include "Graphics/GraphicsScene.h"
 #include "Graphics/RenderResourceManager.h"
@@ -179,17 +180,21 @@ void MeshComponent::GraphicsSceneObjectUpdate(
 	HELIUM_ASSERT( pScene );
 	HELIUM_ASSERT( pSceneObject );
 	
-	const Simd::Vector3& rPosition = pTransform->GetPosition();
+	WorldManager* pWorldManager = WorldManager::GetInstance();
+	HELIUM_ASSERT( pWorldManager );
+	float32_t alpha = pWorldManager->GetInterpolationAlpha();
+
+	const Simd::Vector3 position = pTransform->GetInterpolatedPosition( alpha );
 	Simd::Matrix44 transform(
 		Simd::Matrix44::INIT_ROTATION_TRANSLATION,
-		pTransform->GetRotation(),
-		rPosition);
+		pTransform->GetInterpolatedRotation( alpha ),
+		position);
 	transform.ScaleLocal( pTransform->GetScale() );
 	pSceneObject->SetTransform( transform );
 
 	Mesh* pMesh = pThis->m_Mesh;
 
-	Simd::AaBox worldBounds( rPosition, rPosition );
+	Simd::AaBox worldBounds( position, position );
 
 	// Only thing remaining if this is a transform-only update is the world bounds, so update it and return.
 	if( pSceneObject->GetUpdateMode() == GraphicsSceneObject::UPDATE_TRANSFORM_ONLY )
@@ -300,12 +305,17 @@ void Helium::MeshComponent::Update( GraphicsScene *pGraphicsScene, TransformComp
 		Attach(pGraphicsScene, pTransform);
 	}
 
-	if (pTransform->IsDirty())
+	if (pTransform->IsDirty() || pTransform->IsInterpolating())
 	{
 	   SetNeedsGraphicsSceneObjectUpdate( pTransform, GraphicsSceneObject::UPDATE_TRANSFORM_ONLY );
 	}
 }
 
+bool Helium::MeshComponent::NeedsUpdate( TransformComponent *pTransform ) const
+{
+	return m_NeedsReattach || pTransform->IsDirty() || pTransform->IsInterpolating();
+}
+
 
 HELIUM_DEFINE_COMPONENT(Helium::MeshSceneObjectTransform, 128);
 
@@ -347,22 +357,42 @@ void Helium::MeshSceneObjectTransform::GraphicsSceneObjectUpdate( GraphicsScene
 
 //////////////////////////////////////////////////////////////////////////
 
-static GraphicsScene *pGraphicsScene = NULL;
+struct MeshComponentUpdate
+{
+	GraphicsScene *m_pGraphicsScene;
+	TransformComponent *m_pTransform;
+	MeshComponent *m_pMeshComponent;
+};
 
-void UpdateMeshComponent(TransformComponent *pTransform, MeshComponent *pMeshComponent)
+void ApplyMeshComponentUpdate(Component *, void *pData)
 {
-	pMeshComponent->Update( pGraphicsScene, pTransform );
+	MeshComponentUpdate *pUpdate = static_cast< MeshComponentUpdate * >( pData );
+	pUpdate->m_pMeshComponent->Update( pUpdate->m_pGraphicsScene, pUpdate->m_pTransform );
+}
+
+// Finding the meshes that need an update runs in parallel, the update itself touches the graphics scene and may
+// allocate a sibling component so it is deferred to the command buffer
+void UpdateMeshComponent(GraphicsScene &rGraphicsScene, MeshComponent *pMeshComponent, ComponentCommandBuffer &rCommandBuffer)
+{
+	TransformComponent *pTransform = pMeshComponent->GetComponentCollection()->GetFirst<TransformComponent>();
+
+	if ( pTransform && pMeshComponent->NeedsUpdate( pTransform ) )
+	{
+		MeshComponentUpdate update = { &rGraphicsScene, pTransform, pMeshComponent };
+		rCommandBuffer.Call( ApplyMeshComponentUpdate, &update, sizeof( update ) );
+	}
 }
 
 void UpdateMeshComponents( World *pWorld )
 {
+	// The scene comes from this world's graphics manager, worlds may be updated at the same time
 	GraphicsManagerComponent *pGraphicsManager = pWorld->GetComponents().GetFirst<GraphicsManagerComponent>();
 	HELIUM_ASSERT( pGraphicsManager );
 
-	pGraphicsScene = pGraphicsManager->GetGraphicsScene();
+	GraphicsScene *pGraphicsScene = pGraphicsManager->GetGraphicsScene();
 	HELIUM_ASSERT( pGraphicsScene );
 
-	QueryComponents< TransformComponent, MeshComponent, UpdateMeshComponent >( pWorld );
+	ParallelForEachComponent< MeshComponent, GraphicsScene, UpdateMeshComponent >( pWorld, *pGraphicsScene );
 }
 
 void Helium::UpdateMeshComponentsTask::DefineContract( TaskContract &rContract )
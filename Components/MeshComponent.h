@@ -47,6 +47,7 @@ namespace Helium
 		//@}
 
 		void Update( class GraphicsScene *pGraphicsScene, class TransformComponent *pTransform );
+		bool NeedsUpdate( class TransformComponent *pTransform ) const;
 		
 		/// @name Scene GameObject Synchronization Callback
 		//@{
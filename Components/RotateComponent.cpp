@@ -32,7 +32,9 @@ HELIUM_DEFINE_COMPONENT(Helium::RotateComponent, 16);
 
 void Helium::RotateComponent::PopulateMetaType( Reflect::MetaStruct& comp )
 {
-
+	comp.AddField( &Helium::RotateComponent::m_Roll, "m_Roll", Reflect::FieldFlags::Discard );
+	comp.AddField( &Helium::RotateComponent::m_Pitch, "m_Pitch", Reflect::FieldFlags::Discard );
+	comp.AddField( &Helium::RotateComponent::m_Yaw, "m_Yaw", Reflect::FieldFlags::Discard );
 }
 
 void Helium::RotateComponent::Initialize( const RotateComponentDefinition &definition )
@@ -89,6 +91,8 @@ void Helium::UpdateRotateComponentsTask::DefineContract( TaskContract &rContract
 {
 	rContract.ExecuteBefore<StandardDependencies::ProcessPhysics>();
 	rContract.ExecuteAfter<StandardDependencies::ReceiveInput>();
+	rContract.ReadsComponents<RotateComponent>();
+	rContract.WritesComponents<TransformComponent>();
 }
 
 HELIUM_DEFINE_TASK( UpdateRotateComponentsTask, (ForEachWorld< QueryComponents< RotateComponent, TransformComponent, UpdateRotateComponents > >), TickTypes::Gameplay )
@@ -0,0 +1,898 @@
+#include "ComponentsPch.h"
+#include "Components/SpatialIndexComponent.h"
+
+#include "Reflect/TranslatorDeduction.h"
+
+#include "Components/TransformComponent.h"
+
+#include "Platform/MemoryHeap.h"
+#include "Foundation/Numeric.h"
+#include "EngineJobs/JobManager.h"
+#include "Framework/World.h"
+
+using namespace Helium;
+
+/// Smallest cell table, in slots.
+static const size_t MIN_CELL_CAPACITY = 64;
+/// Cell coordinates are clamped to this magnitude so far away positions can't overflow.
+static const float32_t MAX_CELL_COORDINATE = 1073741824.0f;
+
+static uint32_t HashCellCoordinates( const int32_t *pCoordinates )
+{
+	return ( static_cast< uint32_t >( pCoordinates[ 0 ] ) * 73856093u ) ^
+		( static_cast< uint32_t >( pCoordinates[ 1 ] ) * 19349663u ) ^
+		( static_cast< uint32_t >( pCoordinates[ 2 ] ) * 83492791u );
+}
+
+static void GetPosition( const Simd::Vector3 &rVector, float32_t *pPosition )
+{
+	pPosition[ 0 ] = rVector.GetElement( 0 );
+	pPosition[ 1 ] = rVector.GetElement( 1 );
+	pPosition[ 2 ] = rVector.GetElement( 2 );
+}
+
+static float32_t GetDistanceSquared( const float32_t *pA, const float32_t *pB )
+{
+	float32_t x = pA[ 0 ] - pB[ 0 ];
+	float32_t y = pA[ 1 ] - pB[ 1 ];
+	float32_t z = pA[ 2 ] - pB[ 2 ];
+
+	return x * x + y * y + z * z;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SpatialIndexComponentDefinition
+
+HELIUM_DEFINE_CLASS(Helium::SpatialIndexComponentDefinition);
+
+void Helium::SpatialIndexComponentDefinition::PopulateMetaType( Reflect::MetaStruct& comp )
+{
+	comp.AddField(&SpatialIndexComponentDefinition::m_CellSize, "m_CellSize");
+}
+
+SpatialIndexComponentDefinition::SpatialIndexComponentDefinition()
+	: m_CellSize( 8.0f )
+{
+
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SpatialIndexComponent
+
+HELIUM_DEFINE_COMPONENT(Helium::SpatialIndexComponent, 16);
+
+void Helium::SpatialIndexComponent::PopulateMetaType( Reflect::MetaStruct& comp )
+{
+
+}
+
+SpatialIndexComponent::SpatialIndexComponent()
+	: m_CellSize( 1.0f )
+	, m_InverseCellSize( 1.0f )
+	, m_UsedCellCount( 0 )
+	, m_OccupiedCellCount( 0 )
+	, m_IndexedCount( 0 )
+	, m_bBoundsDirty( false )
+	, m_Stamp( 0 )
+{
+	for ( size_t axis = 0; axis < 3; ++axis )
+	{
+		m_BoundsMinimum[ axis ] = NumericLimits< int32_t >::Maximum;
+		m_BoundsMaximum[ axis ] = NumericLimits< int32_t >::Minimum;
+	}
+}
+
+void Helium::SpatialIndexComponent::Initialize( const SpatialIndexComponentDefinition &definition )
+{
+	HELIUM_ASSERT( definition.m_CellSize > 0.0f );
+
+	m_CellSize = definition.m_CellSize > 0.0f ? definition.m_CellSize : 1.0f;
+	m_InverseCellSize = 1.0f / m_CellSize;
+
+	RebuildCells( MIN_CELL_CAPACITY );
+}
+
+/// Bring the index up to date with this world's transforms.
+///
+/// New transforms are added, freed ones removed, and transforms whose dirty flag is set are moved to their new cell.
+/// This must run before the dirty flags are cleared.
+///
+/// @see UpdateSpatialIndexTask
+void Helium::SpatialIndexComponent::Update()
+{
+	ComponentManager *pComponentManager = GetWorld()->GetComponentManager();
+	HELIUM_ASSERT( pComponentManager );
+
+	const Components::Pool *pPool = pComponentManager->GetPool( Components::GetType< TransformComponent >() );
+	if ( !pPool )
+	{
+		return;
+	}
+
+	size_t oldEntryCount = m_Entries.GetSize();
+	if ( oldEntryCount < pPool->GetCapacity() )
+	{
+		m_Entries.Resize( pPool->GetCapacity() );
+		for ( size_t entryIndex = oldEntryCount; entryIndex < m_Entries.GetSize(); ++entryIndex )
+		{
+			m_Entries[ entryIndex ].m_Handle = 0;
+		}
+	}
+
+	// Zero is reserved for entries no pass has seen yet
+	if ( ++m_Stamp == 0 )
+	{
+		m_Stamp = 1;
+	}
+
+	const size_t count = pPool->GetAllocatedCount();
+	Component * const *ppComponents = pPool->GetAllocatedComponents();
+
+	for ( size_t rosterIndex = 0; rosterIndex < count; ++rosterIndex )
+	{
+		TransformComponent *pTransform = static_cast< TransformComponent * >( ppComponents[ rosterIndex ] );
+		uint32_t entryIndex = pPool->GetComponentIndex( pTransform );
+
+		Entry &rEntry = ClaimEntry( entryIndex, pPool->GetHandle( pTransform ) );
+		rEntry.m_Stamp = m_Stamp;
+
+		if ( IsValid( rEntry.m_Cell ) && !pTransform->IsDirty() )
+		{
+			continue;
+		}
+
+		GetPosition( pTransform->GetPosition(), rEntry.m_Position );
+
+		int32_t coordinates[ 3 ];
+		GetCellCoordinates( rEntry.m_Position, coordinates );
+
+		if ( IsValid( rEntry.m_Cell ) )
+		{
+			const Cell &rCell = m_Cells[ rEntry.m_Cell ];
+			if ( rCell.m_Coordinates[ 0 ] == coordinates[ 0 ] &&
+				rCell.m_Coordinates[ 1 ] == coordinates[ 1 ] &&
+				rCell.m_Coordinates[ 2 ] == coordinates[ 2 ] )
+			{
+				continue;
+			}
+
+			UnlinkEntry( entryIndex );
+		}
+
+		uint32_t cellIndex = FindCell( coordinates );
+		if ( IsInvalid( cellIndex ) )
+		{
+			cellIndex = AddCell( coordinates );
+		}
+
+		LinkEntry( entryIndex, cellIndex );
+	}
+
+	// Only look for freed transforms if there are more entries than live transforms
+	if ( m_IndexedCount > count )
+	{
+		for ( size_t entryIndex = 0; entryIndex < m_Entries.GetSize(); ++entryIndex )
+		{
+			if ( m_Entries[ entryIndex ].m_Handle && m_Entries[ entryIndex ].m_Stamp != m_Stamp )
+			{
+				ReleaseEntry( static_cast< uint32_t >( entryIndex ) );
+			}
+		}
+	}
+
+	HELIUM_ASSERT( m_IndexedCount == count );
+
+	if ( m_bBoundsDirty )
+	{
+		UpdateBounds();
+	}
+}
+
+/// Set the layers a transform is on, so queries can pick out particular kinds of objects.
+///
+/// Transforms are on SPATIAL_INDEX_LAYER_DEFAULT until this is called.  The mask is kept until the transform is freed.
+///
+/// @param[in] pTransform  Transform in this component's world.
+/// @param[in] layerMask   Layers the transform is on.
+void Helium::SpatialIndexComponent::SetLayerMask( TransformComponent *pTransform, uint32_t layerMask )
+{
+	HELIUM_ASSERT( pTransform );
+	HELIUM_ASSERT( pTransform->GetWorld() == GetWorld() );
+
+	const Components::Pool *pPool = Components::Pool::GetPool( pTransform );
+	uint32_t entryIndex = pPool->GetComponentIndex( pTransform );
+
+	size_t oldEntryCount = m_Entries.GetSize();
+	if ( oldEntryCount <= entryIndex )
+	{
+		m_Entries.Resize( pPool->GetCapacity() );
+		for ( size_t newIndex = oldEntryCount; newIndex < m_Entries.GetSize(); ++newIndex )
+		{
+			m_Entries[ newIndex ].m_Handle = 0;
+		}
+	}
+
+	ClaimEntry( entryIndex, pPool->GetHandle( pTransform ) ).m_LayerMask = layerMask;
+}
+
+/// Find the indexed transforms within a distance of a point.
+///
+/// @param[in]  rCenter    Point to search around.
+/// @param[in]  radius     Search distance.
+/// @param[in]  layerMask  Only transforms on one of these layers are returned.
+/// @param[out] rResults   Transforms found are appended to this array, in no particular order.
+void Helium::SpatialIndexComponent::QueryRadius(
+	const Simd::Vector3 &rCenter,
+	float32_t radius,
+	uint32_t layerMask,
+	DynamicArray< TransformComponent * > &rResults ) const
+{
+	float32_t center[ 3 ];
+	GetPosition( rCenter, center );
+
+	float32_t minimumPosition[ 3 ] = { center[ 0 ] - radius, center[ 1 ] - radius, center[ 2 ] - radius };
+	float32_t maximumPosition[ 3 ] = { center[ 0 ] + radius, center[ 1 ] + radius, center[ 2 ] + radius };
+
+	int32_t minimum[ 3 ];
+	int32_t maximum[ 3 ];
+	GetCellCoordinates( minimumPosition, minimum );
+	GetCellCoordinates( maximumPosition, maximum );
+
+	QueryCells( minimum, maximum, center, radius * radius, NULL, NULL, layerMask, rResults );
+}
+
+/// Find the indexed transforms within an axis aligned box.
+///
+/// @param[in]  rMinimum   Minimum corner of the box.
+/// @param[in]  rMaximum   Maximum corner of the box.
+/// @param[in]  layerMask  Only transforms on one of these layers are returned.
+/// @param[out] rResults   Transforms found are appended to this array, in no particular order.
+void Helium::SpatialIndexComponent::QueryBox(
+	const Simd::Vector3 &rMinimum,
+	const Simd::Vector3 &rMaximum,
+	uint32_t layerMask,
+	DynamicArray< TransformComponent * > &rResults ) const
+{
+	float32_t boxMinimum[ 3 ];
+	float32_t boxMaximum[ 3 ];
+	GetPosition( rMinimum, boxMinimum );
+	GetPosition( rMaximum, boxMaximum );
+
+	int32_t minimum[ 3 ];
+	int32_t maximum[ 3 ];
+	GetCellCoordinates( boxMinimum, minimum );
+	GetCellCoordinates( boxMaximum, maximum );
+
+	QueryCells( minimum, maximum, NULL, 0.0f, boxMinimum, boxMaximum, layerMask, rResults );
+}
+
+/// Find the indexed transforms closest to a point.
+///
+/// Cells are searched in growing shells around the point, so the cost depends on how crowded the area around the
+/// point is rather than on the number of indexed transforms.  Once a shell spans more cells than are occupied, the
+/// occupied cells are scanned directly instead, so sparse worlds don't probe the table for every empty cell.
+///
+/// @param[in]  rCenter    Point to search around.
+/// @param[in]  count      Most transforms to find.
+/// @param[in]  maxRadius  Transforms further away than this are ignored.
+/// @param[in]  layerMask  Only transforms on one of these layers are returned.
+/// @param[out] ppResults  Array of count transforms to fill, closest first.
+///
+/// @return  Number of transforms found.
+size_t Helium::SpatialIndexComponent::QueryNearest(
+	const Simd::Vector3 &rCenter,
+	size_t count,
+	float32_t maxRadius,
+	uint32_t layerMask,
+	TransformComponent **ppResults ) const
+{
+	HELIUM_ASSERT( ppResults || !count );
+
+	if ( !count || !m_IndexedCount )
+	{
+		return 0;
+	}
+
+	StackMemoryHeap<>& rStackHeap = ThreadLocalStackAllocator::GetMemoryHeap();
+	StackMemoryHeap<>::Marker stackMarker( rStackHeap );
+
+	float32_t *pDistances = static_cast< float32_t * >( rStackHeap.Allocate( sizeof( float32_t ) * count ) );
+	uint32_t *pFound = static_cast< uint32_t * >( rStackHeap.Allocate( sizeof( uint32_t ) * count ) );
+	size_t foundCount = 0;
+
+	float32_t center[ 3 ];
+	GetPosition( rCenter, center );
+
+	int32_t centerCell[ 3 ];
+	GetCellCoordinates( center, centerCell );
+
+	const float32_t maxRadiusSquared = maxRadius * maxRadius;
+
+	for ( int32_t shell = 0; ; ++shell )
+	{
+		// Nothing in this shell or beyond can be closer than this
+		float32_t shellDistance = static_cast< float32_t >( Max( shell - 1, 0 ) ) * m_CellSize;
+		if ( shellDistance > maxRadius ||
+			( foundCount == count && shellDistance * shellDistance >= pDistances[ count - 1 ] ) )
+		{
+			break;
+		}
+
+		// The shells so far and this one span shellSide^3 cells, once that's more than are occupied it's cheaper to
+		// scan the occupied cells that haven't been searched yet
+		uint64_t shellSide = static_cast< uint64_t >( shell ) * 2 + 1;
+		if ( shellSide * shellSide * shellSide > m_OccupiedCellCount )
+		{
+			for ( size_t cellIndex = 0; cellIndex < m_Cells.GetSize(); ++cellIndex )
+			{
+				const Cell &rCell = m_Cells[ cellIndex ];
+				if ( !rCell.m_bUsed || IsInvalid( rCell.m_FirstEntry ) )
+				{
+					continue;
+				}
+
+				int64_t ring = 0;
+				float32_t cellDistanceSquared = 0.0f;
+				for ( size_t axis = 0; axis < 3; ++axis )
+				{
+					int64_t delta = static_cast< int64_t >( rCell.m_Coordinates[ axis ] ) - centerCell[ axis ];
+					ring = Max( ring, delta < 0 ? -delta : delta );
+
+					float32_t cellMinimum = static_cast< float32_t >( rCell.m_Coordinates[ axis ] ) * m_CellSize;
+					float32_t offset = Max( Max( cellMinimum - center[ axis ], center[ axis ] - ( cellMinimum + m_CellSize ) ), 0.0f );
+					cellDistanceSquared += offset * offset;
+				}
+
+				if ( ring < shell ||
+					cellDistanceSquared > maxRadiusSquared ||
+					( foundCount == count && cellDistanceSquared >= pDistances[ count - 1 ] ) )
+				{
+					continue;
+				}
+
+				GatherNearest(
+					static_cast< uint32_t >( cellIndex ),
+					center,
+					maxRadiusSquared,
+					layerMask,
+					count,
+					pDistances,
+					pFound,
+					foundCount );
+			}
+
+			break;
+		}
+
+		int32_t minimum[ 3 ];
+		int32_t maximum[ 3 ];
+		bool bCoversBounds = true;
+		for ( size_t axis = 0; axis < 3; ++axis )
+		{
+			minimum[ axis ] = Max( centerCell[ axis ] - shell, m_BoundsMinimum[ axis ] );
+			maximum[ axis ] = Min( centerCell[ axis ] + shell, m_BoundsMaximum[ axis ] );
+			bCoversBounds = bCoversBounds &&
+				centerCell[ axis ] - shell <= m_BoundsMinimum[ axis ] &&
+				centerCell[ axis ] + shell >= m_BoundsMaximum[ axis ];
+		}
+
+		int32_t coordinates[ 3 ];
+		for ( coordinates[ 0 ] = minimum[ 0 ]; coordinates[ 0 ] <= maximum[ 0 ]; ++coordinates[ 0 ] )
+		{
+			bool bOnShellX = Abs( coordinates[ 0 ] - centerCell[ 0 ] ) == shell;
+
+			for ( coordinates[ 1 ] = minimum[ 1 ]; coordinates[ 1 ] <= maximum[ 1 ]; ++coordinates[ 1 ] )
+			{
+				bool bOnShellXY = bOnShellX || Abs( coordinates[ 1 ] - centerCell[ 1 ] ) == shell;
+
+				// Inside the shell on both x and y, only the two z faces are part of it
+				int32_t zStep = bOnShellXY ? 1 : Max( shell * 2, 1 );
+				for ( coordinates[ 2 ] = bOnShellXY ? minimum[ 2 ] : centerCell[ 2 ] - shell; coordinates[ 2 ] <= maximum[ 2 ]; coordinates[ 2 ] += zStep )
+				{
+					if ( coordinates[ 2 ] < minimum[ 2 ] )
+					{
+						continue;
+					}
+
+					uint32_t cellIndex = FindCell( coordinates );
+					if ( IsInvalid( cellIndex ) )
+					{
+						continue;
+					}
+
+					GatherNearest( cellIndex, center, maxRadiusSquared, layerMask, count, pDistances, pFound, foundCount );
+				}
+			}
+		}
+
+		if ( bCoversBounds )
+		{
+			break;
+		}
+	}
+
+	size_t resultCount = 0;
+	for ( size_t foundIndex = 0; foundIndex < foundCount; ++foundIndex )
+	{
+		Component *pComponent = Components::Pool::ResolveHandle( m_Entries[ pFound[ foundIndex ] ].m_Handle );
+		if ( pComponent )
+		{
+			ppResults[ resultCount++ ] = static_cast< TransformComponent * >( pComponent );
+		}
+	}
+
+	return resultCount;
+}
+
+/// Add the entries of a cell to the closest found so far.
+///
+/// @param[in]     cellIndex         Cell to search.
+/// @param[in]     pCenter           Point being searched around.
+/// @param[in]     maxRadiusSquared  Entries further away than this are ignored.
+/// @param[in]     layerMask         Only entries on one of these layers are considered.
+/// @param[in]     count             Most entries to find.
+/// @param[in,out] pDistances        Squared distances of the entries found so far, closest first.
+/// @param[in,out] pFound            Entries found so far, closest first.
+/// @param[in,out] rFoundCount       Number of entries found so far.
+void Helium::SpatialIndexComponent::GatherNearest(
+	uint32_t cellIndex,
+	const float32_t *pCenter,
+	float32_t maxRadiusSquared,
+	uint32_t layerMask,
+	size_t count,
+	float32_t *pDistances,
+	uint32_t *pFound,
+	size_t &rFoundCount ) const
+{
+	for ( uint32_t entryIndex = m_Cells[ cellIndex ].m_FirstEntry; IsValid( entryIndex ); entryIndex = m_Entries[ entryIndex ].m_Next )
+	{
+		const Entry &rEntry = m_Entries[ entryIndex ];
+		if ( !( rEntry.m_LayerMask & layerMask ) )
+		{
+			continue;
+		}
+
+		float32_t distanceSquared = GetDistanceSquared( rEntry.m_Position, pCenter );
+		if ( distanceSquared > maxRadiusSquared ||
+			( rFoundCount == count && distanceSquared >= pDistances[ count - 1 ] ) )
+		{
+			continue;
+		}
+
+		// Insertion sort, count is expected to be small
+		size_t insertIndex = Min( rFoundCount, count - 1 );
+		while ( insertIndex > 0 && pDistances[ insertIndex - 1 ] > distanceSquared )
+		{
+			pDistances[ insertIndex ] = pDistances[ insertIndex - 1 ];
+			pFound[ insertIndex ] = pFound[ insertIndex - 1 ];
+			--insertIndex;
+		}
+
+		pDistances[ insertIndex ] = distanceSquared;
+		pFound[ insertIndex ] = entryIndex;
+		rFoundCount = Min( rFoundCount + 1, count );
+	}
+}
+
+/// Run QueryRadius() for several points at once.
+///
+/// @param[in]  pCenters        Points to search around.
+/// @param[in]  queryCount      Number of points.
+/// @param[in]  radius          Search distance.
+/// @param[in]  layerMask       Only transforms on one of these layers are returned.
+/// @param[out] rResults        Transforms found for every point, one after another.
+/// @param[out] rResultOffsets  queryCount + 1 offsets into rResults, the results of point i are at
+///                             [rResultOffsets[i], rResultOffsets[i + 1]).
+void Helium::SpatialIndexComponent::QueryRadiusBatch(
+	const Simd::Vector3 *pCenters,
+	size_t queryCount,
+	float32_t radius,
+	uint32_t layerMask,
+	DynamicArray< TransformComponent * > &rResults,
+	DynamicArray< size_t > &rResultOffsets ) const
+{
+	HELIUM_ASSERT( pCenters || !queryCount );
+
+	rResults.Resize( 0 );
+	rResultOffsets.Resize( queryCount + 1 );
+
+	for ( size_t queryIndex = 0; queryIndex < queryCount; ++queryIndex )
+	{
+		rResultOffsets[ queryIndex ] = rResults.GetSize();
+		QueryRadius( pCenters[ queryIndex ], radius, layerMask, rResults );
+	}
+
+	rResultOffsets[ queryCount ] = rResults.GetSize();
+}
+
+namespace
+{
+	struct NearestBatchData
+	{
+		const SpatialIndexComponent *m_pIndex;
+		const Simd::Vector3 *m_pCenters;
+		size_t m_Count;
+		float32_t m_MaxRadius;
+		uint32_t m_LayerMask;
+		TransformComponent **m_ppResults;
+	};
+}
+
+/// Run QueryNearest() for several points at once, spread over the job manager's worker threads.
+///
+/// @param[in]  pCenters    Points to search around.
+/// @param[in]  queryCount  Number of points.
+/// @param[in]  count       Most transforms to find for each point.
+/// @param[in]  maxRadius   Transforms further away than this are ignored.
+/// @param[in]  layerMask   Only transforms on one of these layers are returned.
+/// @param[out] ppResults   Array of queryCount * count transforms to fill.  The results of point i start at
+///                         ppResults[i * count], closest first, and unused slots are set to null.
+void Helium::SpatialIndexComponent::QueryNearestBatch(
+	const Simd::Vector3 *pCenters,
+	size_t queryCount,
+	size_t count,
+	float32_t maxRadius,
+	uint32_t layerMask,
+	TransformComponent **ppResults ) const
+{
+	HELIUM_ASSERT( pCenters || !queryCount );
+	HELIUM_ASSERT( ppResults || !queryCount || !count );
+
+	if ( !count )
+	{
+		return;
+	}
+
+	NearestBatchData data;
+	data.m_pIndex = this;
+	data.m_pCenters = pCenters;
+	data.m_Count = count;
+	data.m_MaxRadius = maxRadius;
+	data.m_LayerMask = layerMask;
+	data.m_ppResults = ppResults;
+
+	JobManager::ParallelFor( queryCount, 0, QueryNearestRange, &data );
+}
+
+void Helium::SpatialIndexComponent::QueryNearestRange( void *pData, size_t start, size_t end )
+{
+	const NearestBatchData &rData = *static_cast< const NearestBatchData * >( pData );
+
+	for ( size_t queryIndex = start; queryIndex < end; ++queryIndex )
+	{
+		TransformComponent **ppResults = rData.m_ppResults + queryIndex * rData.m_Count;
+		size_t foundCount = rData.m_pIndex->QueryNearest( rData.m_pCenters[ queryIndex ], rData.m_Count, rData.m_MaxRadius, rData.m_LayerMask, ppResults );
+
+		for ( size_t resultIndex = foundCount; resultIndex < rData.m_Count; ++resultIndex )
+		{
+			ppResults[ resultIndex ] = NULL;
+		}
+	}
+}
+
+void Helium::SpatialIndexComponent::QueryCells(
+	const int32_t *pMinimum,
+	const int32_t *pMaximum,
+	const float32_t *pCenter,
+	float32_t radiusSquared,
+	const float32_t *pBoxMinimum,
+	const float32_t *pBoxMaximum,
+	uint32_t layerMask,
+	DynamicArray< TransformComponent * > &rResults ) const
+{
+	if ( !m_IndexedCount )
+	{
+		return;
+	}
+
+	// Cells outside the bounds of the table can't hold anything
+	int32_t minimum[ 3 ];
+	int32_t maximum[ 3 ];
+	for ( size_t axis = 0; axis < 3; ++axis )
+	{
+		minimum[ axis ] = Max( pMinimum[ axis ], m_BoundsMinimum[ axis ] );
+		maximum[ axis ] = Min( pMaximum[ axis ], m_BoundsMaximum[ axis ] );
+		if ( minimum[ axis ] > maximum[ axis ] )
+		{
+			return;
+		}
+	}
+
+	int32_t coordinates[ 3 ];
+	for ( coordinates[ 0 ] = minimum[ 0 ]; coordinates[ 0 ] <= maximum[ 0 ]; ++coordinates[ 0 ] )
+	{
+		for ( coordinates[ 1 ] = minimum[ 1 ]; coordinates[ 1 ] <= maximum[ 1 ]; ++coordinates[ 1 ] )
+		{
+			for ( coordinates[ 2 ] = minimum[ 2 ]; coordinates[ 2 ] <= maximum[ 2 ]; ++coordinates[ 2 ] )
+			{
+				uint32_t cellIndex = FindCell( coordinates );
+				if ( IsInvalid( cellIndex ) )
+				{
+					continue;
+				}
+
+				for ( uint32_t entryIndex = m_Cells[ cellIndex ].m_FirstEntry; IsValid( entryIndex ); entryIndex = m_Entries[ entryIndex ].m_Next )
+				{
+					const Entry &rEntry = m_Entries[ entryIndex ];
+					if ( !( rEntry.m_LayerMask & layerMask ) )
+					{
+						continue;
+					}
+
+					if ( pCenter )
+					{
+						if ( GetDistanceSquared( rEntry.m_Position, pCenter ) > radiusSquared )
+						{
+							continue;
+						}
+					}
+					else if ( rEntry.m_Position[ 0 ] < pBoxMinimum[ 0 ] || rEntry.m_Position[ 0 ] > pBoxMaximum[ 0 ] ||
+						rEntry.m_Position[ 1 ] < pBoxMinimum[ 1 ] || rEntry.m_Position[ 1 ] > pBoxMaximum[ 1 ] ||
+						rEntry.m_Position[ 2 ] < pBoxMinimum[ 2 ] || rEntry.m_Position[ 2 ] > pBoxMaximum[ 2 ] )
+					{
+						continue;
+					}
+
+					Component *pComponent = Components::Pool::ResolveHandle( rEntry.m_Handle );
+					if ( pComponent )
+					{
+						rResults.Push( static_cast< TransformComponent * >( pComponent ) );
+					}
+				}
+			}
+		}
+	}
+}
+
+void Helium::SpatialIndexComponent::GetCellCoordinates( const float32_t *pPosition, int32_t *pCoordinates ) const
+{
+	for ( size_t axis = 0; axis < 3; ++axis )
+	{
+		float32_t coordinate = Floor( pPosition[ axis ] * m_InverseCellSize );
+		pCoordinates[ axis ] = static_cast< int32_t >( Clamp( coordinate, -MAX_CELL_COORDINATE, MAX_CELL_COORDINATE ) );
+	}
+}
+
+uint32_t Helium::SpatialIndexComponent::FindCell( const int32_t *pCoordinates ) const
+{
+	size_t mask = m_Cells.GetSize() - 1;
+	for ( size_t slot = HashCellCoordinates( pCoordinates ) & mask; m_Cells[ slot ].m_bUsed; slot = ( slot + 1 ) & mask )
+	{
+		const Cell &rCell = m_Cells[ slot ];
+		if ( rCell.m_Coordinates[ 0 ] == pCoordinates[ 0 ] &&
+			rCell.m_Coordinates[ 1 ] == pCoordinates[ 1 ] &&
+			rCell.m_Coordinates[ 2 ] == pCoordinates[ 2 ] )
+		{
+			return static_cast< uint32_t >( slot );
+		}
+	}
+
+	return Invalid< uint32_t >();
+}
+
+uint32_t Helium::SpatialIndexComponent::AddCell( const int32_t *pCoordinates )
+{
+	HELIUM_ASSERT( IsInvalid( FindCell( pCoordinates ) ) );
+
+	// Keep the table at most half full, dropping cells that emptied out while at it
+	if ( ( m_UsedCellCount + 1 ) * 2 > m_Cells.GetSize() )
+	{
+		size_t occupiedCount = 0;
+		for ( DynamicArray< Cell >::ConstIterator iter = m_Cells.Begin(); iter != m_Cells.End(); ++iter )
+		{
+			if ( iter->m_bUsed && IsValid( iter->m_FirstEntry ) )
+			{
+				++occupiedCount;
+			}
+		}
+
+		size_t capacity = MIN_CELL_CAPACITY;
+		while ( capacity < ( occupiedCount + 1 ) * 4 )
+		{
+			capacity *= 2;
+		}
+
+		RebuildCells( capacity );
+	}
+
+	size_t mask = m_Cells.GetSize() - 1;
+	size_t slot = HashCellCoordinates( pCoordinates ) & mask;
+	while ( m_Cells[ slot ].m_bUsed )
+	{
+		slot = ( slot + 1 ) & mask;
+	}
+
+	Cell &rCell = m_Cells[ slot ];
+	rCell.m_bUsed = true;
+	rCell.m_FirstEntry = Invalid< uint32_t >();
+	for ( size_t axis = 0; axis < 3; ++axis )
+	{
+		rCell.m_Coordinates[ axis ] = pCoordinates[ axis ];
+		m_BoundsMinimum[ axis ] = Min( m_BoundsMinimum[ axis ], pCoordinates[ axis ] );
+		m_BoundsMaximum[ axis ] = Max( m_BoundsMaximum[ axis ], pCoordinates[ axis ] );
+	}
+
+	++m_UsedCellCount;
+
+	return static_cast< uint32_t >( slot );
+}
+
+void Helium::SpatialIndexComponent::RebuildCells( size_t capacity )
+{
+	HELIUM_ASSERT( ( capacity & ( capacity - 1 ) ) == 0 );
+
+	DynamicArray< Cell > oldCells;
+	oldCells.Swap( m_Cells );
+
+	m_Cells.Resize( capacity );
+	for ( DynamicArray< Cell >::Iterator iter = m_Cells.Begin(); iter != m_Cells.End(); ++iter )
+	{
+		iter->m_bUsed = false;
+	}
+
+	m_UsedCellCount = 0;
+	m_bBoundsDirty = false;
+	for ( size_t axis = 0; axis < 3; ++axis )
+	{
+		m_BoundsMinimum[ axis ] = NumericLimits< int32_t >::Maximum;
+		m_BoundsMaximum[ axis ] = NumericLimits< int32_t >::Minimum;
+	}
+
+	for ( DynamicArray< Cell >::ConstIterator iter = oldCells.Begin(); iter != oldCells.End(); ++iter )
+	{
+		if ( !iter->m_bUsed || IsInvalid( iter->m_FirstEntry ) )
+		{
+			continue;
+		}
+
+		uint32_t cellIndex = AddCell( iter->m_Coordinates );
+		m_Cells[ cellIndex ].m_FirstEntry = iter->m_FirstEntry;
+
+		for ( uint32_t entryIndex = iter->m_FirstEntry; IsValid( entryIndex ); entryIndex = m_Entries[ entryIndex ].m_Next )
+		{
+			m_Entries[ entryIndex ].m_Cell = cellIndex;
+		}
+	}
+}
+
+void Helium::SpatialIndexComponent::LinkEntry( uint32_t entryIndex, uint32_t cellIndex )
+{
+	Entry &rEntry = m_Entries[ entryIndex ];
+	Cell &rCell = m_Cells[ cellIndex ];
+	HELIUM_ASSERT( IsInvalid( rEntry.m_Cell ) );
+
+	rEntry.m_Cell = cellIndex;
+	rEntry.m_Previous = Invalid< uint32_t >();
+	rEntry.m_Next = rCell.m_FirstEntry;
+	if ( IsValid( rCell.m_FirstEntry ) )
+	{
+		m_Entries[ rCell.m_FirstEntry ].m_Previous = entryIndex;
+	}
+	else
+	{
+		// The bounds may have shrunk past this cell while it was empty
+		++m_OccupiedCellCount;
+		for ( size_t axis = 0; axis < 3; ++axis )
+		{
+			m_BoundsMinimum[ axis ] = Min( m_BoundsMinimum[ axis ], rCell.m_Coordinates[ axis ] );
+			m_BoundsMaximum[ axis ] = Max( m_BoundsMaximum[ axis ], rCell.m_Coordinates[ axis ] );
+		}
+	}
+
+	rCell.m_FirstEntry = entryIndex;
+}
+
+void Helium::SpatialIndexComponent::UnlinkEntry( uint32_t entryIndex )
+{
+	Entry &rEntry = m_Entries[ entryIndex ];
+	HELIUM_ASSERT( IsValid( rEntry.m_Cell ) );
+
+	if ( IsValid( rEntry.m_Previous ) )
+	{
+		m_Entries[ rEntry.m_Previous ].m_Next = rEntry.m_Next;
+	}
+	else
+	{
+		m_Cells[ rEntry.m_Cell ].m_FirstEntry = rEntry.m_Next;
+	}
+
+	if ( IsValid( rEntry.m_Next ) )
+	{
+		m_Entries[ rEntry.m_Next ].m_Previous = rEntry.m_Previous;
+	}
+
+	const Cell &rCell = m_Cells[ rEntry.m_Cell ];
+	if ( IsInvalid( rCell.m_FirstEntry ) )
+	{
+		--m_OccupiedCellCount;
+		for ( size_t axis = 0; axis < 3; ++axis )
+		{
+			if ( rCell.m_Coordinates[ axis ] == m_BoundsMinimum[ axis ] || rCell.m_Coordinates[ axis ] == m_BoundsMaximum[ axis ] )
+			{
+				m_bBoundsDirty = true;
+			}
+		}
+	}
+
+	rEntry.m_Cell = Invalid< uint32_t >();
+}
+
+// Shrinks the bounds to the cells that still hold entries
+void Helium::SpatialIndexComponent::UpdateBounds()
+{
+	for ( size_t axis = 0; axis < 3; ++axis )
+	{
+		m_BoundsMinimum[ axis ] = NumericLimits< int32_t >::Maximum;
+		m_BoundsMaximum[ axis ] = NumericLimits< int32_t >::Minimum;
+	}
+
+	for ( DynamicArray< Cell >::ConstIterator iter = m_Cells.Begin(); iter != m_Cells.End(); ++iter )
+	{
+		if ( !iter->m_bUsed || IsInvalid( iter->m_FirstEntry ) )
+		{
+			continue;
+		}
+
+		for ( size_t axis = 0; axis < 3; ++axis )
+		{
+			m_BoundsMinimum[ axis ] = Min( m_BoundsMinimum[ axis ], iter->m_Coordinates[ axis ] );
+			m_BoundsMaximum[ axis ] = Max( m_BoundsMaximum[ axis ], iter->m_Coordinates[ axis ] );
+		}
+	}
+
+	m_bBoundsDirty = false;
+}
+
+// Returns the entry for the given transform, replacing whatever freed transform used the same pool slot before
+SpatialIndexComponent::Entry &Helium::SpatialIndexComponent::ClaimEntry( uint32_t entryIndex, Components::Handle handle )
+{
+	Entry &rEntry = m_Entries[ entryIndex ];
+	if ( rEntry.m_Handle != handle )
+	{
+		if ( rEntry.m_Handle )
+		{
+			ReleaseEntry( entryIndex );
+		}
+
+		rEntry.m_Handle = handle;
+		rEntry.m_LayerMask = SPATIAL_INDEX_LAYER_DEFAULT;
+		rEntry.m_Cell = Invalid< uint32_t >();
+		rEntry.m_Stamp = 0;
+		++m_IndexedCount;
+	}
+
+	return rEntry;
+}
+
+void Helium::SpatialIndexComponent::ReleaseEntry( uint32_t entryIndex )
+{
+	Entry &rEntry = m_Entries[ entryIndex ];
+	HELIUM_ASSERT( rEntry.m_Handle );
+
+	if ( IsValid( rEntry.m_Cell ) )
+	{
+		UnlinkEntry( entryIndex );
+	}
+
+	rEntry.m_Handle = 0;
+	--m_IndexedCount;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// UpdateSpatialIndexTask
+
+void UpdateSpatialIndex( SpatialIndexComponent *pSpatialIndex )
+{
+	pSpatialIndex->Update();
+}
+
+void Helium::UpdateSpatialIndexTask::DefineContract( TaskContract &rContract )
+{
+	// Pick up everything gameplay and physics moved this frame, before the dirty flags are cleared
+	rContract.ExecuteAfter<StandardDependencies::PostPhysicsGameplay>();
+	rContract.ExecuteBefore<ClearTransformComponentDirtyFlagsTask>();
+	rContract.ReadsComponents<TransformComponent>();
+	rContract.WritesComponents<SpatialIndexComponent>();
+}
+
+HELIUM_DEFINE_TASK( UpdateSpatialIndexTask, (ForEachWorld< QueryComponents< SpatialIndexComponent, UpdateSpatialIndex > >), TickTypes::Gameplay )
@@ -0,0 +1,195 @@
+#pragma once
+
+#include "Components/Components.h"
+#include "Foundation/DynamicArray.h"
+#include "Framework/ComponentDefinition.h"
+#include "Framework/TaskScheduler.h"
+#include "MathSimd/Vector3.h"
+
+namespace Helium
+{
+	class SpatialIndexComponentDefinition;
+	class TransformComponent;
+
+	/// Layer every transform is indexed on until SpatialIndexComponent::SetLayerMask() says otherwise.
+	const static uint32_t SPATIAL_INDEX_LAYER_DEFAULT = 1u << 0;
+	/// Layer mask matching every indexed transform.
+	const static uint32_t SPATIAL_INDEX_LAYER_ALL = 0xffffffff;
+
+	/// World-wide index of TransformComponent positions for range and neighbor queries.
+	///
+	/// Add one to a world definition to share a single index between every system in the world.  Positions are kept in
+	/// a hashed uniform grid that UpdateSpatialIndexTask brings up to date once a frame, only moving the transforms whose
+	/// dirty flag is set, so queries made during a frame see positions as of the end of the previous frame's gameplay.
+	///
+	/// Queries may run concurrently with each other (the batched ones run in parallel themselves) but not with
+	/// Update() or SetLayerMask().
+	class HELIUM_COMPONENTS_API SpatialIndexComponent : public Component
+	{
+	public:
+		HELIUM_DECLARE_COMPONENT( Helium::SpatialIndexComponent, Helium::Component );
+		static void PopulateMetaType( Reflect::MetaStruct& comp );
+
+		SpatialIndexComponent();
+
+		void Initialize( const SpatialIndexComponentDefinition &definition );
+
+		/// @name Index Maintenance
+		//@{
+		void Update();
+		void SetLayerMask( TransformComponent *pTransform, uint32_t layerMask );
+
+		inline float32_t GetCellSize() const;
+		inline size_t GetIndexedCount() const;
+		//@}
+
+		/// @name Queries
+		//@{
+		void QueryRadius(
+			const Simd::Vector3 &rCenter,
+			float32_t radius,
+			uint32_t layerMask,
+			DynamicArray< TransformComponent * > &rResults ) const;
+		void QueryBox(
+			const Simd::Vector3 &rMinimum,
+			const Simd::Vector3 &rMaximum,
+			uint32_t layerMask,
+			DynamicArray< TransformComponent * > &rResults ) const;
+		size_t QueryNearest(
+			const Simd::Vector3 &rCenter,
+			size_t count,
+			float32_t maxRadius,
+			uint32_t layerMask,
+			TransformComponent **ppResults ) const;
+		//@}
+
+		/// @name Batched Queries
+		//@{
+		void QueryRadiusBatch(
+			const Simd::Vector3 *pCenters,
+			size_t queryCount,
+			float32_t radius,
+			uint32_t layerMask,
+			DynamicArray< TransformComponent * > &rResults,
+			DynamicArray< size_t > &rResultOffsets ) const;
+		void QueryNearestBatch(
+			const Simd::Vector3 *pCenters,
+			size_t queryCount,
+			size_t count,
+			float32_t maxRadius,
+			uint32_t layerMask,
+			TransformComponent **ppResults ) const;
+		//@}
+
+	private:
+		/// Indexed transform, stored at the transform's index in its pool.
+		struct Entry
+		{
+			/// Handle of the transform, zero if the entry is unused.
+			Components::Handle m_Handle;
+			/// Indexed position.
+			float32_t m_Position[ 3 ];
+			/// Layers the transform is on.
+			uint32_t m_LayerMask;
+			/// Cell holding the entry, invalid if the entry has not been placed yet.
+			uint32_t m_Cell;
+			/// Next entry in the same cell.
+			uint32_t m_Next;
+			/// Previous entry in the same cell.
+			uint32_t m_Previous;
+			/// Update() pass that last saw the transform.
+			uint32_t m_Stamp;
+		};
+
+		/// Grid cell, in an open addressed hash table keyed by cell coordinates.
+		struct Cell
+		{
+			/// Cell coordinates.
+			int32_t m_Coordinates[ 3 ];
+			/// First entry in the cell, invalid if empty.
+			uint32_t m_FirstEntry;
+			/// True if this slot of the table holds a cell.
+			bool m_bUsed;
+		};
+
+		/// @name Grid Management
+		//@{
+		void GetCellCoordinates( const float32_t *pPosition, int32_t *pCoordinates ) const;
+		uint32_t FindCell( const int32_t *pCoordinates ) const;
+		uint32_t AddCell( const int32_t *pCoordinates );
+		void RebuildCells( size_t capacity );
+		void LinkEntry( uint32_t entryIndex, uint32_t cellIndex );
+		void UnlinkEntry( uint32_t entryIndex );
+		Entry &ClaimEntry( uint32_t entryIndex, Components::Handle handle );
+		void ReleaseEntry( uint32_t entryIndex );
+		void UpdateBounds();
+		//@}
+
+		/// @name Query Support
+		//@{
+		void QueryCells(
+			const int32_t *pMinimum,
+			const int32_t *pMaximum,
+			const float32_t *pCenter,
+			float32_t radiusSquared,
+			const float32_t *pBoxMinimum,
+			const float32_t *pBoxMaximum,
+			uint32_t layerMask,
+			DynamicArray< TransformComponent * > &rResults ) const;
+		void GatherNearest(
+			uint32_t cellIndex,
+			const float32_t *pCenter,
+			float32_t maxRadiusSquared,
+			uint32_t layerMask,
+			size_t count,
+			float32_t *pDistances,
+			uint32_t *pFound,
+			size_t &rFoundCount ) const;
+		static void QueryNearestRange( void *pData, size_t start, size_t end );
+		//@}
+
+		/// Edge length of a grid cell.
+		float32_t m_CellSize;
+		/// Reciprocal of the cell edge length.
+		float32_t m_InverseCellSize;
+
+		/// Entries, indexed like the transform pool.
+		DynamicArray< Entry > m_Entries;
+		/// Grid cell hash table, its size is always a power of two.
+		DynamicArray< Cell > m_Cells;
+		/// Number of used slots in the cell table.
+		size_t m_UsedCellCount;
+		/// Number of cells holding at least one entry.
+		size_t m_OccupiedCellCount;
+		/// Number of used entries.
+		size_t m_IndexedCount;
+		/// Smallest coordinates of any occupied cell.
+		int32_t m_BoundsMinimum[ 3 ];
+		/// Largest coordinates of any occupied cell.
+		int32_t m_BoundsMaximum[ 3 ];
+		/// True if a cell on the bounds emptied out, so Update() should shrink them.
+		bool m_bBoundsDirty;
+		/// Current Update() pass.
+		uint32_t m_Stamp;
+	};
+
+	class HELIUM_COMPONENTS_API SpatialIndexComponentDefinition : public Helium::ComponentDefinitionHelper<SpatialIndexComponent, SpatialIndexComponentDefinition>
+	{
+		HELIUM_DECLARE_CLASS( Helium::SpatialIndexComponentDefinition, Helium::ComponentDefinition );
+		static void PopulateMetaType( Reflect::MetaStruct& comp );
+
+		SpatialIndexComponentDefinition();
+
+		/// Edge length of a grid cell, about the radius of a typical query works well.
+		float32_t m_CellSize;
+	};
+	typedef StrongPtr<SpatialIndexComponentDefinition> SpatialIndexComponentDefinitionPtr;
+
+	struct HELIUM_COMPONENTS_API UpdateSpatialIndexTask : public TaskDefinition
+	{
+		HELIUM_DECLARE_TASK(UpdateSpatialIndexTask);
+		virtual void DefineContract(TaskContract &rContract);
+	};
+}
+
+#include "Components/SpatialIndexComponent.inl"
@@ -0,0 +1,15 @@
+/// Get the edge length of a grid cell.
+///
+/// @return  Cell size.
+Helium::float32_t Helium::SpatialIndexComponent::GetCellSize() const
+{
+	return m_CellSize;
+}
+
+/// Get the number of transforms in the index.
+///
+/// @return  Indexed transform count.
+size_t Helium::SpatialIndexComponent::GetIndexedCount() const
+{
+	return m_IndexedCount;
+}
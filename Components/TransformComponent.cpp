@@ -1,7 +1,9 @@
 #include "ComponentsPch.h"
 #include "Components/TransformComponent.h"
+#include "Components/RotateComponent.h"
 
 #include "Framework/World.h"
+#include "Framework/ComponentLayout.h"
 #include "Reflect/TranslatorDeduction.h"
 
 HELIUM_DEFINE_COMPONENT(Helium::TransformComponent, 128);
@@ -10,6 +12,13 @@ using namespace Helium;
 
 void Helium::TransformComponent::PopulateMetaType( Reflect::MetaStruct& comp )
 {
+	comp.AddField(&TransformComponent::m_Position, "m_Position", Components::FIELD_FLAG_HOT);
+	comp.AddField(&TransformComponent::m_Rotation, "m_Rotation", Components::FIELD_FLAG_HOT);
+	comp.AddField(&TransformComponent::m_Scale,    "m_Scale");
+	comp.AddField(&TransformComponent::m_bDirty,   "m_bDirty",   Components::FIELD_FLAG_HOT);
+	comp.AddField(&TransformComponent::m_PreviousPosition, "m_PreviousPosition", Reflect::FieldFlags::Discard);
+	comp.AddField(&TransformComponent::m_PreviousRotation, "m_PreviousRotation", Reflect::FieldFlags::Discard);
+	comp.AddField(&TransformComponent::m_bMovedThisStep,   "m_bMovedThisStep",   Reflect::FieldFlags::Discard);
 }
 
 void Helium::TransformComponent::Initialize( const TransformComponentDefinition &definition )
@@ -18,6 +27,73 @@ void Helium::TransformComponent::Initialize( const TransformComponentDefinition
 	m_Rotation = definition.m_Rotation;
 	m_Scale = definition.m_Scale;
 	m_bDirty = true;
+
+	m_PreviousPosition = m_Position;
+	m_PreviousRotation = m_Rotation;
+	m_bMovedThisStep = false;
+}
+
+void Helium::TransformComponent::SavePreviousState()
+{
+	if ( m_bMovedThisStep )
+	{
+		m_PreviousPosition = m_Position;
+		m_PreviousRotation = m_Rotation;
+		m_bMovedThisStep = false;
+
+		// The blended transform jumps to the current one, so it still has to be pushed to rendering
+		m_bDirty = true;
+	}
+}
+
+Simd::Vector3 Helium::TransformComponent::GetInterpolatedPosition( float32_t alpha ) const
+{
+	if ( !m_bMovedThisStep )
+	{
+		return m_Position;
+	}
+
+	return m_PreviousPosition + ( m_Position - m_PreviousPosition ) * Simd::Vector3( alpha );
+}
+
+Simd::Quat Helium::TransformComponent::GetInterpolatedRotation( float32_t alpha ) const
+{
+	if ( !m_bMovedThisStep )
+	{
+		return m_Rotation;
+	}
+
+	// Normalized lerp along the shorter arc, close enough to a slerp over a single step
+	float32_t dot = 0.0f;
+	for ( size_t i = 0; i < 4; ++i )
+	{
+		dot += m_PreviousRotation.GetElement( i ) * m_Rotation.GetElement( i );
+	}
+
+	float32_t sign = dot < 0.0f ? -1.0f : 1.0f;
+	float32_t lengthSquared = 0.0f;
+
+	Simd::Quat rotation;
+	for ( size_t i = 0; i < 4; ++i )
+	{
+		float32_t previous = m_PreviousRotation.GetElement( i );
+		float32_t element = previous + ( sign * m_Rotation.GetElement( i ) - previous ) * alpha;
+		rotation.SetElement( i, element );
+		lengthSquared += element * element;
+	}
+
+	if ( lengthSquared < HELIUM_EPSILON )
+	{
+		return m_Rotation;
+	}
+
+	float32_t invLength = 1.0f / sqrtf( lengthSquared );
+	for ( size_t i = 0; i < 4; ++i )
+	{
+		rotation.SetElement( i, rotation.GetElement( i ) * invLength );
+	}
+
+	return rotation;
 }
 
 HELIUM_DEFINE_CLASS(Helium::TransformComponentDefinition);
@@ -49,7 +125,7 @@ void Helium::TransformComponentDefinition::PopulateMetaType( Reflect::MetaStruct
 //    }
 //}
 
-void ClearTransformComponentDirtyFlags( TransformComponent *pComponent )
+void ClearTransformComponentDirtyFlags( TransformComponent *pComponent, ComponentCommandBuffer & )
 {
 	pComponent->ClearDirtyFlag();
 }
@@ -60,4 +136,24 @@ void Helium::ClearTransformComponentDirtyFlagsTask::DefineContract( TaskContract
 }
 
 //HELIUM_DEFINE_TASK(ClearTransformComponentDirtyFlagsTask, ForEachWorld<ClearTransformComponentDirtyFlags> )
-HELIUM_DEFINE_TASK( ClearTransformComponentDirtyFlagsTask, (ForEachWorld< QueryComponents< TransformComponent, ClearTransformComponentDirtyFlags > >), TickTypes::Render )
+HELIUM_DEFINE_TASK( ClearTransformComponentDirtyFlagsTask, (ForEachWorld< ParallelForEachComponent< TransformComponent, ClearTransformComponentDirtyFlags > >), TickTypes::Render )
+
+//////////////////////////////////////////////////////////////////////////
+
+void SaveTransformComponentPreviousState( TransformComponent *pComponent, ComponentCommandBuffer & )
+{
+	pComponent->SavePreviousState();
+}
+
+void Helium::SaveTransformComponentPreviousStateTask::DefineContract( TaskContract &rContract )
+{
+	// Has to run once at the start of every simulation step, before anything moves. It ticks for every tick type so
+	// IsInterpolating() is cleared in the editor too, and the render tick type would otherwise make it run per frame.
+	rContract.SetCadence( TaskCadences::Fixed );
+	rContract.ExecuteAfter<StandardDependencies::ReceiveInput>();
+	rContract.ExecuteBefore<StandardDependencies::PrePhysicsGameplay>();
+	rContract.ExecuteBefore<UpdateRotateComponentsTask>();
+	rContract.WritesComponents<TransformComponent>();
+}
+
+HELIUM_DEFINE_TASK( SaveTransformComponentPreviousStateTask, (ForEachWorld< ParallelForEachComponent< TransformComponent, SaveTransformComponentPreviousState > >), TickTypes::Always )
@@ -19,10 +19,10 @@ namespace Helium
 		void Initialize( const TransformComponentDefinition &definition );
 				
 		inline const Simd::Vector3& GetPosition() const { return m_Position; }
-		virtual void SetPosition( const Simd::Vector3& rPosition ) { m_Position = rPosition; m_bDirty = true; }
+		virtual void SetPosition( const Simd::Vector3& rPosition ) { m_Position = rPosition; m_bDirty = true; m_bMovedThisStep = true; }
 
 		inline const Simd::Quat& GetRotation() const { return m_Rotation; }
-		virtual void SetRotation( const Simd::Quat& rRotation ) { m_Rotation = rRotation; m_bDirty = true; }
+		virtual void SetRotation( const Simd::Quat& rRotation ) { m_Rotation = rRotation; m_bDirty = true; m_bMovedThisStep = true; }
 
 		inline float32_t GetScale() const { return m_Scale; }
 		virtual void SetScale( float32_t scale ) { m_Scale = scale; }
@@ -30,10 +30,22 @@ namespace Helium
 		bool IsDirty() const { return m_bDirty; }
 		void ClearDirtyFlag() { m_bDirty = false; }
 
+		// Rendering blends between the transform at the start of the last simulation step and the current one by
+		// WorldManager::GetInterpolationAlpha(). IsInterpolating() is true while the two differ, in which case the
+		// blended transform changes every frame even if the transform itself doesn't.
+		bool IsInterpolating() const { return m_bMovedThisStep; }
+		void SavePreviousState();
+		Simd::Vector3 GetInterpolatedPosition( float32_t alpha ) const;
+		Simd::Quat GetInterpolatedRotation( float32_t alpha ) const;
+
 		Simd::Vector3 m_Position;
 		Simd::Quat m_Rotation;
 		float32_t m_Scale;
 		bool m_bDirty;
+
+		Simd::Vector3 m_PreviousPosition;
+		Simd::Quat m_PreviousRotation;
+		bool m_bMovedThisStep;
 	};
 	typedef Helium::ComponentPtr<TransformComponent> TransformComponentPtr;
 		
@@ -64,4 +76,10 @@ namespace Helium
 		HELIUM_DECLARE_TASK(ClearTransformComponentDirtyFlagsTask);
 		virtual void DefineContract(TaskContract &rContract);
 	};
+
+	struct HELIUM_COMPONENTS_API SaveTransformComponentPreviousStateTask : public TaskDefinition
+	{
+		HELIUM_DECLARE_TASK(SaveTransformComponentPreviousStateTask);
+		virtual void DefineContract(TaskContract &rContract);
+	};
 }
@@ -276,6 +276,8 @@ bool ProjectViewModel::OpenProject( const FilePath& project )
 
 	ConfigPc::SaveUserConfig();
 
+	pAssetPreprocessor->ApplyCacheCompressionConfig();
+
 #if HELIUM_OS_WIN
 	m_Engine.Initialize( &wxGetApp().GetFrame()->GetSceneManager(), GetHwndOf( wxGetApp().GetFrame() ) );
 #else
@@ -12,8 +12,10 @@ AsyncLoader* AsyncLoader::sm_pInstance = NULL;
 /// Constructor.
 AsyncLoader::AsyncLoader()
 	: m_requestPool( REQUEST_POOL_BLOCK_SIZE )
-	, m_pThread( NULL )
-	, m_pWorker( NULL )
+	, m_pendingCount( 0 )
+	, m_wakeUpCondition( false, false )
+	, m_idleCondition( true, true )
+	, m_stopCounter( 0 )
 {
 }
 
@@ -25,20 +27,41 @@ AsyncLoader::~AsyncLoader()
 
 /// Initialize the async loader.
 ///
+/// @param[in] workerCount  Number of load worker threads to start, or zero to use DEFAULT_WORKER_COUNT.
+///
 /// @return  True if initialization was sucessful, false if not.
 ///
 /// @see Cleanup()
-bool AsyncLoader::Initialize()
+bool AsyncLoader::Initialize( uint32_t workerCount )
 {
 	Cleanup();
 
-	// Start up the async loading thread.
-	m_pWorker = new LoadWorker;
-	HELIUM_ASSERT( m_pWorker );
+	if( workerCount == 0 )
+	{
+		workerCount = DEFAULT_WORKER_COUNT;
+	}
+
+	workerCount = Min( workerCount, WORKER_COUNT_MAX );
 
-	m_pThread = new RunnableThread( m_pWorker );
-	HELIUM_ASSERT( m_pThread );
-	HELIUM_VERIFY( m_pThread->Start( TXT( "AsyncLoader - file loading" ) ) );
+	// Split the open file stream budget between the workers.
+	size_t streamLimit = Max< size_t >( FILE_STREAM_LIMIT / workerCount, 1 );
+
+	AtomicExchangeRelease( m_stopCounter, 0 );
+
+	// Start up the async loading threads.
+	m_workers.Reserve( workerCount );
+	m_threads.Reserve( workerCount );
+	for( uint32_t workerIndex = 0; workerIndex < workerCount; ++workerIndex )
+	{
+		LoadWorker* pWorker = new LoadWorker( this, streamLimit );
+		HELIUM_ASSERT( pWorker );
+		m_workers.Push( pWorker );
+
+		RunnableThread* pThread = new RunnableThread( pWorker );
+		HELIUM_ASSERT( pThread );
+		m_threads.Push( pThread );
+		HELIUM_VERIFY( pThread->Start( TXT( "AsyncLoader - file loading" ) ) );
+	}
 
 	return true;
 }
@@ -48,20 +71,33 @@ bool AsyncLoader::Initialize()
 /// @see Initialize()
 void AsyncLoader::Cleanup()
 {
-	if( m_pWorker )
+	if( !m_threads.IsEmpty() )
 	{
-		m_pWorker->Stop();
+		// Each worker passes the wake-up signal on to the next one as it stops.
+		AtomicExchangeRelease( m_stopCounter, 1 );
+		m_wakeUpCondition.Signal();
+
+		size_t threadCount = m_threads.GetSize();
+		for( size_t threadIndex = 0; threadIndex < threadCount; ++threadIndex )
+		{
+			RunnableThread* pThread = m_threads[ threadIndex ];
+			HELIUM_ASSERT( pThread );
+			pThread->Join();
+			delete pThread;
+		}
+
+		m_threads.Clear();
 	}
 
-	if( m_pThread )
+	size_t workerCount = m_workers.GetSize();
+	for( size_t workerIndex = 0; workerIndex < workerCount; ++workerIndex )
 	{
-		m_pThread->Join();
-		delete m_pThread;
-		m_pThread = NULL;
+		delete m_workers[ workerIndex ];
 	}
 
-	delete m_pWorker;
-	m_pWorker = NULL;
+	m_workers.Clear();
+
+	m_wakeUpCondition.Reset();
 }
 
 /// Queue an async load request.
@@ -74,7 +110,7 @@ void AsyncLoader::Cleanup()
 ///
 /// @return  ID identifying the load request if queued successfully, invalid index if the request queue failed.
 ///
-/// @see SyncRequest(), TrySyncRequest()
+/// @see QueueCompressedRequest(), SyncRequest(), TrySyncRequest()
 size_t AsyncLoader::QueueRequest(
 	void* pBuffer,
 	const String& rFileName,
@@ -82,33 +118,37 @@ size_t AsyncLoader::QueueRequest(
 	size_t size,
 	EPriority priority )
 {
-	HELIUM_ASSERT( pBuffer );
-	HELIUM_ASSERT( static_cast< size_t >( priority ) < static_cast< size_t >( PRIORITY_MAX ) );
-
-	// Make sure the load worker is running.
-	if( !m_pWorker )
-	{
-		return Invalid< size_t >();
-	}
-
-	// Allocate and queue the request.
-	Request* pRequest = m_requestPool.Allocate();
-	HELIUM_ASSERT( pRequest );
-	pRequest->pBuffer = pBuffer;
-	pRequest->fileName = rFileName;
-	pRequest->offset = offset;
-	pRequest->size = size;
-	pRequest->priority = priority;
-
-	pRequest->bytesRead = 0;
-	AtomicExchangeRelease( pRequest->processedCounter, 0 );
-
-	m_pWorker->QueueRequest( pRequest );
+	return AddRequest( pBuffer, rFileName, offset, size, size, CompressionCodecs::None, priority );
+}
 
-	size_t requestIndex = m_requestPool.GetIndex( pRequest );
-	HELIUM_ASSERT( IsValid( requestIndex ) );
+/// Queue an async load request for compressed data, which will be decompressed on a load worker thread.
+///
+/// The number of bytes reported as read once the request completes is the number of decompressed bytes stored in
+/// the buffer, or zero if the compressed data could not be read in full or is corrupt.
+///
+/// @param[in] pBuffer         Buffer in which to store the decompressed data.
+/// @param[in] size            Number of decompressed bytes to store (decompression stops once this is reached).
+/// @param[in] rFileName       FilePath name of the file from which to load.
+/// @param[in] offset          Byte offset of the compressed data within the file.
+/// @param[in] compressedSize  Number of bytes of compressed data.
+/// @param[in] codec           Codec with which the data was compressed.
+/// @param[in] priority        Load priority.
+///
+/// @return  ID identifying the load request if queued successfully, invalid index if the request queue failed.
+///
+/// @see QueueRequest(), SyncRequest(), TrySyncRequest()
+size_t AsyncLoader::QueueCompressedRequest(
+	void* pBuffer,
+	size_t size,
+	const String& rFileName,
+	uint64_t offset,
+	size_t compressedSize,
+	CompressionCodec codec,
+	EPriority priority )
+{
+	HELIUM_ASSERT( static_cast< size_t >( codec ) < static_cast< size_t >( CompressionCodecs::Count ) );
 
-	return requestIndex;
+	return AddRequest( pBuffer, rFileName, offset, size, compressedSize, codec, priority );
 }
 
 /// Block the current thread until the load request with the specified ID completes and release the request
@@ -129,10 +169,7 @@ size_t AsyncLoader::SyncRequest( size_t id )
 	Request* pRequest = m_requestPool.GetObject( id );
 	HELIUM_ASSERT( pRequest );
 
-	while( pRequest->processedCounter == 0 )
-	{
-		Thread::Yield();
-	}
+	pRequest->completedCondition.Wait();
 
 	size_t bytesRead = pRequest->bytesRead;
 	m_requestPool.Release( pRequest );
@@ -159,7 +196,7 @@ bool AsyncLoader::TrySyncRequest( size_t id, size_t& rBytesRead )
 
 	Request* pRequest = m_requestPool.GetObject( id );
 	HELIUM_ASSERT( pRequest );
-	if( pRequest->processedCounter == 0 )
+	if( !pRequest->completedCondition.Wait( 0 ) )
 	{
 		return false;
 	}
@@ -176,21 +213,23 @@ bool AsyncLoader::TrySyncRequest( size_t id, size_t& rBytesRead )
 /// pending requests in order to free any associated resources.
 void AsyncLoader::Flush()
 {
-	if( m_pWorker )
+	if( !m_workers.IsEmpty() )
 	{
-		m_pWorker->Flush();
+		m_idleCondition.Wait();
 	}
 }
 
 /// Lock async loading for writing to files that may be in use.
 ///
+/// Once this returns, no requests are pending and no load worker holds a file open until Unlock() is called.
+///
 /// @see Unlock()
 void AsyncLoader::Lock()
 {
-	if( m_pWorker )
-	{
-		m_pWorker->Lock();
-	}
+	// Prevent other threads from queueing requests or writing out data while we have a write lock.
+	m_writeLock.LockWrite();
+
+	Flush();
 }
 
 /// Unlock a previous loader lock.
@@ -198,10 +237,7 @@ void AsyncLoader::Lock()
 /// @see Lock()
 void AsyncLoader::Unlock()
 {
-	if( m_pWorker )
-	{
-		m_pWorker->Unlock();
-	}
+	m_writeLock.UnlockWrite();
 }
 
 /// Get the singleton AsyncLoader instance.
@@ -245,138 +281,498 @@ void AsyncLoader::Shutdown()
 	}
 }
 
+/// Allocate and queue a load request.
+///
+/// @param[in] pBuffer    Buffer in which to store the loaded data.
+/// @param[in] rFileName  FilePath name of the file from which to load.
+/// @param[in] offset     Byte offset within the file from which to load.
+/// @param[in] size       Number of bytes to store in the buffer.
+/// @param[in] fileSize   Number of bytes to read from the file.
+/// @param[in] codec      Codec with which the data in the file is compressed.
+/// @param[in] priority   Load priority.
+///
+/// @return  ID identifying the load request if queued successfully, invalid index if the request queue failed.
+size_t AsyncLoader::AddRequest(
+	void* pBuffer,
+	const String& rFileName,
+	uint64_t offset,
+	size_t size,
+	size_t fileSize,
+	CompressionCodec codec,
+	EPriority priority )
+{
+	HELIUM_ASSERT( pBuffer );
+	HELIUM_ASSERT( static_cast< size_t >( priority ) < static_cast< size_t >( PRIORITY_MAX ) );
+
+	// Make sure the load workers are running.
+	if( m_workers.IsEmpty() )
+	{
+		return Invalid< size_t >();
+	}
+
+	// Allocate and queue the request.
+	Request* pRequest = m_requestPool.Allocate();
+	HELIUM_ASSERT( pRequest );
+	pRequest->pBuffer = pBuffer;
+	pRequest->fileName = rFileName;
+	pRequest->offset = offset;
+	pRequest->size = size;
+	pRequest->fileSize = fileSize;
+	pRequest->codec = codec;
+	pRequest->priority = priority;
+
+	pRequest->bytesRead = 0;
+	pRequest->completedCondition.Reset();
+
+	{
+		// Prevent access to the load queue while an exclusive write lock is held.
+		ScopeReadLock nonExclusiveLock( m_writeLock );
+
+		// The request must be counted as pending before any worker can see it, or a worker could finish it first and
+		// let the pending count (and Flush()) briefly drop to zero while other reads are still in flight.
+		MutexScopeLock scopeLock( m_queueLock );
+
+		RequestQueue& rQueue = m_queues[ priority ];
+		rQueue.requests.Push( pRequest );
+		++rQueue.count;
+
+		AddPendingLocked( 1 );
+	}
+
+	m_wakeUpCondition.Signal();
+
+	size_t requestIndex = m_requestPool.GetIndex( pRequest );
+	HELIUM_ASSERT( IsValid( requestIndex ) );
+
+	return requestIndex;
+}
+
+/// Take the highest priority queued request along with any queued requests for the data following it in the same
+/// file.
+///
+/// @param[out] ppRequests  Array in which to store the requests taken, in file order.
+/// @param[in]  maxCount    Maximum number of requests to take.
+///
+/// @return  Number of requests taken, zero if the queues are empty.
+///
+/// @see IsQueueEmpty()
+size_t AsyncLoader::AcquireRequests( Request** ppRequests, size_t maxCount )
+{
+	HELIUM_ASSERT( ppRequests );
+	HELIUM_ASSERT( maxCount != 0 );
+
+	MutexScopeLock scopeLock( m_queueLock );
+
+	Request* pFirstRequest = NULL;
+	for( size_t priorityIndex = PRIORITY_MAX; priorityIndex-- != 0; )
+	{
+		RequestQueue& rQueue = m_queues[ priorityIndex ];
+		if( rQueue.count != 0 )
+		{
+			// Skip over the slots of requests that were merged into an earlier read.
+			while( !rQueue.requests[ rQueue.head ] )
+			{
+				++rQueue.head;
+			}
+
+			pFirstRequest = rQueue.requests[ rQueue.head ];
+			rQueue.requests[ rQueue.head ] = NULL;
+			++rQueue.head;
+			--rQueue.count;
+
+			// Drop the slots that have been taken once they make up the bulk of the array, so that popping stays
+			// amortized constant time.
+			if( rQueue.count == 0 )
+			{
+				rQueue.requests.Resize( 0 );
+				rQueue.head = 0;
+			}
+			else if( rQueue.head >= rQueue.requests.GetSize() / 2 )
+			{
+				rQueue.requests.Remove( 0, rQueue.head );
+				rQueue.head = 0;
+			}
+
+			break;
+		}
+	}
+
+	if( !pFirstRequest )
+	{
+		return 0;
+	}
+
+	ppRequests[ 0 ] = pFirstRequest;
+	size_t requestCount = 1;
+
+	// Grab queued requests that continue where the last one taken ends, regardless of their priority, so that they
+	// can be serviced without seeking.
+	while( requestCount < maxCount )
+	{
+		const Request* pLastRequest = ppRequests[ requestCount - 1 ];
+		uint64_t nextOffset = pLastRequest->offset + pLastRequest->fileSize;
+
+		Request* pNextRequest = NULL;
+		size_t scanCount = 0;
+		for( size_t priorityIndex = PRIORITY_MAX; priorityIndex-- != 0 && !pNextRequest && scanCount < MERGE_SCAN_LIMIT; )
+		{
+			RequestQueue& rQueue = m_queues[ priorityIndex ];
+			size_t queueSize = rQueue.requests.GetSize();
+			for( size_t queueIndex = rQueue.head;
+				queueIndex < queueSize && scanCount < MERGE_SCAN_LIMIT;
+				++queueIndex, ++scanCount )
+			{
+				Request* pRequest = rQueue.requests[ queueIndex ];
+				if( pRequest && pRequest->offset == nextOffset && pRequest->fileName == pFirstRequest->fileName )
+				{
+					pNextRequest = pRequest;
+
+					// Leave a hole rather than shifting the rest of the queue.
+					rQueue.requests[ queueIndex ] = NULL;
+					--rQueue.count;
+
+					break;
+				}
+			}
+		}
+
+		if( !pNextRequest )
+		{
+			break;
+		}
+
+		ppRequests[ requestCount ] = pNextRequest;
+		++requestCount;
+	}
+
+	return requestCount;
+}
+
+/// Get whether any requests are still waiting to be picked up by a load worker.
+///
+/// @return  True if all request queues are empty, false if not.
+///
+/// @see AcquireRequests()
+bool AsyncLoader::IsQueueEmpty() const
+{
+	MutexScopeLock scopeLock( m_queueLock );
+
+	for( size_t priorityIndex = 0; priorityIndex < PRIORITY_MAX; ++priorityIndex )
+	{
+		if( m_queues[ priorityIndex ].count != 0 )
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/// Add to the count of pending work that Flush() waits on.
+///
+/// @param[in] count  Number of requests queued, or one for a worker that started holding files open.
+///
+/// @see ReleasePending()
+void AsyncLoader::AddPending( size_t count )
+{
+	MutexScopeLock scopeLock( m_queueLock );
+	AddPendingLocked( count );
+}
+
+/// Add to the count of pending work that Flush() waits on while the queue lock is already held.
+///
+/// @param[in] count  Number of requests queued, or one for a worker that started holding files open.
+///
+/// @see AddPending()
+void AsyncLoader::AddPendingLocked( size_t count )
+{
+	if( m_pendingCount == 0 )
+	{
+		m_idleCondition.Reset();
+	}
+
+	m_pendingCount += count;
+}
+
+/// Remove from the count of pending work that Flush() waits on, waking up any flushing threads once it reaches zero.
+///
+/// @param[in] count  Number of requests processed, or one for a worker that closed its files.
+///
+/// @see AddPending()
+void AsyncLoader::ReleasePending( size_t count )
+{
+	MutexScopeLock scopeLock( m_queueLock );
+
+	HELIUM_ASSERT( m_pendingCount >= count );
+	m_pendingCount -= count;
+
+	if( m_pendingCount == 0 )
+	{
+		m_idleCondition.Signal();
+	}
+}
+
 /// Constructor.
-AsyncLoader::LoadWorker::LoadWorker()
-	: m_wakeUpCondition( false, false )
-	, m_stopCounter( 0 )
-	, m_processingCounter( 0 )
+AsyncLoader::Request::Request()
+	: pBuffer( NULL )
+	, offset( 0 )
+	, size( 0 )
+	, fileSize( 0 )
+	, codec( CompressionCodecs::None )
+	, priority( PRIORITY_INVALID )
+	, bytesRead( 0 )
+	, completedCondition( true, false )
+{
+}
+
+/// Constructor.
+AsyncLoader::RequestQueue::RequestQueue()
+	: head( 0 )
+	, count( 0 )
+{
+}
+
+/// Constructor.
+///
+/// @param[in] pLoader      Loader owning this worker.
+/// @param[in] streamLimit  Maximum number of files to keep open at once.
+AsyncLoader::LoadWorker::LoadWorker( AsyncLoader* pLoader, size_t streamLimit )
+	: m_pLoader( pLoader )
+	, m_streamLimit( streamLimit )
+	, m_useCounter( 0 )
+	, m_bHoldingFiles( false )
 {
+	HELIUM_ASSERT( pLoader );
+	HELIUM_ASSERT( streamLimit != 0 );
 }
 
 /// Destructor.
 AsyncLoader::LoadWorker::~LoadWorker()
 {
+	CloseStreams();
 }
 
 /// Execute the async loading work.
 void AsyncLoader::LoadWorker::Run()
 {
-	BufferedStream* pBufferedStream = new BufferedStream;
-	HELIUM_ASSERT( pBufferedStream );
+	Request* requests[ MERGE_REQUEST_LIMIT ];
 
-	while( m_stopCounter == 0 )
+	while( m_pLoader->m_stopCounter == 0 )
 	{
-		AtomicExchangeAcquire( m_processingCounter, 1 );
-
-		Request* pRequest;
+		size_t requestCount = m_pLoader->AcquireRequests( requests, HELIUM_ARRAY_COUNT( requests ) );
+		if( requestCount == 0 )
 		{
-			Locker< DynamicArray< Request* >, SpinLock >::Handle handle ( m_requestQueue );
-			pRequest = handle->IsEmpty() ? NULL : handle->Pop();
+			// Queue is empty, so let go of any open files and sleep until notified.
+			CloseStreams();
+			m_pLoader->m_wakeUpCondition.Wait();
+
+			continue;
 		}
-		if( !pRequest )
+
+		// Let another worker pick up whatever is left in the queue.
+		bool bQueueEmpty = m_pLoader->IsQueueEmpty();
+		if( !bQueueEmpty )
 		{
-			// Queue is empty, so sleep until notified.
-			AtomicExchangeRelease( m_processingCounter, 0 );
-			m_wakeUpCondition.Wait();
+			m_pLoader->m_wakeUpCondition.Signal();
+		}
 
-			continue;
+		ProcessRequests( requests, requestCount );
+
+		// Files must not be held open by the time the loader goes idle, as Lock() is used to write to them.
+		if( bQueueEmpty || m_pLoader->IsQueueEmpty() )
+		{
+			CloseStreams();
 		}
 
+		m_pLoader->ReleasePending( requestCount );
+	}
+
+	CloseStreams();
+
+	// Pass the stop request on to the next worker.
+	m_pLoader->m_wakeUpCondition.Signal();
+}
+
+/// Service a run of requests for consecutive data in the same file.
+///
+/// @param[in] ppRequests    Requests to service, in file order.
+/// @param[in] requestCount  Number of requests.
+void AsyncLoader::LoadWorker::ProcessRequests( Request* const* ppRequests, size_t requestCount )
+{
+	HELIUM_ASSERT( ppRequests );
+	HELIUM_ASSERT( requestCount != 0 );
+
+	const Request* pFirstRequest = ppRequests[ 0 ];
+	HELIUM_ASSERT( pFirstRequest );
+
+	BufferedStream* pBufferedStream = GetStream( pFirstRequest->fileName );
+	bool bSeekSucceeded = false;
+	if( pBufferedStream )
+	{
+		int64_t offset = pBufferedStream->Seek( pFirstRequest->offset, SeekOrigins::Begin );
+		bSeekSucceeded = ( static_cast< uint64_t >( offset ) == pFirstRequest->offset );
+	}
+
+	for( size_t requestIndex = 0; requestIndex < requestCount; ++requestIndex )
+	{
+		Request* pRequest = ppRequests[ requestIndex ];
 		HELIUM_ASSERT( pRequest );
 
-		FileStream* pFileStream = FileStream::OpenFileStream( pRequest->fileName, FileStream::MODE_READ );
-		if( !pFileStream )
+		if( !pBufferedStream )
 		{
 			SetInvalid( pRequest->bytesRead );
 		}
 		else
 		{
 			pRequest->bytesRead = 0;
-
-			pBufferedStream->Open( pFileStream );
-			int64_t offset = pBufferedStream->Seek( pRequest->offset, SeekOrigins::Begin );
-			if( static_cast< uint64_t >( offset ) == pRequest->offset )
+			if( bSeekSucceeded )
 			{
-				pRequest->bytesRead = pBufferedStream->Read( pRequest->pBuffer, 1, pRequest->size );
+				if( pRequest->codec == CompressionCodecs::None )
+				{
+					pRequest->bytesRead = pBufferedStream->Read( pRequest->pBuffer, 1, pRequest->size );
+				}
+				else
+				{
+					pRequest->bytesRead = ReadCompressed( pBufferedStream, pRequest );
+				}
 			}
-
-			pBufferedStream->Open( NULL );
-
-			delete pFileStream;
 		}
 
-		AtomicExchangeRelease( pRequest->processedCounter, 1 );
-
-		Thread::Yield();
+		// Once the request is signaled it may be released and reused at any time, so it must not be touched after
+		// that.
+		pRequest->completedCondition.Signal();
 	}
-
-	AtomicExchangeRelease( m_processingCounter, 0 );
-
-	delete pBufferedStream;
-}
-
-/// Request the load worker to stop processing and return at the next possible opportunity.
-void AsyncLoader::LoadWorker::Stop()
-{
-	AtomicExchangeRelease( m_stopCounter, 1 );
-	m_wakeUpCondition.Signal();
 }
 
-/// Queue an async load request.
+/// Read and decompress the data for a compressed request.
 ///
-/// @param[in] pRequest  Request to queue.  Note that the @c processedCounter value should be set to 0 prior to
-///                      calling this function (the worker thread will set it to 1 once the request has been
-///                      processed).
+/// @param[in] pStream   Stream positioned at the start of the compressed data.
+/// @param[in] pRequest  Request to service.
 ///
-/// @see Flush()
-void AsyncLoader::LoadWorker::QueueRequest( Request* pRequest )
+/// @return  Number of decompressed bytes stored in the request buffer, zero if the data could not be read in full or
+///          could not be decompressed.
+size_t AsyncLoader::LoadWorker::ReadCompressed( BufferedStream* pStream, const Request* pRequest )
 {
+	HELIUM_ASSERT( pStream );
 	HELIUM_ASSERT( pRequest );
-	HELIUM_ASSERT( pRequest->processedCounter == 0 );
 
-	// Prevent access to the load queue while an exclusive write lock is held.
-	ScopeReadLock nonExclusiveLock( m_writeLock );
+	m_compressedData.Resize( pRequest->fileSize );
+	size_t compressedBytesRead = pStream->Read( m_compressedData.GetData(), 1, pRequest->fileSize );
+	if( compressedBytesRead != pRequest->fileSize )
+	{
+		return 0;
+	}
 
+	size_t bytesRead = Decompress(
+		pRequest->codec,
+		m_compressedData.GetData(),
+		compressedBytesRead,
+		pRequest->pBuffer,
+		pRequest->size );
+	if( IsInvalid( bytesRead ) )
 	{
-		Locker< DynamicArray< Request* >, SpinLock >::Handle handle ( m_requestQueue );
-		handle->Push( pRequest );
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			( TXT( "AsyncLoader: Failed to decompress %" ) PRIuSZ TXT( " bytes at offset %" ) PRIu64
+			TXT( " in \"%s\".\n" ) ),
+			compressedBytesRead,
+			pRequest->offset,
+			*pRequest->fileName );
+
+		return 0;
 	}
 
-	m_wakeUpCondition.Signal();
+	return bytesRead;
 }
 
-/// Block the current thread until all pending load requests have completed.
+/// Get an open stream for reading from the given file, opening it if necessary.
+///
+/// @param[in] rFileName  Name of the file.
 ///
-/// @see QueueRequest()
-void AsyncLoader::LoadWorker::Flush()
+/// @return  Stream positioned at an unspecified offset, or null if the file could not be opened.
+///
+/// @see CloseStreams()
+BufferedStream* AsyncLoader::LoadWorker::GetStream( const String& rFileName )
 {
-	bool isEmpty;
+	++m_useCounter;
+
+	size_t streamCount = m_streams.GetSize();
+	for( size_t streamIndex = 0; streamIndex < streamCount; ++streamIndex )
 	{
-		Locker< DynamicArray< Request* >, SpinLock >::Handle handle ( m_requestQueue );
-		isEmpty = handle->IsEmpty();
+		OpenStream& rStream = m_streams[ streamIndex ];
+		if( rStream.fileName == rFileName )
+		{
+			rStream.lastUse = m_useCounter;
+
+			return rStream.pBufferedStream;
+		}
 	}
 
-	while( m_processingCounter != 0 && !isEmpty )
+	// Make room by closing the least recently used file.
+	if( streamCount >= m_streamLimit )
 	{
-		Thread::Yield();
+		size_t oldestIndex = 0;
+		for( size_t streamIndex = 1; streamIndex < streamCount; ++streamIndex )
+		{
+			if( m_streams[ streamIndex ].lastUse < m_streams[ oldestIndex ].lastUse )
+			{
+				oldestIndex = streamIndex;
+			}
+		}
+
+		OpenStream& rOldest = m_streams[ oldestIndex ];
+		rOldest.pBufferedStream->Open( NULL );
+		delete rOldest.pBufferedStream;
+		delete rOldest.pFileStream;
+		m_streams.RemoveSwap( oldestIndex );
 	}
-}
 
-/// Acquire an exclusive lock for writing to files and flush the async loader queue.
-///
-/// @see Unlock()
-void AsyncLoader::LoadWorker::Lock()
-{
-	// Prevent other threads from queueing requests or writing out data while we have a write lock.
-	m_writeLock.LockWrite();
+	FileStream* pFileStream = FileStream::OpenFileStream( rFileName, FileStream::MODE_READ );
+	if( !pFileStream )
+	{
+		return NULL;
+	}
 
-	Flush();
+	// Keep the loader from reporting itself idle while this worker has files open.
+	if( !m_bHoldingFiles )
+	{
+		m_pLoader->AddPending( 1 );
+		m_bHoldingFiles = true;
+	}
+
+	BufferedStream* pBufferedStream = new BufferedStream;
+	HELIUM_ASSERT( pBufferedStream );
+	pBufferedStream->Open( pFileStream );
+
+	OpenStream* pStream = m_streams.New();
+	HELIUM_ASSERT( pStream );
+	pStream->fileName = rFileName;
+	pStream->pFileStream = pFileStream;
+	pStream->pBufferedStream = pBufferedStream;
+	pStream->lastUse = m_useCounter;
+
+	return pBufferedStream;
 }
 
-/// Release an exclusive lock for writing to files.
+/// Close all files held open by this worker.
 ///
-/// @see Lock()
-void AsyncLoader::LoadWorker::Unlock()
+/// @see GetStream()
+void AsyncLoader::LoadWorker::CloseStreams()
 {
-	m_writeLock.UnlockWrite();
+	size_t streamCount = m_streams.GetSize();
+	for( size_t streamIndex = 0; streamIndex < streamCount; ++streamIndex )
+	{
+		OpenStream& rStream = m_streams[ streamIndex ];
+		rStream.pBufferedStream->Open( NULL );
+		delete rStream.pBufferedStream;
+		delete rStream.pFileStream;
+	}
+
+	m_streams.Clear();
+
+	if( m_bHoldingFiles )
+	{
+		m_bHoldingFiles = false;
+		m_pLoader->ReleasePending( 1 );
+	}
 }
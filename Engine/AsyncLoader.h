@@ -9,6 +9,7 @@
 #include "Foundation/String.h"
 
 #include "Engine/Engine.h"
+#include "Engine/Compression.h"
 
 #ifdef _MSC_VER
 #pragma warning( push )
@@ -21,7 +22,17 @@
 
 namespace Helium
 {
+	class BufferedStream;
+	class FileStream;
+
 	/// Async loading manager.
+	///
+	/// Requests are serviced by a small pool of load worker threads, highest priority first and in the order they were
+	/// queued within a priority.  A worker that picks up a request also takes queued requests for the data directly
+	/// following it in the same file, so runs of small reads from a cache file are serviced with a single seek.  Workers
+	/// keep recently used files open (up to FILE_STREAM_LIMIT across all workers) while there is work queued, and close
+	/// them once the queue drains so files are never held open while idle.  Compressed data is decompressed by the
+	/// workers as well, so requesting threads only ever see the decompressed result.
 	class HELIUM_ENGINE_API AsyncLoader : NonCopyable
 	{
 	public:
@@ -29,6 +40,14 @@ namespace Helium
 		static const size_t REQUEST_POOL_BLOCK_SIZE = 128;
 		/// Maximum number of open file streams.
 		static const size_t FILE_STREAM_LIMIT = 16;
+		/// Default number of load worker threads.
+		static const uint32_t DEFAULT_WORKER_COUNT = 4;
+		/// Maximum number of load worker threads.
+		static const uint32_t WORKER_COUNT_MAX = FILE_STREAM_LIMIT;
+		/// Most requests for adjacent data serviced together.
+		static const size_t MERGE_REQUEST_LIMIT = 16;
+		/// Number of queued requests searched for adjacent data per merged request.
+		static const size_t MERGE_SCAN_LIMIT = 64;
 
 		/// Load request priority.
 		enum EPriority
@@ -46,7 +65,7 @@ namespace Helium
 
 		/// @name Initialization
 		//@{
-		bool Initialize();
+		bool Initialize( uint32_t workerCount = 0 );
 		void Cleanup();
 		//@}
 
@@ -55,6 +74,9 @@ namespace Helium
 		size_t QueueRequest(
 			void* pBuffer, const String& rFileName, uint64_t offset, size_t size,
 			EPriority priority = PRIORITY_NORMAL );
+		size_t QueueCompressedRequest(
+			void* pBuffer, size_t size, const String& rFileName, uint64_t offset, size_t compressedSize,
+			CompressionCodec codec, EPriority priority = PRIORITY_NORMAL );
 		size_t SyncRequest( size_t id );
 		bool TrySyncRequest( size_t id, size_t& rBytesRead );
 
@@ -75,21 +97,47 @@ namespace Helium
 		/// Async load request data.
 		struct Request
 		{
+			/// @name Construction/Destruction
+			//@{
+			Request();
+			//@}
+
 			/// Output buffer.
 			void* pBuffer;
 			/// File name.
 			String fileName;
 			/// Offset from which to begin reading.
 			uint64_t offset;
-			/// Number of bytes to read.
+			/// Number of bytes to store in the output buffer.
 			size_t size;
+			/// Number of bytes to read from the file.
+			size_t fileSize;
+			/// Codec with which the data in the file is compressed.
+			CompressionCodec codec;
 			/// Priority.
 			EPriority priority;
 
 			/// Number of bytes read.
-			volatile size_t bytesRead;
-			/// Set to a non-zero value once this request has been processed.
-			volatile int32_t processedCounter;
+			size_t bytesRead;
+			/// Signaled once this request has been processed (the only completion signal, as the request may be
+			/// released as soon as it is set).
+			Condition completedCondition;
+		};
+
+		/// Queue of requests with the same priority.
+		struct RequestQueue
+		{
+			/// @name Construction/Destruction
+			//@{
+			RequestQueue();
+			//@}
+
+			/// Queued requests, oldest first (null for requests taken out of order to be merged with another).
+			DynamicArray< Request* > requests;
+			/// Index of the oldest slot not yet taken.
+			size_t head;
+			/// Number of requests still queued.
+			size_t count;
 		};
 
 		/// Async loading thread runnable.
@@ -98,7 +146,7 @@ namespace Helium
 		public:
 			/// @name Construction/Destruction
 			//@{
-			LoadWorker();
+			LoadWorker( AsyncLoader* pLoader, size_t streamLimit );
 			virtual ~LoadWorker();
 			//@}
 
@@ -107,42 +155,66 @@ namespace Helium
 			virtual void Run();
 			//@}
 
-			/// @name External Thread Control
-			//@{
-			void Stop();
-			//@}
-
-			/// @name External Request Queue Control
+		private:
+			/// Open file kept around for subsequent requests.
+			struct OpenStream
+			{
+				/// File name.
+				String fileName;
+				/// File stream.
+				FileStream* pFileStream;
+				/// Buffered stream reading from the file stream.
+				BufferedStream* pBufferedStream;
+				/// Value of m_useCounter when the stream was last used.
+				uint64_t lastUse;
+			};
+
+			/// @name Request Processing
 			//@{
-			void QueueRequest( Request* pRequest );
-			void Flush();
-
-			void Lock();
-			void Unlock();
+			void ProcessRequests( Request* const* ppRequests, size_t requestCount );
+			size_t ReadCompressed( BufferedStream* pStream, const Request* pRequest );
+			BufferedStream* GetStream( const String& rFileName );
+			void CloseStreams();
 			//@}
 
-		private:
-			/// Async load request queue.
-			Locker< DynamicArray< Request* >, SpinLock > m_requestQueue;
-			/// Condition used to wake up the worker thread when load requests are queued (or when it should shut down).
-			Condition m_wakeUpCondition;
-
-			/// Read-write lock used for synchronization of external file writes.
-			ReadWriteLock m_writeLock;
-
-			/// Non-zero if this thread should stop when next possible, zero if it should continue.
-			volatile int32_t m_stopCounter;
-			/// Non-zero if this thread is currently processing a load request.
-			volatile int32_t m_processingCounter;
+			/// Loader owning this worker.
+			AsyncLoader* m_pLoader;
+			/// Most files this worker keeps open at once.
+			size_t m_streamLimit;
+			/// Files currently open.
+			DynamicArray< OpenStream > m_streams;
+			/// Incremented each time a stream is used, to find the least recently used one.
+			uint64_t m_useCounter;
+			/// True if this worker is counted as pending in the loader while it holds files open.
+			bool m_bHoldingFiles;
+			/// Scratch buffer for reading compressed data.
+			DynamicArray< uint8_t > m_compressedData;
 		};
 
 		/// Pool of async load request objects.
 		ObjectPool< Request > m_requestPool;
 
-		/// Async loading thread.
-		RunnableThread* m_pThread;
-		/// Async loading thread worker.
-		LoadWorker* m_pWorker;
+		/// Queued requests for each priority.
+		RequestQueue m_queues[ PRIORITY_MAX ];
+		/// Number of requests queued or being processed, plus one for each worker holding files open.
+		size_t m_pendingCount;
+		/// Lock for the request queues and pending count.
+		mutable Mutex m_queueLock;
+		/// Condition used to wake up a worker thread when load requests are queued (or when they should shut down).
+		Condition m_wakeUpCondition;
+		/// Condition signaled whenever no requests are pending.
+		Condition m_idleCondition;
+
+		/// Read-write lock used for synchronization of external file writes.
+		ReadWriteLock m_writeLock;
+
+		/// Non-zero if the worker threads should stop when next possible, zero if they should continue.
+		volatile int32_t m_stopCounter;
+
+		/// Async loading threads.
+		DynamicArray< RunnableThread* > m_threads;
+		/// Async loading thread workers.
+		DynamicArray< LoadWorker* > m_workers;
 
 		/// Singleton instance.
 		static AsyncLoader* sm_pInstance;
@@ -152,5 +224,21 @@ namespace Helium
 		AsyncLoader();
 		~AsyncLoader();
 		//@}
+
+		/// @name Request Management
+		//@{
+		size_t AddRequest(
+			void* pBuffer, const String& rFileName, uint64_t offset, size_t size, size_t fileSize,
+			CompressionCodec codec, EPriority priority );
+		//@}
+
+		/// @name Worker Interface
+		//@{
+		size_t AcquireRequests( Request** ppRequests, size_t maxCount );
+		bool IsQueueEmpty() const;
+		void AddPending( size_t count );
+		void ReleasePending( size_t count );
+		void AddPendingLocked( size_t count );
+		//@}
 	};
 }
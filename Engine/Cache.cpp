@@ -1,6 +1,10 @@
 #include "EnginePch.h"
 #include "Engine/Cache.h"
 
+#include "Platform/Encoding.h"
+#include "Platform/Timer.h"
+
+#include "Foundation/Crc32.h"
 #include "Foundation/FileStream.h"
 #include "Foundation/MemoryStream.h"
 #include "Foundation/StringConverter.h"
@@ -9,6 +13,14 @@
 #include "Engine/FileLocations.h"
 #include "Engine/AsyncLoader.h"
 
+#if HELIUM_OS_WIN
+# include <windows.h>
+#else
+# include <fcntl.h>
+# include <stdio.h>
+# include <unistd.h>
+#endif
+
 #define USE_BSON_FOR_CACHE_FORMAT 0
 #define USE_JSON_FOR_CACHE_FORMAT 1
 
@@ -26,14 +38,94 @@ typedef Helium::Persist::ArchiveWriterMessagePack CacheArchiveWriter;
 typedef Helium::Persist::ArchiveReaderMessagePack CacheArchiveReader;
 #endif
 
+#include <algorithm>
+
 using namespace Helium;
 
 /// TOC header magic number.
 static const uint32_t TOC_MAGIC = 0xcac4e70c;
 /// TOC header magic number (byte-swapped).
 static const uint32_t TOC_MAGIC_SWAPPED = 0x0ce7c4ca;
+/// Suffix appended to the TOC file name while a new TOC is being written.
+#define TOC_TEMP_FILE_SUFFIX TXT( ".tmp" )
+
+/// Flush any data for a file that is still held by the operating system out to disk.
+///
+/// @param[in] rFileName  Name of the file to flush.
+///
+/// @return  True if the file was flushed successfully, false if not.
+static bool SyncFile( const String& rFileName )
+{
+#if HELIUM_OS_WIN
+	std::wstring wideFileName;
+	if( !ConvertString( *rFileName, wideFileName ) )
+	{
+		return false;
+	}
+
+	HANDLE hFile = ::CreateFileW(
+		wideFileName.c_str(),
+		GENERIC_WRITE,
+		FILE_SHARE_READ | FILE_SHARE_WRITE,
+		NULL,
+		OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL,
+		NULL );
+	if( hFile == INVALID_HANDLE_VALUE )
+	{
+		return false;
+	}
+
+	bool bSuccess = ( ::FlushFileBuffers( hFile ) != FALSE );
+	::CloseHandle( hFile );
+
+	return bSuccess;
+#else
+	int fileDescriptor = open( *rFileName, O_RDONLY );
+	if( fileDescriptor == -1 )
+	{
+		return false;
+	}
+
+	bool bSuccess = ( fsync( fileDescriptor ) == 0 );
+	close( fileDescriptor );
+
+	return bSuccess;
+#endif
+}
+
+/// Atomically replace a file with another, so that the destination always refers to either the old or the new file,
+/// even if the process is interrupted.
+///
+/// @param[in] rSourceFileName       Name of the file to move.
+/// @param[in] rDestinationFileName  Name of the file to replace.
+///
+/// @return  True if the file was replaced successfully, false if not.
+static bool ReplaceFileAtomic( const String& rSourceFileName, const String& rDestinationFileName )
+{
+#if HELIUM_OS_WIN
+	std::wstring wideSourceFileName;
+	std::wstring wideDestinationFileName;
+	if( !ConvertString( *rSourceFileName, wideSourceFileName ) ||
+		!ConvertString( *rDestinationFileName, wideDestinationFileName ) )
+	{
+		return false;
+	}
+
+	return ( ::MoveFileExW(
+		wideSourceFileName.c_str(),
+		wideDestinationFileName.c_str(),
+		MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH ) != FALSE );
+#else
+	return ( rename( *rSourceFileName, *rDestinationFileName ) == 0 );
+#endif
+}
+
 /// Cache format version number.
-const uint32_t Cache::sm_Version = 0;
+///
+/// Version 1 replaced the TOC entry list with a table of fixed-size records that is used in place.  Version 2 added
+/// per-entry compression.
+const uint32_t Cache::sm_Version = 2;
 
 /// Constructor.
 Cache::Cache()
@@ -43,7 +135,16 @@ Cache::Cache()
 , m_asyncLoadId( Invalid< size_t >() )
 , m_pTocBuffer( NULL )
 , m_tocSize( Invalid< uint32_t >() )
+, m_pTocRecords( NULL )
+, m_pTocBuckets( NULL )
+, m_pTocStrings( NULL )
+, m_tocEntryCount( 0 )
+, m_tocBucketCount( 0 )
+, m_tocStringDataSize( 0 )
 , m_pEntryPool( NULL )
+, m_uncommittedEntryCount( 0 )
+, m_firstUncommittedTickCount( 0 )
+, m_bCacheFileMappingAttempted( false )
 {
 }
 
@@ -107,9 +208,17 @@ bool Cache::Initialize( Name name, EPlatform platform, const char* pTocFileName,
 
 /// Shut down this cache and free all allocated memory.
 ///
-/// @see Initialize()
+/// Any entry updates that have not been committed to the TOC yet are committed first.
+///
+/// @see Initialize(), CommitToc()
 void Cache::Shutdown()
 {
+	if( m_uncommittedEntryCount != 0 )
+	{
+		CommitToc();
+		m_uncommittedEntryCount = 0;
+	}
+
 	m_name = NULL_NAME;
 	m_platform = PLATFORM_INVALID;
 
@@ -125,8 +234,7 @@ void Cache::Shutdown()
 		SetInvalid( m_asyncLoadId );
 	}
 
-	DefaultAllocator().Free( m_pTocBuffer );
-	m_pTocBuffer = NULL;
+	ReleaseTocData();
 	SetInvalid( m_tocSize );
 
 	m_bTocLoaded = false;
@@ -136,11 +244,15 @@ void Cache::Shutdown()
 
 	delete m_pEntryPool;
 	m_pEntryPool = NULL;
+
+	m_cacheFileMapping.Close();
+	m_bCacheFileMappingAttempted = false;
 }
 
 /// Begin asynchronous loading of the cache table of contents.
 ///
-/// This must be called after calling Initialize() in order to begin using an existing cache.
+/// This must be called after calling Initialize() in order to begin using an existing cache.  If the TOC file can be
+/// memory mapped, it is used in place and loading completes before this returns (IsTocLoaded() will return true).
 ///
 /// @return  True if loading was started successfully, false if not.
 ///
@@ -174,6 +286,23 @@ bool Cache::BeginLoadToc()
 		return false;
 	}
 
+	// Use the TOC in place from a mapping of the file if possible, in which case loading is done right away.
+	HELIUM_ASSERT( !m_tocMapping.IsOpen() );
+	if( m_tocMapping.Open( m_tocFileName ) )
+	{
+		HELIUM_ASSERT( m_tocMapping.GetSize() < UINT32_MAX );
+		m_tocSize = static_cast< uint32_t >( m_tocMapping.GetSize() );
+
+		if( !FinalizeTocLoad( m_tocMapping.GetData() ) )
+		{
+			ReleaseTocData();
+		}
+
+		m_bTocLoaded = true;
+
+		return true;
+	}
+
 	HELIUM_ASSERT( !m_pTocBuffer );
 	DefaultAllocator allocator;
 	m_pTocBuffer = static_cast< uint8_t* >( allocator.Allocate( m_tocSize ) );
@@ -244,6 +373,7 @@ bool Cache::TryFinishLoadToc()
 			TXT( "Cache::TryFinishLoadToc(): No data loaded from TOC file \"%s\".\n" ),
 			*m_tocFileName );
 
+		ReleaseTocData();
 		SetInvalid( m_tocSize );
 	}
 	else
@@ -260,25 +390,10 @@ bool Cache::TryFinishLoadToc()
 			m_tocSize = static_cast< uint32_t >( bytesRead );
 		}
 
-		bool bFinalizeResult = FinalizeTocLoad();
-
-		DefaultAllocator().Free( m_pTocBuffer );
-		m_pTocBuffer = NULL;
-
-		if( !bFinalizeResult )
+		// The TOC is used in place, so the buffer is kept around if it is valid.
+		if( !FinalizeTocLoad( m_pTocBuffer ) )
 		{
-			HELIUM_ASSERT( m_pEntryPool );
-
-			size_t entryCount = m_entries.GetSize();
-			for( size_t entryIndex = 0; entryIndex < entryCount; ++entryIndex )
-			{
-				Entry* pEntry = m_entries[ entryIndex ];
-				HELIUM_ASSERT( pEntry );
-				m_pEntryPool->Release( pEntry );
-			}
-
-			m_entries.Clear();
-			m_entryMap.Clear();
+			ReleaseTocData();
 		}
 	}
 
@@ -298,7 +413,7 @@ void Cache::EnforceTocLoad()
 
 		if( BeginLoadToc() )
 		{
-			while( !TryFinishLoadToc() )
+			while( !IsTocLoaded() && !TryFinishLoadToc() )
 			{
 				Thread::Yield();
 			}
@@ -319,34 +434,83 @@ const Cache::Entry* Cache::FindEntry( AssetPath path, uint32_t subDataIndex ) co
 	key.subDataIndex = subDataIndex;
 
 	EntryMapType::ConstAccessor mapAccessor;
-	if( !m_entryMap.Find( mapAccessor, key ) )
+	if( m_entryMap.Find( mapAccessor, key ) )
+	{
+		Entry* pEntry = mapAccessor->Second();
+		HELIUM_ASSERT( pEntry );
+
+		return pEntry;
+	}
+
+	// Entries from the TOC are only added to the map once looked up.
+	if( !m_pTocRecords )
 	{
 		return NULL;
 	}
 
-	Entry* pEntry = mapAccessor->Second();
-	HELIUM_ASSERT( pEntry );
+	String pathString;
+	path.ToString( pathString );
 
-	return pEntry;
+	uint32_t recordIndex = FindTocRecord( pathString, subDataIndex );
+	if( IsInvalid( recordIndex ) )
+	{
+		return NULL;
+	}
+
+	return MaterializeTocEntry( recordIndex );
 }
 
 /// Add or update an entry in the cache.
 ///
-/// @param[in] path          Asset path.
-/// @param[in] subDataIndex  Sub-data index associated with the cached data.
-/// @param[in] pData         Data to cache.
-/// @param[in] timestamp     Timestamp value to associate with the entry in the cache.
-/// @param[in] size          Number of bytes to cache.
+/// The entry data is appended to the cache file immediately, while the TOC is only rewritten periodically; use
+/// CommitToc() to write out pending TOC updates.
+///
+/// @param[in] path              Asset path.
+/// @param[in] subDataIndex      Sub-data index associated with the cached data.
+/// @param[in] pData             Data to cache.
+/// @param[in] timestamp         Timestamp value to associate with the entry in the cache.
+/// @param[in] size              Number of bytes to cache.
+/// @param[in] codec             Codec with which to compress the data.  The data is stored uncompressed if it does not
+///                              get any smaller.
+/// @param[in] compressionLevel  Codec-specific compression level.
 ///
 /// @return  True if the cache was updated successfully, false if not.
+///
+/// @see CommitToc()
 bool Cache::CacheEntry(
 					   AssetPath path,
 					   uint32_t subDataIndex,
 					   const void* pData,
 					   int64_t timestamp,
-					   uint32_t size )
+					   uint32_t size,
+					   CompressionCodec codec,
+					   int32_t compressionLevel )
 {
 	HELIUM_ASSERT( pData || size == 0 );
+	HELIUM_ASSERT( static_cast< size_t >( codec ) < static_cast< size_t >( CompressionCodecs::Count ) );
+
+	// Compress the data up front, as the compressed size determines where the entry goes.
+	DynamicArray< uint8_t > compressedData;
+	const void* pStoredData = pData;
+	uint32_t storedSize = size;
+	if( codec != CompressionCodecs::None )
+	{
+		if( Compress( codec, compressionLevel, pData, size, compressedData ) && compressedData.GetSize() < size )
+		{
+			pStoredData = compressedData.GetData();
+			storedSize = static_cast< uint32_t >( compressedData.GetSize() );
+		}
+		else
+		{
+			codec = CompressionCodecs::None;
+		}
+	}
+
+	// Make sure any TOC entry for the same data is in the entry map so that it gets updated instead of duplicated.
+	FindEntry( path, subDataIndex );
+
+	// Entries are only ever appended to the cache file.  Data referenced by the TOC on disk is never overwritten, so
+	// an interrupted update leaves the committed cache intact (and the cache file mapping stays valid).
 
 	Status status;
 	status.Read( m_cacheFileName.GetData() );
@@ -361,10 +525,14 @@ bool Cache::CacheEntry(
 	pEntryUpdate->path = path;
 	pEntryUpdate->subDataIndex = subDataIndex;
 	pEntryUpdate->size = size;
+	pEntryUpdate->compressedSize = storedSize;
+	pEntryUpdate->codec = codec;
 
 	uint64_t originalOffset = 0;
 	int64_t originalTimestamp = 0;
 	uint32_t originalSize = 0;
+	uint32_t originalCompressedSize = 0;
+	CompressionCodec originalCodec = CompressionCodecs::None;
 
 	EntryKey key;
 	key.path = path;
@@ -390,18 +558,14 @@ bool Cache::CacheEntry(
 		originalOffset = pEntryUpdate->offset;
 		originalTimestamp = pEntryUpdate->timestamp;
 		originalSize = pEntryUpdate->size;
+		originalCompressedSize = pEntryUpdate->compressedSize;
+		originalCodec = pEntryUpdate->codec;
 
-		if( originalSize < size )
-		{
-			pEntryUpdate->offset = entryOffset;
-		}
-		else
-		{
-			entryOffset = originalOffset;
-		}
-
+		pEntryUpdate->offset = entryOffset;
 		pEntryUpdate->timestamp = timestamp;
 		pEntryUpdate->size = size;
+		pEntryUpdate->compressedSize = storedSize;
+		pEntryUpdate->codec = codec;
 	}
 
 	AsyncLoader* pAsyncLoader = AsyncLoader::GetInstance();
@@ -422,10 +586,12 @@ bool Cache::CacheEntry(
 	{
 		HELIUM_TRACE(
 			TraceLevels::Info,
-			TXT( "Cache: Caching \"%s\" to \"%s\" (%" ) PRIu32 TXT( " bytes @ offset %" ) PRIu64 TXT( ").\n" ),
+			( TXT( "Cache: Caching \"%s\" to \"%s\" (%" ) PRIu32 TXT( " bytes, %" ) PRIu32 TXT( " stored @ offset %" )
+			PRIu64 TXT( ").\n" ) ),
 			*path.ToString(),
 			*m_cacheFileName,
 			size,
+			storedSize,
 			entryOffset );
 
 		uint64_t seekOffset = static_cast< uint64_t >( pCacheStream->Seek(
@@ -446,20 +612,22 @@ bool Cache::CacheEntry(
 				pEntryUpdate->offset = originalOffset;
 				pEntryUpdate->timestamp = originalTimestamp;
 				pEntryUpdate->size = originalSize;
+				pEntryUpdate->compressedSize = originalCompressedSize;
+				pEntryUpdate->codec = originalCodec;
 			}
 
 			bCacheSuccess = false;
 		}
 		else
 		{
-			size_t writeSize = pCacheStream->Write( pData, 1, size );
-			if( writeSize != size )
+			size_t writeSize = pCacheStream->Write( pStoredData, 1, storedSize );
+			if( writeSize != storedSize )
 			{
 				HELIUM_TRACE(
 					TraceLevels::Error,
 					( TXT( "Cache: Failed to write %" ) PRIu32 TXT( " bytes to cache \"%s\" (%" ) PRIuSZ
 					TXT( " bytes written).\n" ) ),
-					size,
+					storedSize,
 					*m_cacheFileName,
 					writeSize );
 
@@ -474,111 +642,263 @@ bool Cache::CacheEntry(
 					pEntryUpdate->offset = originalOffset;
 					pEntryUpdate->timestamp = originalTimestamp;
 					pEntryUpdate->size = originalSize;
+					pEntryUpdate->compressedSize = originalCompressedSize;
+					pEntryUpdate->codec = originalCodec;
 				}
 
 				bCacheSuccess = false;
 			}
-			else
-			{
-				HELIUM_TRACE( TraceLevels::Info, TXT( "Cache: Rewriting TOC file \"%s\".\n" ), *m_tocFileName );
+		}
 
-				FileStream* pTocStream = FileStream::OpenFileStream( m_tocFileName, FileStream::MODE_WRITE, true );
-				if( !pTocStream )
-				{
-					HELIUM_TRACE( TraceLevels::Error, TXT( "Cache: Failed to open TOC \"%s\" for writing.\n" ), *m_tocFileName );
-				}
-				else
-				{
-					BufferedStream* pBufferedStream = new BufferedStream( pTocStream );
-					HELIUM_ASSERT( pBufferedStream );
+		delete pCacheStream;
+	}
 
-					pBufferedStream->Write( &TOC_MAGIC, sizeof( TOC_MAGIC ), 1 );
-					pBufferedStream->Write( &sm_Version, sizeof( sm_Version ), 1 );
+	// The TOC is only rewritten once enough updates have accumulated.  The interval grows with the number of entries,
+	// so the total amount of TOC data written while building a cache stays proportional to the number of entries.
+	// Updates are also not left uncommitted for longer than TOC_COMMIT_SECONDS_MAX, so a slow trickle of updates
+	// doesn't stay invisible to other processes (or get lost on a crash) for the whole session.
+	if( bCacheSuccess )
+	{
+		uint64_t tickCount = Timer::GetTickCount();
+		if( m_uncommittedEntryCount++ == 0 )
+		{
+			m_firstUncommittedTickCount = tickCount;
+		}
 
-					uint32_t entryCount = static_cast< uint32_t >( m_entries.GetSize() );
-					pBufferedStream->Write( &entryCount, sizeof( entryCount ), 1 );
+		uint32_t commitInterval = static_cast< uint32_t >( m_entries.GetSize() / 4 );
+		if( commitInterval < TOC_COMMIT_INTERVAL_MIN )
+		{
+			commitInterval = TOC_COMMIT_INTERVAL_MIN;
+		}
 
-					String entryPath;
-					uint_fast32_t entryCountFast = entryCount;
-					for( uint_fast32_t entryIndex = 0; entryIndex < entryCountFast; ++entryIndex )
-					{
-						Entry* pEntry = m_entries[ entryIndex ];
-						HELIUM_ASSERT( pEntry );
+		uint64_t commitTickCount = static_cast< uint64_t >( TOC_COMMIT_SECONDS_MAX ) * Timer::GetTicksPerSecond();
 
-						pEntry->path.ToString( entryPath );
-						HELIUM_ASSERT( entryPath.GetSize() < UINT16_MAX );
-						uint16_t pathSize = static_cast< uint16_t >( entryPath.GetSize() );
-						pBufferedStream->Write( &pathSize, sizeof( pathSize ), 1 );
+		if( m_uncommittedEntryCount >= commitInterval ||
+			tickCount - m_firstUncommittedTickCount >= commitTickCount )
+		{
+			WriteToc();
+		}
+	}
 
-						pBufferedStream->Write( *entryPath, sizeof( char ), pathSize );
+	pAsyncLoader->Unlock();
 
-						pBufferedStream->Write( &pEntry->subDataIndex, sizeof( pEntry->subDataIndex ), 1 );
+	return bCacheSuccess;
+}
 
-						pBufferedStream->Write( &pEntry->offset, sizeof( pEntry->offset ), 1 );
-						pBufferedStream->Write( &pEntry->timestamp, sizeof( pEntry->timestamp ), 1 );
-						pBufferedStream->Write( &pEntry->size, sizeof( pEntry->size ), 1 );
-					}
+/// Write out any entry updates that have not been committed to the TOC file yet.
+///
+/// CacheEntry() appends entry data to the cache file right away, but only rewrites the TOC periodically.  Entries that
+/// have not been committed are not visible to other processes and are lost if this process exits abnormally.  Any
+/// uncommitted updates are committed automatically when the cache is shut down, and tools call this (through
+/// CacheManager::CommitTocs()) whenever they finish a batch of caching.
+///
+/// @return  True if the TOC is up to date, false if writing it failed.
+///
+/// @see CacheEntry()
+bool Cache::CommitToc()
+{
+	if( m_uncommittedEntryCount == 0 )
+	{
+		return true;
+	}
 
-					delete pBufferedStream;
-					delete pTocStream;
-				}
-			}
+	AsyncLoader* pAsyncLoader = AsyncLoader::GetInstance();
+	HELIUM_ASSERT( pAsyncLoader );
+
+	pAsyncLoader->Lock();
+	bool bSuccess = WriteToc();
+	pAsyncLoader->Unlock();
+
+	return bSuccess;
+}
+
+/// Get the cached data for an entry directly from a read-only mapping of the cache file.
+///
+/// The cache file is mapped on the first call, and the entry's pages are requested from the operating system right
+/// away, so calling this when a load is issued gives the data time to be paged in before it is deserialized.  The
+/// returned pointer remains valid until the cache is shut down.  Entries added with CacheEntry() after the cache file
+/// was mapped are not part of the mapping.
+///
+/// @param[in] rEntry  Cache entry.
+///
+/// @return  Pointer to the first byte of the entry data, or null if the entry is compressed, or if the cache file could
+///          not be mapped or does not contain the full entry (the data can still be loaded with QueueEntryLoad() in
+///          that case).
+const uint8_t* Cache::MapEntry( const Entry& rEntry )
+{
+	if( rEntry.codec != CompressionCodecs::None )
+	{
+		return NULL;
+	}
+
+	MutexScopeLock scopeLock( m_cacheFileMappingLock );
+
+	if( !m_bCacheFileMappingAttempted )
+	{
+		m_bCacheFileMappingAttempted = true;
+
+		if( !m_cacheFileName.IsEmpty() && !m_cacheFileMapping.Open( m_cacheFileName ) )
+		{
+			HELIUM_TRACE(
+				TraceLevels::Warning,
+				TXT( "Cache::MapEntry(): Failed to map cache file \"%s\", falling back to async reads.\n" ),
+				*m_cacheFileName );
 		}
+	}
 
-		delete pCacheStream;
+	const uint8_t* pData = m_cacheFileMapping.GetData();
+	uint64_t mappedSize = m_cacheFileMapping.GetSize();
+	if( !pData || rEntry.offset > mappedSize || rEntry.size > mappedSize - rEntry.offset )
+	{
+		return NULL;
 	}
 
-	pAsyncLoader->Unlock();
+	m_cacheFileMapping.Prefetch( rEntry.offset, rEntry.size );
 
-	return bCacheSuccess;
+	return pData + rEntry.offset;
 }
 
-/// Finalize the TOC loading process.
+/// Begin loading the data for an entry with the AsyncLoader, decompressing it on the loader's worker threads if
+/// necessary.
 ///
-/// Note that this does not free any resources on a failed load (the caller is responsible for such clean-up work).
+/// @param[in] rEntry       Cache entry.
+/// @param[in] pBuffer      Buffer in which to load the entry data.
+/// @param[in] loadSizeMax  Maximum number of bytes to load (the entry size is loaded if this is larger).
 ///
-/// @return  True if the TOC load was successful, false if not.
-bool Cache::FinalizeTocLoad()
+/// @return  AsyncLoader request ID, or an invalid index if the request could not be queued.
+///
+/// @see ReadEntry(), MapEntry()
+size_t Cache::QueueEntryLoad( const Entry& rEntry, void* pBuffer, size_t loadSizeMax ) const
 {
-	HELIUM_ASSERT( m_pTocBuffer );
+	HELIUM_ASSERT( pBuffer );
+
+	AsyncLoader* pAsyncLoader = AsyncLoader::GetInstance();
+	HELIUM_ASSERT( pAsyncLoader );
 
-	const uint8_t* pTocCurrent = m_pTocBuffer;
-	const uint8_t* pTocMax = pTocCurrent + m_tocSize;
+	size_t loadSize = Min< size_t >( rEntry.size, loadSizeMax );
+	if( rEntry.codec == CompressionCodecs::None )
+	{
+		return pAsyncLoader->QueueRequest( pBuffer, m_cacheFileName, rEntry.offset, loadSize );
+	}
 
-	StackMemoryHeap<>& rStackHeap = ThreadLocalStackAllocator::GetMemoryHeap();
+	return pAsyncLoader->QueueCompressedRequest(
+		pBuffer,
+		loadSize,
+		m_cacheFileName,
+		rEntry.offset,
+		rEntry.compressedSize,
+		rEntry.codec );
+}
 
-	// Validate the TOC header.
-	uint32_t magic;
-	if( !CheckedTocRead( MemoryCopy, magic, TXT( "the header magic" ), pTocCurrent, pTocMax ) )
+/// Read and decompress the data for an entry, blocking the current thread.
+///
+/// @param[in]  rEntry  Cache entry.
+/// @param[out] rData   Buffer in which to store the entry data (resized to the entry size).
+///
+/// @return  True if the full entry was read successfully, false if not.
+///
+/// @see QueueEntryLoad()
+bool Cache::ReadEntry( const Entry& rEntry, DynamicArray< uint8_t >& rData ) const
+{
+	rData.Resize( 0 );
+
+	FileStream* pCacheStream = FileStream::OpenFileStream( m_cacheFileName, FileStream::MODE_READ );
+	if( !pCacheStream )
 	{
+		HELIUM_TRACE( TraceLevels::Error, TXT( "Cache: Failed to open cache \"%s\" for reading.\n" ), *m_cacheFileName );
+
 		return false;
 	}
 
-	LOAD_VALUE_CALLBACK* pLoadFunction = NULL;
-	if( magic == TOC_MAGIC )
+	bool bSuccess = false;
+
+	int64_t seekOffset = pCacheStream->Seek( static_cast< int64_t >( rEntry.offset ), SeekOrigins::Begin );
+	if( static_cast< uint64_t >( seekOffset ) == rEntry.offset )
+	{
+		DynamicArray< uint8_t > compressedData;
+		DynamicArray< uint8_t >& rStoredData = ( rEntry.codec == CompressionCodecs::None ? rData : compressedData );
+		rStoredData.Resize( rEntry.compressedSize );
+
+		size_t bytesRead = pCacheStream->Read( rStoredData.GetData(), 1, rEntry.compressedSize );
+		if( bytesRead == rEntry.compressedSize )
+		{
+			if( rEntry.codec == CompressionCodecs::None )
+			{
+				bSuccess = true;
+			}
+			else
+			{
+				rData.Resize( rEntry.size );
+				size_t decompressedSize = Decompress(
+					rEntry.codec,
+					compressedData.GetData(),
+					compressedData.GetSize(),
+					rData.GetData(),
+					rData.GetSize() );
+				bSuccess = ( decompressedSize == rEntry.size );
+			}
+		}
+	}
+
+	delete pCacheStream;
+
+	if( !bSuccess )
 	{
 		HELIUM_TRACE(
-			TraceLevels::Info,
-			TXT( "Cache::FinalizeTocLoad(): TOC \"%s\" identified (no byte swapping).\n" ),
-			*m_tocFileName );
+			TraceLevels::Error,
+			( TXT( "Cache: Failed to read %" ) PRIu32 TXT( " bytes at offset %" ) PRIu64 TXT( " from cache \"%s\".\n" ) ),
+			rEntry.compressedSize,
+			rEntry.offset,
+			*m_cacheFileName );
 
-		pLoadFunction = MemoryCopy;
+		rData.Resize( 0 );
 	}
-	else if( magic == TOC_MAGIC_SWAPPED )
+
+	return bSuccess;
+}
+
+/// Finalize the TOC loading process.
+///
+/// This only validates the TOC header and sizes and sets up access to the TOC data in place; entry information is
+/// created the first time each entry is accessed.  Note that this does not free any resources on a failed load (the
+/// caller is responsible for such clean-up work).
+///
+/// @param[in] pTocData  TOC file contents (m_tocSize bytes), which must remain valid until ReleaseTocData() is called.
+///
+/// @return  True if the TOC load was successful, false if not.
+///
+/// @see ReleaseTocData()
+bool Cache::FinalizeTocLoad( const uint8_t* pTocData )
+{
+	HELIUM_ASSERT( pTocData );
+	HELIUM_ASSERT( m_entries.IsEmpty() );
+
+	// Validate the TOC header.
+	TocHeader header;
+	if( m_tocSize < sizeof( header ) )
 	{
 		HELIUM_TRACE(
-			TraceLevels::Info,
-			TXT( "Cache::FinalizeTocLoad(): TOC \"%s\" identified (byte swapping is necessary).\n" ),
+			TraceLevels::Error,
+			TXT( "Cache::FinalizeTocLoad(): TOC \"%s\" is too small to hold a header.\n" ),
 			*m_tocFileName );
+
+		return false;
+	}
+
+	MemoryCopy( &header, pTocData, sizeof( header ) );
+
+	if( header.magic == TOC_MAGIC_SWAPPED )
+	{
 		HELIUM_TRACE(
-			TraceLevels::Warning,
-			( TXT( "Cache::TryFinishLoadToc(): Cache for TOC \"%s\" uses byte swapping, which may incur " )
-			TXT( "performance penalties.\n" ) ),
+			TraceLevels::Error,
+			( TXT( "Cache::FinalizeTocLoad(): TOC \"%s\" was written for a different byte order and cannot be used " )
+			TXT( "in place.\n" ) ),
 			*m_tocFileName );
 
-		pLoadFunction = ReverseByteOrder;
+		return false;
 	}
-	else
+
+	if( header.magic != TOC_MAGIC )
 	{
 		HELIUM_TRACE(
 			TraceLevels::Error,
@@ -588,189 +908,385 @@ bool Cache::FinalizeTocLoad()
 		return false;
 	}
 
-	uint32_t version;
-	if( !CheckedTocRead( pLoadFunction, version, TXT( "the cache version number" ), pTocCurrent, pTocMax ) )
+	if( header.version != sm_Version )
 	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			( TXT( "Cache::FinalizeTocLoad(): Cache version number (%" ) PRIu32 TXT( ") does not match the " )
+			TXT( "supported version (%" ) PRIu32 TXT( ").  The cache needs to be rebuilt.\n" ) ),
+			header.version,
+			sm_Version );
+
 		return false;
 	}
 
-	if( version > sm_Version )
+	uint64_t recordsOffset = sizeof( TocHeader );
+	uint64_t bucketsOffset = recordsOffset + static_cast< uint64_t >( header.entryCount ) * sizeof( TocRecord );
+	uint64_t stringsOffset = bucketsOffset + ( static_cast< uint64_t >( header.bucketCount ) + 1 ) * sizeof( uint32_t );
+	uint64_t tocSize = stringsOffset + header.stringDataSize;
+	if( header.bucketCount == 0 || tocSize != m_tocSize )
 	{
 		HELIUM_TRACE(
 			TraceLevels::Error,
-			( TXT( "Cache::FinalizeTocLoad(): Cache version number (%" ) PRIu32 TXT( ") exceeds the maximum " )
-			TXT( "supported version (%" ) PRIu32 TXT( ").\n" ) ),
-			version,
-			sm_Version );
+			( TXT( "Cache::FinalizeTocLoad(): TOC \"%s\" size (%" ) PRIu32 TXT( " bytes) does not match the size " )
+			TXT( "given by its header (%" ) PRIu64 TXT( " bytes).\n" ) ),
+			*m_tocFileName,
+			m_tocSize,
+			tocSize );
 
 		return false;
 	}
 
-	// Read the numbers of entries in the cache.
-	uint32_t entryCount;
-	bool bReadResult = CheckedTocRead(
-		pLoadFunction,
-		entryCount,
-		TXT( "the number of entries in the cache" ),
-		pTocCurrent,
-		pTocMax );
-	if( !bReadResult )
+	const uint32_t* pBuckets = reinterpret_cast< const uint32_t* >( pTocData + bucketsOffset );
+	if( pBuckets[ header.bucketCount ] != header.entryCount )
 	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			TXT( "Cache::FinalizeTocLoad(): TOC \"%s\" has an invalid bucket table.\n" ),
+			*m_tocFileName );
+
 		return false;
 	}
 
-	// Load the entry information.
-	EntryKey key;
+	m_pTocRecords = reinterpret_cast< const TocRecord* >( pTocData + recordsOffset );
+	m_pTocBuckets = pBuckets;
+	m_pTocStrings = reinterpret_cast< const char* >( pTocData + stringsOffset );
+	m_tocEntryCount = header.entryCount;
+	m_tocBucketCount = header.bucketCount;
+	m_tocStringDataSize = header.stringDataSize;
 
-	uint_fast32_t entryCountFast = entryCount;
-	m_entries.Reserve( entryCountFast );
-	for( uint_fast32_t entryIndex = 0; entryIndex < entryCountFast; ++entryIndex )
-	{
-		uint16_t entryPathSize;
-		bReadResult = CheckedTocRead(
-			pLoadFunction,
-			entryPathSize,
-			TXT( "entry AssetPath string size" ),
-			pTocCurrent,
-			pTocMax );
-		if( !bReadResult )
-		{
-			return false;
-		}
+	m_entries.Add( NULL, m_tocEntryCount );
 
-		uint_fast16_t entryPathSizeFast = entryPathSize;
-
-		StackMemoryHeap<>::Marker stackMarker( rStackHeap );
-		char* pPathString = static_cast< char* >( rStackHeap.Allocate(
-			sizeof( char ) * ( entryPathSizeFast + 1 ) ) );
-		HELIUM_ASSERT( pPathString );
-		pPathString[ entryPathSizeFast ] = TXT( '\0' );
+	return true;
+}
 
-		for( uint_fast16_t characterIndex = 0; characterIndex < entryPathSizeFast; ++characterIndex )
+/// Release the TOC file data and any TOC entries that have not been accessed yet.
+///
+/// Entries that have already been accessed remain available.
+///
+/// @see FinalizeTocLoad()
+void Cache::ReleaseTocData()
+{
+	// Drop the slots of TOC entries that were never accessed.
+	size_t entryCount = m_entries.GetSize();
+	size_t keptCount = 0;
+	for( size_t entryIndex = 0; entryIndex < entryCount; ++entryIndex )
+	{
+		Entry* pEntry = m_entries[ entryIndex ];
+		if( pEntry )
 		{
-			bReadResult = CheckedTocRead(
-				pLoadFunction,
-				pPathString[ characterIndex ],
-				TXT( "entry AssetPath string character" ),
-				pTocCurrent,
-				pTocMax );
-			if( !bReadResult )
-			{
-				return false;
-			}
+			m_entries[ keptCount ] = pEntry;
+			++keptCount;
 		}
+	}
 
-		AssetPath entryPath;
-		if( !entryPath.Set( pPathString ) )
-		{
-			HELIUM_TRACE(
-				TraceLevels::Error,
-				TXT( "Cache::FinalizeTocLoad(): Failed to set AssetPath for entry %" ) PRIuFAST16 TXT( ".\n" ),
-				entryIndex );
+	m_entries.Resize( keptCount );
 
-			return false;
-		}
+	m_pTocRecords = NULL;
+	m_pTocBuckets = NULL;
+	m_pTocStrings = NULL;
+	m_tocEntryCount = 0;
+	m_tocBucketCount = 0;
+	m_tocStringDataSize = 0;
 
-		uint32_t entrySubDataIndex;
-		bReadResult = CheckedTocRead(
-			pLoadFunction,
-			entrySubDataIndex,
-			TXT( "entry sub-data index" ),
-			pTocCurrent,
-			pTocMax );
-		if( !bReadResult )
-		{
-			return false;
-		}
+	m_tocMapping.Close();
 
-		key.path = entryPath;
-		key.subDataIndex = entrySubDataIndex;
+	DefaultAllocator().Free( m_pTocBuffer );
+	m_pTocBuffer = NULL;
+}
 
-		EntryMapType::ConstAccessor entryAccessor;
-		if( m_entryMap.Find( entryAccessor, key ) )
-		{
-			HELIUM_TRACE(
-				TraceLevels::Error,
-				( TXT( "Cache::FinalizeTocLoad(): Duplicate entry found for AssetPath \"%s\", sub-data %" ) PRIu32
-				TXT( ".\n" ) ),
-				pPathString,
-				entrySubDataIndex );
+/// Rewrite the TOC file with the current set of entries.
+///
+/// All entry information is created from the current TOC data first, as the TOC file is released and replaced.  The
+/// new TOC is written to a temporary file, which atomically replaces the old TOC once it and the cache file have been
+/// flushed to disk, so the TOC on disk always matches a complete set of cache data.
+///
+/// @return  True if the TOC was written successfully, false if not.
+bool Cache::WriteToc()
+{
+	HELIUM_TRACE( TraceLevels::Info, TXT( "Cache: Rewriting TOC file \"%s\".\n" ), *m_tocFileName );
 
-			return false;
-		}
+	size_t entryCountActual = m_entries.GetSize();
+	HELIUM_ASSERT( entryCountActual <= UINT32_MAX );
+	uint32_t entryCount = static_cast< uint32_t >( entryCountActual );
 
-		uint64_t entryOffset;
-		if( !CheckedTocRead( pLoadFunction, entryOffset, TXT( "entry offset" ), pTocCurrent, pTocMax ) )
-		{
-			return false;
-		}
+	for( uint32_t entryIndex = 0; entryIndex < entryCount; ++entryIndex )
+	{
+		GetEntry( entryIndex );
+	}
 
-		int64_t entryTimestamp;
-		if( !CheckedTocRead( pLoadFunction, entryTimestamp, TXT( "entry timestamp" ), pTocCurrent, pTocMax ) )
-		{
-			return false;
-		}
+	ReleaseTocData();
 
-		uint32_t entrySize;
-		if( !CheckedTocRead( pLoadFunction, entrySize, TXT( "entry size" ), pTocCurrent, pTocMax ) )
-		{
-			return false;
-		}
+	// Build the entry records and path strings, then sort the records into hash order.
+	DynamicArray< TocRecord > records;
+	records.Reserve( entryCount );
 
-		Entry* pEntry = m_pEntryPool->Allocate();
+	DynamicArray< char > stringData;
+
+	String entryPath;
+	for( uint32_t entryIndex = 0; entryIndex < entryCount; ++entryIndex )
+	{
+		Entry* pEntry = m_entries[ entryIndex ];
 		HELIUM_ASSERT( pEntry );
-		pEntry->path = entryPath;
-		pEntry->subDataIndex = entrySubDataIndex;
-		pEntry->offset = entryOffset;
-		pEntry->timestamp = entryTimestamp;
-		pEntry->size = entrySize;
 
-		m_entries.Add( pEntry );
+		pEntry->path.ToString( entryPath );
+
+		size_t pathOffset = stringData.GetSize();
+		size_t pathSize = entryPath.GetSize();
+		HELIUM_ASSERT( pathOffset + pathSize <= UINT32_MAX );
+		stringData.Resize( pathOffset + pathSize );
+		MemoryCopy( stringData.GetData() + pathOffset, *entryPath, pathSize );
+
+		TocRecord* pRecord = records.New();
+		HELIUM_ASSERT( pRecord );
+		pRecord->offset = pEntry->offset;
+		pRecord->timestamp = pEntry->timestamp;
+		pRecord->pathHash = ComputePathHash( entryPath );
+		pRecord->subDataIndex = pEntry->subDataIndex;
+		pRecord->size = pEntry->size;
+		pRecord->compressedSize = pEntry->compressedSize;
+		pRecord->pathOffset = static_cast< uint32_t >( pathOffset );
+		pRecord->pathSize = static_cast< uint32_t >( pathSize );
+		pRecord->codec = static_cast< uint32_t >( pEntry->codec );
+		pRecord->reserved = 0;
+	}
+
+	std::sort( records.GetData(), records.GetData() + records.GetSize(), CompareTocRecords );
+
+	// Store the index of the first record in each bucket.  Buckets are ordered by hash, so each bucket's records are
+	// contiguous.
+	uint32_t bucketCount = Max< uint32_t >( entryCount, 1 );
+	DynamicArray< uint32_t > buckets;
+	buckets.Add( 0, bucketCount + 1 );
+	for( uint32_t recordIndex = 0; recordIndex < entryCount; ++recordIndex )
+	{
+		++buckets[ GetTocBucket( records[ recordIndex ].pathHash, bucketCount ) + 1 ];
+	}
+
+	for( uint32_t bucketIndex = 0; bucketIndex < bucketCount; ++bucketIndex )
+	{
+		buckets[ bucketIndex + 1 ] += buckets[ bucketIndex ];
+	}
+
+	TocHeader header;
+	header.magic = TOC_MAGIC;
+	header.version = sm_Version;
+	header.entryCount = entryCount;
+	header.bucketCount = bucketCount;
+	header.stringDataSize = static_cast< uint32_t >( stringData.GetSize() );
+	header.reserved = 0;
+
+	String tempTocFileName = m_tocFileName;
+	tempTocFileName += TOC_TEMP_FILE_SUFFIX;
+
+	FileStream* pTocStream = FileStream::OpenFileStream( tempTocFileName, FileStream::MODE_WRITE, true );
+	if( !pTocStream )
+	{
+		HELIUM_TRACE( TraceLevels::Error, TXT( "Cache: Failed to open TOC \"%s\" for writing.\n" ), *tempTocFileName );
 
-		HELIUM_VERIFY( m_entryMap.Insert( entryAccessor, KeyValue< EntryKey, Entry* >( key, pEntry ) ) );
+		return false;
 	}
 
+	BufferedStream* pBufferedStream = new BufferedStream( pTocStream );
+	HELIUM_ASSERT( pBufferedStream );
+
+	bool bWriteSuccess =
+		pBufferedStream->Write( &header, sizeof( header ), 1 ) == 1 &&
+		pBufferedStream->Write( records.GetData(), sizeof( TocRecord ), records.GetSize() ) == records.GetSize() &&
+		pBufferedStream->Write( buckets.GetData(), sizeof( uint32_t ), buckets.GetSize() ) == buckets.GetSize() &&
+		pBufferedStream->Write( stringData.GetData(), sizeof( char ), stringData.GetSize() ) == stringData.GetSize();
+
+	delete pBufferedStream;
+	delete pTocStream;
+
+	if( !bWriteSuccess )
+	{
+		HELIUM_TRACE( TraceLevels::Error, TXT( "Cache: Failed to write TOC \"%s\".\n" ), *tempTocFileName );
+
+		return false;
+	}
+
+	// The cache data must reach the disk before the TOC that references it.
+	if( !SyncFile( m_cacheFileName ) || !SyncFile( tempTocFileName ) )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Warning,
+			TXT( "Cache: Failed to flush cache \"%s\" to disk before committing its TOC.\n" ),
+			*m_cacheFileName );
+	}
+
+	if( !ReplaceFileAtomic( tempTocFileName, m_tocFileName ) )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			TXT( "Cache: Failed to replace TOC \"%s\" with \"%s\".\n" ),
+			*m_tocFileName,
+			*tempTocFileName );
+
+		return false;
+	}
+
+	m_uncommittedEntryCount = 0;
+
 	return true;
 }
 
-/// Read a value from the cache TOC, check the TOC bounds in the process.
-///
-/// @param[in]  pLoadFunction  Function to use for reading the value.
-/// @param[out] rValue         Read value.
-/// @param[in]  pDescription   Description of the value to read (for logging).
-/// @param[in]  rpTocCurrent   Pointer to the current offset within the TOC file buffer.
-/// @param[in]  pTocMax        Pointer to the end of the TOC file buffer.
-///
-/// @return  True if the value was read successfully, false if not.
-template< typename T >
-bool Cache::CheckedTocRead(
-						   LOAD_VALUE_CALLBACK* pLoadFunction,
-						   T& rValue,
-						   const char* pDescription,
-						   const uint8_t*& rpTocCurrent,
-						   const uint8_t* pTocMax )
+/// Find the TOC record for an entry.
+///
+/// @param[in] rPathString    Entry path string.
+/// @param[in] subDataIndex   Sub-data index associated with the cached data.
+///
+/// @return  Index of the TOC record if found, invalid index if not.
+///
+/// @see MaterializeTocEntry()
+uint32_t Cache::FindTocRecord( const String& rPathString, uint32_t subDataIndex ) const
 {
-	HELIUM_UNREF( pDescription );  // Used for logging only (unused in release builds).
+	HELIUM_ASSERT( m_pTocRecords );
+
+	uint32_t pathHash = ComputePathHash( rPathString );
+	uint32_t bucketIndex = GetTocBucket( pathHash, m_tocBucketCount );
+
+	uint32_t recordEnd = Min( m_pTocBuckets[ bucketIndex + 1 ], m_tocEntryCount );
+	for( uint32_t recordIndex = m_pTocBuckets[ bucketIndex ]; recordIndex < recordEnd; ++recordIndex )
+	{
+		const TocRecord& rRecord = m_pTocRecords[ recordIndex ];
+		if( rRecord.pathHash == pathHash &&
+			rRecord.subDataIndex == subDataIndex &&
+			rRecord.pathSize == rPathString.GetSize() &&
+			rRecord.pathOffset <= m_tocStringDataSize &&
+			rRecord.pathSize <= m_tocStringDataSize - rRecord.pathOffset &&
+			MemoryCompare( m_pTocStrings + rRecord.pathOffset, *rPathString, rRecord.pathSize ) == 0 )
+		{
+			return recordIndex;
+		}
+	}
 
-	HELIUM_ASSERT( pLoadFunction );
-	HELIUM_ASSERT( pDescription );
-	HELIUM_ASSERT( rpTocCurrent );
-	HELIUM_ASSERT( pTocMax );
+	return Invalid< uint32_t >();
+}
 
-	if( rpTocCurrent + sizeof( rValue ) > pTocMax )
+/// Create the entry information for a TOC record if it has not been created already.
+///
+/// @param[in] index  TOC record index.
+///
+/// @return  Entry information.
+///
+/// @see FindTocRecord()
+Cache::Entry* Cache::MaterializeTocEntry( uint32_t index ) const
+{
+	MutexScopeLock scopeLock( m_entryLock );
+
+	Entry* pEntry = m_entries[ index ];
+	if( pEntry )
+	{
+		return pEntry;
+	}
+
+	HELIUM_ASSERT( m_pTocRecords );
+	HELIUM_ASSERT( index < m_tocEntryCount );
+	const TocRecord& rRecord = m_pTocRecords[ index ];
+
+	HELIUM_ASSERT( m_pEntryPool );
+	pEntry = m_pEntryPool->Allocate();
+	HELIUM_ASSERT( pEntry );
+	pEntry->offset = rRecord.offset;
+	pEntry->timestamp = rRecord.timestamp;
+	pEntry->path.Clear();
+	pEntry->subDataIndex = rRecord.subDataIndex;
+	pEntry->size = rRecord.size;
+	pEntry->compressedSize = rRecord.compressedSize;
+	pEntry->codec = CompressionCodecs::None;
+
+	if( rRecord.codec >= static_cast< uint32_t >( CompressionCodecs::Count ) )
 	{
 		HELIUM_TRACE(
 			TraceLevels::Error,
-			TXT( "Cache::TryFinishLoadToc(): Not enough bytes in the TOC file for %s.\n" ),
-			pDescription );
+			TXT( "Cache: TOC \"%s\" entry %" ) PRIu32 TXT( " uses unknown compression codec %" ) PRIu32 TXT( ".\n" ),
+			*m_tocFileName,
+			index,
+			rRecord.codec );
+
+		// Leave the entry unusable rather than misinterpreting its data.
+		pEntry->size = 0;
+		pEntry->compressedSize = 0;
+	}
+	else
+	{
+		pEntry->codec = static_cast< CompressionCodec >( rRecord.codec );
+	}
 
-		return false;
+	if( rRecord.pathOffset > m_tocStringDataSize || rRecord.pathSize > m_tocStringDataSize - rRecord.pathOffset )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			TXT( "Cache: TOC \"%s\" entry %" ) PRIu32 TXT( " has an invalid path string range.\n" ),
+			*m_tocFileName,
+			index );
+	}
+	else
+	{
+		StackMemoryHeap<>& rStackHeap = ThreadLocalStackAllocator::GetMemoryHeap();
+		StackMemoryHeap<>::Marker stackMarker( rStackHeap );
+		char* pPathString = static_cast< char* >( rStackHeap.Allocate( sizeof( char ) * ( rRecord.pathSize + 1 ) ) );
+		HELIUM_ASSERT( pPathString );
+		MemoryCopy( pPathString, m_pTocStrings + rRecord.pathOffset, rRecord.pathSize );
+		pPathString[ rRecord.pathSize ] = TXT( '\0' );
+
+		if( !pEntry->path.Set( pPathString ) )
+		{
+			HELIUM_TRACE(
+				TraceLevels::Error,
+				TXT( "Cache: Failed to set AssetPath for TOC \"%s\" entry %" ) PRIu32 TXT( ".\n" ),
+				*m_tocFileName,
+				index );
+		}
+		else
+		{
+			EntryKey key;
+			key.path = pEntry->path;
+			key.subDataIndex = pEntry->subDataIndex;
+
+			EntryMapType::ConstAccessor entryAccessor;
+			m_entryMap.Insert( entryAccessor, KeyValue< EntryKey, Entry* >( key, pEntry ) );
+		}
 	}
 
-	pLoadFunction( &rValue, rpTocCurrent, sizeof( rValue ) );
-	rpTocCurrent += sizeof( rValue );
+	m_entries[ index ] = pEntry;
 
-	return true;
+	return pEntry;
+}
+
+/// Compute the hash of an entry path string stored in the TOC.
+///
+/// @param[in] rPathString  Entry path string.
+///
+/// @return  Path hash.
+uint32_t Cache::ComputePathHash( const String& rPathString )
+{
+	return Crc32( rPathString.GetData() ? *rPathString : TXT( "" ) );
+}
+
+/// Comparison function for sorting TOC records by path hash.
+///
+/// @param[in] rRecord0  First record.
+/// @param[in] rRecord1  Second record.
+///
+/// @return  True if the first record comes before the second record, false if not.
+bool Cache::CompareTocRecords( const TocRecord& rRecord0, const TocRecord& rRecord1 )
+{
+	return rRecord0.pathHash < rRecord1.pathHash;
+}
+
+/// Get the TOC lookup bucket for a path hash.
+///
+/// Buckets are assigned in hash order, so records sorted by hash are also grouped by bucket.
+///
+/// @param[in] pathHash     Path hash.
+/// @param[in] bucketCount  Number of buckets.
+///
+/// @return  Bucket index.
+uint32_t Cache::GetTocBucket( uint32_t pathHash, uint32_t bucketCount )
+{
+	return static_cast< uint32_t >( ( static_cast< uint64_t >( pathHash ) * bucketCount ) >> 32 );
 }
 
 /// Equality comparison.
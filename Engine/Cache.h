@@ -3,9 +3,13 @@
 #include "Engine/Engine.h"
 #include "Reflect/Translator.h"
 
+#include "Platform/Locks.h"
+
 #include "Foundation/ConcurrentHashMap.h"
 #include "Foundation/ObjectPool.h"
 #include "Engine/AssetPath.h"
+#include "Engine/Compression.h"
+#include "Engine/MappedFile.h"
 #include "Reflect/Object.h"
 
 namespace Helium
@@ -19,6 +23,11 @@ namespace Helium
 
 		/// Default Entry pool block size (for use with modifiable caches on the PC).
 		static const size_t ENTRY_POOL_BLOCK_SIZE = 64;
+		/// Minimum number of entry updates between automatic TOC commits.
+		static const uint32_t TOC_COMMIT_INTERVAL_MIN = 256;
+		/// Seconds after which an uncommitted entry update is committed with the next entry update, however few
+		/// updates are pending.
+		static const uint32_t TOC_COMMIT_SECONDS_MAX = 30;
 
 		/// Cache platforms.
 		enum EPlatform
@@ -47,8 +56,12 @@ namespace Helium
 			/// Sub-data index.
 			uint32_t subDataIndex;
 
-			/// Entry size.
+			/// Entry size (after decompression).
 			uint32_t size;
+			/// Number of bytes the entry occupies in the cache file.
+			uint32_t compressedSize;
+			/// Codec with which the entry data is compressed in the cache file.
+			CompressionCodec codec;
 		};
 
 		/// @name Construction/Destruction
@@ -70,6 +83,8 @@ namespace Helium
 		inline bool IsTocLoaded() const;
 
 		void EnforceTocLoad();
+
+		bool CommitToc();
 		//@}
 
 		/// @name Data Access
@@ -84,7 +99,20 @@ namespace Helium
 		inline const Entry& GetEntry( uint32_t index ) const;
 		const Entry* FindEntry( AssetPath path, uint32_t subDataIndex ) const;
 
-		bool CacheEntry( AssetPath path, uint32_t subDataIndex, const void* pData, int64_t timestamp, uint32_t size );
+		bool CacheEntry(
+			AssetPath path, uint32_t subDataIndex, const void* pData, int64_t timestamp, uint32_t size,
+			CompressionCodec codec = CompressionCodecs::None, int32_t compressionLevel = COMPRESSION_LEVEL_DEFAULT );
+		//@}
+
+		/// @name Entry Loading
+		//@{
+		size_t QueueEntryLoad( const Entry& rEntry, void* pBuffer, size_t loadSizeMax ) const;
+		bool ReadEntry( const Entry& rEntry, DynamicArray< uint8_t >& rData ) const;
+		//@}
+
+		/// @name Mapped Access
+		//@{
+		const uint8_t* MapEntry( const Entry& rEntry );
 		//@}
 
 #if HELIUM_TOOLS
@@ -94,8 +122,48 @@ namespace Helium
 		static Reflect::ObjectPtr ReadCacheObjectFromBuffer( const uint8_t *_buffer, const size_t _offset, const size_t _count, Reflect::ObjectResolver *pResolver = 0 );
 
 	private:
-		/// Value read callback.
-		typedef void ( LOAD_VALUE_CALLBACK )( void* pDestination, const void* pSource, size_t byteCount );
+		/// Table of contents header.
+		struct TocHeader
+		{
+			/// File magic, used to identify the TOC and its byte order.
+			uint32_t magic;
+			/// Cache format version number.
+			uint32_t version;
+			/// Number of entry records.
+			uint32_t entryCount;
+			/// Number of lookup buckets.
+			uint32_t bucketCount;
+			/// Size of the path string data, in bytes.
+			uint32_t stringDataSize;
+			/// Reserved (keeps the entry records 8-byte aligned).
+			uint32_t reserved;
+		};
+
+		/// Table of contents entry record.  Records are sorted by path hash, and the TOC header and records are followed
+		/// by the index of the first record in each lookup bucket (plus one past the last record) and the path strings.
+		struct TocRecord
+		{
+			/// Entry offset.
+			uint64_t offset;
+			/// Entry timestamp.
+			int64_t timestamp;
+			/// Hash of the entry path string.
+			uint32_t pathHash;
+			/// Sub-data index.
+			uint32_t subDataIndex;
+			/// Entry size (after decompression).
+			uint32_t size;
+			/// Number of bytes the entry occupies in the cache file.
+			uint32_t compressedSize;
+			/// Offset of the entry path string within the path string data.
+			uint32_t pathOffset;
+			/// Length of the entry path string (not null-terminated).
+			uint32_t pathSize;
+			/// Compression codec of the entry data.
+			uint32_t codec;
+			/// Reserved (keeps records 8-byte aligned).
+			uint32_t reserved;
+		};
 
 		/// Asset entry key.
 		struct EntryKey
@@ -140,28 +208,64 @@ namespace Helium
 
 		/// Asynchronous TOC load ID.
 		size_t m_asyncLoadId;
-		/// Allocated buffer for asynchronous TOC loading.
+		/// Allocated buffer for asynchronous TOC loading (only used if the TOC file could not be mapped).
 		uint8_t* m_pTocBuffer;
 		/// Size of the TOC, in bytes.
 		uint32_t m_tocSize;
+		/// Read-only mapping of the TOC file.
+		MappedFile m_tocMapping;
+
+		/// TOC entry records, in either m_tocMapping or m_pTocBuffer.
+		const TocRecord* m_pTocRecords;
+		/// TOC lookup bucket table.
+		const uint32_t* m_pTocBuckets;
+		/// TOC path string data.
+		const char* m_pTocStrings;
+		/// Number of TOC entry records.
+		uint32_t m_tocEntryCount;
+		/// Number of TOC lookup buckets.
+		uint32_t m_tocBucketCount;
+		/// Size of the TOC path string data, in bytes.
+		uint32_t m_tocStringDataSize;
 
 		/// Cache entry pool.
 		ObjectPool< Entry >* m_pEntryPool;
-		/// Cache entry information.
-		DynamicArray< Entry* > m_entries;
-		/// Entry lookup hash map.
-		EntryMapType m_entryMap;
+		/// Cache entry information, starting with the TOC entries (null until first accessed).
+		mutable DynamicArray< Entry* > m_entries;
+		/// Entry lookup hash map for entries that have been accessed or added since the TOC was loaded.
+		mutable EntryMapType m_entryMap;
+		/// Lock for creating entry information from the TOC.
+		mutable Mutex m_entryLock;
+		/// Number of entries added or updated since the TOC file was last written.
+		uint32_t m_uncommittedEntryCount;
+		/// Timer tick count at the oldest entry update not yet written to the TOC file.
+		uint64_t m_firstUncommittedTickCount;
+
+		/// Read-only mapping of the cache file.
+		MappedFile m_cacheFileMapping;
+		/// Lock for mapping the cache file on first use.
+		Mutex m_cacheFileMappingLock;
+		/// True once mapping the cache file has been attempted since it was last modified.
+		bool m_bCacheFileMappingAttempted;
 
 		/// @name Loading Utility Functions
 		//@{
-		bool FinalizeTocLoad();
+		bool FinalizeTocLoad( const uint8_t* pTocData );
+		void ReleaseTocData();
+		bool WriteToc();
+		//@}
+
+		/// @name TOC Lookup
+		//@{
+		uint32_t FindTocRecord( const String& rPathString, uint32_t subDataIndex ) const;
+		Entry* MaterializeTocEntry( uint32_t index ) const;
 		//@}
 
 		/// @name Private Static Utility Functions
 		//@{
-		template< typename T > static bool CheckedTocRead(
-			LOAD_VALUE_CALLBACK* pLoadFunction, T& rValue, const char* pDescription, const uint8_t*& rpTocCurrent,
-			const uint8_t* pTocMax );
+		static uint32_t ComputePathHash( const String& rPathString );
+		static uint32_t GetTocBucket( uint32_t pathHash, uint32_t bucketCount );
+		static bool CompareTocRecords( const TocRecord& rRecord0, const TocRecord& rRecord1 );
 		//@}
 	};
 }
@@ -69,6 +69,11 @@ const Helium::Cache::Entry& Helium::Cache::GetEntry( uint32_t index ) const
     HELIUM_ASSERT( index < m_entries.GetSize() );
 
     Entry* pEntry = m_entries[ index ];
+    if( !pEntry )
+    {
+        pEntry = MaterializeTocEntry( index );
+    }
+
     HELIUM_ASSERT( pEntry );
 
     return *pEntry;
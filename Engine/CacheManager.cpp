@@ -94,6 +94,39 @@ Cache* CacheManager::GetCache( Name name, Cache::EPlatform platform )
 	return pCache;
 }
 
+/// Write out pending TOC updates for every cache that has been created.
+///
+/// @return  True if all TOCs are up to date, false if writing any of them failed.
+///
+/// @see Cache::CommitToc()
+bool CacheManager::CommitTocs()
+{
+	bool bSuccess = true;
+
+	for( size_t platformIndex = 0; platformIndex < HELIUM_ARRAY_COUNT( m_cacheMaps ); ++platformIndex )
+	{
+		ConcurrentHashMap< Name, Cache* >::ConstAccessor cacheAccessor;
+		if( !m_cacheMaps[ platformIndex ].First( cacheAccessor ) )
+		{
+			continue;
+		}
+
+		do
+		{
+			Cache* pCache = cacheAccessor->Second();
+			HELIUM_ASSERT( pCache );
+			if( !pCache->CommitToc() )
+			{
+				bSuccess = false;
+			}
+
+			++cacheAccessor;
+		} while( cacheAccessor.IsValid() );
+	}
+
+	return bSuccess;
+}
+
 /// Get the cache data directory for the specified platform.
 ///
 /// @param[in] platform  Target platform, or Cache::PLATFORM_INVALID name to use the current platform.
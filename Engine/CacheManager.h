@@ -21,6 +21,8 @@ namespace Helium
 		/// @name Cache Access
 		//@{
 		Cache* GetCache( Name name, Cache::EPlatform platform = Cache::PLATFORM_INVALID );
+
+		bool CommitTocs();
 		//@}
 
 		/// @name Filesystem Information
@@ -149,6 +149,7 @@ size_t CachePackageLoader::BeginLoadObject( AssetPath path, Reflect::ObjectResol
 
 		SetInvalid( pRequest->asyncLoadId );
 		pRequest->pAsyncLoadBuffer = NULL;
+		pRequest->pCacheData = NULL;
 		pRequest->pPropertyDataBegin = NULL;
 		pRequest->pPropertyDataEnd = NULL;
 		pRequest->pPersistentResourceDataBegin = NULL;
@@ -208,6 +209,7 @@ size_t CachePackageLoader::BeginLoadObject( AssetPath path, Reflect::ObjectResol
 	HELIUM_ASSERT( !pRequest->spObject );
 	SetInvalid( pRequest->asyncLoadId );
 	pRequest->pAsyncLoadBuffer = NULL;
+	pRequest->pCacheData = NULL;
 	pRequest->pPropertyDataBegin = NULL;
 	pRequest->pPropertyDataEnd = NULL;
 	pRequest->pPersistentResourceDataBegin = NULL;
@@ -237,24 +239,30 @@ size_t CachePackageLoader::BeginLoadObject( AssetPath path, Reflect::ObjectResol
 	{
 		HELIUM_ASSERT( !pObject || !pObject->GetAnyFlagSet( Asset::FLAG_LOADED | Asset::FLAG_LINKED ) );
 
-		HELIUM_TRACE(
-			TraceLevels::Debug,
-			TXT( "CachePackageLoader::BeginLoadObject(): Issuing async load of property data for \"%s\".\n" ),
-			*path.ToString() );
-
-		size_t entrySize = pEntry->size;
-		pRequest->pAsyncLoadBuffer = static_cast< uint8_t* >( DefaultAllocator().Allocate( entrySize ) );
-		HELIUM_ASSERT( pRequest->pAsyncLoadBuffer );
+		// Deserialize directly from the mapped cache file if possible (the data is paged in while the request waits to
+		// be ticked), otherwise read the data into a buffer of our own.
+		pRequest->pCacheData = m_pCache->MapEntry( *pEntry );
+		if( pRequest->pCacheData )
+		{
+			HELIUM_TRACE(
+				TraceLevels::Debug,
+				TXT( "CachePackageLoader::BeginLoadObject(): Using mapped property data for \"%s\".\n" ),
+				*path.ToString() );
+		}
+		else
+		{
+			HELIUM_TRACE(
+				TraceLevels::Debug,
+				TXT( "CachePackageLoader::BeginLoadObject(): Issuing async load of property data for \"%s\".\n" ),
+				*path.ToString() );
 
-		AsyncLoader* pAsyncLoader = AsyncLoader::GetInstance();
-		HELIUM_ASSERT( pAsyncLoader );
+			size_t entrySize = pEntry->size;
+			pRequest->pAsyncLoadBuffer = static_cast< uint8_t* >( DefaultAllocator().Allocate( entrySize ) );
+			HELIUM_ASSERT( pRequest->pAsyncLoadBuffer );
 
-		pRequest->asyncLoadId = pAsyncLoader->QueueRequest(
-			pRequest->pAsyncLoadBuffer,
-			m_pCache->GetCacheFileName(),
-			pEntry->offset,
-			entrySize );
-		HELIUM_ASSERT( IsValid( pRequest->asyncLoadId ) );
+			pRequest->asyncLoadId = m_pCache->QueueEntryLoad( *pEntry, pRequest->pAsyncLoadBuffer, entrySize );
+			HELIUM_ASSERT( IsValid( pRequest->asyncLoadId ) );
+		}
 	}
 
 	size_t requestId = m_loadRequests.Add( pRequest );
@@ -352,7 +360,7 @@ void CachePackageLoader::Tick()
 
 		if( !( pRequest->flags & LOAD_FLAG_PRELOADED ) )
 		{
-			if( IsValid( pRequest->asyncLoadId ) )
+			if( !pRequest->pPropertyDataBegin )
 			{
 				if( !TickCacheLoad( pRequest ) )
 				{
@@ -372,6 +380,7 @@ void CachePackageLoader::Tick()
 
 		HELIUM_ASSERT( IsInvalid( pRequest->asyncLoadId ) );
 		HELIUM_ASSERT( pRequest->pAsyncLoadBuffer == NULL );
+		HELIUM_ASSERT( pRequest->pCacheData == NULL );
 	}
 }
 
@@ -404,16 +413,22 @@ bool CachePackageLoader::TickCacheLoad( LoadRequest* pRequest )
 	HELIUM_ASSERT( pRequest );
 	HELIUM_ASSERT( !( pRequest->flags & LOAD_FLAG_PRELOADED ) );
 
-	AsyncLoader* pAsyncLoader = AsyncLoader::GetInstance();
-	HELIUM_ASSERT( pAsyncLoader );
+	HELIUM_ASSERT( pRequest->pEntry );
 
-	size_t bytesRead = 0;
-	if( !pAsyncLoader->TrySyncRequest( pRequest->asyncLoadId, bytesRead ) )
+	size_t bytesRead = pRequest->pEntry->size;
+	if( IsValid( pRequest->asyncLoadId ) )
 	{
-		return false;
-	}
+		AsyncLoader* pAsyncLoader = AsyncLoader::GetInstance();
+		HELIUM_ASSERT( pAsyncLoader );
 
-	SetInvalid( pRequest->asyncLoadId );
+		if( !pAsyncLoader->TrySyncRequest( pRequest->asyncLoadId, bytesRead ) )
+		{
+			return false;
+		}
+
+		SetInvalid( pRequest->asyncLoadId );
+		pRequest->pCacheData = pRequest->pAsyncLoadBuffer;
+	}
 
 	if( bytesRead == 0 || IsInvalid( bytesRead ) )
 	{
@@ -426,7 +441,7 @@ bool CachePackageLoader::TickCacheLoad( LoadRequest* pRequest )
 	}
 	else
 	{
-		uint8_t* pBufferEnd = pRequest->pAsyncLoadBuffer + bytesRead;
+		const uint8_t* pBufferEnd = pRequest->pCacheData + bytesRead;
 		pRequest->pPropertyDataEnd = pBufferEnd;
 		pRequest->pPersistentResourceDataEnd = pBufferEnd;
 
@@ -440,6 +455,7 @@ bool CachePackageLoader::TickCacheLoad( LoadRequest* pRequest )
 	// else will be done with the object itself from here on out).
 	DefaultAllocator().Free( pRequest->pAsyncLoadBuffer );
 	pRequest->pAsyncLoadBuffer = NULL;
+	pRequest->pCacheData = NULL;
 
 	Asset* pObject = pRequest->spObject;
 	if( pObject )
@@ -491,6 +507,7 @@ bool CachePackageLoader::TickDeserialize( LoadRequest* pRequest )
 
 			DefaultAllocator().Free( pRequest->pAsyncLoadBuffer );
 			pRequest->pAsyncLoadBuffer = NULL;
+			pRequest->pCacheData = NULL;
 
 			pRequest->flags |= LOAD_FLAG_PRELOADED | LOAD_FLAG_ERROR;
 
@@ -567,6 +584,7 @@ bool CachePackageLoader::TickDeserialize( LoadRequest* pRequest )
 
 	DefaultAllocator().Free( pRequest->pAsyncLoadBuffer );
 	pRequest->pAsyncLoadBuffer = NULL;
+	pRequest->pCacheData = NULL;
 
 	pObject->SetFlags( Asset::FLAG_PRELOADED );
 
@@ -614,8 +632,8 @@ bool CachePackageLoader::ReadCacheData( LoadRequest* pRequest )
 {
 	HELIUM_ASSERT( pRequest );
 
-	uint8_t* pBufferCurrent = pRequest->pAsyncLoadBuffer;
-	uint8_t* pPropertyDataEnd = pRequest->pPropertyDataEnd;
+	const uint8_t* pBufferCurrent = pRequest->pCacheData;
+	const uint8_t* pPropertyDataEnd = pRequest->pPropertyDataEnd;
 	HELIUM_ASSERT( pBufferCurrent );
 	HELIUM_ASSERT( pPropertyDataEnd );
 	HELIUM_ASSERT( pBufferCurrent <= pPropertyDataEnd );
@@ -8,6 +8,9 @@
 namespace Helium
 {
 	/// Package loader for loading objects from a binary cache.
+	///
+	/// Objects are deserialized straight out of a read-only mapping of the cache file when possible, falling back to
+	/// reading each object into a buffer with the AsyncLoader if the file cannot be mapped.
 	class CachePackageLoader : public PackageLoader
 	{
 	public:
@@ -67,17 +70,19 @@ namespace Helium
 
 			/// Async load ID.
 			size_t asyncLoadId;
-			/// Async load buffer.
+			/// Async load buffer (only used if the cache file could not be mapped).
 			uint8_t* pAsyncLoadBuffer;
+			/// Cached data of the entry, either within the mapped cache file or pAsyncLoadBuffer.
+			const uint8_t* pCacheData;
 
-			/// Pointer to where the property data begins within the pAsyncLoadBuffer
-			uint8_t* pPropertyDataBegin;
+			/// Pointer to where the property data begins within pCacheData
+			const uint8_t* pPropertyDataBegin;
 			/// End of the property data
-			uint8_t* pPropertyDataEnd;
-			/// Pointer to where the persistent resource data begins within the pAsyncLoadBuffer
-			uint8_t* pPersistentResourceDataBegin;
+			const uint8_t* pPropertyDataEnd;
+			/// Pointer to where the persistent resource data begins within pCacheData
+			const uint8_t* pPersistentResourceDataBegin;
 			/// End of the persistent resource data.
-			uint8_t* pPersistentResourceDataEnd;
+			const uint8_t* pPersistentResourceDataEnd;
 
 			// Load index for the owning asset
 			size_t ownerLoadIndex;
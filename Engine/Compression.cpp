@@ -0,0 +1,143 @@
+#include "EnginePch.h"
+#include "Engine/Compression.h"
+
+#include "zlib/zlib.h"
+
+using namespace Helium;
+
+/// Compress a block of data.
+///
+/// @param[in]  codec       Compression codec.
+/// @param[in]  level       Codec-specific compression level, or COMPRESSION_LEVEL_DEFAULT.  For deflate, this ranges
+///                         from 1 (fastest) to 9 (smallest).
+/// @param[in]  pSource     Data to compress.
+/// @param[in]  sourceSize  Number of bytes to compress.
+/// @param[out] rDest       Buffer in which to store the compressed data (resized to fit).
+///
+/// @return  True if the data was compressed, false if the codec does not compress or compression failed.
+///
+/// @see Decompress()
+bool Helium::Compress(
+	CompressionCodec codec,
+	int32_t level,
+	const void* pSource,
+	size_t sourceSize,
+	DynamicArray< uint8_t >& rDest )
+{
+	HELIUM_ASSERT( pSource || sourceSize == 0 );
+
+	rDest.Resize( 0 );
+
+	switch( codec )
+	{
+	case CompressionCodecs::Deflate:
+		{
+			if( sourceSize > static_cast< size_t >( NumericLimits< uLong >::Maximum ) )
+			{
+				return false;
+			}
+
+			uLong sourceLength = static_cast< uLong >( sourceSize );
+			uLongf destLength = compressBound( sourceLength );
+			rDest.Resize( destLength );
+
+			int result = compress2(
+				rDest.GetData(),
+				&destLength,
+				static_cast< const Bytef* >( pSource ),
+				sourceLength,
+				( level == COMPRESSION_LEVEL_DEFAULT ? Z_DEFAULT_COMPRESSION : Clamp( level, 1, 9 ) ) );
+			if( result != Z_OK )
+			{
+				HELIUM_TRACE(
+					TraceLevels::Error,
+					TXT( "Compress(): zlib compression of %" ) PRIuSZ TXT( " bytes failed (error %d).\n" ),
+					sourceSize,
+					result );
+
+				rDest.Resize( 0 );
+
+				return false;
+			}
+
+			rDest.Resize( destLength );
+
+			return true;
+		}
+
+	default:
+		return false;
+	}
+}
+
+/// Decompress a block of data.
+///
+/// Output stops once the destination buffer is full, so a prefix of the data can be decompressed by passing a
+/// destination buffer smaller than the original data.
+///
+/// @param[in]  codec       Codec with which the data was compressed.
+/// @param[in]  pSource     Compressed data.
+/// @param[in]  sourceSize  Number of bytes of compressed data.
+/// @param[out] pDest       Buffer in which to store the decompressed data.
+/// @param[in]  destSize    Size of the destination buffer.
+///
+/// @return  Number of bytes stored in the destination buffer, or an invalid index if the data is corrupt.
+///
+/// @see Compress()
+size_t Helium::Decompress(
+	CompressionCodec codec,
+	const void* pSource,
+	size_t sourceSize,
+	void* pDest,
+	size_t destSize )
+{
+	HELIUM_ASSERT( pSource || sourceSize == 0 );
+	HELIUM_ASSERT( pDest || destSize == 0 );
+
+	switch( codec )
+	{
+	case CompressionCodecs::None:
+		{
+			size_t copySize = Min( sourceSize, destSize );
+			MemoryCopy( pDest, pSource, copySize );
+
+			return copySize;
+		}
+
+	case CompressionCodecs::Deflate:
+		{
+			if( sourceSize > static_cast< size_t >( NumericLimits< uInt >::Maximum ) ||
+				destSize > static_cast< size_t >( NumericLimits< uInt >::Maximum ) )
+			{
+				return Invalid< size_t >();
+			}
+
+			z_stream stream;
+			MemoryZero( &stream, sizeof( stream ) );
+			stream.next_in = static_cast< Bytef* >( const_cast< void* >( pSource ) );
+			stream.avail_in = static_cast< uInt >( sourceSize );
+			stream.next_out = static_cast< Bytef* >( pDest );
+			stream.avail_out = static_cast< uInt >( destSize );
+
+			if( inflateInit( &stream ) != Z_OK )
+			{
+				return Invalid< size_t >();
+			}
+
+			int result = inflate( &stream, Z_FINISH );
+			size_t bytesWritten = destSize - stream.avail_out;
+			inflateEnd( &stream );
+
+			// Z_BUF_ERROR with a full output buffer just means the caller only asked for part of the data.
+			if( result != Z_STREAM_END && !( result == Z_BUF_ERROR && stream.avail_out == 0 ) )
+			{
+				return Invalid< size_t >();
+			}
+
+			return bytesWritten;
+		}
+
+	default:
+		return Invalid< size_t >();
+	}
+}
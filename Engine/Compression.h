@@ -0,0 +1,31 @@
+#pragma once
+
+#include "Engine/Engine.h"
+
+#include "Foundation/DynamicArray.h"
+
+namespace Helium
+{
+	/// Block compression codecs available for cached data.
+	namespace CompressionCodecs
+	{
+		enum Type
+		{
+			/// Data is stored as-is.
+			None,
+			/// zlib deflate stream.
+			Deflate,
+
+			Count
+		};
+	}
+	typedef CompressionCodecs::Type CompressionCodec;
+
+	/// Default compression level, a reasonable balance between speed and compression ratio.
+	const static int32_t COMPRESSION_LEVEL_DEFAULT = -1;
+
+	HELIUM_ENGINE_API bool Compress(
+		CompressionCodec codec, int32_t level, const void* pSource, size_t sourceSize, DynamicArray< uint8_t >& rDest );
+	HELIUM_ENGINE_API size_t Decompress(
+		CompressionCodec codec, const void* pSource, size_t sourceSize, void* pDest, size_t destSize );
+}
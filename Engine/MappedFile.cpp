@@ -0,0 +1,185 @@
+#include "EnginePch.h"
+#include "Engine/MappedFile.h"
+
+#include "Platform/Encoding.h"
+
+#if HELIUM_OS_WIN
+# include <windows.h>
+#else
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+using namespace Helium;
+
+/// Constructor.
+MappedFile::MappedFile()
+	: m_pData( NULL )
+	, m_size( 0 )
+#if HELIUM_OS_WIN
+	, m_hMapping( NULL )
+#endif
+{
+}
+
+/// Destructor.
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+/// Map the entire contents of a file for reading.
+///
+/// Any previously mapped file is closed first.  Empty files cannot be mapped.
+///
+/// @param[in] rFileName  Name of the file to map.
+///
+/// @return  True if the file was mapped successfully, false if not.
+///
+/// @see Close()
+bool MappedFile::Open( const String& rFileName )
+{
+	Close();
+
+#if HELIUM_OS_WIN
+	std::wstring wideFileName;
+	if( !ConvertString( *rFileName, wideFileName ) )
+	{
+		return false;
+	}
+
+	HANDLE hFile = ::CreateFileW(
+		wideFileName.c_str(),
+		GENERIC_READ,
+		FILE_SHARE_READ | FILE_SHARE_WRITE,
+		NULL,
+		OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS,
+		NULL );
+	if( hFile == INVALID_HANDLE_VALUE )
+	{
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
+	if( !::GetFileSizeEx( hFile, &fileSize ) || fileSize.QuadPart <= 0 ||
+		static_cast< uint64_t >( fileSize.QuadPart ) > static_cast< uint64_t >( NumericLimits< size_t >::Maximum ) )
+	{
+		::CloseHandle( hFile );
+
+		return false;
+	}
+
+	// The mapping object keeps the file open, so the file handle itself is no longer needed once it exists.
+	HANDLE hMapping = ::CreateFileMappingW( hFile, NULL, PAGE_READONLY, 0, 0, NULL );
+	::CloseHandle( hFile );
+	if( !hMapping )
+	{
+		return false;
+	}
+
+	void* pView = ::MapViewOfFile( hMapping, FILE_MAP_READ, 0, 0, 0 );
+	if( !pView )
+	{
+		::CloseHandle( hMapping );
+
+		return false;
+	}
+
+	m_hMapping = hMapping;
+	m_pData = static_cast< const uint8_t* >( pView );
+	m_size = static_cast< uint64_t >( fileSize.QuadPart );
+#else
+	int fileDescriptor = open( *rFileName, O_RDONLY );
+	if( fileDescriptor == -1 )
+	{
+		return false;
+	}
+
+	struct stat fileStatus;
+	if( fstat( fileDescriptor, &fileStatus ) != 0 || fileStatus.st_size <= 0 ||
+		static_cast< uint64_t >( fileStatus.st_size ) > static_cast< uint64_t >( NumericLimits< size_t >::Maximum ) )
+	{
+		close( fileDescriptor );
+
+		return false;
+	}
+
+	size_t mapSize = static_cast< size_t >( fileStatus.st_size );
+
+	// The mapping holds its own reference to the file, so the descriptor can be closed right away.
+	void* pView = mmap( NULL, mapSize, PROT_READ, MAP_SHARED, fileDescriptor, 0 );
+	close( fileDescriptor );
+	if( pView == MAP_FAILED )
+	{
+		return false;
+	}
+
+	// Reads are driven by asset load order rather than file order, so don't let the kernel read ahead on its own;
+	// Prefetch() is used to request the ranges that are actually needed.
+	madvise( pView, mapSize, MADV_RANDOM );
+
+	m_pData = static_cast< const uint8_t* >( pView );
+	m_size = static_cast< uint64_t >( mapSize );
+#endif
+
+	return true;
+}
+
+/// Unmap the current file, if any.
+///
+/// Any pointers into the mapped data are invalid once this returns.
+///
+/// @see Open()
+void MappedFile::Close()
+{
+	if( !m_pData )
+	{
+		return;
+	}
+
+#if HELIUM_OS_WIN
+	::UnmapViewOfFile( m_pData );
+	::CloseHandle( m_hMapping );
+	m_hMapping = NULL;
+#else
+	munmap( const_cast< uint8_t* >( m_pData ), static_cast< size_t >( m_size ) );
+#endif
+
+	m_pData = NULL;
+	m_size = 0;
+}
+
+/// Hint that a range of the mapped file will be read soon, so that the operating system can begin paging it in.
+///
+/// This never blocks on I/O.  Ranges outside of the mapping are clamped to it.
+///
+/// @param[in] offset  Byte offset of the start of the range.
+/// @param[in] size    Number of bytes in the range.
+void MappedFile::Prefetch( uint64_t offset, uint64_t size ) const
+{
+	if( !m_pData || offset >= m_size || size == 0 )
+	{
+		return;
+	}
+
+	size = Min( size, m_size - offset );
+
+#if HELIUM_OS_WIN
+	// PrefetchVirtualMemory() is not available on all supported versions of Windows, and FILE_FLAG_RANDOM_ACCESS
+	// already keeps the cache manager from reading too far ahead, so pages are simply faulted in on first access.
+	HELIUM_UNREF( size );
+#else
+	// madvise() requires a page-aligned start address.
+	size_t pageSize = static_cast< size_t >( sysconf( _SC_PAGESIZE ) );
+	uintptr_t rangeStart = reinterpret_cast< uintptr_t >( m_pData + offset );
+	uintptr_t alignedStart = rangeStart & ~static_cast< uintptr_t >( pageSize - 1 );
+
+	madvise(
+		reinterpret_cast< void* >( alignedStart ),
+		static_cast< size_t >( size ) + static_cast< size_t >( rangeStart - alignedStart ),
+		MADV_WILLNEED );
+#endif
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Engine/Engine.h"
+
+#include "Foundation/String.h"
+
+namespace Helium
+{
+	/// Read-only memory mapping of an entire file.
+	///
+	/// Mapped pages are backed by the operating system's file cache, so several processes mapping the same file share
+	/// a single copy of its contents.  The mapping covers the file as it was when opened; the file must not be
+	/// truncated while it is mapped, and data appended afterwards is only visible after re-opening the mapping.
+	class HELIUM_ENGINE_API MappedFile : NonCopyable
+	{
+	public:
+		/// @name Construction/Destruction
+		//@{
+		MappedFile();
+		~MappedFile();
+		//@}
+
+		/// @name Mapping
+		//@{
+		bool Open( const String& rFileName );
+		void Close();
+		inline bool IsOpen() const;
+		//@}
+
+		/// @name Data Access
+		//@{
+		inline const uint8_t* GetData() const;
+		inline uint64_t GetSize() const;
+
+		void Prefetch( uint64_t offset, uint64_t size ) const;
+		//@}
+
+	private:
+		/// Start of the mapped file contents.
+		const uint8_t* m_pData;
+		/// Size of the mapping, in bytes.
+		uint64_t m_size;
+
+#if HELIUM_OS_WIN
+		/// File mapping object handle.
+		void* m_hMapping;
+#endif
+	};
+}
+
+#include "Engine/MappedFile.inl"
@@ -0,0 +1,29 @@
+/// Get whether a file is currently mapped.
+///
+/// @return  True if a file is mapped, false if not.
+///
+/// @see Open(), Close()
+bool Helium::MappedFile::IsOpen() const
+{
+	return m_pData != NULL;
+}
+
+/// Get the start of the mapped file contents.
+///
+/// @return  Pointer to the first byte of the file, or null if no file is mapped.
+///
+/// @see GetSize()
+const uint8_t* Helium::MappedFile::GetData() const
+{
+	return m_pData;
+}
+
+/// Get the number of bytes mapped.
+///
+/// @return  Size of the mapped file, or zero if no file is mapped.
+///
+/// @see GetData()
+uint64_t Helium::MappedFile::GetSize() const
+{
+	return m_size;
+}
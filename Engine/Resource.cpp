@@ -133,14 +133,8 @@ size_t Resource::BeginLoadSubData( void* pBuffer, uint32_t subDataIndex, size_t
 		return Invalid< size_t >();
 	}
 
-	// Begin an asynchronous load.
-	size_t subDataSize = pCacheEntry->size;
-	size_t loadSize = Min( subDataSize, loadSizeMax );
-
-	AsyncLoader* pAsyncLoader = AsyncLoader::GetInstance();
-	HELIUM_ASSERT( pAsyncLoader );
-
-	size_t loadId = pAsyncLoader->QueueRequest( pBuffer, pCache->GetCacheFileName(), pCacheEntry->offset, loadSize );
+	// Begin an asynchronous load (compressed entries are decompressed by the async loader).
+	size_t loadId = pCache->QueueEntryLoad( *pCacheEntry, pBuffer, loadSizeMax );
 
 	return loadId;
 }
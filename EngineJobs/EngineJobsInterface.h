@@ -4,6 +4,7 @@
 #include "Foundation/Functions.h"
 #include "EngineJobs/EngineJobs.h"
 #include "EngineJobs/EngineJobsTypes.h"
+#include "EngineJobs/JobManager.h"
 
 namespace Helium
 {
@@ -0,0 +1,584 @@
+#include "EngineJobsPch.h"
+#include "EngineJobs/JobManager.h"
+
+#include "Platform/Atomic.h"
+#include "Platform/MemoryHeap.h"
+
+using namespace Helium;
+
+static uint32_t g_InitCount = 0;
+JobManager* JobManager::sm_pInstance = NULL;
+
+/// Constructor.
+JobManager::JobManager()
+	: m_queuedJobCount( 0 )
+	, m_nextQueueIndex( 0 )
+{
+}
+
+/// Destructor.
+JobManager::~JobManager()
+{
+	Cleanup();
+}
+
+/// Initialize the job manager and start its worker threads.
+///
+/// @param[in] workerCount  Number of worker threads to create, or zero to create one worker for each hardware thread
+///                         other than the calling thread.
+///
+/// @return  True if initialization was sucessful, false if not.
+///
+/// @see Cleanup()
+bool JobManager::Initialize( uint32_t workerCount )
+{
+	Cleanup();
+
+	if( workerCount == 0 )
+	{
+		uint32_t hardwareThreadCount = static_cast< uint32_t >( std::thread::hardware_concurrency() );
+		workerCount = ( hardwareThreadCount > 1 ? hardwareThreadCount - 1 : 1 );
+	}
+
+	if( workerCount > WORKER_COUNT_MAX )
+	{
+		workerCount = WORKER_COUNT_MAX;
+	}
+
+	m_workers.Reserve( workerCount );
+	m_threads.Reserve( workerCount );
+
+	// Create all workers before starting any threads, as running workers will attempt to steal from each other.
+	for( uint32_t workerIndex = 0; workerIndex < workerCount; ++workerIndex )
+	{
+		JobWorker* pWorker = new JobWorker( this, workerIndex );
+		HELIUM_ASSERT( pWorker );
+		m_workers.Push( pWorker );
+	}
+
+	for( uint32_t workerIndex = 0; workerIndex < workerCount; ++workerIndex )
+	{
+		RunnableThread* pThread = new RunnableThread( m_workers[ workerIndex ] );
+		HELIUM_ASSERT( pThread );
+		HELIUM_VERIFY( pThread->Start( TXT( "JobManager - worker" ) ) );
+		m_threads.Push( pThread );
+	}
+
+	// Wait for each worker to publish its thread ID so that GetCurrentWorkerIndex() can be used safely.
+	for( uint32_t workerIndex = 0; workerIndex < workerCount; ++workerIndex )
+	{
+		while( m_workers[ workerIndex ]->m_startedCounter == 0 )
+		{
+			Thread::Yield();
+		}
+	}
+
+	HELIUM_TRACE( TraceLevels::Info, TXT( "JobManager::Initialize(): Started %" ) PRIu32 TXT( " worker threads.\n" ), workerCount );
+
+	return true;
+}
+
+/// Stop all worker threads and shut down the job manager.
+///
+/// Any jobs still queued are run on the calling thread before returning.
+///
+/// @see Initialize()
+void JobManager::Cleanup()
+{
+	size_t workerCount = m_workers.GetSize();
+	for( size_t workerIndex = 0; workerIndex < workerCount; ++workerIndex )
+	{
+		m_workers[ workerIndex ]->Stop();
+	}
+
+	size_t threadCount = m_threads.GetSize();
+	for( size_t threadIndex = 0; threadIndex < threadCount; ++threadIndex )
+	{
+		RunnableThread* pThread = m_threads[ threadIndex ];
+		HELIUM_ASSERT( pThread );
+		pThread->Join();
+		delete pThread;
+	}
+
+	m_threads.Clear();
+
+	// Drain anything left behind so that no counter is left waiting forever.
+	Job job;
+	while( FindJob( Invalid< uint32_t >(), job ) )
+	{
+		RunJob( job );
+	}
+
+	for( size_t workerIndex = 0; workerIndex < workerCount; ++workerIndex )
+	{
+		delete m_workers[ workerIndex ];
+	}
+
+	m_workers.Clear();
+}
+
+/// Spawn a job.
+///
+/// If called from within a running job, the new job is pushed onto the current worker's own queue; otherwise jobs are
+/// distributed across worker queues in round-robin order.  If the job manager has not been started or the target
+/// queue is full, the job is run immediately on the calling thread.
+///
+/// @param[in] pFunction  Job entry point.
+/// @param[in] pData      Data to pass to the job entry point.
+/// @param[in] rCounter   Counter used to track completion of the job.  This can be the same counter the calling job
+///                       was spawned against in order to make the parent's completion depend on the child.
+///
+/// @see Wait(), ParallelFor()
+void JobManager::Spawn( JOB_FUNC* pFunction, void* pData, JobCounter& rCounter )
+{
+	HELIUM_ASSERT( pFunction );
+
+	Job job;
+	job.pFunction = pFunction;
+	job.pData = pData;
+	job.pCounter = &rCounter;
+
+	AtomicIncrementAcquire( rCounter.m_pendingCount );
+
+	JobManager* pManager = sm_pInstance;
+	if( !pManager || pManager->m_workers.IsEmpty() )
+	{
+		RunJob( job );
+
+		return;
+	}
+
+	uint32_t workerCount = pManager->GetWorkerCount();
+	uint32_t queueIndex = pManager->GetCurrentWorkerIndex();
+	if( IsInvalid( queueIndex ) )
+	{
+		queueIndex = static_cast< uint32_t >( AtomicIncrementUnsafe( pManager->m_nextQueueIndex ) ) % workerCount;
+	}
+
+	if( !pManager->m_workers[ queueIndex ]->m_queue.Push( job ) )
+	{
+		RunJob( job );
+
+		return;
+	}
+
+	AtomicIncrementRelease( pManager->m_queuedJobCount );
+	pManager->WakeWorker();
+}
+
+/// Block the calling thread until all jobs spawned against the given counter have completed.
+///
+/// Rather than sleeping, the calling thread runs queued jobs (stealing from workers as necessary) until the counter
+/// reaches zero.
+///
+/// @param[in] rCounter  Counter on which to wait.
+///
+/// @see Spawn()
+void JobManager::Wait( JobCounter& rCounter )
+{
+	JobManager* pManager = sm_pInstance;
+	uint32_t workerIndex = ( pManager ? pManager->GetCurrentWorkerIndex() : Invalid< uint32_t >() );
+
+	Job job;
+	while( !rCounter.IsDone() )
+	{
+		if( pManager && pManager->FindJob( workerIndex, job ) )
+		{
+			RunJob( job );
+		}
+		else
+		{
+			Thread::Yield();
+		}
+	}
+}
+
+/// Run a single queued job on the calling thread, if any are available.
+///
+/// This can be used by threads that need to poll for some other condition while still helping with queued work.
+///
+/// @return  True if a job was run, false if no jobs were queued.
+///
+/// @see Wait()
+bool JobManager::TryRunJob()
+{
+	JobManager* pManager = sm_pInstance;
+	if( !pManager )
+	{
+		return false;
+	}
+
+	Job job;
+	if( !pManager->FindJob( pManager->GetCurrentWorkerIndex(), job ) )
+	{
+		return false;
+	}
+
+	RunJob( job );
+
+	return true;
+}
+
+/// Run a function over the index range [0, count) in parallel.
+///
+/// The range is split into sub-ranges of at most @c grainSize indices, each of which is run as a separate job.  The
+/// first sub-range is run on the calling thread, which then helps with the remaining work until all sub-ranges have
+/// completed.
+///
+/// @param[in] count      Number of indices to process.
+/// @param[in] grainSize  Maximum number of indices to process in a single job, or zero to pick a size based on the
+///                       number of worker threads.
+/// @param[in] pFunction  Function to call for each sub-range.
+/// @param[in] pData      Data to pass to the function.
+///
+/// @see Spawn(), Wait()
+void JobManager::ParallelFor( size_t count, size_t grainSize, PARALLEL_FOR_FUNC* pFunction, void* pData )
+{
+	HELIUM_ASSERT( pFunction );
+
+	if( count == 0 )
+	{
+		return;
+	}
+
+	JobManager* pManager = sm_pInstance;
+	if( !pManager || pManager->m_workers.IsEmpty() )
+	{
+		pFunction( pData, 0, count );
+
+		return;
+	}
+
+	if( grainSize == 0 )
+	{
+		size_t targetRangeCount = ( pManager->m_workers.GetSize() + 1 ) * PARALLEL_FOR_RANGES_PER_THREAD;
+		grainSize = ( count + targetRangeCount - 1 ) / targetRangeCount;
+	}
+
+	size_t rangeCount = ( count + grainSize - 1 ) / grainSize;
+	if( rangeCount <= 1 )
+	{
+		pFunction( pData, 0, count );
+
+		return;
+	}
+
+	StackMemoryHeap<>& rStackHeap = ThreadLocalStackAllocator::GetMemoryHeap();
+	StackMemoryHeap<>::Marker stackMarker( rStackHeap );
+
+	ParallelForRange* pRanges = static_cast< ParallelForRange* >(
+		rStackHeap.Allocate( sizeof( ParallelForRange ) * rangeCount ) );
+	HELIUM_ASSERT( pRanges );
+
+	JobCounter counter;
+	for( size_t rangeIndex = 0; rangeIndex < rangeCount; ++rangeIndex )
+	{
+		ParallelForRange& rRange = pRanges[ rangeIndex ];
+		rRange.pFunction = pFunction;
+		rRange.pData = pData;
+		rRange.start = rangeIndex * grainSize;
+		rRange.end = Min( rRange.start + grainSize, count );
+
+		if( rangeIndex != 0 )
+		{
+			Spawn( ParallelForRangeCallback, &rRange, counter );
+		}
+	}
+
+	pFunction( pData, pRanges[ 0 ].start, pRanges[ 0 ].end );
+
+	Wait( counter );
+}
+
+/// Get the singleton JobManager instance.
+///
+/// @return  Pointer to the JobManager instance.
+///
+/// @see Startup(), Shutdown()
+JobManager* JobManager::GetInstance()
+{
+	return sm_pInstance;
+}
+
+/// Create the singleton JobManager instance.
+///
+/// @param[in] workerCount  Number of worker threads to create, or zero to create one worker for each hardware thread
+///                         other than the calling thread.
+///
+/// @see GetInstance()
+void JobManager::Startup( uint32_t workerCount )
+{
+	if ( ++g_InitCount == 1 )
+	{
+		HELIUM_ASSERT( !sm_pInstance );
+		JobManager* pInstance = new JobManager;
+		HELIUM_ASSERT( pInstance );
+		if ( !HELIUM_VERIFY( pInstance->Initialize( workerCount ) ) )
+		{
+			delete pInstance;
+			--g_InitCount;
+
+			return;
+		}
+
+		sm_pInstance = pInstance;
+	}
+}
+
+/// Destroy the singleton JobManager instance.
+///
+/// @see GetInstance()
+void JobManager::Shutdown()
+{
+	if ( --g_InitCount == 0 )
+	{
+		HELIUM_ASSERT( sm_pInstance );
+
+		// Clear the instance first so that jobs spawned during cleanup are run inline.
+		JobManager* pInstance = sm_pInstance;
+		sm_pInstance = NULL;
+
+		pInstance->Cleanup();
+		delete pInstance;
+	}
+}
+
+/// Get the index of the worker running on the calling thread.
+///
+/// @return  Worker index, or an invalid index if the calling thread is not a worker thread.
+uint32_t JobManager::GetCurrentWorkerIndex() const
+{
+	std::thread::id currentThreadId = std::this_thread::get_id();
+
+	size_t workerCount = m_workers.GetSize();
+	for( size_t workerIndex = 0; workerIndex < workerCount; ++workerIndex )
+	{
+		if( m_workers[ workerIndex ]->m_threadId == currentThreadId )
+		{
+			return static_cast< uint32_t >( workerIndex );
+		}
+	}
+
+	return Invalid< uint32_t >();
+}
+
+/// Find a job to run, checking the given worker's own queue first and then stealing from all other workers.
+///
+/// @param[in]  workerIndex  Index of the worker looking for work, or an invalid index for non-worker threads.
+/// @param[out] rJob         Job to run if one was found.
+///
+/// @return  True if a job was found and removed from its queue, false if all queues are empty.
+bool JobManager::FindJob( uint32_t workerIndex, Job& rJob )
+{
+	if( m_queuedJobCount == 0 )
+	{
+		return false;
+	}
+
+	uint32_t workerCount = GetWorkerCount();
+	uint32_t startIndex = 0;
+	if( IsValid( workerIndex ) )
+	{
+		if( m_workers[ workerIndex ]->m_queue.Pop( rJob ) )
+		{
+			AtomicDecrementRelease( m_queuedJobCount );
+
+			return true;
+		}
+
+		startIndex = workerIndex + 1;
+	}
+
+	for( uint32_t offset = 0; offset < workerCount; ++offset )
+	{
+		uint32_t victimIndex = ( startIndex + offset ) % workerCount;
+		if( victimIndex != workerIndex && m_workers[ victimIndex ]->m_queue.Steal( rJob ) )
+		{
+			AtomicDecrementRelease( m_queuedJobCount );
+
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/// Wake up a single sleeping worker, if any.
+void JobManager::WakeWorker()
+{
+	size_t workerCount = m_workers.GetSize();
+	for( size_t workerIndex = 0; workerIndex < workerCount; ++workerIndex )
+	{
+		if( m_workers[ workerIndex ]->Wake() )
+		{
+			break;
+		}
+	}
+}
+
+/// Run a job and release its counter.
+///
+/// @param[in] rJob  Job to run.
+void JobManager::RunJob( const Job& rJob )
+{
+	HELIUM_ASSERT( rJob.pFunction );
+	HELIUM_ASSERT( rJob.pCounter );
+
+	rJob.pFunction( rJob.pData );
+
+	HELIUM_VERIFY( AtomicDecrementRelease( rJob.pCounter->m_pendingCount ) >= 0 );
+}
+
+/// Job callback used to run a single parallel-for sub-range.
+///
+/// @param[in] pData  Parallel-for range information.
+void JobManager::ParallelForRangeCallback( void* pData )
+{
+	HELIUM_ASSERT( pData );
+
+	ParallelForRange* pRange = static_cast< ParallelForRange* >( pData );
+	pRange->pFunction( pRange->pData, pRange->start, pRange->end );
+}
+
+/// Constructor.
+JobManager::JobQueue::JobQueue()
+	: m_top( 0 )
+	, m_bottom( 0 )
+{
+}
+
+/// Push a job onto the bottom of this queue.
+///
+/// @param[in] rJob  Job to push.
+///
+/// @return  True if the job was queued, false if the queue is full.
+bool JobManager::JobQueue::Push( const Job& rJob )
+{
+	m_lock.Lock();
+
+	bool bPushed = ( m_bottom - m_top < QUEUE_CAPACITY );
+	if( bPushed )
+	{
+		m_jobs[ m_bottom & ( QUEUE_CAPACITY - 1 ) ] = rJob;
+		++m_bottom;
+	}
+
+	m_lock.Unlock();
+
+	return bPushed;
+}
+
+/// Pop the most recently pushed job from the bottom of this queue.
+///
+/// @param[out] rJob  Popped job.
+///
+/// @return  True if a job was popped, false if the queue is empty.
+bool JobManager::JobQueue::Pop( Job& rJob )
+{
+	m_lock.Lock();
+
+	bool bPopped = ( m_bottom != m_top );
+	if( bPopped )
+	{
+		--m_bottom;
+		rJob = m_jobs[ m_bottom & ( QUEUE_CAPACITY - 1 ) ];
+	}
+
+	m_lock.Unlock();
+
+	return bPopped;
+}
+
+/// Steal the oldest job from the top of this queue.
+///
+/// @param[out] rJob  Stolen job.
+///
+/// @return  True if a job was stolen, false if the queue is empty.
+bool JobManager::JobQueue::Steal( Job& rJob )
+{
+	m_lock.Lock();
+
+	bool bStolen = ( m_bottom != m_top );
+	if( bStolen )
+	{
+		rJob = m_jobs[ m_top & ( QUEUE_CAPACITY - 1 ) ];
+		++m_top;
+	}
+
+	m_lock.Unlock();
+
+	return bStolen;
+}
+
+/// Constructor.
+///
+/// @param[in] pManager  Owning job manager.
+/// @param[in] index     Index of this worker.
+JobManager::JobWorker::JobWorker( JobManager* pManager, uint32_t index )
+	: m_pManager( pManager )
+	, m_index( index )
+	, m_wakeUpCondition( false, false )
+	, m_startedCounter( 0 )
+	, m_stopCounter( 0 )
+	, m_sleepingCounter( 0 )
+{
+	HELIUM_ASSERT( pManager );
+}
+
+/// Destructor.
+JobManager::JobWorker::~JobWorker()
+{
+}
+
+/// Run queued jobs until stopped.
+void JobManager::JobWorker::Run()
+{
+	m_threadId = std::this_thread::get_id();
+	AtomicExchangeRelease( m_startedCounter, 1 );
+
+	Job job;
+	while( m_stopCounter == 0 )
+	{
+		if( m_pManager->FindJob( m_index, job ) )
+		{
+			RunJob( job );
+
+			continue;
+		}
+
+		// Publish that we are going to sleep before checking the queues one last time, so that a job spawned in
+		// between either gets seen here or sends us a wake-up signal.
+		AtomicExchangeAcquire( m_sleepingCounter, 1 );
+		if( m_pManager->m_queuedJobCount != 0 || m_stopCounter != 0 )
+		{
+			AtomicExchangeRelease( m_sleepingCounter, 0 );
+
+			continue;
+		}
+
+		m_wakeUpCondition.Wait();
+		AtomicExchangeRelease( m_sleepingCounter, 0 );
+	}
+}
+
+/// Request the worker to stop processing and return at the next possible opportunity.
+void JobManager::JobWorker::Stop()
+{
+	AtomicExchangeRelease( m_stopCounter, 1 );
+	m_wakeUpCondition.Signal();
+}
+
+/// Wake up this worker if it is sleeping.
+///
+/// @return  True if the worker was sleeping and has been signaled, false if it was already awake.
+bool JobManager::JobWorker::Wake()
+{
+	if( m_sleepingCounter == 0 || AtomicExchangeAcquire( m_sleepingCounter, 0 ) == 0 )
+	{
+		return false;
+	}
+
+	m_wakeUpCondition.Signal();
+
+	return true;
+}
@@ -0,0 +1,213 @@
+#pragma once
+
+#include "Platform/Condition.h"
+#include "Platform/Locks.h"
+#include "Platform/Thread.h"
+
+#include "Foundation/DynamicArray.h"
+
+#include "EngineJobs/EngineJobs.h"
+
+#include <thread>
+
+namespace Helium
+{
+	/// Job entry point.
+	typedef void JOB_FUNC( void* pData );
+	/// Parallel-for entry point, called once for each sub-range [start, end) of the full index range.
+	typedef void PARALLEL_FOR_FUNC( void* pData, size_t start, size_t end );
+
+	/// Completion counter for a group of jobs.
+	///
+	/// The counter serves as the handle for every job spawned against it.  A running job may spawn child jobs against
+	/// the same counter; since each child is registered before its parent finishes, the counter will not reach zero
+	/// until the entire job tree has completed.
+	class HELIUM_ENGINE_JOBS_API JobCounter : NonCopyable
+	{
+		friend class JobManager;
+
+	public:
+		/// @name Construction/Destruction
+		//@{
+		inline JobCounter();
+		inline ~JobCounter();
+		//@}
+
+		/// @name Data Access
+		//@{
+		inline bool IsDone() const;
+		inline int32_t GetPendingCount() const;
+		//@}
+
+	private:
+		/// Number of jobs spawned against this counter that have not yet completed.
+		volatile int32_t m_pendingCount;
+	};
+
+	/// Work-stealing job scheduler.
+	///
+	/// One worker thread is created for each hardware thread other than the main thread.  Each worker owns a job
+	/// queue; jobs spawned from within a worker are pushed onto its own queue and run in LIFO order, while idle
+	/// workers (and threads blocked in Wait()) steal the oldest jobs from other queues.  If the job manager has not
+	/// been started, all jobs are run immediately on the calling thread.
+	class HELIUM_ENGINE_JOBS_API JobManager : NonCopyable
+	{
+	public:
+		/// Maximum number of jobs that can be queued on a single worker (must be a power of two).
+		static const uint32_t QUEUE_CAPACITY = 1024;
+		/// Maximum number of worker threads.
+		static const uint32_t WORKER_COUNT_MAX = 64;
+		/// Number of parallel-for sub-ranges to target per thread when no grain size is given.
+		static const size_t PARALLEL_FOR_RANGES_PER_THREAD = 4;
+
+		/// @name Initialization
+		//@{
+		bool Initialize( uint32_t workerCount = 0 );
+		void Cleanup();
+		//@}
+
+		/// @name Data Access
+		//@{
+		inline uint32_t GetWorkerCount() const;
+		//@}
+
+		/// @name Job Dispatch
+		//@{
+		static void Spawn( JOB_FUNC* pFunction, void* pData, JobCounter& rCounter );
+		static void Wait( JobCounter& rCounter );
+		static bool TryRunJob();
+		static void ParallelFor( size_t count, size_t grainSize, PARALLEL_FOR_FUNC* pFunction, void* pData );
+		//@}
+
+		/// @name Static Access
+		//@{
+		static JobManager* GetInstance();
+		static void Startup( uint32_t workerCount = 0 );
+		static void Shutdown();
+		//@}
+
+	private:
+		/// Queued job.
+		struct Job
+		{
+			/// Job entry point.
+			JOB_FUNC* pFunction;
+			/// Data to pass to the entry point.
+			void* pData;
+			/// Counter to decrement once the job has completed.
+			JobCounter* pCounter;
+		};
+
+		/// Parallel-for sub-range.
+		struct ParallelForRange
+		{
+			/// User entry point.
+			PARALLEL_FOR_FUNC* pFunction;
+			/// User data.
+			void* pData;
+			/// First index in the range.
+			size_t start;
+			/// One past the last index in the range.
+			size_t end;
+		};
+
+		/// Fixed-capacity double-ended job queue.
+		class JobQueue
+		{
+		public:
+			/// @name Construction/Destruction
+			//@{
+			JobQueue();
+			//@}
+
+			/// @name Queue Operations
+			//@{
+			bool Push( const Job& rJob );
+			bool Pop( Job& rJob );
+			bool Steal( Job& rJob );
+			//@}
+
+		private:
+			/// Queue access lock.
+			SpinLock m_lock;
+			/// Ring buffer of queued jobs.
+			Job m_jobs[ QUEUE_CAPACITY ];
+			/// Index of the oldest queued job (stolen from by other threads).
+			uint32_t m_top;
+			/// Index one past the newest queued job (pushed and popped by the owning worker).
+			uint32_t m_bottom;
+		};
+
+		/// Job worker thread runnable.
+		class JobWorker : public Runnable
+		{
+		public:
+			/// @name Construction/Destruction
+			//@{
+			JobWorker( JobManager* pManager, uint32_t index );
+			virtual ~JobWorker();
+			//@}
+
+			/// @name Runnable Interface
+			//@{
+			virtual void Run();
+			//@}
+
+			/// @name External Thread Control
+			//@{
+			void Stop();
+			bool Wake();
+			//@}
+
+			/// Job queue owned by this worker.
+			JobQueue m_queue;
+			/// Identifier of the thread running this worker (set once the worker starts running).
+			std::thread::id m_threadId;
+			/// Non-zero once the worker thread has started and set its thread ID.
+			volatile int32_t m_startedCounter;
+
+		private:
+			/// Owning job manager.
+			JobManager* m_pManager;
+			/// Index of this worker.
+			uint32_t m_index;
+
+			/// Condition used to wake up the worker thread when jobs are queued (or when it should shut down).
+			Condition m_wakeUpCondition;
+			/// Non-zero if this thread should stop when next possible, zero if it should continue.
+			volatile int32_t m_stopCounter;
+			/// Non-zero if this thread is waiting (or about to wait) on its wake-up condition.
+			volatile int32_t m_sleepingCounter;
+		};
+
+		/// Worker runnables.
+		DynamicArray< JobWorker* > m_workers;
+		/// Worker threads.
+		DynamicArray< RunnableThread* > m_threads;
+		/// Number of jobs currently sitting in a queue.
+		volatile int32_t m_queuedJobCount;
+		/// Round-robin counter for distributing jobs spawned from non-worker threads.
+		volatile int32_t m_nextQueueIndex;
+
+		/// Singleton instance.
+		static JobManager* sm_pInstance;
+
+		/// @name Construction/Destruction
+		//@{
+		JobManager();
+		~JobManager();
+		//@}
+
+		/// @name Private Utility Functions
+		//@{
+		uint32_t GetCurrentWorkerIndex() const;
+		bool FindJob( uint32_t workerIndex, Job& rJob );
+		void WakeWorker();
+
+		static void RunJob( const Job& rJob );
+		static void ParallelForRangeCallback( void* pData );
+		//@}
+	};
+}
+
+#include "EngineJobs/JobManager.inl"
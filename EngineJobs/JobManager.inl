@@ -0,0 +1,42 @@
+namespace Helium
+{
+	/// Constructor.
+	JobCounter::JobCounter()
+		: m_pendingCount( 0 )
+	{
+	}
+
+	/// Destructor.
+	JobCounter::~JobCounter()
+	{
+		HELIUM_ASSERT_MSG( m_pendingCount == 0, TXT( "JobCounter destroyed while jobs are still pending" ) );
+	}
+
+	/// Get whether all jobs spawned against this counter have completed.
+	///
+	/// @return  True if no jobs are pending, false if not.
+	///
+	/// @see GetPendingCount()
+	bool JobCounter::IsDone() const
+	{
+		return ( m_pendingCount == 0 );
+	}
+
+	/// Get the number of jobs spawned against this counter that have not yet completed.
+	///
+	/// @return  Pending job count.
+	///
+	/// @see IsDone()
+	int32_t JobCounter::GetPendingCount() const
+	{
+		return m_pendingCount;
+	}
+
+	/// Get the number of worker threads.
+	///
+	/// @return  Worker thread count.
+	uint32_t JobManager::GetWorkerCount() const
+	{
+		return static_cast< uint32_t >( m_workers.GetSize() );
+	}
+}
@@ -64,9 +64,77 @@ namespace Helium
         }
     }
 
+    /// Sub-range of a parallel quicksort to run as a separate job.
+    template< typename T, typename CompareFunction >
+    struct _QuicksortRange
+    {
+        /// Pointer to the first element to sort.
+        T* pBase;
+        /// Number of elements to sort.
+        size_t count;
+        /// Comparison function object.
+        CompareFunction* pCompare;
+        /// Sub-division size at which to sort the remainder on a single thread.
+        size_t singleJobCount;
+    };
+
+    template< typename T, typename CompareFunction >
+    static void _ParallelQuicksort( T* pBase, size_t count, CompareFunction& rCompare, size_t singleJobCount );
+
+    /// Job callback for sorting a parallel quicksort sub-range.
+    ///
+    /// @param[in] pData  Sub-range to sort.
+    template< typename T, typename CompareFunction >
+    static void _ParallelQuicksortCallback( void* pData )
+    {
+        HELIUM_ASSERT( pData );
+
+        _QuicksortRange< T, CompareFunction >* pRange = static_cast< _QuicksortRange< T, CompareFunction >* >( pData );
+        _ParallelQuicksort( pRange->pBase, pRange->count, *pRange->pCompare, pRange->singleJobCount );
+    }
+
+    /// Recursive quicksort that sorts the lower partition in a separate job while it continues on the upper partition,
+    /// falling back to a single-threaded sort once partitions are small enough.
+    template< typename T, typename CompareFunction >
+    static void _ParallelQuicksort( T* pBase, size_t count, CompareFunction& rCompare, size_t singleJobCount )
+    {
+        HELIUM_ASSERT( pBase );
+
+        if( count <= singleJobCount || count <= 2 )
+        {
+            _Quicksort( pBase, count, rCompare );
+
+            return;
+        }
+
+        size_t pivotIndex = _Partition( pBase, count, rCompare );
+
+        // The child job references data on this stack frame, so we must wait for it before returning.
+        JobCounter counter;
+        _QuicksortRange< T, CompareFunction > lowerRange;
+        if( pivotIndex > 1 )
+        {
+            lowerRange.pBase = pBase;
+            lowerRange.count = pivotIndex;
+            lowerRange.pCompare = &rCompare;
+            lowerRange.singleJobCount = singleJobCount;
+            JobManager::Spawn( _ParallelQuicksortCallback< T, CompareFunction >, &lowerRange, counter );
+        }
+
+        size_t startIndex = pivotIndex + 1;
+        HELIUM_ASSERT( startIndex <= count );
+        size_t partitionSize = count - startIndex;
+        if( partitionSize > 1 )
+        {
+            _ParallelQuicksort( pBase + startIndex, partitionSize, rCompare, singleJobCount );
+        }
+
+        JobManager::Wait( counter );
+    }
+
     /// Recursively sort an array of elements.
     ///
-    /// @param[in] pContext  Context in which this job is running.
+    /// Partitions larger than the single job count are sorted in parallel using the job manager.
     template< typename T, typename CompareFunction >
     void SortJob< T, CompareFunction >::Run()
     {
@@ -80,7 +148,7 @@ namespace Helium
         HELIUM_ASSERT( pBase );
 
         CompareFunction& rCompare = m_parameters.compare;
-        
-		_Quicksort( pBase, count, rCompare );
+
+        _ParallelQuicksort( pBase, count, rCompare, m_parameters.singleJobCount );
     }
 }
@@ -0,0 +1,498 @@
+#include "FrameworkPch.h"
+#include "Framework/ComponentArchetype.h"
+#include "Framework/ComponentQuery.h"
+
+#include "Platform/Atomic.h"
+
+using namespace Helium;
+using namespace Helium::Components;
+
+/// Last query call site ID handed out.
+static volatile int32_t g_LastQueryId = 0;
+
+////////////////////////////////////////////////////////////////////////
+//       Archetype
+////////////////////////////////////////////////////////////////////////
+
+size_t Archetype::FindColumn( TypeId type ) const
+{
+	for ( size_t column = 0; column < m_Types.GetSize(); ++column )
+	{
+		if ( m_Types[ column ] == type )
+		{
+			return column;
+		}
+	}
+
+	return Invalid<size_t>();
+}
+
+////////////////////////////////////////////////////////////////////////
+//       ArchetypeStorage
+////////////////////////////////////////////////////////////////////////
+
+ArchetypeStorage::ArchetypeStorage()
+	: m_IterationDepth( 0 )
+{
+	for ( size_t index = 0; index < MAX_CACHED_QUERIES; ++index )
+	{
+		m_CachedQueries[ index ] = NULL;
+	}
+}
+
+ArchetypeStorage::~ArchetypeStorage()
+{
+	HELIUM_ASSERT( !m_IterationDepth );
+
+	for ( DynamicArray< Archetype * >::Iterator iter = m_Archetypes.Begin();
+		iter != m_Archetypes.End(); ++iter)
+	{
+		delete *iter;
+	}
+
+	m_Archetypes.Clear();
+
+	for ( DynamicArray< ComponentQuery * >::Iterator iter = m_Queries.Begin();
+		iter != m_Queries.End(); ++iter)
+	{
+		delete *iter;
+	}
+
+	m_Queries.Clear();
+}
+
+void ArchetypeStorage::OnCollectionChanged( ComponentCollection &rCollection, TypeId type )
+{
+	MutexScopeLock scopeLock( m_Lock );
+
+	Archetype *pCurrent = rCollection.m_pArchetype;
+	bool collectionHasType = rCollection.m_Components.Find( type ) != rCollection.m_Components.End();
+	bool archetypeHasType = pCurrent && IsValid( pCurrent->FindColumn( type ) );
+
+	if ( m_IterationDepth )
+	{
+		// Keep the rows where they are until the iteration is done, only dropping pointers to freed components
+		if ( pCurrent )
+		{
+			RefreshRow( rCollection );
+		}
+
+		if ( rCollection.m_Components.IsEmpty() )
+		{
+			// The collection may be destroyed before the iteration ends, so let go of it now
+			UnqueueChange( rCollection );
+			if ( pCurrent )
+			{
+				ClearRow( rCollection );
+			}
+		}
+		else if ( collectionHasType != archetypeHasType )
+		{
+			QueueChange( rCollection );
+		}
+
+		return;
+	}
+
+	if ( collectionHasType == archetypeHasType )
+	{
+		// Signature didn't change, but the head of the chain for this type may have
+		if ( pCurrent )
+		{
+			RefreshRow( rCollection );
+		}
+
+		return;
+	}
+
+	Archetype *pTarget = GetArchetypeWithType( pCurrent, type, collectionHasType );
+
+	if ( pCurrent )
+	{
+		RemoveRow( rCollection );
+	}
+
+	// Collections with no components at all are not tracked
+	if ( pTarget )
+	{
+		AddRow( pTarget, rCollection );
+	}
+}
+
+void ArchetypeStorage::RemoveCollection( ComponentCollection &rCollection )
+{
+	MutexScopeLock scopeLock( m_Lock );
+
+	UnqueueChange( rCollection );
+
+	if ( rCollection.m_pArchetype )
+	{
+		if ( m_IterationDepth )
+		{
+			ClearRow( rCollection );
+		}
+		else
+		{
+			RemoveRow( rCollection );
+		}
+	}
+}
+
+void ArchetypeStorage::BeginIteration()
+{
+	// Take the lock so an iteration can't start while a change is halfway through moving rows
+	MutexScopeLock scopeLock( m_Lock );
+
+	++m_IterationDepth;
+}
+
+void ArchetypeStorage::EndIteration()
+{
+	// Likewise the last iteration must finish compacting before the next one can start
+	MutexScopeLock scopeLock( m_Lock );
+
+	HELIUM_ASSERT( m_IterationDepth > 0 );
+	if ( --m_IterationDepth )
+	{
+		return;
+	}
+
+	// Close the holes left by collections that went away, moving rows down from the end
+	for ( DynamicArray< Archetype * >::Iterator iter = m_HoledArchetypes.Begin();
+		iter != m_HoledArchetypes.End(); ++iter)
+	{
+		Archetype &rArchetype = **iter;
+		size_t rowCount = rArchetype.m_Collections.GetSize();
+
+		for ( size_t row = 0; row < rowCount; )
+		{
+			if ( rArchetype.m_Collections[ row ] )
+			{
+				++row;
+				continue;
+			}
+
+			size_t lastRow = --rowCount;
+			if ( row != lastRow )
+			{
+				for ( size_t column = 0; column < rArchetype.m_Columns.GetSize(); ++column )
+				{
+					rArchetype.m_Columns[ column ][ row ] = rArchetype.m_Columns[ column ][ lastRow ];
+				}
+
+				rArchetype.m_Collections[ row ] = rArchetype.m_Collections[ lastRow ];
+				if ( rArchetype.m_Collections[ row ] )
+				{
+					rArchetype.m_Collections[ row ]->m_ArchetypeRow = static_cast< uint32_t >( row );
+				}
+			}
+		}
+
+		for ( size_t column = 0; column < rArchetype.m_Columns.GetSize(); ++column )
+		{
+			rArchetype.m_Columns[ column ].Resize( rowCount );
+		}
+
+		rArchetype.m_Collections.Resize( rowCount );
+		rArchetype.m_HoleCount = 0;
+	}
+
+	m_HoledArchetypes.Resize( 0 );
+
+	// Then move the collections whose signature changed during the iteration
+	for ( DynamicArray< ComponentCollection * >::Iterator iter = m_PendingCollections.Begin();
+		iter != m_PendingCollections.End(); ++iter)
+	{
+		ComponentCollection &rCollection = **iter;
+		rCollection.m_bArchetypeChangePending = false;
+		MoveToSignature( rCollection );
+	}
+
+	m_PendingCollections.Resize( 0 );
+}
+
+ComponentQuery& ArchetypeStorage::GetQuery( const TypeId *types, size_t typesCount )
+{
+	MutexScopeLock scopeLock( m_Lock );
+
+	return FindOrCreateQuery( types, typesCount );
+}
+
+uint32_t ArchetypeStorage::AllocateQueryId()
+{
+	return static_cast< uint32_t >( AtomicIncrement( g_LastQueryId ) - 1 );
+}
+
+ComponentQuery& ArchetypeStorage::CacheQuery( uint32_t queryId, const TypeId *types, size_t typesCount )
+{
+	// Call sites past MAX_CACHED_QUERIES still work, they just search for their query every time
+	MutexScopeLock scopeLock( m_Lock );
+
+	ComponentQuery &rQuery = FindOrCreateQuery( types, typesCount );
+	if ( queryId < MAX_CACHED_QUERIES )
+	{
+		AtomicExchangeRelease( m_CachedQueries[ queryId ], &rQuery );
+	}
+
+	return rQuery;
+}
+
+ComponentQuery& ArchetypeStorage::FindOrCreateQuery( const TypeId *types, size_t typesCount )
+{
+	for ( DynamicArray< ComponentQuery * >::Iterator iter = m_Queries.Begin();
+		iter != m_Queries.End(); ++iter)
+	{
+		if ( ( *iter )->Matches( types, typesCount ) )
+		{
+			return **iter;
+		}
+	}
+
+	ComponentQuery *pQuery = new ComponentQuery( *this, types, typesCount );
+	for ( DynamicArray< Archetype * >::Iterator iter = m_Archetypes.Begin();
+		iter != m_Archetypes.End(); ++iter)
+	{
+		pQuery->OnArchetypeAdded( **iter );
+	}
+
+	m_Queries.Push( pQuery );
+	return *pQuery;
+}
+
+Archetype* ArchetypeStorage::GetArchetypeWithType( Archetype *pFrom, TypeId type, bool add )
+{
+	// Use the cached edge if we've made this transition before
+	if ( pFrom )
+	{
+		Map< TypeId, Archetype * > &rEdges = add ? pFrom->m_AddEdges : pFrom->m_RemoveEdges;
+		Map< TypeId, Archetype * >::Iterator iter = rEdges.Find( type );
+		if ( iter != rEdges.End() )
+		{
+			return iter->Second();
+		}
+	}
+
+	// Build the sorted type list of the destination
+	DynamicArray< TypeId > types;
+	if ( pFrom )
+	{
+		types = pFrom->m_Types;
+	}
+
+	if ( add )
+	{
+		size_t insertIndex = 0;
+		while ( insertIndex < types.GetSize() && types[ insertIndex ] < type )
+		{
+			++insertIndex;
+		}
+
+		types.Insert( insertIndex, type );
+	}
+	else
+	{
+		HELIUM_ASSERT( pFrom );
+		size_t column = pFrom->FindColumn( type );
+		HELIUM_ASSERT( IsValid( column ) );
+		types.Remove( column );
+	}
+
+	Archetype *pTarget = types.IsEmpty() ? NULL : FindOrCreateArchetype( types );
+
+	if ( pFrom )
+	{
+		Map< TypeId, Archetype * > &rEdges = add ? pFrom->m_AddEdges : pFrom->m_RemoveEdges;
+		rEdges.Insert( rEdges.End(), Map< TypeId, Archetype * >::ValueType( type, pTarget ) );
+	}
+
+	return pTarget;
+}
+
+Archetype* ArchetypeStorage::FindOrCreateArchetype( const DynamicArray< TypeId > &rTypes )
+{
+	for ( DynamicArray< Archetype * >::Iterator iter = m_Archetypes.Begin();
+		iter != m_Archetypes.End(); ++iter)
+	{
+		Archetype *pArchetype = *iter;
+		if ( pArchetype->m_Types.GetSize() != rTypes.GetSize() )
+		{
+			continue;
+		}
+
+		bool match = true;
+		for ( size_t column = 0; column < rTypes.GetSize(); ++column )
+		{
+			if ( pArchetype->m_Types[ column ] != rTypes[ column ] )
+			{
+				match = false;
+				break;
+			}
+		}
+
+		if ( match )
+		{
+			return pArchetype;
+		}
+	}
+
+	Archetype *pArchetype = new Archetype();
+	pArchetype->m_Types = rTypes;
+	pArchetype->m_Columns.Resize( rTypes.GetSize() );
+	pArchetype->m_HoleCount = 0;
+	m_Archetypes.Push( pArchetype );
+
+	for ( DynamicArray< ComponentQuery * >::Iterator iter = m_Queries.Begin();
+		iter != m_Queries.End(); ++iter)
+	{
+		( *iter )->OnArchetypeAdded( *pArchetype );
+	}
+
+	return pArchetype;
+}
+
+void ArchetypeStorage::AddRow( Archetype *pArchetype, ComponentCollection &rCollection )
+{
+	HELIUM_ASSERT( !rCollection.m_pArchetype );
+	HELIUM_ASSERT( !m_IterationDepth );
+
+	size_t row = pArchetype->m_Collections.GetSize();
+	pArchetype->m_Collections.Push( &rCollection );
+
+	// Columns keep their capacity when an archetype shrinks, so this only allocates past the high water mark
+	for ( size_t column = 0; column < pArchetype->m_Columns.GetSize(); ++column )
+	{
+		pArchetype->m_Columns[ column ].Push( NULL );
+	}
+
+	rCollection.m_pArchetype = pArchetype;
+	rCollection.m_ArchetypeRow = static_cast< uint32_t >( row );
+
+	RefreshRow( rCollection );
+}
+
+void ArchetypeStorage::RemoveRow( ComponentCollection &rCollection )
+{
+	Archetype *pArchetype = rCollection.m_pArchetype;
+	HELIUM_ASSERT( pArchetype );
+	HELIUM_ASSERT( !m_IterationDepth );
+
+	size_t row = rCollection.m_ArchetypeRow;
+	size_t lastRow = pArchetype->m_Collections.GetSize() - 1;
+
+	// Swap the last row into the hole to keep the rows dense
+	for ( size_t column = 0; column < pArchetype->m_Columns.GetSize(); ++column )
+	{
+		pArchetype->m_Columns[ column ].RemoveSwap( row );
+	}
+
+	pArchetype->m_Collections.RemoveSwap( row );
+	if ( row != lastRow )
+	{
+		pArchetype->m_Collections[ row ]->m_ArchetypeRow = static_cast< uint32_t >( row );
+	}
+
+	rCollection.m_pArchetype = NULL;
+	rCollection.m_ArchetypeRow = Invalid<uint32_t>();
+}
+
+void ArchetypeStorage::RefreshRow( ComponentCollection &rCollection ) const
+{
+	Archetype *pArchetype = rCollection.m_pArchetype;
+	HELIUM_ASSERT( pArchetype );
+
+	size_t row = rCollection.m_ArchetypeRow;
+	for ( size_t column = 0; column < pArchetype->m_Types.GetSize(); ++column )
+	{
+		// Only a collection waiting to move after an iteration can be missing one of its archetype's types
+		Component *pComponent = rCollection.GetFirst( pArchetype->m_Types[ column ] );
+		HELIUM_ASSERT( pComponent || m_IterationDepth );
+		pArchetype->m_Columns[ column ][ row ] = pComponent;
+	}
+}
+
+void ArchetypeStorage::MoveToSignature( ComponentCollection &rCollection )
+{
+	DynamicArray< TypeId > types;
+	types.Reserve( rCollection.m_Components.GetSize() );
+	for ( Map< TypeId, Component * >::ConstIterator iter = rCollection.m_Components.Begin();
+		iter != rCollection.m_Components.End(); ++iter)
+	{
+		size_t insertIndex = 0;
+		while ( insertIndex < types.GetSize() && types[ insertIndex ] < iter->First() )
+		{
+			++insertIndex;
+		}
+
+		types.Insert( insertIndex, iter->First() );
+	}
+
+	Archetype *pTarget = types.IsEmpty() ? NULL : FindOrCreateArchetype( types );
+	if ( pTarget == rCollection.m_pArchetype )
+	{
+		if ( pTarget )
+		{
+			RefreshRow( rCollection );
+		}
+
+		return;
+	}
+
+	if ( rCollection.m_pArchetype )
+	{
+		RemoveRow( rCollection );
+	}
+
+	if ( pTarget )
+	{
+		AddRow( pTarget, rCollection );
+	}
+}
+
+void ArchetypeStorage::QueueChange( ComponentCollection &rCollection )
+{
+	if ( !rCollection.m_bArchetypeChangePending )
+	{
+		rCollection.m_bArchetypeChangePending = true;
+		m_PendingCollections.Push( &rCollection );
+	}
+}
+
+void ArchetypeStorage::UnqueueChange( ComponentCollection &rCollection )
+{
+	if ( !rCollection.m_bArchetypeChangePending )
+	{
+		return;
+	}
+
+	for ( size_t index = 0; index < m_PendingCollections.GetSize(); ++index )
+	{
+		if ( m_PendingCollections[ index ] == &rCollection )
+		{
+			m_PendingCollections.RemoveSwap( index );
+			break;
+		}
+	}
+
+	rCollection.m_bArchetypeChangePending = false;
+}
+
+void ArchetypeStorage::ClearRow( ComponentCollection &rCollection )
+{
+	Archetype *pArchetype = rCollection.m_pArchetype;
+	HELIUM_ASSERT( pArchetype );
+
+	size_t row = rCollection.m_ArchetypeRow;
+	for ( size_t column = 0; column < pArchetype->m_Columns.GetSize(); ++column )
+	{
+		pArchetype->m_Columns[ column ][ row ] = NULL;
+	}
+
+	pArchetype->m_Collections[ row ] = NULL;
+	if ( !pArchetype->m_HoleCount++ )
+	{
+		m_HoledArchetypes.Push( pArchetype );
+	}
+
+	rCollection.m_pArchetype = NULL;
+	rCollection.m_ArchetypeRow = Invalid<uint32_t>();
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "Framework/Framework.h"
+#include "Framework/Components.h"
+
+#include "Platform/Locks.h"
+
+#include "Foundation/DynamicArray.h"
+#include "Foundation/Map.h"
+
+namespace Helium
+{
+	class ComponentQuery;
+
+	namespace Components
+	{
+		//! All component collections that have exactly the same set of component types. Each row holds the first
+		//! component of each type in one collection (further components of the same type are reached through the usual
+		//! GetNextComponent() chain). Columns are stored SoA, one array of component pointers per type, so a query over
+		//! a column is a linear walk through memory. The component data itself stays in the per-type Pool, as handles and
+		//! Pool::GetPool() depend on each component's place in its pool.
+		class HELIUM_FRAMEWORK_API Archetype
+		{
+		public:
+			inline const DynamicArray< TypeId >& GetTypes() const;
+			inline size_t                        GetRowCount() const;
+			inline Component* const*             GetColumn( size_t column ) const;
+			inline ComponentCollection*          GetCollection( size_t row ) const;
+
+			size_t                               FindColumn( TypeId type ) const;
+
+		private:
+			friend class ArchetypeStorage;
+
+			DynamicArray< TypeId >               m_Types;        //< Sorted, one column per type
+			DynamicArray< DynamicArray< Component * > > m_Columns; //< [ column ][ row ], NULL where a row lost the type
+			DynamicArray< ComponentCollection * > m_Collections; //< [ row ], NULL for rows removed during an iteration
+			size_t                               m_HoleCount;    //< Rows removed during an iteration, compacted after it
+
+			// Cached transitions to the archetype with one type added/removed
+			Map< TypeId, Archetype * >           m_AddEdges;
+			Map< TypeId, Archetype * >           m_RemoveEdges;
+		};
+
+		//! Optional per-ComponentManager index that groups component collections by their component signature, so that
+		//! tuple queries can sweep contiguous arrays instead of doing a map lookup per entity. Component memory itself
+		//! stays in the per-type Pool; the archetype rows hold pointers into those pools. The storage is created with
+		//! the ComponentManager when the SystemDefinition enables it, and never afterwards.
+		class HELIUM_FRAMEWORK_API ArchetypeStorage
+		{
+		public:
+			//! Number of query call sites that can have their query cached by ID
+			static const size_t MAX_CACHED_QUERIES = 256;
+
+			ArchetypeStorage();
+			~ArchetypeStorage();
+
+			// Called by the Pool after a component of the given type was added to or removed from a collection
+			void                       OnCollectionChanged( ComponentCollection &rCollection, TypeId type );
+
+			// Stop tracking a collection that is about to have all of its components freed
+			void                       RemoveCollection( ComponentCollection &rCollection );
+
+			// Queries bracket their iteration with these. While any iteration is running, rows are not moved: collections
+			// that change signature stay in their row (with NULL for any type they lost) and move once the last
+			// iteration ends, and removed rows are left as holes and compacted then.
+			void                       BeginIteration();
+			void                       EndIteration();
+
+			// Get the persistent query for the given type tuple, creating it on first use
+			ComponentQuery&            GetQuery( const TypeId *types, size_t typesCount );
+
+			// Same as above, but remembers the query for the call site with the given ID so later calls don't search
+			inline ComponentQuery&     GetQuery( uint32_t queryId, const TypeId *types, size_t typesCount );
+
+			// Hand out a new call site ID for GetQuery()
+			static uint32_t            AllocateQueryId();
+
+			inline size_t              GetArchetypeCount() const;
+			inline const Archetype*    GetArchetype( size_t index ) const;
+
+		private:
+			ComponentQuery&            CacheQuery( uint32_t queryId, const TypeId *types, size_t typesCount );
+			ComponentQuery&            FindOrCreateQuery( const TypeId *types, size_t typesCount );
+			Archetype*                 GetArchetypeWithType( Archetype *pFrom, TypeId type, bool add );
+			Archetype*                 FindOrCreateArchetype( const DynamicArray< TypeId > &rTypes );
+			void                       AddRow( Archetype *pArchetype, ComponentCollection &rCollection );
+			void                       RemoveRow( ComponentCollection &rCollection );
+			void                       RefreshRow( ComponentCollection &rCollection ) const;
+			void                       MoveToSignature( ComponentCollection &rCollection );
+			void                       QueueChange( ComponentCollection &rCollection );
+			void                       UnqueueChange( ComponentCollection &rCollection );
+			void                       ClearRow( ComponentCollection &rCollection );
+
+			DynamicArray< Archetype * > m_Archetypes;
+			DynamicArray< ComponentQuery * > m_Queries;
+			ComponentQuery * volatile   m_CachedQueries[ MAX_CACHED_QUERIES ]; //< Indexed by call site ID, written under m_Lock
+
+			int32_t                     m_IterationDepth;           //< Changed and checked under m_Lock
+			DynamicArray< ComponentCollection * > m_PendingCollections; //< Collections to move once iteration ends
+			DynamicArray< Archetype * > m_HoledArchetypes;              //< Archetypes to compact once iteration ends
+
+			// Pools of different types may allocate and free in parallel tasks, and queries may be requested from any of
+			// them, so every change to the archetypes, rows and queries is made under this lock, as is every change to the
+			// iteration depth. Iterations read rows without it, which is safe because rows are only moved or compacted while
+			// holding the lock with no iteration running.
+			Mutex                       m_Lock;
+		};
+	}
+}
+
+#include "Framework/ComponentArchetype.inl"
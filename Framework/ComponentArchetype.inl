@@ -0,0 +1,43 @@
+
+namespace Helium
+{
+	namespace Components
+	{
+		const DynamicArray< TypeId >& Archetype::GetTypes() const
+		{
+			return m_Types;
+		}
+
+		size_t Archetype::GetRowCount() const
+		{
+			return m_Collections.GetSize();
+		}
+
+		Component* const* Archetype::GetColumn( size_t column ) const
+		{
+			return m_Columns[ column ].GetData();
+		}
+
+		ComponentCollection* Archetype::GetCollection( size_t row ) const
+		{
+			return m_Collections[ row ];
+		}
+
+		ComponentQuery& ArchetypeStorage::GetQuery( uint32_t queryId, const TypeId *types, size_t typesCount )
+		{
+			// Queries are never destroyed before the storage, so once a slot is set it can be read without the lock
+			ComponentQuery *pQuery = queryId < MAX_CACHED_QUERIES ? m_CachedQueries[ queryId ] : NULL;
+			return pQuery ? *pQuery : CacheQuery( queryId, types, typesCount );
+		}
+
+		size_t ArchetypeStorage::GetArchetypeCount() const
+		{
+			return m_Archetypes.GetSize();
+		}
+
+		const Archetype* ArchetypeStorage::GetArchetype( size_t index ) const
+		{
+			return m_Archetypes[ index ];
+		}
+	}
+}
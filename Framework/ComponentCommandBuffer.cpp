@@ -0,0 +1,94 @@
+#include "FrameworkPch.h"
+#include "Framework/ComponentCommandBuffer.h"
+
+using namespace Helium;
+
+ComponentCommandBuffer::ComponentCommandBuffer()
+{
+
+}
+
+void ComponentCommandBuffer::Allocate( Components::TypeId type, Components::IHasComponents *pOwner, ComponentCollection &rCollection, Callback callback, const void *pData, size_t dataSize )
+{
+	Command &rCommand = AddCommand( COMMAND_ALLOCATE, callback, pData, dataSize );
+	rCommand.m_ComponentType = type;
+	rCommand.m_pOwner = pOwner;
+	rCommand.m_pCollection = &rCollection;
+}
+
+void ComponentCommandBuffer::Free( Component *pComponent )
+{
+	HELIUM_ASSERT( pComponent );
+
+	Command &rCommand = AddCommand( COMMAND_FREE, NULL, NULL, 0 );
+	rCommand.m_Handle = pComponent->GetHandle();
+}
+
+void ComponentCommandBuffer::Call( Callback callback, const void *pData, size_t dataSize )
+{
+	HELIUM_ASSERT( callback );
+	AddCommand( COMMAND_CALL, callback, pData, dataSize );
+}
+
+void ComponentCommandBuffer::Execute( ComponentManager &rManager )
+{
+	for ( DynamicArray< Command >::Iterator iter = m_Commands.Begin();
+		iter != m_Commands.End(); ++iter)
+	{
+		void *pData = IsValid( iter->m_DataOffset ) ? m_Data.GetData() + iter->m_DataOffset : NULL;
+
+		switch ( iter->m_Type )
+		{
+		case COMMAND_ALLOCATE:
+			{
+				Component *pComponent = rManager.Allocate( iter->m_ComponentType, iter->m_pOwner, *iter->m_pCollection );
+				if ( pComponent && iter->m_Callback )
+				{
+					iter->m_Callback( pComponent, pData );
+				}
+			}
+			break;
+
+		case COMMAND_FREE:
+			{
+				// Several ranges may have asked to free the same component, so an earlier command may have already freed it
+				Component *pComponent = Components::Pool::ResolveHandle( iter->m_Handle );
+				if ( pComponent )
+				{
+					pComponent->FreeComponent();
+				}
+			}
+			break;
+
+		case COMMAND_CALL:
+			iter->m_Callback( NULL, pData );
+			break;
+		}
+	}
+
+	Clear();
+}
+
+ComponentCommandBuffer::Command& ComponentCommandBuffer::AddCommand( CommandType type, Callback callback, const void *pData, size_t dataSize )
+{
+	Command &rCommand = *m_Commands.New();
+	rCommand.m_Type = type;
+	rCommand.m_ComponentType = Invalid< Components::TypeId >();
+	rCommand.m_Handle = 0;
+	rCommand.m_pOwner = NULL;
+	rCommand.m_pCollection = NULL;
+	rCommand.m_Callback = callback;
+	rCommand.m_DataOffset = Invalid< size_t >();
+
+	if ( dataSize )
+	{
+		HELIUM_ASSERT( pData );
+
+		size_t offset = ( m_Data.GetSize() + DATA_ALIGNMENT - 1 ) & ~( DATA_ALIGNMENT - 1 );
+		m_Data.Resize( offset + dataSize );
+		MemoryCopy( m_Data.GetData() + offset, pData, dataSize );
+		rCommand.m_DataOffset = offset;
+	}
+
+	return rCommand;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Framework/Framework.h"
+#include "Framework/Components.h"
+
+#include "Foundation/DynamicArray.h"
+
+namespace Helium
+{
+	//! Records structural changes (component allocation, freeing, and arbitrary callbacks) so they can be made later from
+	//! a single thread. Used by parallel component passes, where each range of the pass records into its own buffer and
+	//! the buffers are executed in range order once every range has finished.
+	class HELIUM_FRAMEWORK_API ComponentCommandBuffer
+	{
+	public:
+		//! Callback run when the buffer is executed. pComponent is the newly allocated component for Allocate() commands
+		//! and NULL for Call() commands. pData points to a copy of the data given when the command was recorded.
+		typedef void (*Callback)( Component *pComponent, void *pData );
+
+		ComponentCommandBuffer();
+
+		void                  Allocate( Components::TypeId type, Components::IHasComponents *pOwner, ComponentCollection &rCollection, Callback callback = NULL, const void *pData = NULL, size_t dataSize = 0 );
+		void                  Free( Component *pComponent );
+		void                  Call( Callback callback, const void *pData = NULL, size_t dataSize = 0 );
+
+		template <class T> void AllocateSibling( Component *pSibling, Callback callback = NULL, const void *pData = NULL, size_t dataSize = 0 )
+		{
+			Allocate( Components::GetType<T>(), pSibling->GetOwner(), *pSibling->GetComponentCollection(), callback, pData, dataSize );
+		}
+
+		void                  Execute( ComponentManager &rManager );
+		inline bool           IsEmpty() const;
+		inline void           Clear();
+
+	private:
+		static const size_t DATA_ALIGNMENT = 16;
+
+		enum CommandType
+		{
+			COMMAND_ALLOCATE,
+			COMMAND_FREE,
+			COMMAND_CALL,
+		};
+
+		struct Command
+		{
+			CommandType                  m_Type;
+			Components::TypeId           m_ComponentType;
+			Components::Handle           m_Handle;
+			Components::IHasComponents*  m_pOwner;
+			ComponentCollection*         m_pCollection;
+			Callback                     m_Callback;
+			size_t                       m_DataOffset;
+		};
+
+		Command&                 AddCommand( CommandType type, Callback callback, const void *pData, size_t dataSize );
+
+		DynamicArray< Command >  m_Commands;
+		DynamicArray< uint8_t >  m_Data;  //< Copies of the callback data, each aligned to DATA_ALIGNMENT
+	};
+}
+
+#include "Framework/ComponentCommandBuffer.inl"
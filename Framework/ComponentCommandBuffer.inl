@@ -0,0 +1,14 @@
+
+namespace Helium
+{
+	bool ComponentCommandBuffer::IsEmpty() const
+	{
+		return m_Commands.IsEmpty();
+	}
+
+	void ComponentCommandBuffer::Clear()
+	{
+		m_Commands.Resize( 0 );
+		m_Data.Resize( 0 );
+	}
+}
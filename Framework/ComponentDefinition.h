@@ -27,6 +27,10 @@ namespace Helium
 		// Implemented by child classes to finish setting up the component.
 		inline virtual void FinalizeComponent() const;
 
+		// Type of component CreateComponentInternal() allocates, or invalid if unknown. Used to reserve pool space
+		// before spawning many entities at once
+		inline virtual Components::TypeId GetComponentType() const;
+
 		// Gets the component that this definition generated previously
 		inline Helium::Component *GetCreatedComponent() const;
 
@@ -50,6 +54,11 @@ namespace Helium
 			return c;
 		}
 
+		virtual Components::TypeId GetComponentType() const
+		{
+			return Components::GetType<ComponentT>();
+		}
+
 		virtual void FinalizeComponent() const
 		{
 
@@ -69,6 +78,11 @@ namespace Helium
 			return c;
 		}
 
+		virtual Components::TypeId GetComponentType() const
+		{
+			return Components::GetType<ComponentT>();
+		}
+
 		virtual void FinalizeComponent() const
 		{
 			Component *c = GetCreatedComponent();
@@ -89,6 +103,11 @@ namespace Helium
 			return c;
 		}
 
+		virtual Components::TypeId GetComponentType() const
+		{
+			return Components::GetType<ComponentT>();
+		}
+
 		virtual void FinalizeComponent() const
 		{
 			Component *c = GetCreatedComponent();
@@ -16,6 +16,11 @@ namespace Helium
     void ComponentDefinition::FinalizeComponent() const 
     { 
     }
+
+    Components::TypeId ComponentDefinition::GetComponentType() const
+    {
+        return Invalid< Components::TypeId >();
+    }
         
     Helium::Component *ComponentDefinition::GetCreatedComponent() const 
     { 
@@ -0,0 +1,140 @@
+#include "FrameworkPch.h"
+#include "Framework/ComponentLayout.h"
+
+using namespace Helium;
+using namespace Helium::Components;
+
+#define PAD_VALUE( _VALUE , _PAD ) ((_VALUE + (_PAD-1)) & (~(_PAD-1)))
+
+// Reflected fields of the type and all of its bases, sorted by offset
+static void GetFieldsByOffset( const Reflect::MetaStruct *pStructure, DynamicArray< const Reflect::Field * > &rFields )
+{
+	for ( const Reflect::MetaStruct *pCurrent = pStructure; pCurrent; pCurrent = pCurrent->m_Base )
+	{
+		for (DynamicArray< Reflect::Field >::ConstIterator iter = pCurrent->m_Fields.Begin();
+			iter != pCurrent->m_Fields.End(); ++iter)
+		{
+			size_t index = rFields.GetSize();
+			while ( index > 0 && rFields[ index - 1 ]->m_Offset > iter->m_Offset )
+			{
+				--index;
+			}
+
+			rFields.Insert( index, &*iter );
+		}
+	}
+}
+
+bool Components::GetMemoryLayout( TypeId type, MemoryLayout &rLayout )
+{
+	const TypeData *pTypeData = GetTypeData( type );
+	HELIUM_ASSERT( pTypeData );
+
+	if ( !pTypeData || !pTypeData->m_Structure || !pTypeData->GetSize() )
+	{
+		return false;
+	}
+
+	rLayout.m_TypeData = pTypeData;
+	rLayout.m_Size = pTypeData->GetSize();
+	rLayout.m_Stride = PAD_VALUE( rLayout.m_Size, HELIUM_SIMD_ALIGNMENT );
+	rLayout.m_HeaderSize = pTypeData->GetOffsetOfComponent() + sizeof( Component );
+	rLayout.m_FieldSize = 0;
+	rLayout.m_HotFieldSize = 0;
+	rLayout.m_HotSpan = 0;
+	rLayout.m_PoolPadding = rLayout.m_Stride - rLayout.m_Size;
+	rLayout.m_CacheLines = ( rLayout.m_Stride + LAYOUT_CACHE_LINE_SIZE - 1 ) / LAYOUT_CACHE_LINE_SIZE;
+
+	DynamicArray< const Reflect::Field * > fields;
+	GetFieldsByOffset( pTypeData->m_Structure, fields );
+
+	size_t hotBegin = Invalid< size_t >();
+	size_t hotEnd = 0;
+
+	for (DynamicArray< const Reflect::Field * >::ConstIterator iter = fields.Begin(); iter != fields.End(); ++iter)
+	{
+		const Reflect::Field *pField = *iter;
+		size_t fieldSize = pField->m_Size * pField->m_Count;
+		rLayout.m_FieldSize += fieldSize;
+
+		if ( pField->m_Flags & FIELD_FLAG_HOT )
+		{
+			rLayout.m_HotFieldSize += fieldSize;
+			hotBegin = Min< size_t >( hotBegin, pField->m_Offset );
+			hotEnd = Max< size_t >( hotEnd, pField->m_Offset + fieldSize );
+		}
+	}
+
+	if ( IsValid( hotBegin ) )
+	{
+		rLayout.m_HotSpan = hotEnd - hotBegin;
+	}
+
+	size_t accounted = rLayout.m_HeaderSize + rLayout.m_FieldSize;
+	rLayout.m_GapSize = ( accounted < rLayout.m_Size ) ? rLayout.m_Size - accounted : 0;
+
+	return true;
+}
+
+void Components::ReportMemoryLayout()
+{
+	HELIUM_TRACE(
+		TraceLevels::Info,
+		"Components::ReportMemoryLayout - size/stride/header/fields/hot/gap/pad bytes, cache lines per component, hot density\n");
+
+	for ( TypeId type = 0; type < GetTypeCount(); ++type )
+	{
+		MemoryLayout layout;
+		if ( !GetMemoryLayout( type, layout ) )
+		{
+			continue;
+		}
+
+		// Fraction of the bytes a linear walk pulls through the cache that hot loops actually use
+		float32_t hotDensity = static_cast< float32_t >( layout.m_HotFieldSize ) / static_cast< float32_t >( layout.m_Stride );
+
+		HELIUM_TRACE(
+			( layout.m_HotFieldSize && layout.m_HotSpan > LAYOUT_CACHE_LINE_SIZE ) ? TraceLevels::Warning : TraceLevels::Info,
+			"  %-40s %5" PRIuSZ " %5" PRIuSZ " %4" PRIuSZ " %5" PRIuSZ " %5" PRIuSZ " %5" PRIuSZ " %3" PRIuSZ "  %2" PRIuSZ " lines  %3.0f%% hot%s\n",
+			layout.m_TypeData->m_Structure->m_Name,
+			layout.m_Size,
+			layout.m_Stride,
+			layout.m_HeaderSize,
+			layout.m_FieldSize,
+			layout.m_HotFieldSize,
+			layout.m_GapSize,
+			layout.m_PoolPadding,
+			layout.m_CacheLines,
+			hotDensity * 100.0f,
+			( layout.m_HotFieldSize && layout.m_HotSpan > LAYOUT_CACHE_LINE_SIZE ) ? " (hot fields span more than one cache line, group them together)" : "");
+
+		DynamicArray< const Reflect::Field * > fields;
+		GetFieldsByOffset( layout.m_TypeData->m_Structure, fields );
+
+		size_t offset = layout.m_HeaderSize;
+		for (DynamicArray< const Reflect::Field * >::ConstIterator iter = fields.Begin(); iter != fields.End(); ++iter)
+		{
+			const Reflect::Field *pField = *iter;
+
+			if ( pField->m_Offset > offset )
+			{
+				HELIUM_TRACE( TraceLevels::Debug, "    %5" PRIuSZ "  %4" PRIuSZ "  <gap>\n", offset, static_cast< size_t >( pField->m_Offset - offset ) );
+			}
+
+			HELIUM_TRACE(
+				TraceLevels::Debug,
+				"    %5" PRIuSZ "  %4" PRIuSZ "  %s%s\n",
+				static_cast< size_t >( pField->m_Offset ),
+				static_cast< size_t >( pField->m_Size * pField->m_Count ),
+				pField->m_Name,
+				( pField->m_Flags & FIELD_FLAG_HOT ) ? " [hot]" : "");
+
+			offset = Max< size_t >( offset, pField->m_Offset + pField->m_Size * pField->m_Count );
+		}
+
+		if ( offset < layout.m_Stride )
+		{
+			HELIUM_TRACE( TraceLevels::Debug, "    %5" PRIuSZ "  %4" PRIuSZ "  <gap>\n", offset, layout.m_Stride - offset );
+		}
+	}
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Framework/Framework.h"
+#include "Framework/Components.h"
+
+namespace Helium
+{
+	namespace Components
+	{
+		//! Set in Reflect::Field::m_Flags (above the bits Reflect uses) to mark a component field as read or written by
+		//! per-frame passes. Hot fields are what the memory layout report measures cache usage against:
+		//!   comp.AddField( &TransformComponent::m_Position, "m_Position", Components::FIELD_FLAG_HOT );
+		const static uint32_t FIELD_FLAG_HOT = 1u << 31;
+
+		//! Size of the cache line the layout report measures against
+		const static size_t LAYOUT_CACHE_LINE_SIZE = 64;
+
+		//! How a component type is laid out in its pool. Components only reflect some of their fields, so bytes that
+		//! aren't the header or a reflected field are reported as gaps: compiler padding or unreflected members.
+		struct HELIUM_FRAMEWORK_API MemoryLayout
+		{
+			const TypeData* m_TypeData;
+			size_t          m_Size;             //< sizeof the component
+			size_t          m_Stride;           //< Distance between neighbouring components in a pool
+			size_t          m_HeaderSize;       //< vtable (if any) and DataInline bookkeeping ahead of the payload
+			size_t          m_FieldSize;        //< Bytes in reflected fields
+			size_t          m_HotFieldSize;     //< Bytes in reflected fields flagged FIELD_FLAG_HOT
+			size_t          m_HotSpan;          //< Bytes from the start of the first hot field to the end of the last
+			size_t          m_GapSize;          //< Bytes within the component not covered by the header or reflected fields
+			size_t          m_PoolPadding;      //< Bytes added after each component to keep the next one aligned
+			size_t          m_CacheLines;       //< Cache lines a linear walk over a pool touches per component (rounded up)
+		};
+
+		//! Compute the layout of a registered component type. Returns false for types with no pool storage.
+		HELIUM_FRAMEWORK_API bool GetMemoryLayout( TypeId type, MemoryLayout &rLayout );
+
+		//! Trace the layout of every registered component type, and at debug level every reflected field with the gaps
+		//! between them, so wasted space and poorly packed hot data can be spotted.
+		HELIUM_FRAMEWORK_API void ReportMemoryLayout();
+	}
+}
@@ -1,12 +1,51 @@
-
 #include "FrameworkPch.h"
 #include "Framework/ComponentQuery.h"
-#include <limits>
-#include <vector>
+
+#include "EngineJobs/JobManager.h"
 
 using namespace Helium;
 
-struct FoundComponentList
+// Adapts the ComponentTupleCallback interface to ComponentQuery::ForEach
+struct LegacyTupleHandler
+{
+	DynamicArray<Component *> m_Tuple;
+	ComponentTupleCallback m_Callback;
+
+	void operator()( Component * const *tuple )
+	{
+		for (size_t index = 0; index < m_Tuple.GetSize(); ++index)
+		{
+			m_Tuple[index] = tuple[index];
+		}
+
+		m_Callback(m_Tuple);
+	}
+};
+
+void Helium::QueryComponentsInternal(ComponentManager &rManager, const Components::TypeId *types, size_t typesCount, ComponentTupleCallback emit_tuple_callback)
+{
+	// If no types to query, do nothing
+	if (!typesCount)
+	{
+		return;
+	}
+
+	LegacyTupleHandler handler;
+	handler.m_Tuple.Resize(typesCount);
+	handler.m_Callback = emit_tuple_callback;
+
+	Components::ArchetypeStorage *pArchetypeStorage = rManager.GetArchetypeStorage();
+	if ( pArchetypeStorage )
+	{
+		pArchetypeStorage->GetQuery( types, typesCount ).ForEach( handler );
+	}
+	else
+	{
+		QueryComponentsUnindexed( rManager, types, typesCount, InvokeTupleHandler< LegacyTupleHandler >, &handler );
+	}
+}
+
+struct UnindexedQueryType
 {
 	Component *m_Component;
 	size_t m_TypeIndex;
@@ -14,50 +53,39 @@ struct FoundComponentList
 	Components::TypeId m_TypeId;
 };
 
-bool SortFoundComponentList(const FoundComponentList &lhs, const FoundComponentList &rhs)
-{
-	return lhs.m_Count < rhs.m_Count;
-}
-
-void EmitTuples(DynamicArray<Component *> &tuple, std::vector<FoundComponentList> &found_components, size_t type_index, ComponentTupleCallback emit_tuple_callback)
+static void EmitUnindexedTuples(Component **tuple, const UnindexedQueryType *found_components, size_t typesCount, size_t order, ComponentTupleDataCallback callback, void *pData)
 {
-	Component *c = found_components[ type_index ].m_Component;
+	Component *c = found_components[ order ].m_Component;
 	HELIUM_ASSERT( c );
 	do
 	{
-		tuple[found_components[type_index].m_TypeIndex] = c;
-		
-		if (type_index < found_components.size() - 1)
+		tuple[ found_components[ order ].m_TypeIndex ] = c;
+
+		if ( order + 1 < typesCount )
 		{
-			EmitTuples(tuple, found_components, ++type_index, emit_tuple_callback);
+			EmitUnindexedTuples( tuple, found_components, typesCount, order + 1, callback, pData );
 		}
 		else
 		{
-			emit_tuple_callback(tuple);
+			callback( tuple, pData );
 		}
-	} 
+	}
 	while ( ( c = c->GetNextComponent() ) );
 }
 
-void Helium::QueryComponentsInternal(ComponentManager &rManager, const Components::TypeId *types, size_t typesCount, ComponentTupleCallback emit_tuple_callback)
+void Helium::QueryComponentsUnindexed(ComponentManager &rManager, const Components::TypeId *types, size_t typesCount, ComponentTupleDataCallback callback, void *pData)
 {
-	// If no types to query, do nothing
-	if (!typesCount)
-	{
-		return;
-	}
-	
-	// Prepare the structure that will help us emit all permutations of found components
-	std::vector<FoundComponentList> found_components;
-	found_components.resize(typesCount);
-	
-	// Find the component with the least instances
+	HELIUM_ASSERT( typesCount > 0 && typesCount <= ComponentQuery::MAX_TYPES );
+
+	UnindexedQueryType found_components[ ComponentQuery::MAX_TYPES ];
+
 	for (size_t index = 0; index < typesCount; ++index)
 	{
+		found_components[index].m_Component = NULL;
 		found_components[index].m_TypeIndex = index;
 		found_components[index].m_TypeId = types[index];
 		found_components[index].m_Count = rManager.CountAllocatedComponentsThatImplement(types[index]);
-		
+
 		// Bail if any component type doesn't exist
 		if (!found_components[index].m_Count)
 		{
@@ -65,39 +93,182 @@ void Helium::QueryComponentsInternal(ComponentManager &rManager, const Component
 		}
 	}
 
-	// Sort the types by commonality
-	std::sort(found_components.begin(), found_components.end(), SortFoundComponentList);
-	
+	// Sort the types by commonality so the rarest type drives the walk
+	for (size_t index = 1; index < typesCount; ++index)
+	{
+		UnindexedQueryType type = found_components[index];
+		size_t insert_index = index;
+		for ( ; insert_index > 0 && found_components[insert_index - 1].m_Count > type.m_Count; --insert_index)
+		{
+			found_components[insert_index] = found_components[insert_index - 1];
+		}
+
+		found_components[insert_index] = type;
+	}
+
 	const DynamicArray< Components::TypeId > &implementing_types = Components::GetTypeData( found_components[0].m_TypeId )->m_ImplementingTypes;
-	
-	// For every component
+
+	Component *tuple[ ComponentQuery::MAX_TYPES ];
 	for ( ComponentIteratorBase iterator(rManager, implementing_types); iterator.GetBaseComponent(); iterator.Advance() )
 	{
 		Component *outer_component = iterator.GetBaseComponent();
 
-		found_components[0].m_Component = outer_component;
-
 		ComponentCollection *collection = outer_component->GetComponentCollection();
 		HELIUM_ASSERT(collection);
-		
+
 		// Walk the other types we need components of
 		bool emit_tuples = true;
-		for (size_t type_index = 1; type_index < found_components.size(); ++type_index)
+		for (size_t order = 1; order < typesCount; ++order)
 		{
-			found_components[type_index].m_Component = collection->GetFirst( found_components[type_index].m_TypeId );
-			if ( !found_components[type_index].m_Component )
+			found_components[order].m_Component = collection->GetFirst( found_components[order].m_TypeId );
+			if ( !found_components[order].m_Component )
 			{
 				emit_tuples = false;
 				break;
 			}
 		}
-		
-		if (emit_tuples)
+
+		if (!emit_tuples)
+		{
+			continue;
+		}
+
+		tuple[found_components[0].m_TypeIndex] = outer_component;
+		if ( typesCount > 1 )
+		{
+			EmitUnindexedTuples( tuple, found_components, typesCount, 1, callback, pData );
+		}
+		else
+		{
+			callback( tuple, pData );
+		}
+	}
+}
+
+// Number of roster entries that fit in a cache line, parallel ranges are a multiple of this so no two ranges share one
+static const size_t PARALLEL_RANGE_ALIGNMENT = 64 / sizeof( Component * );
+// Smallest range worth handing to another thread
+static const size_t PARALLEL_RANGE_MIN_SIZE = 8 * PARALLEL_RANGE_ALIGNMENT;
+
+struct ParallelForEachComponentData
+{
+	Component * const *m_pComponents;
+	ComponentCommandBuffer *m_pCommandBuffers;
+	size_t m_GrainSize;
+	ComponentRangeCallback m_Callback;
+	void *m_pCallbackData;
+};
+
+static void ParallelForEachComponentRange( void *pData, size_t start, size_t end )
+{
+	ParallelForEachComponentData &rData = *static_cast< ParallelForEachComponentData * >( pData );
+	rData.m_Callback( rData.m_pComponents + start, end - start, rData.m_pCommandBuffers[ start / rData.m_GrainSize ], rData.m_pCallbackData );
+}
+
+void Helium::ParallelForEachComponentInternal(ComponentManager &rManager, Components::TypeId type, ComponentRangeCallback callback, void *pData)
+{
+	const DynamicArray< Components::TypeId > &implementing_types = Components::GetTypeData( type )->m_ImplementingTypes;
+
+	JobManager *pJobManager = JobManager::GetInstance();
+	size_t threadCount = ( pJobManager ? pJobManager->GetWorkerCount() : 0 ) + 1;
+
+	// One command buffer per range, across all pools, so the buffers can be executed in a deterministic order
+	DynamicArray< ComponentCommandBuffer > command_buffers;
+
+	for (DynamicArray< Components::TypeId >::ConstIterator iter = implementing_types.Begin(); iter != implementing_types.End(); ++iter)
+	{
+		const Components::Pool *pPool = rManager.GetPool( *iter );
+		if ( !pPool || !pPool->GetAllocatedCount() )
+		{
+			continue;
+		}
+
+		size_t count = pPool->GetAllocatedCount();
+		size_t grain_size = ( count + threadCount * JobManager::PARALLEL_FOR_RANGES_PER_THREAD - 1 ) / ( threadCount * JobManager::PARALLEL_FOR_RANGES_PER_THREAD );
+		grain_size = Max( grain_size, PARALLEL_RANGE_MIN_SIZE );
+		grain_size = ( grain_size + PARALLEL_RANGE_ALIGNMENT - 1 ) & ~( PARALLEL_RANGE_ALIGNMENT - 1 );
+
+		size_t range_count = ( count + grain_size - 1 ) / grain_size;
+		size_t first_buffer = command_buffers.GetSize();
+		command_buffers.Resize( first_buffer + range_count );
+
+		ParallelForEachComponentData data;
+		data.m_pComponents = pPool->GetAllocatedComponents();
+		data.m_pCommandBuffers = command_buffers.GetData() + first_buffer;
+		data.m_GrainSize = grain_size;
+		data.m_Callback = callback;
+		data.m_pCallbackData = pData;
+
+		JobManager::ParallelFor( count, grain_size, ParallelForEachComponentRange, &data );
+	}
+
+	for (DynamicArray< ComponentCommandBuffer >::Iterator iter = command_buffers.Begin(); iter != command_buffers.End(); ++iter)
+	{
+		iter->Execute( rManager );
+	}
+}
+
+ComponentQuery::ComponentQuery( Components::ArchetypeStorage &rStorage, const Components::TypeId *types, size_t typesCount )
+	: m_pStorage( &rStorage )
+	, m_TypeCount( typesCount )
+{
+	HELIUM_ASSERT( typesCount > 0 );
+	HELIUM_ASSERT( typesCount <= MAX_TYPES );
+
+	for ( size_t index = 0; index < typesCount; ++index )
+	{
+		m_Types[ index ] = types[ index ];
+	}
+}
+
+bool ComponentQuery::Matches( const Components::TypeId *types, size_t typesCount ) const
+{
+	if ( typesCount != m_TypeCount )
+	{
+		return false;
+	}
+
+	for ( size_t index = 0; index < typesCount; ++index )
+	{
+		if ( m_Types[ index ] != types[ index ] )
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void ComponentQuery::OnArchetypeAdded( const Components::Archetype &rArchetype )
+{
+	ArchetypeMatch match;
+	match.m_pArchetype = &rArchetype;
+
+	uint16_t columnCount = 0;
+
+	// Every queried type must be implemented by at least one of the archetype's columns
+	for ( size_t typeIndex = 0; typeIndex < m_TypeCount; ++typeIndex )
+	{
+		match.m_ColumnStarts[ typeIndex ] = columnCount;
+
+		const DynamicArray< Components::TypeId > &rImplementingTypes = Components::GetTypeData( m_Types[ typeIndex ] )->m_ImplementingTypes;
+		for ( DynamicArray< Components::TypeId >::ConstIterator iter = rImplementingTypes.Begin();
+			iter != rImplementingTypes.End(); ++iter)
+		{
+			size_t column = rArchetype.FindColumn( *iter );
+			if ( IsValid( column ) )
+			{
+				HELIUM_ASSERT( columnCount < MAX_MATCH_COLUMNS );
+				match.m_Columns[ columnCount++ ] = static_cast< uint16_t >( column );
+			}
+		}
+
+		match.m_ColumnCounts[ typeIndex ] = columnCount - match.m_ColumnStarts[ typeIndex ];
+		if ( !match.m_ColumnCounts[ typeIndex ] )
 		{
-			DynamicArray<Component *> tuple;
-			tuple.Resize(typesCount);
-			tuple[found_components[0].m_TypeIndex] = outer_component;
-			EmitTuples(tuple, found_components, 1, emit_tuple_callback);
+			return;
 		}
 	}
+
+	m_Matches.Push( match );
 }
@@ -1,30 +1,178 @@
-
 #pragma once
 
 #include "Framework/Framework.h"
 #include "Foundation/DynamicArray.h"
 #include "Framework/Components.h"
+#include "Framework/ComponentArchetype.h"
+#include "Framework/ComponentCommandBuffer.h"
 
 namespace Helium
 {
 	typedef void (*ComponentTupleCallback)(DynamicArray<Component *> &tuple);
-	
+
 	void HELIUM_FRAMEWORK_API QueryComponentsInternal(ComponentManager &rManager, const Components::TypeId *types, size_t typesCount, ComponentTupleCallback callback);
-	
-	template <class A, class B, void (*F)(A *, B *)>
-	void TupleHandler(DynamicArray<Component *> &components)
+
+	typedef void (*ComponentTupleDataCallback)( Component * const *tuple, void *pData );
+
+	//! Calls callback for every tuple of components sharing a collection by looking up each collection's components,
+	//! starting from the rarest type. Used when the manager has no archetype storage.
+	void HELIUM_FRAMEWORK_API QueryComponentsUnindexed(ComponentManager &rManager, const Components::TypeId *types, size_t typesCount, ComponentTupleDataCallback callback, void *pData);
+
+	template <class Handler>
+	void InvokeTupleHandler( Component * const *tuple, void *pData )
 	{
-		F(
-			static_cast<A *>(components[0]), 
-			static_cast<B *>(components[1]));
+		( *static_cast< Handler * >( pData ) )( tuple );
 	}
-	
-	template <class A, class B, class C, void (*F)(A *, B *, C *)>
-	void TupleHandler(DynamicArray<Component *> &components)
+
+	typedef void (*ComponentRangeCallback)(Component * const *ppComponents, size_t count, ComponentCommandBuffer &rCommandBuffer, void *pData);
+
+	//! Runs the callback across the job manager's threads over cache line aligned ranges of every pool implementing the
+	//! given type. Each range records structural changes into its own command buffer; the buffers are executed in range
+	//! order on the calling thread once the whole pass is complete. pData is passed to every call of the callback.
+	void HELIUM_FRAMEWORK_API ParallelForEachComponentInternal(ComponentManager &rManager, Components::TypeId type, ComponentRangeCallback callback, void *pData);
+
+	template <class T, void (*F)(T *, ComponentCommandBuffer &)>
+	void ComponentRangeHandler(Component * const *ppComponents, size_t count, ComponentCommandBuffer &rCommandBuffer, void *)
 	{
-		F(
-			static_cast<A *>(components[0]), 
-			static_cast<B *>(components[1]), 
-			static_cast<C *>(components[2]));
+		for (size_t index = 0; index < count; ++index)
+		{
+			F( static_cast<T *>(ppComponents[index]), rCommandBuffer );
+		}
 	}
+
+	//! Same as ComponentRangeHandler, with pData being the Context shared by every range
+	template <class T, class Context, void (*F)(Context &, T *, ComponentCommandBuffer &)>
+	void ComponentRangeContextHandler(Component * const *ppComponents, size_t count, ComponentCommandBuffer &rCommandBuffer, void *pData)
+	{
+		Context &rContext = *static_cast< Context * >( pData );
+		for (size_t index = 0; index < count; ++index)
+		{
+			F( rContext, static_cast<T *>(ppComponents[index]), rCommandBuffer );
+		}
+	}
+
+	//! Persistent query for all tuples of components (one component implementing each queried type) that share a component
+	//! collection. Queries are created once per type tuple by the ArchetypeStorage and kept up to date as archetypes are
+	//! created, so iterating a query never allocates, counts or sorts anything.
+	class HELIUM_FRAMEWORK_API ComponentQuery
+	{
+	public:
+		//! Maximum number of types in a single query
+		static const size_t MAX_TYPES = 8;
+		//! Maximum number of archetype columns a single archetype can contribute to a query (more than one column
+		//! implements a queried type when the entity has components of several derived types)
+		static const size_t MAX_MATCH_COLUMNS = 32;
+
+		ComponentQuery( Components::ArchetypeStorage &rStorage, const Components::TypeId *types, size_t typesCount );
+
+		bool                           Matches( const Components::TypeId *types, size_t typesCount ) const;
+		void                           OnArchetypeAdded( const Components::Archetype &rArchetype );
+
+		inline size_t                  GetTypeCount() const;
+		inline Components::TypeId      GetType( size_t index ) const;
+		inline size_t                  GetArchetypeCount() const;
+
+		//! Calls rHandler( Component * const *tuple ) for every matching tuple. Tuple entries are in query type order. The
+		//! handler may allocate and free components: archetype changes are deferred until the iteration ends, so every
+		//! row is visited once and collections that change during the iteration are not visited again.
+		template <class Handler> void  ForEach( Handler &rHandler ) const;
+
+	private:
+		struct ArchetypeMatch
+		{
+			const Components::Archetype *m_pArchetype;
+			uint16_t                     m_ColumnStarts[ MAX_TYPES ];  //< Offset into m_Columns for each queried type
+			uint16_t                     m_ColumnCounts[ MAX_TYPES ];  //< Number of archetype columns implementing each queried type
+			uint16_t                     m_Columns[ MAX_MATCH_COLUMNS ];
+		};
+
+		template <class Handler> void  EmitTuples( Component **tuple, const Components::Archetype &rArchetype, size_t row, const ArchetypeMatch &rMatch, size_t typeIndex, Handler &rHandler ) const;
+
+		Components::ArchetypeStorage  *m_pStorage;
+		Components::TypeId             m_Types[ MAX_TYPES ];
+		size_t                         m_TypeCount;
+		DynamicArray< ArchetypeMatch > m_Matches;
+	};
+
+	//! Call site ID for ArchetypeStorage::GetQuery(), one per Site type so each call site finds its query without a
+	//! search or lock once it has been created
+	template <class Site>
+	struct ComponentQuerySite
+	{
+		static uint32_t s_QueryId;
+	};
+
+	template <class Site>
+	uint32_t ComponentQuerySite< Site >::s_QueryId = Components::ArchetypeStorage::AllocateQueryId();
+
+	//! Calls rHandler( Component * const *tuple ) for every tuple, through the query cached for Site when the manager has
+	//! archetype storage and through QueryComponentsUnindexed() when it doesn't. Site has no effect on the unindexed
+	//! path, which still picks the rarest type to drive the walk on every call.
+	template <class Site, class Handler>
+	void ForEachComponentTuple( ComponentManager &rManager, const Components::TypeId *types, size_t typesCount, Handler &rHandler );
+
+	template <class A, void (*F)(A *)>
+	struct ComponentTupleHandler1
+	{
+		inline void operator()( Component * const *tuple ) const
+		{
+			F( static_cast<A *>(tuple[0]) );
+		}
+	};
+
+	template <class A, class B, void (*F)(A *, B *)>
+	struct ComponentTupleHandler2
+	{
+		inline void operator()( Component * const *tuple ) const
+		{
+			F(
+				static_cast<A *>(tuple[0]),
+				static_cast<B *>(tuple[1]));
+		}
+	};
+
+	template <class A, class B, class C, void (*F)(A *, B *, C *)>
+	struct ComponentTupleHandler3
+	{
+		inline void operator()( Component * const *tuple ) const
+		{
+			F(
+				static_cast<A *>(tuple[0]),
+				static_cast<B *>(tuple[1]),
+				static_cast<C *>(tuple[2]));
+		}
+	};
+
+	template <class A, class B, class C, class D, void (*F)(A *, B *, C *, D *)>
+	struct ComponentTupleHandler4
+	{
+		inline void operator()( Component * const *tuple ) const
+		{
+			F(
+				static_cast<A *>(tuple[0]),
+				static_cast<B *>(tuple[1]),
+				static_cast<C *>(tuple[2]),
+				static_cast<D *>(tuple[3]));
+		}
+	};
+
+	//! Tuple handler that also passes a per query context to F, for state looked up once per world rather than once
+	//! per tuple
+	template <class A, class B, class Context, void (*F)(Context &, A *, B *)>
+	struct ComponentTupleContextHandler2
+	{
+		explicit ComponentTupleContextHandler2( Context &rContext ) : m_pContext( &rContext ) { }
+
+		inline void operator()( Component * const *tuple ) const
+		{
+			F(
+				*m_pContext,
+				static_cast<A *>(tuple[0]),
+				static_cast<B *>(tuple[1]));
+		}
+
+		Context *m_pContext;
+	};
 }
+
+#include "Framework/ComponentQuery.inl"
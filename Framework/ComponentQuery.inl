@@ -0,0 +1,90 @@
+
+namespace Helium
+{
+	size_t ComponentQuery::GetTypeCount() const
+	{
+		return m_TypeCount;
+	}
+
+	Components::TypeId ComponentQuery::GetType( size_t index ) const
+	{
+		HELIUM_ASSERT( index < m_TypeCount );
+		return m_Types[ index ];
+	}
+
+	size_t ComponentQuery::GetArchetypeCount() const
+	{
+		return m_Matches.GetSize();
+	}
+
+	template <class Handler>
+	void ComponentQuery::ForEach( Handler &rHandler ) const
+	{
+		Component *tuple[ MAX_TYPES ];
+
+		// Rows stay put until the iteration ends, so the handler can allocate and free components without rows being
+		// skipped or visited twice
+		m_pStorage->BeginIteration();
+
+		// Archetypes are only created and rows only added outside of iterations, so the matches and row counts can't
+		// change under us
+		for ( size_t matchIndex = 0; matchIndex < m_Matches.GetSize(); ++matchIndex )
+		{
+			const ArchetypeMatch &rMatch = m_Matches[ matchIndex ];
+			const Components::Archetype &rArchetype = *rMatch.m_pArchetype;
+
+			for ( size_t row = 0; row < rArchetype.GetRowCount(); ++row )
+			{
+				// Collections removed during the iteration leave a hole
+				if ( rArchetype.GetCollection( row ) )
+				{
+					EmitTuples( tuple, rArchetype, row, rMatch, 0, rHandler );
+				}
+			}
+		}
+
+		m_pStorage->EndIteration();
+	}
+
+	template <class Handler>
+	void ComponentQuery::EmitTuples( Component **tuple, const Components::Archetype &rArchetype, size_t row, const ArchetypeMatch &rMatch, size_t typeIndex, Handler &rHandler ) const
+	{
+		const uint16_t *pColumns = rMatch.m_Columns + rMatch.m_ColumnStarts[ typeIndex ];
+		const uint16_t *pColumnsEnd = pColumns + rMatch.m_ColumnCounts[ typeIndex ];
+
+		for ( ; pColumns != pColumnsEnd; ++pColumns )
+		{
+			// Null if the collection lost this type earlier in the iteration
+			Component *c = rArchetype.GetColumn( *pColumns )[ row ];
+
+			// Every component in the chain for this type is part of a separate tuple
+			for ( ; c; c = c->GetNextComponent() )
+			{
+				tuple[ typeIndex ] = c;
+
+				if ( typeIndex + 1 < m_TypeCount )
+				{
+					EmitTuples( tuple, rArchetype, row, rMatch, typeIndex + 1, rHandler );
+				}
+				else
+				{
+					rHandler( tuple );
+				}
+			}
+		}
+	}
+
+	template <class Site, class Handler>
+	void ForEachComponentTuple( ComponentManager &rManager, const Components::TypeId *types, size_t typesCount, Handler &rHandler )
+	{
+		Components::ArchetypeStorage *pArchetypeStorage = rManager.GetArchetypeStorage();
+		if ( pArchetypeStorage )
+		{
+			pArchetypeStorage->GetQuery( ComponentQuerySite< Site >::s_QueryId, types, typesCount ).ForEach( rHandler );
+		}
+		else
+		{
+			QueryComponentsUnindexed( rManager, types, typesCount, InvokeTupleHandler< Handler >, &rHandler );
+		}
+	}
+}
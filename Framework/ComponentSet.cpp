@@ -226,6 +226,237 @@ void HELIUM_FRAMEWORK_API Helium::Components::DeployComponents( IHasComponents &
 	}
 }
 
+Helium::ComponentDeploymentPlan::ComponentDeploymentPlan()
+	: m_Built( false )
+{
+
+}
+
+void Helium::ComponentDeploymentPlan::Build( const ComponentSet &rComponentSet, const DynamicArray<ComponentDefinitionPtr> *pSharedDefinitions )
+{
+	Clear();
+
+	if ( pSharedDefinitions )
+	{
+		for (DynamicArray<ComponentDefinitionPtr>::ConstIterator iter = pSharedDefinitions->Begin();
+			iter != pSharedDefinitions->End(); ++iter)
+		{
+			if (*iter)
+			{
+				m_SharedDefinitions.Push( *iter );
+			}
+			else
+			{
+				HELIUM_TRACE( 
+					TraceLevels::Warning, 
+					TXT( "ComponentDeploymentPlan::Build - A ComponentDefinitionPtr in the supplied list was null - ignoring.\n"));
+			}
+		}
+	}
+
+	// Use the same ordering and duplicate handling as DeployComponents()
+	typedef Map<Name, ComponentDefinitionPtr> M_Definitions;
+	M_Definitions definitions;
+
+	for (size_t i = 0; i < rComponentSet.m_Components.GetSize(); ++i)
+	{
+		const ComponentSet::NameDefinitionPair &pair = rComponentSet.m_Components[i];
+		M_Definitions::Iterator iter = definitions.Find(pair.m_Name);
+
+		if (iter != definitions.End())
+		{
+			HELIUM_TRACE( 
+				TraceLevels::Warning, 
+				TXT( "ComponentDeploymentPlan::Build - Multiple components named '%s'\n"), 
+				*pair.m_Name);
+			continue;
+		}
+
+		if ( !pair.m_Definition.ReferencesObject() )
+		{
+			HELIUM_TRACE( 
+				TraceLevels::Warning, 
+				TXT( "ComponentDeploymentPlan::Build - Cannot clone null component named '%s'\n"), 
+				*pair.m_Name);
+			continue;
+		}
+
+		definitions.Insert(iter, M_Definitions::ValueType(pair.m_Name, pair.m_Definition));
+	}
+
+	typedef Map<Name, size_t> M_Indices;
+	M_Indices indices;
+
+	for (M_Definitions::Iterator iter = definitions.Begin(); iter != definitions.End(); ++iter)
+	{
+		M_Indices::Iterator indexIter = indices.Find(iter->First());
+		indices.Insert(indexIter, M_Indices::ValueType(iter->First(), m_Definitions.GetSize()));
+		m_Definitions.Push( iter->Second() );
+	}
+
+	// Resolve every exposed parameter to the field it writes, and to the component it refers to (if any)
+	for (size_t i = 0; i < rComponentSet.m_Parameters.GetSize(); ++i)
+	{
+		const ComponentSet::Parameter &parameter = rComponentSet.m_Parameters[i];
+
+		M_Indices::Iterator targetIter = indices.Find(parameter.m_ComponentName);
+		if (targetIter == indices.End())
+		{
+			HELIUM_TRACE( 
+				TraceLevels::Warning, 
+				TXT( "ComponentDeploymentPlan::Build - Parameter '%s' refers to a component '%s' that cannot be found - ignored.\n"), 
+				*parameter.m_ParameterName,
+				*parameter.m_ComponentName);
+			continue;
+		}
+
+		uint32_t fieldNameCrc = Crc32( parameter.m_ComponentFieldName.Get() );
+		const Reflect::Field *field = m_Definitions[ targetIter->Second() ]->GetMetaClass()->FindFieldByName(fieldNameCrc);
+		if (!field)
+		{
+			HELIUM_TRACE( 
+				TraceLevels::Warning, 
+				TXT( "ComponentDeploymentPlan::Build - Parameter '%s' cannot find field named '%s' on component '%s' - ignored.\n"), 
+				*parameter.m_ParameterName,
+				*parameter.m_ComponentFieldName,
+				*parameter.m_ComponentName);
+			continue;
+		}
+
+		M_Indices::Iterator sourceIter = indices.Find(parameter.m_ParameterName);
+
+		Binding &rBinding = *m_Bindings.New();
+		rBinding.m_ParameterName = parameter.m_ParameterName;
+		rBinding.m_TargetIndex = targetIter->Second();
+		rBinding.m_Field = field;
+		rBinding.m_SourceIndex = ( sourceIter != indices.End() ) ? sourceIter->Second() : Invalid<size_t>();
+	}
+
+	m_Built = true;
+}
+
+void Helium::ComponentDeploymentPlan::Clear()
+{
+	m_SharedDefinitions.Clear();
+	m_Definitions.Clear();
+	m_Bindings.Clear();
+	m_Built = false;
+}
+
+void Helium::ComponentDeploymentPlan::ReservePools( ComponentManager &rManager, size_t entityCount ) const
+{
+	HELIUM_ASSERT( m_Built );
+
+	// Several definitions may allocate the same type, so total them up before reserving
+	typedef Map<Components::TypeId, size_t> M_Counts;
+	M_Counts counts;
+
+	for (size_t i = 0; i < m_SharedDefinitions.GetSize() + m_Definitions.GetSize(); ++i)
+	{
+		const ComponentDefinitionPtr &rDefinition = ( i < m_SharedDefinitions.GetSize() ) ? 
+			m_SharedDefinitions[ i ] : 
+			m_Definitions[ i - m_SharedDefinitions.GetSize() ];
+
+		Components::TypeId type = rDefinition->GetComponentType();
+		if ( !IsValid( type ) )
+		{
+			continue;
+		}
+
+		M_Counts::Iterator iter = counts.Find(type);
+		if (iter == counts.End())
+		{
+			counts.Insert(iter, M_Counts::ValueType(type, entityCount));
+		}
+		else
+		{
+			iter->Second() += entityCount;
+		}
+	}
+
+	for (M_Counts::Iterator iter = counts.Begin(); iter != counts.End(); ++iter)
+	{
+		if ( !rManager.Reserve( iter->First(), iter->Second() ) )
+		{
+			HELIUM_TRACE( 
+				TraceLevels::Warning, 
+				TXT( "ComponentDeploymentPlan::ReservePools - Could not reserve %d components of type %s\n"), 
+				iter->Second(),
+				Components::GetTypeData( iter->First() )->m_Structure->m_Name);
+		}
+	}
+}
+
+void Helium::ComponentDeploymentPlan::CloneDefinitions( DynamicArray<ComponentDefinitionPtr> &rClones ) const
+{
+	HELIUM_ASSERT( m_Built );
+
+	rClones.Resize( m_Definitions.GetSize() );
+	for (size_t i = 0; i < m_Definitions.GetSize(); ++i)
+	{
+		Reflect::ObjectPtr object_ptr = m_Definitions[i]->Clone();
+		rClones[i] = Reflect::AssertCast<Helium::ComponentDefinition>(object_ptr.Get());
+	}
+}
+
+void Helium::ComponentDeploymentPlan::BindParameters( DynamicArray<ComponentDefinitionPtr> &rClones, const ParameterSet *pParameterSet ) const
+{
+	HELIUM_ASSERT( m_Built );
+	HELIUM_ASSERT( rClones.GetSize() == m_Definitions.GetSize() );
+
+	for (DynamicArray<Binding>::ConstIterator bindingIter = m_Bindings.Begin(); 
+		bindingIter != m_Bindings.End(); ++bindingIter)
+	{
+		Reflect::Pointer target( bindingIter->m_Field, rClones[ bindingIter->m_TargetIndex ].Get() );
+
+		// Supplied parameters win over components of the same name, and the first of duplicate parameters wins
+		Parameter parameter;
+		if ( pParameterSet && pParameterSet->FindParameter( bindingIter->m_ParameterName, parameter ) )
+		{
+			bindingIter->m_Field->m_Translator->Copy( parameter.GetPointer(), target, Reflect::CopyFlags::Shallow );
+			continue;
+		}
+
+		if ( IsValid( bindingIter->m_SourceIndex ) )
+		{
+			bindingIter->m_Field->m_Translator->Copy( 
+				Reflect::Pointer( rClones[ bindingIter->m_SourceIndex ] ), 
+				target, 
+				Reflect::CopyFlags::Shallow );
+		}
+	}
+}
+
+void Helium::ComponentDeploymentPlan::Deploy( Components::IHasComponents &rHasComponents, const DynamicArray<ComponentDefinitionPtr> &rClones ) const
+{
+	HELIUM_ASSERT( m_Built );
+	HELIUM_ASSERT( rClones.GetSize() == m_Definitions.GetSize() );
+
+	for (DynamicArray<ComponentDefinitionPtr>::ConstIterator iter = m_SharedDefinitions.Begin();
+		iter != m_SharedDefinitions.End(); ++iter)
+	{
+		(*iter)->CreateComponent(rHasComponents);
+	}
+
+	for (DynamicArray<ComponentDefinitionPtr>::ConstIterator iter = m_SharedDefinitions.Begin();
+		iter != m_SharedDefinitions.End(); ++iter)
+	{
+		(*iter)->FinalizeComponent();
+	}
+
+	for (DynamicArray<ComponentDefinitionPtr>::ConstIterator iter = rClones.Begin();
+		iter != rClones.End(); ++iter)
+	{
+		(*iter)->CreateComponent(rHasComponents);
+	}
+
+	for (DynamicArray<ComponentDefinitionPtr>::ConstIterator iter = rClones.Begin();
+		iter != rClones.End(); ++iter)
+	{
+		(*iter)->FinalizeComponent();
+	}
+}
+
 HELIUM_DEFINE_BASE_STRUCT(Helium::ComponentSet);
 
 void Helium::ComponentSet::PopulateMetaType( Reflect::MetaStruct& comp )
@@ -39,6 +39,7 @@ namespace Helium
 			Components::IHasComponents &rHasComponents, 
 			const Helium::ComponentSet &components, 
 			const ParameterSet *parameters);
+		friend class ComponentDeploymentPlan;
 
 	private:
 
@@ -71,4 +72,48 @@ namespace Helium
 		DynamicArray<NameDefinitionPair> m_Components;
 		DynamicArray<Parameter> m_Parameters;
 	};
+
+	// Precomputed version of DeployComponents() for spawning many entities from the same component set. Building the
+	// plan resolves component names, parameter bindings and reflection fields once. A batch then clones and binds the
+	// definitions once per distinct parameter set, and runs the usual two phase CreateComponent/FinalizeComponent on
+	// those clones for every entity in turn. Components keep pointers to the definition they were created from, so
+	// clones must not be rebound once deployed. Shared definitions are deployed uncloned ahead of the set, the way
+	// EntityDefinition deploys its plain component list.
+	class HELIUM_FRAMEWORK_API ComponentDeploymentPlan
+	{
+	public:
+		ComponentDeploymentPlan();
+
+		void Build( const ComponentSet &rComponentSet, const DynamicArray<ComponentDefinitionPtr> *pSharedDefinitions = NULL );
+		void Clear();
+		inline bool IsBuilt() const;
+
+		// Make sure the pools for every component in the plan have room for entityCount more entities
+		void ReservePools( ComponentManager &rManager, size_t entityCount ) const;
+
+		// Clone the definitions for a batch
+		void CloneDefinitions( DynamicArray<ComponentDefinitionPtr> &rClones ) const;
+
+		// Copy parameter values into freshly cloned definitions
+		void BindParameters( DynamicArray<ComponentDefinitionPtr> &rClones, const ParameterSet *pParameterSet ) const;
+
+		// Create and finalize one entity's components from the clones
+		void Deploy( Components::IHasComponents &rHasComponents, const DynamicArray<ComponentDefinitionPtr> &rClones ) const;
+
+	private:
+		struct Binding
+		{
+			Name                      m_ParameterName;
+			size_t                    m_TargetIndex;     //< Component receiving the value
+			const Reflect::Field*     m_Field;           //< Field on the target's definition
+			size_t                    m_SourceIndex;     //< Component supplying the value when no parameter is given, or invalid
+		};
+
+		DynamicArray<ComponentDefinitionPtr>  m_SharedDefinitions;
+		DynamicArray<ComponentDefinitionPtr>  m_Definitions;  //< Originals, in deployment order
+		DynamicArray<Binding>                 m_Bindings;
+		bool                                  m_Built;
+	};
 }
+
+#include "Framework/ComponentSet.inl"
@@ -0,0 +1,8 @@
+
+namespace Helium
+{
+	bool ComponentDeploymentPlan::IsBuilt() const
+	{
+		return m_Built;
+	}
+}
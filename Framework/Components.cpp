@@ -1,8 +1,11 @@
 
 #include "FrameworkPch.h"
 #include "Framework/Components.h"
+#include "Framework/ComponentArchetype.h"
+#include "Framework/ComponentLayout.h"
 #include "Framework/SystemDefinition.h"
 
+#include "Platform/Atomic.h"
 #include "Foundation/Numeric.h"
 #include "Reflect/TranslatorDeduction.h"
 #include "Engine/Asset.h"
@@ -23,8 +26,11 @@ Helium::DynamicMemoryHeap      Components::g_ComponentAllocator;
 int32_t                    g_ComponentsInitCount = 0;
 int32_t                    g_ComponentManagerInstanceCount = 0;
 DynamicArray<TypeData *>   g_ComponentTypes;
-ComponentPtrBase*          g_ComponentPtrRegistry[COMPONENT_PTR_CHECK_FREQUENCY];
-uint16_t                   g_ComponentProcessPendingDeletesCallCount = 0;
+Pool*                      Components::g_PoolsByHandleSlot[POOL_HANDLE_SLOT_COUNT];
+uint8_t                    g_PoolHandleSlotSerials[POOL_HANDLE_SLOT_COUNT];
+uint16_t                   g_NextPoolHandleSlot = 0;
+Mutex                      g_PoolHandleSlotLock;
+bool                       g_ComponentUseArchetypeStorage = false;
 
 ComponentRegistrar<Helium::Component, void> Helium::Component::s_ComponentRegistrar("Helium::Component");
 
@@ -34,6 +40,8 @@ void Components::Startup( SystemDefinition *pSystemDefinition )
 	{
 		if ( pSystemDefinition )
 		{
+			g_ComponentUseArchetypeStorage = pSystemDefinition->m_UseArchetypeStorage;
+
 			DynamicArray< ComponentTypeConfig > &rTypeConfigs = pSystemDefinition->m_ComponentTypeConfigs;
 			for (DynamicArray< ComponentTypeConfig >::Iterator configIter = rTypeConfigs.Begin(); 
 				configIter != rTypeConfigs.End(); ++configIter)
@@ -45,7 +53,31 @@ void Components::Startup( SystemDefinition *pSystemDefinition )
 					TypeData &rTypeData = **componentTypeIter;
 					if (rTypeData.m_Name == configIter->m_ComponentTypeName)
 					{
-						rTypeData.m_DefaultCount = configIter->m_PoolSize;
+						// -1 keeps the count given to HELIUM_DEFINE_COMPONENT (a config may only set an overflow policy)
+						if ( configIter->m_PoolSize != Invalid<uint32_t>() )
+						{
+							rTypeData.m_DefaultCount = static_cast<ComponentIndex>(
+								Min<uint32_t>( configIter->m_PoolSize, Invalid<ComponentIndex>() - 1 ) );
+						}
+
+						switch ( configIter->m_OverflowPolicy )
+						{
+						case EComponentPoolOverflow::FAIL:
+							rTypeData.m_OverflowPolicy = POOL_OVERFLOW_FAIL;
+							break;
+
+						case EComponentPoolOverflow::GROW:
+							rTypeData.m_OverflowPolicy = POOL_OVERFLOW_GROW;
+							break;
+
+						case EComponentPoolOverflow::GROW_AND_WARN:
+							rTypeData.m_OverflowPolicy = POOL_OVERFLOW_GROW_AND_WARN;
+							break;
+
+						default:
+							break;
+						}
+
 						found = true;
 						break;
 					}
@@ -60,6 +92,11 @@ void Components::Startup( SystemDefinition *pSystemDefinition )
 						*configIter->m_ComponentTypeName);
 				}
 			}
+
+			if ( pSystemDefinition->m_ReportComponentMemoryLayout )
+			{
+				ReportMemoryLayout();
+			}
 		}
 	}
 }
@@ -71,11 +108,16 @@ void Components::Shutdown()
 		HELIUM_TRACE( TraceLevels::Info, TXT( "Components shutting down.\n" ));
 		HELIUM_ASSERT( !g_ComponentManagerInstanceCount );
 
+		ReportPoolUsage();
+
 		for (DynamicArray<TypeData *>::Iterator iter = g_ComponentTypes.Begin();
 			iter != g_ComponentTypes.End(); ++iter)
 		{
 			TypeData *data = *iter;
 			data->m_DefaultCount = 0;
+			data->m_OverflowPolicy = POOL_OVERFLOW_GROW_AND_WARN;
+			data->m_HighWaterMark = 0;
+			data->m_PoolGrowCount = 0;
 			data->m_ImplementedTypes.Clear();
 			data->m_ImplementingTypes.Clear();
 			data->m_Structure = NULL;
@@ -83,6 +125,41 @@ void Components::Shutdown()
 		}
 
 		g_ComponentTypes.Clear();
+		g_ComponentUseArchetypeStorage = false;
+	}
+}
+
+void Components::ReportPoolUsage()
+{
+	MutexScopeLock scopeLock( g_PoolHandleSlotLock );
+
+	for (DynamicArray<TypeData *>::Iterator iter = g_ComponentTypes.Begin();
+		iter != g_ComponentTypes.End(); ++iter)
+	{
+		const TypeData &rTypeData = **iter;
+		ComponentIndex highWaterMark = rTypeData.m_HighWaterMark;
+
+		for (uint32_t slot = 0; slot < POOL_HANDLE_SLOT_COUNT; ++slot)
+		{
+			const Pool *pPool = g_PoolsByHandleSlot[ slot ];
+			if ( pPool && pPool->GetTypeId() == rTypeData.m_TypeId )
+			{
+				highWaterMark = Max( highWaterMark, pPool->GetHighWaterMark() );
+			}
+		}
+
+		if ( !highWaterMark && !rTypeData.m_PoolGrowCount )
+		{
+			continue;
+		}
+
+		HELIUM_TRACE(
+			rTypeData.m_PoolGrowCount ? TraceLevels::Warning : TraceLevels::Info,
+			"Components::ReportPoolUsage - %s: pool size %d, high water mark %d, pages grown %d\n",
+			rTypeData.m_Structure->m_Name,
+			rTypeData.m_DefaultCount,
+			highWaterMark,
+			rTypeData.m_PoolGrowCount);
 	}
 }
 
@@ -144,6 +221,11 @@ const TypeData* Components::GetTypeData( TypeId type )
 	return g_ComponentTypes[ type ];
 }
 
+size_t Components::GetTypeCount()
+{
+	return g_ComponentTypes.GetSize();
+}
+
 ComponentManagerPtr Components::CreateManager( World *pWorld )
 {
 	return new ComponentManager(pWorld);
@@ -166,12 +248,8 @@ Pool* Pool::CreatePool( ComponentManager *pComponentManager, const TypeData &rTy
 	HELIUM_ASSERT( componentSize );
 	componentSize = PAD_VALUE(componentSize, HELIUM_SIMD_ALIGNMENT);
 
-	size_t poolSize = PAD_VALUE( sizeof( Components::Pool ), HELIUM_SIMD_ALIGNMENT );
-	size_t memoryRequried = poolSize + componentSize * count;
-	Pool *pool = (Pool *)g_ComponentAllocator.AllocateAligned( POOL_ALIGN_SIZE, memoryRequried );
+	Pool *pool = (Pool *)g_ComponentAllocator.AllocateAligned( POOL_ALIGN_SIZE, sizeof( Pool ) );
 	new(pool) Pool();
-	
-	pool->m_ParallelData = HELIUM_NEW_A( g_ComponentAllocator, DataParallel, count );
 
 	pool->m_World = pComponentManager->GetWorld();
 	pool->m_ComponentManager = pComponentManager;
@@ -179,42 +257,120 @@ Pool* Pool::CreatePool( ComponentManager *pComponentManager, const TypeData &rTy
 	pool->m_TypeId = rTypeData.m_TypeId;
 	pool->m_ComponentSize = componentSize;
 	pool->m_FirstUnallocatedIndex = 0;
+	pool->m_HighWaterMark = 0;
+	pool->m_OverflowPolicy = rTypeData.m_OverflowPolicy;
 	pool->m_ComponentOffset = rTypeData.GetOffsetOfComponent();
-		
-	pool->m_Roster.Resize( count );
 
-	for (uint16_t i = 0; i < count; ++i)
+	// A component finds its page through a 16-bit offset in units of HELIUM_COMPONENT_POOL_ALIGN_SIZE, which bounds the
+	// size of a page. The first page is sized for the requested count (but no smaller than POOL_PAGE_SIZE_MIN), later
+	// pages match it. Pages hold a power of two components so GetComponent() can find an index with a shift and a mask.
+	size_t pageHeaderSize = PAD_VALUE( sizeof( PoolPage ), HELIUM_SIMD_ALIGNMENT );
+	size_t maxPageSize = ( NumericLimits<uint16_t>::Maximum * HELIUM_COMPONENT_POOL_ALIGN_SIZE - pageHeaderSize - pool->m_ComponentOffset ) / componentSize;
+	maxPageSize = Min<size_t>( maxPageSize, Invalid<ComponentIndex>() );
+	HELIUM_ASSERT( maxPageSize );
+
+	size_t requestedPageSize = Max<size_t>( count, POOL_PAGE_SIZE_MIN );
+	uint16_t pageShift = 0;
+	while ( ( static_cast<size_t>( 1 ) << pageShift ) < requestedPageSize && ( static_cast<size_t>( 2 ) << pageShift ) <= maxPageSize )
+	{
+		++pageShift;
+	}
+
+	pool->m_PageShift = pageShift;
+	pool->m_PageSize = static_cast<ComponentIndex>( 1 << pageShift );
+	pool->m_PageMask = static_cast<ComponentIndex>( pool->m_PageSize - 1 );
+
+	while ( pool->m_Roster.GetSize() < count )
 	{
-		Component *component = pool->GetComponent( i );
-		pool->m_Roster[i] = component;
+		if ( !pool->AddPage() )
+		{
+			break;
+		}
+	}
 
-		uintptr_t offset = (static_cast<uintptr_t>(reinterpret_cast<uintptr_t>(component) & POOL_ALIGN_SIZE_MASK) - reinterpret_cast<uintptr_t>(pool)) / HELIUM_COMPONENT_POOL_ALIGN_SIZE;
+	// Claim a handle slot. Slots are handed out round-robin so a stale handle to a destroyed pool is unlikely to
+	// resolve against a new pool that reused its slot.
+	{
+		MutexScopeLock scopeLock( g_PoolHandleSlotLock );
+
+		uint32_t attempts = 0;
+		while ( g_PoolsByHandleSlot[ g_NextPoolHandleSlot ] )
+		{
+			HELIUM_ASSERT_MSG( ++attempts < POOL_HANDLE_SLOT_COUNT, TXT( "Out of component pool handle slots" ) );
+			g_NextPoolHandleSlot = static_cast<uint16_t>( ( g_NextPoolHandleSlot + 1 ) % POOL_HANDLE_SLOT_COUNT );
+		}
+
+		// Serials run from 1 so that no valid handle has a zero key
+		const uint32_t serialCount = ( 1 << ( 16 - POOL_HANDLE_SLOT_BITS ) ) - 1;
+		uint8_t &rSerial = g_PoolHandleSlotSerials[ g_NextPoolHandleSlot ];
+		rSerial = static_cast<uint8_t>( rSerial % serialCount + 1 );
+
+		pool->m_HandleSlot = g_NextPoolHandleSlot;
+		pool->m_HandleKey = static_cast<uint16_t>( ( rSerial << POOL_HANDLE_SLOT_BITS ) | g_NextPoolHandleSlot );
+		g_PoolsByHandleSlot[ pool->m_HandleSlot ] = pool;
+		g_NextPoolHandleSlot = static_cast<uint16_t>( ( g_NextPoolHandleSlot + 1 ) % POOL_HANDLE_SLOT_COUNT );
+	}
+
+	HELIUM_TRACE(
+		TraceLevels::Debug,
+		"Components::Pool::CreatePool - [%5d] %s (%d pages of %d components at %x)\n",
+		count,
+		rTypeData.m_Structure->m_Name,
+		pool->m_Pages.GetSize(),
+		pool->m_PageSize,
+		pool);
+
+	return pool;
+}
+
+bool Pool::AddPage()
+{
+	// Invalid<ComponentIndex>() is reserved to terminate chains
+	size_t capacity = m_Roster.GetSize();
+	if ( capacity + m_PageSize >= Invalid<ComponentIndex>() )
+	{
+		return false;
+	}
+
+	size_t pageHeaderSize = PAD_VALUE( sizeof( PoolPage ), HELIUM_SIMD_ALIGNMENT );
+	PoolPage *page = (PoolPage *)g_ComponentAllocator.AllocateAligned( POOL_ALIGN_SIZE, pageHeaderSize + m_ComponentSize * m_PageSize );
+	if ( !page )
+	{
+		return false;
+	}
+
+	page->m_Pool = this;
+	page->m_FirstIndex = static_cast<ComponentIndex>( capacity );
+	m_Pages.Push( page );
+
+	m_Roster.Resize( capacity + m_PageSize );
+	m_ParallelData.Resize( capacity + m_PageSize );
+
+	for (size_t i = capacity; i < capacity + m_PageSize; ++i)
+	{
+		ComponentIndex index = static_cast<ComponentIndex>( i );
+		Component *component = reinterpret_cast<Component *>( GetFirstComponentPtr( page ) + ( i - capacity ) * m_ComponentSize );
+		m_Roster[i] = component;
+
+		uintptr_t offset = (static_cast<uintptr_t>(reinterpret_cast<uintptr_t>(component) & POOL_ALIGN_SIZE_MASK) - reinterpret_cast<uintptr_t>(page)) / HELIUM_COMPONENT_POOL_ALIGN_SIZE;
 		HELIUM_ASSERT(offset <= NumericLimits<uint16_t>::Maximum);
 		HELIUM_ASSERT(offset);
 		component->m_InlineData.m_OffsetToPoolStart = static_cast<uint16_t>(offset);
 			
-		component->m_InlineData.m_Owner = NULL;
 		component->m_InlineData.m_Next = Invalid<ComponentIndex>();
 		component->m_InlineData.m_Previous = Invalid<ComponentIndex>();
 		component->m_InlineData.m_Delete = false;
 		component->m_InlineData.m_Generation = 0;
-		pool->m_ParallelData[i].m_Collection = NULL;
-		pool->m_ParallelData[i].m_RosterIndex = i;
+		m_ParallelData[i].m_Owner = NULL;
+		m_ParallelData[i].m_Collection = NULL;
+		m_ParallelData[i].m_RosterIndex = index;
 
-		HELIUM_ASSERT( Pool::GetPool( component ) == pool );
-		HELIUM_ASSERT( Pool::GetPool( component )->GetComponentIndex( component ) == i );
-		HELIUM_ASSERT( Pool::GetPool( component )->GetComponent( i ) == component );
+		HELIUM_ASSERT( Pool::GetPool( component ) == this );
+		HELIUM_ASSERT( GetComponentIndex( component ) == index );
+		HELIUM_ASSERT( GetComponent( index ) == component );
 	}
 
-	HELIUM_TRACE(
-		TraceLevels::Debug,
-		"Components::Pool::CreatePool - [%5d] %s (%d bytes at %x)\n",
-		count,
-		rTypeData.m_Structure->m_Name,
-		memoryRequried,
-		pool);
-
-	return pool;
+	return true;
 }
 
 void Pool::DestroyPool( Pool *pPool )
@@ -226,10 +382,24 @@ void Pool::DestroyPool( Pool *pPool )
 			pPool->m_Type->m_Structure->m_Name);
 	}
 
-	HELIUM_DELETE_A( g_ComponentAllocator, pPool->m_ParallelData );
+	{
+		MutexScopeLock scopeLock( g_PoolHandleSlotLock );
+		HELIUM_ASSERT( g_PoolsByHandleSlot[ pPool->m_HandleSlot ] == pPool );
+		g_PoolsByHandleSlot[ pPool->m_HandleSlot ] = NULL;
+
+		// Keep the usage telemetry for this type after the pool is gone
+		TypeData *pTypeData = g_ComponentTypes[ pPool->m_TypeId ];
+		pTypeData->m_HighWaterMark = Max( pTypeData->m_HighWaterMark, pPool->m_HighWaterMark );
+	}
+
+	for (DynamicArray<PoolPage *>::Iterator iter = pPool->m_Pages.Begin();
+		iter != pPool->m_Pages.End(); ++iter)
+	{
+		g_ComponentAllocator.FreeAligned( *iter );
+	}
+
 	pPool->~Pool();
 	g_ComponentAllocator.FreeAligned( pPool );
-	
 }
 
 void Pool::InsertIntoChain(Component *_insertee, ComponentIndex _insertee_index, Component *nextComponent)
@@ -245,7 +415,7 @@ void Pool::InsertIntoChain(Component *_insertee, ComponentIndex _insertee_index,
 		_insertee->m_InlineData.m_Previous = previous_index;
 
 		// Fix previous component's next pointer
-		if (previous_index != Invalid<uint16_t>())
+		if (previous_index != Invalid<ComponentIndex>())
 		{
 			GetComponent( previous_index )->m_InlineData.m_Next = _insertee_index;
 		}
@@ -273,7 +443,7 @@ void Pool::RemoveFromChain(Component *_component, ComponentIndex index)
 	{
 		GetComponent( previous_index )->m_InlineData.m_Next = _component->m_InlineData.m_Next;
 	}
-	else if ( _component->m_InlineData.m_Next != Invalid<uint16_t>() )
+	else if ( _component->m_InlineData.m_Next != Invalid<ComponentIndex>() )
 	{
 		//m_ParallelData[ index ].m_Collection->m_Components[m_TypeId] = GetComponent( _component->m_InlineData.m_Next );
 		m_ParallelData[ index ].m_Collection->m_Components[m_TypeId] = pNextComponent;
@@ -284,16 +454,52 @@ void Pool::RemoveFromChain(Component *_component, ComponentIndex index)
 	}
 
 	// If we have a next node, repoint its previous pointer to our previous pointer
-	if ( _component->m_InlineData.m_Next != Invalid<uint16_t>() )
+	if ( _component->m_InlineData.m_Next != Invalid<ComponentIndex>() )
 	{
 		//m_ParallelData[ _component->m_InlineData.m_Next ].m_Previous = m_ParallelData[ index ].m_Previous;
 		pNextComponent->m_InlineData.m_Previous = _component->m_InlineData.m_Previous;
 	}
 
 	// wipe our node
-	_component->m_InlineData.m_Next = Invalid<uint16_t>();
-	//m_ParallelData[ index ].m_Previous = Invalid<uint16_t>();
-	_component->m_InlineData.m_Previous = Invalid<uint16_t>();
+	_component->m_InlineData.m_Next = Invalid<ComponentIndex>();
+	//m_ParallelData[ index ].m_Previous = Invalid<ComponentIndex>();
+	_component->m_InlineData.m_Previous = Invalid<ComponentIndex>();
+}
+
+bool Pool::Reserve( size_t count )
+{
+	size_t available = m_Roster.GetSize() - m_FirstUnallocatedIndex;
+	return count <= available || Grow( count - available );
+}
+
+bool Pool::Grow( size_t count )
+{
+	if ( m_OverflowPolicy == POOL_OVERFLOW_FAIL )
+	{
+		return false;
+	}
+
+	size_t target = m_Roster.GetSize() + count;
+	while ( m_Roster.GetSize() < target )
+	{
+		if ( !AddPage() )
+		{
+			return false;
+		}
+
+		AtomicIncrement( g_ComponentTypes[ m_TypeId ]->m_PoolGrowCount );
+	}
+
+	if ( m_OverflowPolicy == POOL_OVERFLOW_GROW_AND_WARN )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Warning,
+			"Components::Pool::Grow - Pool for type %s ran out of components and grew to %d. Consider raising its pool size in the SystemDefinition.\n",
+			g_ComponentTypes[ m_TypeId ]->m_Structure->m_Name,
+			m_Roster.GetSize());
+	}
+
+	return true;
 }
 
 Component* Pool::Allocate( IHasComponents *owner, ComponentCollection &collection )
@@ -301,7 +507,7 @@ Component* Pool::Allocate( IHasComponents *owner, ComponentCollection &collectio
 	// Null owner is allowed
 
 	// Do we have a free component to allocate?
-	if (m_FirstUnallocatedIndex >= m_Roster.GetSize())
+	if (m_FirstUnallocatedIndex >= m_Roster.GetSize() && !Grow( 1 ))
 	{
 		// Could not allocate the component because we ran out..
 		HELIUM_ASSERT_MSG( false, TXT( "Could not allocate component of type %s for host %x. No free instances are available. Maximum instances: %d" ), 
@@ -313,6 +519,7 @@ Component* Pool::Allocate( IHasComponents *owner, ComponentCollection &collectio
 
 	// Find out where the component we should allocate is in the roster
 	ComponentIndex roster_index = m_FirstUnallocatedIndex++;
+	m_HighWaterMark = Max( m_HighWaterMark, m_FirstUnallocatedIndex );
 	
 	Component *component = m_Roster[roster_index];
 	ComponentIndex component_index = GetComponentIndex( component );
@@ -329,14 +536,18 @@ Component* Pool::Allocate( IHasComponents *owner, ComponentCollection &collectio
 		collection.m_Components.Insert(iter, Map<TypeId, Component *>::ValueType(m_TypeId, component));
 	}
 
-	//m_ParallelData[ component_index ].m_Owner =  owner;
-	component->m_InlineData.m_Owner = owner;
-
+	m_ParallelData[ component_index ].m_Owner = owner;
 	m_ParallelData[ component_index ].m_Collection = &collection;
 
 	m_Type->Construct( component );
 	HELIUM_ASSERT( component->m_InlineData.m_OffsetToPoolStart);
 
+	ArchetypeStorage *pArchetypeStorage = m_ComponentManager->GetArchetypeStorage();
+	if ( pArchetypeStorage )
+	{
+		pArchetypeStorage->OnCollectionChanged( collection, m_TypeId );
+	}
+
 	return component;
 }
 
@@ -348,15 +559,24 @@ void Pool::Free( Component *component )
 	HELIUM_ASSERT( m_ParallelData[ index ].m_Collection );
 
 	m_Type->Destruct( component );
+
+	ComponentCollection *pCollection = m_ParallelData[ index ].m_Collection;
 	RemoveFromChain( component, index );
 	
 	// Increment generation to invalidate old handles
 	++component->m_InlineData.m_Generation;
 	component->m_InlineData.m_Delete = false;
-	component->m_InlineData.m_Owner = NULL;
 
+	m_ParallelData[ index ].m_Owner = NULL;
 	m_ParallelData[ index ].m_Collection = NULL;
 
+	// Collections taken out of the archetype storage by ComponentManager::ReleaseComponents() stay out of it
+	ArchetypeStorage *pArchetypeStorage = m_ComponentManager->GetArchetypeStorage();
+	if ( pArchetypeStorage && ( pCollection->m_pArchetype || pCollection->m_bArchetypeChangePending ) )
+	{
+		pArchetypeStorage->OnCollectionChanged( *pCollection, m_TypeId );
+	}
+
 	// Get roster indices we will manipulate
 	ComponentIndex used_roster_index = m_ParallelData[ index ].m_RosterIndex;
 	HELIUM_ASSERT( m_FirstUnallocatedIndex );
@@ -386,6 +606,15 @@ void Pool::Free( Component *component )
 	}
 }
 
+void Pool::Free( Component * const *components, size_t count )
+{
+	for ( size_t index = 0; index < count; ++index )
+	{
+		HELIUM_ASSERT( GetPool( components[ index ] ) == this );
+		Free( components[ index ] );
+	}
+}
+
 #if HELIUM_TOOLS
 void Helium::Components::Pool::SpewRosterToTty()
 {
@@ -403,13 +632,14 @@ void Helium::Components::Pool::SpewRosterToTty()
 			"    - Index: %d  Component Addr: %x  Owner Addr: %x\n",
 			GetComponentIndex(m_Roster[i]),
 			m_Roster[i],
-			m_Roster[i]->m_InlineData.m_Owner);
+			GetComponentOwner(m_Roster[i]));
 	}
 }
 #endif
 
 Helium::ComponentManager::ComponentManager(World *pWorld)
 	: m_World(pWorld)
+	, m_pArchetypeStorage( g_ComponentUseArchetypeStorage ? new ArchetypeStorage() : NULL )
 {
 	for (DynamicArray<TypeData *>::Iterator iter = g_ComponentTypes.Begin();
 		iter != g_ComponentTypes.End(); ++iter)
@@ -422,8 +652,6 @@ Helium::ComponentManager::ComponentManager(World *pWorld)
 
 Helium::ComponentManager::~ComponentManager()
 {
-	Tick(); // Process pending deletes if necessary
-
 	for (DynamicArray<Pool *>::Iterator iter = m_Pools.Begin();
 		iter != m_Pools.End(); ++iter)
 	{
@@ -443,51 +671,9 @@ Helium::ComponentManager::~ComponentManager()
 	}
 
 	m_Pools.Clear();
-}
-
-void Helium::Components::Tick()
-{
-	++g_ComponentProcessPendingDeletesCallCount;
-
-	// Look at our registry of component ptrs, we may need to force some of them to invalidate (a ptr must be checked
-	// at least once every 256 frames in case the generation counter overlaps)
-	uint32_t registry_index = g_ComponentProcessPendingDeletesCallCount % COMPONENT_PTR_CHECK_FREQUENCY;
-	ComponentPtrBase *component_ptr = g_ComponentPtrRegistry[registry_index];
-
-	// Double-check that the component head index is set
-	HELIUM_ASSERT(!component_ptr || component_ptr->m_ComponentPtrRegistryHeadIndex == registry_index);
-
-	while (component_ptr)
-	{
-		// Don't do the check until we get our next pointer, as a failed check will splice out the ptr from our doubly
-		// linked list.
-		ComponentPtrBase *component_ptr_to_check = component_ptr;
-		component_ptr = component_ptr->GetNextComponetPtr();
-		component_ptr_to_check->Check();
-	}
-	
-	// Even after we evict components, we still need to verify that we either have no component or the head component
-	// has a properly set index
-	HELIUM_ASSERT(
-		!g_ComponentPtrRegistry[registry_index] || 
-		g_ComponentPtrRegistry[registry_index]->m_ComponentPtrRegistryHeadIndex == registry_index);
-}
 
-void Helium::ComponentManager::RegisterComponentPtr( ComponentPtrBase &pPtr )
-{
-	uint16_t registry_index = g_ComponentProcessPendingDeletesCallCount % COMPONENT_PTR_CHECK_FREQUENCY;
-	pPtr.m_Next = g_ComponentPtrRegistry[registry_index];
-	
-	if (pPtr.m_Next)
-	{
-		// Make the current head component's previous pointer point to the new component, and clear the head component index
-		HELIUM_ASSERT(pPtr.m_Next->m_ComponentPtrRegistryHeadIndex == registry_index);
-		pPtr.m_Next->m_Previous = &pPtr;
-		pPtr.m_Next->m_ComponentPtrRegistryHeadIndex = Helium::Invalid<uint16_t>();
-	}
-
-	pPtr.m_ComponentPtrRegistryHeadIndex = registry_index;
-	g_ComponentPtrRegistry[registry_index] = &pPtr;
+	delete m_pArchetypeStorage;
+	m_pArchetypeStorage = NULL;
 }
 
 size_t Helium::ComponentManager::CountAllocatedComponentsThatImplement( Components::TypeId typeId ) const
@@ -504,43 +690,41 @@ size_t Helium::ComponentManager::CountAllocatedComponentsThatImplement( Componen
 	return count;
 }
 
-void Helium::ComponentPtrBase::Unlink() const
+void Helium::ComponentManager::ReleaseComponents( ComponentCollection * const *ppCollections, size_t count )
 {
-	// If we are the head node in the component ptr registry, we need to point it to the new head
-	if (m_ComponentPtrRegistryHeadIndex != Helium::Invalid<uint16_t>())
+	m_ReleaseBuckets.Resize( m_Pools.GetSize() );
+
+	for ( size_t collectionIndex = 0; collectionIndex < count; ++collectionIndex )
 	{
-		ComponentPtrBase *current_head = g_ComponentPtrRegistry[m_ComponentPtrRegistryHeadIndex];
-		HELIUM_ASSERT(current_head == this);
-		HELIUM_ASSERT(!m_Previous);
+		ComponentCollection &rCollection = *ppCollections[ collectionIndex ];
 
-		// If this new node is legit, mark it as a head node
-		if (m_Next)
+		// Leave the archetype storage once instead of moving through an archetype per freed component
+		if ( m_pArchetypeStorage )
 		{
-			g_ComponentPtrRegistry[m_ComponentPtrRegistryHeadIndex] = m_Next;
-			m_Next->m_ComponentPtrRegistryHeadIndex = m_ComponentPtrRegistryHeadIndex;
-			m_Next->m_Previous = NULL;
+			m_pArchetypeStorage->RemoveCollection( rCollection );
 		}
-		else
+
+		for ( Map< TypeId, Component * >::Iterator iter = rCollection.m_Components.Begin();
+			iter != rCollection.m_Components.End(); ++iter)
 		{
-			g_ComponentPtrRegistry[m_ComponentPtrRegistryHeadIndex] = NULL;
+			DynamicArray< Component * > &rBucket = m_ReleaseBuckets[ iter->First() ];
+			for ( Component *pComponent = iter->Second(); pComponent; pComponent = pComponent->GetNextComponent() )
+			{
+				rBucket.Push( pComponent );
+			}
 		}
-
-		// Unmark ourself as a head node
-		m_ComponentPtrRegistryHeadIndex = Helium::Invalid<uint16_t>();
-	} 
-	// Unlink ourself from doubly linked list of component ptrs
-	else if (m_Previous)
-	{
-		m_Previous->m_Next = m_Next;
 	}
 
-	if (m_Next)
+	// Free by pool so each pool's roster and bookkeeping is only brought in once
+	for ( size_t typeIndex = 0; typeIndex < m_ReleaseBuckets.GetSize(); ++typeIndex )
 	{
-		m_Next->m_Previous = m_Previous;
+		DynamicArray< Component * > &rBucket = m_ReleaseBuckets[ typeIndex ];
+		if ( !rBucket.IsEmpty() )
+		{
+			m_Pools[ typeIndex ]->Free( rBucket.GetData(), rBucket.GetSize() );
+			rBucket.Resize( 0 );
+		}
 	}
-
-	m_Previous = 0;
-	m_Next = 0;
 }
 
 #if HELIUM_TOOLS
@@ -55,7 +55,11 @@
 	Helium::Components::ComponentRegistrar<__Type, __Type::ComponentBase> __Type::s_ComponentRegistrar(#__Type, __Count); \
 	HELIUM_DEFINE_DERIVED_STRUCT( __Type )
 
-#define HELIUM_COMPONENT_PTR_CHECK_FREQUENCY (256)
+// Define to 1 to allow more than 65534 components of a single type per world (grows DataInline by 4 bytes)
+#ifndef HELIUM_COMPONENT_INDEX_32
+#define HELIUM_COMPONENT_INDEX_32 0
+#endif
+
 #define HELIUM_COMPONENT_POOL_ALIGN_SIZE (32)
 #define HELIUM_COMPONENT_POOL_ALIGN_SIZE_MASK (~(POOL_ALIGN_SIZE-1))
 
@@ -70,6 +74,9 @@ namespace Helium
 
 	namespace Components
 	{
+		class Archetype;
+		class ArchetypeStorage;
+
 		template <class T>
 		struct ComponentListT
 		{
@@ -87,13 +94,40 @@ namespace Helium
 	{
 		//! Component type id (not the same as the reflect class id).
 		typedef uint16_t TypeId;
+#if HELIUM_COMPONENT_INDEX_32
+		typedef uint32_t ComponentIndex;
+#else
 		typedef uint16_t ComponentIndex;
+#endif
 		typedef uint16_t ComponentSizeType;
-		typedef uint8_t GenerationIndex;
-
-		const static uint32_t COMPONENT_PTR_CHECK_FREQUENCY = 256;
+		typedef uint16_t GenerationIndex;
+
+		//! Packed reference to a component: [pool serial:4][pool handle slot:12][generation:16][component index:32]. Zero
+		//! is the null handle. Resolving a handle is O(1) and fails once the component is freed, without any registration.
+		//! The serial changes each time a handle slot is reused, so handles into a destroyed pool don't resolve against a
+		//! new pool that took over its slot.
+		typedef uint64_t Handle;
+
+		//! Number of generation bits actually stored per component (the top bit of the field is the delete flag)
+		const static uint32_t GENERATION_BITS = 15;
+		//! Maximum number of pools (across all component managers) that can be live at once
+		const static uint32_t POOL_HANDLE_SLOT_COUNT = 4096;
+		//! Bits of a handle's pool key used for the handle slot (the rest hold the pool serial)
+		const static uint32_t POOL_HANDLE_SLOT_BITS = 12;
+		HELIUM_COMPILE_ASSERT( POOL_HANDLE_SLOT_COUNT <= ( 1 << POOL_HANDLE_SLOT_BITS ) );
+		//! Fewest components per pool page, so that small pools don't grow a few components at a time (must be a power
+		//! of two)
+		const static size_t POOL_PAGE_SIZE_MIN = 64;
 		const static uintptr_t POOL_ALIGN_SIZE = 32;
 		const static uintptr_t POOL_ALIGN_SIZE_MASK = ~(POOL_ALIGN_SIZE-1);
+
+		//! What a pool does when all of its components are allocated
+		enum PoolOverflowPolicy
+		{
+			POOL_OVERFLOW_FAIL,           //< Assert and fail the allocation
+			POOL_OVERFLOW_GROW,           //< Add a page of components
+			POOL_OVERFLOW_GROW_AND_WARN,  //< Add a page of components and warn so the pool size can be tuned
+		};
 		
 #if HELIUM_HEAP
 		HELIUM_FRAMEWORK_API extern Helium::DynamicMemoryHeap g_ComponentAllocator;
@@ -111,6 +145,9 @@ namespace Helium
 			DynamicArray<TypeId>       m_ImplementedTypes;       //< Parent type IDs of this type
 			DynamicArray<TypeId>       m_ImplementingTypes;      //< Child types IDs of this type
 			ComponentIndex             m_DefaultCount;           //< Default number of components of this type to make
+			PoolOverflowPolicy         m_OverflowPolicy;         //< What pools of this type do when they run out of components
+			ComponentIndex             m_HighWaterMark;          //< Most components of this type allocated at once in any destroyed pool
+			volatile int32_t           m_PoolGrowCount;          //< Number of pages added to pools of this type past their initial size (atomic, pools in several worlds may grow at once)
 
 			virtual void       Construct(Component *ptr) const = 0;
 			virtual void       Destruct(Component *ptr) const = 0;
@@ -152,28 +189,41 @@ namespace Helium
 			virtual void Register();
 		};
 		
+		//! Bookkeeping stored in every component. Kept small because it sits between the payloads of neighbouring
+		//! components in a pool; anything not needed to find a component's pool or walk its chain belongs in DataParallel.
 		struct HELIUM_FRAMEWORK_API DataInline
 		{
-			IHasComponents*  m_Owner;
 			uint16_t         m_OffsetToPoolStart;
 			ComponentIndex   m_Next;
 			ComponentIndex   m_Previous;
-			GenerationIndex  m_Generation;
-			bool             m_Delete;
+			GenerationIndex  m_Generation : GENERATION_BITS;
+			GenerationIndex  m_Delete : 1;
 		};
 		
+		//! Bookkeeping the pool keeps in its own array, indexed by component index, out of the way of component payloads
 		struct HELIUM_FRAMEWORK_API DataParallel
 		{
+			IHasComponents*       m_Owner;
 			ComponentCollection*  m_Collection;
 			ComponentIndex        m_RosterIndex;
 		};
 		
+		//! Header at the start of each page of components, lets a component find its pool and index
+		struct HELIUM_FRAMEWORK_API PoolPage
+		{
+			Pool*                      m_Pool;
+			ComponentIndex             m_FirstIndex;
+		};
+
+		//! Components live in fixed-size pages so a pool can grow without moving any component
 		struct HELIUM_FRAMEWORK_API Pool
 		{
 		public:
 			static Pool*               CreatePool( ComponentManager *pComponentManager, const TypeData &rTypeData, ComponentIndex count );
 			static void                DestroyPool( Pool *pPool );
 			static inline Pool*        GetPool( const Component *component );
+			static inline Component*   ResolveHandle( Handle handle );
+			static inline Component*   ResolveHandle( Handle handle, TypeId typeId );
 									   
 			inline TypeId              GetTypeId() const;
 			inline ComponentManager*   GetComponentManager() const;
@@ -182,7 +232,7 @@ namespace Helium
 			inline ComponentIndex      GetComponentIndex(const Component *component) const;
 			inline ComponentCollection* GetComponentCollection(const Component *component) const;
 
-			inline void*               GetComponentOwner(const Component *component) const;
+			inline IHasComponents*     GetComponentOwner(const Component *component) const;
 									   
 			inline Component*          GetNext(Component *component) const;
 			inline Component*          GetNext(ComponentIndex index) const;
@@ -193,12 +243,20 @@ namespace Helium
 			inline ComponentIndex      GetPreviousIndex(Component *component) const;
 			inline ComponentIndex      GetPreviousIndex(ComponentIndex index) const;
 			inline GenerationIndex     GetGeneration(ComponentIndex index) const;
+			inline Handle              GetHandle(const Component *component) const;
 			inline ComponentIndex      GetAllocatedCount() const;
+			inline ComponentIndex      GetCapacity() const;
+			inline ComponentIndex      GetHighWaterMark() const;
+			inline size_t              GetPageCount() const;
 			inline Component * const * GetAllocatedComponents() const;
 			inline Component *         GetComponentByRosterIndex(ComponentIndex index) const;
 
+			//! Makes sure count more components can be allocated, growing according to the overflow policy if needed
+			bool                       Reserve(size_t count);
 			Component*                 Allocate(Components::IHasComponents *owner, ComponentCollection &collection);
 			void                       Free(Component *component);
+			//! Frees several components of this pool in one pass
+			void                       Free(Component * const *components, size_t count);
 			void                       InsertIntoChain(Component *_insertee, ComponentIndex _insertee_index, Component *nextComponent);
 			void                       RemoveFromChain(Component *_component, ComponentIndex index);
 
@@ -208,10 +266,14 @@ namespace Helium
 
 		private:
 
-			inline uintptr_t           GetFirstComponentPtr() const;
+			static inline PoolPage*    GetPage( const Component *component );
+			inline uintptr_t           GetFirstComponentPtr( const PoolPage *page ) const;
+			bool                       AddPage();
+			bool                       Grow( size_t count );
 									   
 			DynamicArray<Component *>  m_Roster;
-			DataParallel*              m_ParallelData;
+			DynamicArray<DataParallel> m_ParallelData;
+			DynamicArray<PoolPage *>   m_Pages;
 			World*                     m_World;
 			ComponentManager*          m_ComponentManager;
 			const TypeData*            m_Type;
@@ -219,11 +281,21 @@ namespace Helium
 			TypeId                     m_TypeId;
 			ComponentSizeType          m_ComponentSize;
 			ComponentIndex             m_FirstUnallocatedIndex;
+			ComponentIndex             m_PageSize;           //< Number of components per page (a power of two)
+			ComponentIndex             m_PageMask;           //< m_PageSize - 1, masks an index down to its offset within its page
+			uint16_t                   m_PageShift;          //< log2( m_PageSize ), shifts an index down to its page
+			ComponentIndex             m_HighWaterMark;      //< Most components allocated at once
+			PoolOverflowPolicy         m_OverflowPolicy;
+			uint16_t                   m_HandleSlot;         //< Index into g_PoolsByHandleSlot
+			uint16_t                   m_HandleKey;          //< Handle slot combined with the slot's serial when this pool claimed it
 		};
+
+		//! Live pools by handle slot, used to resolve handles
+		HELIUM_FRAMEWORK_API extern Pool* g_PoolsByHandleSlot[ POOL_HANDLE_SLOT_COUNT ];
 		
 		HELIUM_FRAMEWORK_API void                Startup( SystemDefinition *pSystemDefinition );
 		HELIUM_FRAMEWORK_API void                Shutdown();
-		HELIUM_FRAMEWORK_API void                Tick();
+		HELIUM_FRAMEWORK_API void                ReportPoolUsage();
 		
 		HELIUM_FRAMEWORK_API TypeId              RegisterType(
 			const Reflect::MetaStruct *_structure, 
@@ -231,6 +303,7 @@ namespace Helium
 			TypeData*                 _base_type_data, 
 			uint16_t                  _count);
 		HELIUM_FRAMEWORK_API const TypeData*     GetTypeData( TypeId type );
+		HELIUM_FRAMEWORK_API size_t              GetTypeCount();
 
 		HELIUM_FRAMEWORK_API ComponentManagerPtr   CreateManager( World *pWorld );
 
@@ -242,14 +315,19 @@ namespace Helium
 	public:
 		virtual                  ~ComponentManager();
 
-		void                     RegisterComponentPtr( ComponentPtrBase &pPtr );
 		inline World*            GetWorld() const;
 		inline const Components::Pool*  GetPool( Components::TypeId typeId );
+		inline Components::ArchetypeStorage* GetArchetypeStorage() const;
 
 		inline Component*        Allocate(Components::TypeId type, Components::IHasComponents *pOwner, ComponentCollection &rCollection);
+		inline bool              Reserve(Components::TypeId type, size_t count);
 		inline size_t            CountAllocatedComponents( Components::TypeId typeId ) const;
 		size_t                   CountAllocatedComponentsThatImplement( Components::TypeId typeId ) const;
 
+		//! Frees every component in the given collections. Components are freed pool by pool and each collection leaves
+		//! the archetype storage once, so this is much cheaper than calling ReleaseAll() on each collection in turn.
+		void                     ReleaseComponents( ComponentCollection * const *ppCollections, size_t count );
+
 		template < class T > T*        Allocate( Components::IHasComponents *pOwner, ComponentCollection &rCollection );
 		template < class T > size_t    CountAllocatedComponents();
 		template < class T > size_t    CountAllocatedComponentsThatImplement();
@@ -260,6 +338,8 @@ namespace Helium
 
 		World *m_World;
 		DynamicArray<Components::Pool *> m_Pools;
+		Components::ArchetypeStorage *m_pArchetypeStorage; //< NULL unless SystemDefinition enables archetype storage
+		DynamicArray< DynamicArray<Component *> > m_ReleaseBuckets; //< Scratch space for ReleaseComponents(), indexed by type
 	};
 
 
@@ -336,7 +416,14 @@ namespace Helium
 
 	private:
 		friend Components::Pool;
+		friend Components::ArchetypeStorage;
+		friend ComponentManager;
 		Map< Components::TypeId, Component * > m_Components;
+
+		// Archetype row this collection occupies (only used when the manager has archetype storage)
+		Components::Archetype *m_pArchetype;
+		uint32_t               m_ArchetypeRow;
+		bool                   m_bArchetypeChangePending; //< Waiting to change archetype once a query iteration ends
 	};
 
 	//! All components have some data for bookkeeping
@@ -354,6 +441,7 @@ namespace Helium
 		inline void                          FreeComponentDeferred();
 
 		inline const Components::DataInline& GetInlineData() const;
+		inline Components::Handle            GetHandle() const;
 
 		template <class T> T* AllocateSiblingComponent();
 		
@@ -361,7 +449,6 @@ namespace Helium
 
 	private:
 		friend Components::Pool;
-		friend ComponentPtrBase;
 		Components::DataInline m_InlineData;
 	};
 
@@ -373,35 +460,19 @@ namespace Helium
 		inline void Check() const;
 		inline bool IsGood() const;
 		inline void Reset(Component *_component = 0);
-
-		ComponentPtrBase *GetNextComponetPtr() { return m_Next; }
-		friend ComponentManager;
-		friend void Helium::Components::Tick();
+		inline Components::Handle GetHandle() const;
 
 	protected:
 		inline ComponentPtrBase();
-		inline ~ComponentPtrBase();
 
-		inline void Reset(Component *_component) const;
-		void Unlink() const;
-			
-		// Component we point to. NOTE: This will ALWAYS be a type T component because 
-		// this class never sets m_Component to anything but NULL. Our non-base template
-		// class is the only way to construct this class or assign a pointer
-		mutable Component *m_Component; 
+		// Resolve the handle, NULL if the component has been freed
+		inline Component *Resolve() const;
+		inline Component *Resolve( Components::TypeId typeId ) const;
 
-	private:
-		// Doubly linked list lets us unsplice ourself easily from list of "allocated" ComponentPtrs
-		mutable ComponentPtrBase *m_Next;
-		mutable ComponentPtrBase *m_Previous;
-			
-		// We set this generation when a component is assigned
-		mutable Components::GenerationIndex m_Generation;
-
-		// If not assigned to Helium::Invalid<uint16_t>(), this node is head of
-		// linked list and is pointed to by g_ComponentPtrRegistry. Destruction of this
-		// Ptr will automatically fix that reference.
-		mutable uint16_t m_ComponentPtrRegistryHeadIndex;
+		// Handle of the component we point to. NOTE: This will ALWAYS refer to a type T component because
+		// this class never sets it to anything but the null handle. Our non-base template class is the only
+		// way to construct this class or assign a pointer
+		mutable Components::Handle m_Handle;
 	};
 
 	// Code that uses T goes here
@@ -415,9 +486,6 @@ namespace Helium
 
 		void operator=(T *_component);
 
-		// Only safe to call this if you know the component was not deallocated since Check() was called
-		T *UncheckedGet() const;
-		
 		T *Get();
 		const T *Get() const;
 
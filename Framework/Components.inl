@@ -7,6 +7,9 @@ namespace Helium
 		
 		TypeData::TypeData() 
 			: m_TypeId(Invalid<TypeId>())
+			, m_OverflowPolicy(POOL_OVERFLOW_GROW_AND_WARN)
+			, m_HighWaterMark(0)
+			, m_PoolGrowCount(0)
 		{
 
 		}
@@ -85,13 +88,64 @@ namespace Helium
 		}
 
 		Pool* Pool::GetPool( const Component *component )
+		{
+			return GetPage( component )->m_Pool;
+		}
+
+		PoolPage* Pool::GetPage( const Component *component )
 		{
 			HELIUM_ASSERT( component->m_InlineData.m_OffsetToPoolStart );
-			return reinterpret_cast<Pool *>( 
+			return reinterpret_cast<PoolPage *>( 
 				( reinterpret_cast<uintptr_t>(component) & POOL_ALIGN_SIZE_MASK ) - 
 				( static_cast<uintptr_t>( component->m_InlineData.m_OffsetToPoolStart ) * HELIUM_COMPONENT_POOL_ALIGN_SIZE ) );
 		}
 		
+		Component* Pool::ResolveHandle( Handle handle )
+		{
+			uint16_t key = static_cast<uint16_t>( handle >> 48 );
+			if ( !key )
+			{
+				return NULL;
+			}
+
+			// The serial part of the key must match too, or the pool that issued the handle is gone
+			const Pool *pPool = g_PoolsByHandleSlot[ key & ( ( 1 << POOL_HANDLE_SLOT_BITS ) - 1 ) ];
+			ComponentIndex index = static_cast<ComponentIndex>( handle & 0xffffffff );
+			if ( !pPool || pPool->m_HandleKey != key || index >= pPool->m_Roster.GetSize() || !pPool->m_ParallelData[ index ].m_Collection )
+			{
+				return NULL;
+			}
+
+			Component *pComponent = pPool->GetComponent( index );
+			if ( pComponent->m_InlineData.m_Generation != static_cast<GenerationIndex>( ( handle >> 32 ) & 0xffff ) )
+			{
+				return NULL;
+			}
+
+			return pComponent;
+		}
+
+		Component* Pool::ResolveHandle( Handle handle, TypeId typeId )
+		{
+			Component *pComponent = ResolveHandle( handle );
+			if ( !pComponent )
+			{
+				return NULL;
+			}
+
+			// The component must be of the requested type or a type derived from it
+			const DynamicArray<TypeId> &rImplementedTypes = GetPool( pComponent )->m_Type->m_ImplementedTypes;
+			for ( DynamicArray<TypeId>::ConstIterator iter = rImplementedTypes.Begin(); iter != rImplementedTypes.End(); ++iter )
+			{
+				if ( *iter == typeId )
+				{
+					return pComponent;
+				}
+			}
+
+			return NULL;
+		}
+
 		TypeId Pool::GetTypeId() const
 		{
 			return m_TypeId;
@@ -111,7 +165,8 @@ namespace Helium
 		{
 			if ( IsValid<ComponentIndex>( index ) )
 			{
-				return reinterpret_cast<Component *>( GetFirstComponentPtr() + index * m_ComponentSize );
+				return reinterpret_cast<Component *>( 
+					GetFirstComponentPtr( m_Pages[ index >> m_PageShift ] ) + ( index & m_PageMask ) * m_ComponentSize );
 			}
 
 			return NULL;
@@ -119,7 +174,9 @@ namespace Helium
 
 		ComponentIndex Pool::GetComponentIndex( const Component *component ) const
 		{
-			return static_cast<ComponentIndex>( ( reinterpret_cast<uintptr_t>( component ) - GetFirstComponentPtr() ) / static_cast<uintptr_t>(m_ComponentSize) );
+			const PoolPage *page = GetPage( component );
+			return page->m_FirstIndex + static_cast<ComponentIndex>( 
+				( reinterpret_cast<uintptr_t>( component ) - GetFirstComponentPtr( page ) ) / static_cast<uintptr_t>(m_ComponentSize) );
 		}
 		
 		ComponentCollection* Pool::GetComponentCollection( const Component *component ) const
@@ -127,9 +184,9 @@ namespace Helium
 			return m_ParallelData[ GetComponentIndex( component ) ].m_Collection;
 		}
 
-		void* Pool::GetComponentOwner( const Component *component ) const
+		IHasComponents* Pool::GetComponentOwner( const Component *component ) const
 		{
-			return component->m_InlineData.m_Owner;
+			return m_ParallelData[ GetComponentIndex( component ) ].m_Owner;
 		}
 
 		Component* Pool::GetNext( Component *component ) const
@@ -180,12 +237,34 @@ namespace Helium
 		{
 			return GetComponent( index )->m_InlineData.m_Generation;
 		}
+
+		Handle Pool::GetHandle( const Component *component ) const
+		{
+			return ( static_cast<Handle>( m_HandleKey ) << 48 ) |
+				( static_cast<Handle>( component->m_InlineData.m_Generation ) << 32 ) |
+				static_cast<Handle>( GetComponentIndex( component ) );
+		}
 		
 		ComponentIndex Pool::GetAllocatedCount() const
 		{
 			return m_FirstUnallocatedIndex;
 		}
 		
+		ComponentIndex Pool::GetCapacity() const
+		{
+			return static_cast<ComponentIndex>( m_Roster.GetSize() );
+		}
+
+		ComponentIndex Pool::GetHighWaterMark() const
+		{
+			return m_HighWaterMark;
+		}
+
+		size_t Pool::GetPageCount() const
+		{
+			return m_Pages.GetSize();
+		}
+
 		Component * const * Pool::GetAllocatedComponents() const
 		{
 			return m_Roster.GetData();
@@ -197,10 +276,10 @@ namespace Helium
 			return m_Roster[index];
 		}
 				
-		uintptr_t Pool::GetFirstComponentPtr() const
+		uintptr_t Pool::GetFirstComponentPtr( const PoolPage *page ) const
 		{
-			static const uintptr_t POOL_SIZE = (  (sizeof(Pool) + (HELIUM_SIMD_ALIGNMENT-1))  &  (~(HELIUM_SIMD_ALIGNMENT-1))  );
-			return reinterpret_cast<uintptr_t>(this) + POOL_SIZE + m_ComponentOffset;
+			static const uintptr_t PAGE_HEADER_SIZE = (  (sizeof(PoolPage) + (HELIUM_SIMD_ALIGNMENT-1))  &  (~(HELIUM_SIMD_ALIGNMENT-1))  );
+			return reinterpret_cast<uintptr_t>(page) + PAGE_HEADER_SIZE + m_ComponentOffset;
 		}
 				
 		template <class T>
@@ -342,6 +421,11 @@ namespace Helium
 		return m_Pools[ type ]->Allocate( pOwner, rCollection );
 	}
 
+	bool ComponentManager::Reserve( Components::TypeId type, size_t count )
+	{
+		return !count || ( m_Pools[ type ] && m_Pools[ type ]->Reserve( count ) );
+	}
+
 	size_t ComponentManager::CountAllocatedComponents( Components::TypeId typeId ) const
 	{
 		return m_Pools[ typeId ]->GetAllocatedCount();
@@ -373,8 +457,16 @@ namespace Helium
 	{
 		return m_Pools[ typeId ];
 	}
+
+	Components::ArchetypeStorage * Helium::ComponentManager::GetArchetypeStorage() const
+	{
+		return m_pArchetypeStorage;
+	}
 	
 	Helium::ComponentCollection::ComponentCollection()
+		: m_pArchetype( NULL )
+		, m_ArchetypeRow( Invalid<uint32_t>() )
+		, m_bArchetypeChangePending( false )
 	{
 
 	}
@@ -476,7 +568,9 @@ namespace Helium
 
 	Components::IHasComponents* Component::GetOwner() const
 	{
-		return m_InlineData.m_Owner;
+		Components::Pool* pool = Components::Pool::GetPool( this );
+		HELIUM_ASSERT( pool );
+		return pool->GetComponentOwner( this );
 	}
 
 	World* Component::GetWorld() const
@@ -503,6 +597,11 @@ namespace Helium
 		return m_InlineData;
 	}
 
+	Components::Handle Component::GetHandle() const
+	{
+		return Components::Pool::GetPool( this )->GetHandle( this );
+	}
+
 
 	template <class T>
 	T* Helium::Component::AllocateSiblingComponent()
@@ -512,65 +611,42 @@ namespace Helium
 
 	void ComponentPtrBase::Check() const
 	{
-		// If no component, we're done
-		if (!m_Component)
-		{
-			return;
-		}
-
-		// If generation doesn't match
-		if (m_Component->m_InlineData.m_Generation != m_Generation)
+		// Drop the handle if the component has been freed
+		if (m_Handle && !Resolve())
 		{
-			// Drop the component
-			Reset(NULL);
+			m_Handle = 0;
 		}
 	}
 
 	bool ComponentPtrBase::IsGood() const
 	{
-		Check();
-		return (m_Component != NULL);
+		return (Resolve() != NULL);
 	}
 
 	void ComponentPtrBase::Reset( Component *_component )
 	{
-		const ComponentPtrBase *ptr = this;
-		ptr->Reset(_component);
+		m_Handle = _component ? _component->GetHandle() : 0;
 	}
 
-	void ComponentPtrBase::Reset( Component *_component ) const
+	Components::Handle ComponentPtrBase::GetHandle() const
 	{
-		if (m_Component == _component)
-		{
-			// Is also desired case for assigning null to null ptr
-			return;
-		}
-
-		Unlink();
-		HELIUM_ASSERT(m_ComponentPtrRegistryHeadIndex == Helium::Invalid<uint16_t>());
-		m_Component = _component;
-
-		if (m_Component)
-		{
-			m_Generation = m_Component->m_InlineData.m_Generation;
-			m_Component->GetComponentManager()->RegisterComponentPtr( *const_cast<ComponentPtrBase *>(this) );
-			HELIUM_ASSERT( m_ComponentPtrRegistryHeadIndex != Helium::Invalid<uint16_t>() );
-			HELIUM_ASSERT( !m_Next || m_Next->m_ComponentPtrRegistryHeadIndex == Helium::Invalid<uint16_t>() );
-		}
+		return m_Handle;
 	}
 
-	ComponentPtrBase::ComponentPtrBase() 
-		: m_Next(0)
-		, m_Previous(0)
-		, m_Component(0)
-		, m_ComponentPtrRegistryHeadIndex(Helium::Invalid<uint16_t>())
+	Component *ComponentPtrBase::Resolve() const
 	{
+		return Components::Pool::ResolveHandle( m_Handle );
+	}
 
+	Component *ComponentPtrBase::Resolve( Components::TypeId typeId ) const
+	{
+		return Components::Pool::ResolveHandle( m_Handle, typeId );
 	}
 
-	ComponentPtrBase::~ComponentPtrBase()
+	ComponentPtrBase::ComponentPtrBase() 
+		: m_Handle(0)
 	{
-		Unlink();
+
 	}
 		
 	template <class T>
@@ -588,7 +664,7 @@ namespace Helium
 	template <class T>
 	ComponentPtr<T>::ComponentPtr( const ComponentPtr& _rhs )
 	{
-		Reset(_rhs.m_Component);
+		m_Handle = _rhs.m_Handle;
 	}
 
 	template <class T>
@@ -597,24 +673,16 @@ namespace Helium
 		Reset(_component);
 	}
 
-	template <class T>
-	T * ComponentPtr<T>::UncheckedGet() const
-	{
-		return static_cast<T*>(m_Component);
-	}
-
 	template <class T>
 	T * ComponentPtr<T>::Get()
 	{
-		Check();
-		return UncheckedGet();
+		return static_cast<T*>(Resolve( T::GetStaticComponentTypeData().m_TypeId ));
 	}
 
 	template <class T>
 	const T * ComponentPtr<T>::Get() const
 	{
-		Check();
-		return UncheckedGet();
+		return static_cast<const T*>(Resolve( T::GetStaticComponentTypeData().m_TypeId ));
 	}
 
 	template <class T>
@@ -1,6 +1,7 @@
 #include "FrameworkPch.h"
 #include "Framework/Entity.h"
 
+#include "Platform/Atomic.h"
 #include "Framework/Slice.h"
 #include "Foundation/Log.h"
 #include "Framework/World.h"
@@ -24,6 +25,32 @@ World * Helium::Entity::GetWorld()
 	return m_spSlice ? m_spSlice->GetWorld() : NULL;
 }
 
+/// Queue this entity for destruction at the end of the current world update.
+///
+/// Safe to call from any thread and any number of times; only the first call queues the entity.
+///
+/// @see IsDeferredDestroySet(), World::DestroyDeferredEntities()
+void Entity::DeferredDestroy()
+{
+	if ( AtomicExchange( m_DeferredDestroy, 1 ) != 0 )
+	{
+		return;
+	}
+
+	World *pWorld = GetWorld();
+	if ( !pWorld )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Warning,
+			TXT( "Entity::DeferredDestroy(): Entity \"%s\" is not in a world and will not be destroyed.\n" ),
+			*m_DefinitionPath.ToString() );
+
+		return;
+	}
+
+	pWorld->EnqueueDeferredDestroy( this );
+}
+
 /// Set the slice to which this entity is currently bound, along with the index of this entity within the slice.
 ///
 /// @param[in] pSlice      SceneDefinition to set.
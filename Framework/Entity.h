@@ -25,8 +25,9 @@ namespace Helium
 		static void PopulateMetaType( Reflect::MetaStruct& comp );
 		
 		Entity()
-			: m_DeferredDestroy(false)
-			, m_sliceIndex(Invalid<size_t>()) { }
+			: m_sliceIndex(Invalid<size_t>())
+			, m_pNextDeferredDestroy(NULL)
+			, m_DeferredDestroy(0) { }
 		~Entity();
 		
 		// TODO: Wish I could inline this but cyclical #includes..
@@ -56,10 +57,25 @@ namespace Helium
 		void ClearSliceInfo();
 		//@}
 
-		void DeferredDestroy() { m_DeferredDestroy = true; }
-		bool IsDeferredDestroySet() { return m_DeferredDestroy; }
+		/// @name Tags
+		//@{
+		inline void SetTag( Tags::TagId tag );
+		inline void ClearTag( Tags::TagId tag );
+		inline bool HasTag( Tags::TagId tag ) const;
+		template <class T> void SetTag() { SetTag( Tags::GetTag<T>() ); }
+		template <class T> void ClearTag() { ClearTag( Tags::GetTag<T>() ); }
+		template <class T> bool HasTag() const { return HasTag( Tags::GetTag<T>() ); }
+		//@}
+
+		/// @name Deferred Destruction
+		//@{
+		void DeferredDestroy();
+		bool IsDeferredDestroySet() { return m_DeferredDestroy != 0; }
+		//@}
 		
 	private:
+		friend class World;
+
 		// Avoid using these vfuncs if you can! Use GetComponents() and GetWorld
 		virtual ComponentManager* VirtualGetComponentManager() override;
 		virtual ComponentCollection& VirtualGetComponents() override;
@@ -73,7 +89,12 @@ namespace Helium
 		/// keep it allocated if we don't need to.
 		AssetPath m_DefinitionPath;
 
-		bool m_DeferredDestroy;
+		/// Next entity in the world's deferred destruction queue.
+		Entity* m_pNextDeferredDestroy;
+		/// Reference held by the deferred destruction queue so queued entities stay alive until the queue is drained.
+		Helium::StrongPtr<Entity> m_spDeferredDestroyReference;
+		/// Non-zero once DeferredDestroy() has been called.
+		volatile int32_t m_DeferredDestroy;
 		
 	};
 	typedef Helium::StrongPtr<Entity> EntityPtr;
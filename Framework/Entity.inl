@@ -55,4 +55,38 @@ namespace Helium
 	{
 		return m_sliceIndex;
 	}
-}
\ No newline at end of file
+
+	/// Set a tag on this entity.  The entity must be in a slice.
+	///
+	/// @param[in] tag  Tag to set.
+	///
+	/// @see ClearTag(), HasTag()
+	void Entity::SetTag( Tags::TagId tag )
+	{
+		HELIUM_ASSERT( m_spSlice );
+		m_spSlice->GetTagColumns().Set( tag, m_sliceIndex );
+	}
+
+	/// Clear a tag on this entity.  The entity must be in a slice.
+	///
+	/// @param[in] tag  Tag to clear.
+	///
+	/// @see SetTag(), HasTag()
+	void Entity::ClearTag( Tags::TagId tag )
+	{
+		HELIUM_ASSERT( m_spSlice );
+		m_spSlice->GetTagColumns().Clear( tag, m_sliceIndex );
+	}
+
+	/// Check whether this entity has a tag.
+	///
+	/// @param[in] tag  Tag to test.
+	///
+	/// @return  True if the tag is set, false if not or if the entity is not in a slice.
+	///
+	/// @see SetTag(), ClearTag()
+	bool Entity::HasTag( Tags::TagId tag ) const
+	{
+		return m_spSlice ? m_spSlice->GetTagColumns().Test( tag, m_sliceIndex ) : false;
+	}
+}
@@ -28,6 +28,7 @@ EntityDefinition::~EntityDefinition()
 void Helium::EntityDefinition::AddComponentDefinition( Helium::Name name, Helium::ComponentDefinition *pComponentDefinition )
 {
 	m_ComponentSet.AddComponentDefinition(name, pComponentDefinition);
+	m_DeploymentPlan.Clear();
 }
 
 Helium::EntityPtr Helium::EntityDefinition::CreateEntity()
@@ -42,3 +43,55 @@ void Helium::EntityDefinition::FinalizeEntity( Entity *pEntity, const ParameterS
 	pEntity->DeployComponents(m_Components);
 	pEntity->DeployComponents(m_ComponentSet, pParameterSet);
 }
+
+void Helium::EntityDefinition::FinalizeEntities( Entity * const *ppEntities, size_t count, const ParameterSet * const *ppParameterSets, size_t parameterSetCount )
+{
+	HELIUM_ASSERT( ppEntities || !count );
+	HELIUM_ASSERT( parameterSetCount == 0 || parameterSetCount == 1 || parameterSetCount == count );
+
+	if ( !count )
+	{
+		return;
+	}
+
+	const ComponentDeploymentPlan &rPlan = GetDeploymentPlan();
+
+	ComponentManager *pManager = ppEntities[0]->VirtualGetComponentManager();
+	HELIUM_ASSERT( pManager );
+	rPlan.ReservePools( *pManager, count );
+
+	// Components hold on to the definition they were created from, so entities may only share clones bound to the same
+	// parameters. Clone again whenever the parameter set changes from one entity to the next.
+	DynamicArray<ComponentDefinitionPtr> clones;
+	const ParameterSet *pBoundParameterSet = NULL;
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		HELIUM_ASSERT( ppEntities[i] );
+
+		const ParameterSet *pParameterSet = NULL;
+		if ( parameterSetCount )
+		{
+			pParameterSet = ppParameterSets[ parameterSetCount > 1 ? i : 0 ];
+		}
+
+		if ( i == 0 || pParameterSet != pBoundParameterSet )
+		{
+			rPlan.CloneDefinitions( clones );
+			rPlan.BindParameters( clones, pParameterSet );
+			pBoundParameterSet = pParameterSet;
+		}
+
+		rPlan.Deploy( *ppEntities[i], clones );
+	}
+}
+
+const Helium::ComponentDeploymentPlan & Helium::EntityDefinition::GetDeploymentPlan()
+{
+	if ( !m_DeploymentPlan.IsBuilt() )
+	{
+		m_DeploymentPlan.Build( m_ComponentSet, &m_Components );
+	}
+
+	return m_DeploymentPlan;
+}
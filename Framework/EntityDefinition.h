@@ -38,10 +38,19 @@ namespace Helium
 		EntityPtr CreateEntity();
 		void FinalizeEntity(Entity *pEntity, const ParameterSet *pParameterSet = NULL);
 
+		// Batched version of FinalizeEntity(). parameterSetCount is 0 (no parameters), 1 (shared by every entity), or
+		// count (one per entity)
+		void FinalizeEntities(Entity * const *ppEntities, size_t count, const ParameterSet * const *ppParameterSets, size_t parameterSetCount);
+
+		const ComponentDeploymentPlan &GetDeploymentPlan();
+
 	private:
 
 		ComponentSet m_ComponentSet;
 		DynamicArray<ComponentDefinitionPtr> m_Components;
+
+		// Built on first batched spawn
+		ComponentDeploymentPlan m_DeploymentPlan;
 	};
 	typedef Helium::StrongPtr<EntityDefinition> EntityDefinitionPtr;
 }
@@ -0,0 +1,134 @@
+#include "FrameworkPch.h"
+#include "Framework/EntityTags.h"
+
+using namespace Helium;
+using namespace Helium::Tags;
+
+// Plain data so registrars running during static initialization never see these before they are constructed
+static size_t g_TagCount;
+static const char* g_TagNames[ MAX_TAG_COUNT ];
+
+TagRegistrar::TagRegistrar( const char *name )
+{
+	HELIUM_ASSERT( g_TagCount < MAX_TAG_COUNT );
+
+	m_TagId = static_cast< TagId >( g_TagCount );
+	g_TagNames[ g_TagCount++ ] = name;
+}
+
+size_t Helium::Tags::GetTagCount()
+{
+	return g_TagCount;
+}
+
+const char* Helium::Tags::GetTagName( TagId tag )
+{
+	HELIUM_ASSERT( tag < g_TagCount );
+	return g_TagNames[ tag ];
+}
+
+void TagColumns::RemoveSwap( size_t index, size_t lastIndex )
+{
+	HELIUM_ASSERT( index <= lastIndex );
+
+	for ( DynamicArray< DynamicArray< TagWord > >::Iterator iter = m_Columns.Begin(); iter != m_Columns.End(); ++iter )
+	{
+		DynamicArray< TagWord > &rColumn = *iter;
+
+		size_t lastWord = lastIndex / TAG_WORD_BITS;
+		if ( lastWord >= rColumn.GetSize() )
+		{
+			// The last entity never had this tag, so neither will whatever is moved into index
+			if ( index / TAG_WORD_BITS < rColumn.GetSize() )
+			{
+				rColumn[ index / TAG_WORD_BITS ] &= ~( TagWord( 1 ) << ( index % TAG_WORD_BITS ) );
+			}
+
+			continue;
+		}
+
+		TagWord lastBit = TagWord( 1 ) << ( lastIndex % TAG_WORD_BITS );
+		TagWord indexBit = TagWord( 1 ) << ( index % TAG_WORD_BITS );
+		TagWord &rIndexWord = rColumn[ index / TAG_WORD_BITS ];
+
+		if ( rColumn[ lastWord ] & lastBit )
+		{
+			rIndexWord |= indexBit;
+		}
+		else
+		{
+			rIndexWord &= ~indexBit;
+		}
+
+		rColumn[ lastWord ] &= ~lastBit;
+	}
+}
+
+void TagColumns::BuildMask( const TagFilter &filter, size_t count, DynamicArray< TagWord > &rMask ) const
+{
+	size_t wordCount = ( count + TAG_WORD_BITS - 1 ) / TAG_WORD_BITS;
+	rMask.Resize( wordCount );
+	if ( !wordCount )
+	{
+		return;
+	}
+
+	TagWord *pMask = rMask.GetData();
+	for ( size_t word = 0; word < wordCount; ++word )
+	{
+		pMask[ word ] = ~TagWord( 0 );
+	}
+
+	// Entities past count are not live
+	if ( count % TAG_WORD_BITS )
+	{
+		pMask[ wordCount - 1 ] = ( TagWord( 1 ) << ( count % TAG_WORD_BITS ) ) - 1;
+	}
+
+	// Whole words at a time, missing words in a column are all clear
+	for ( size_t tagIndex = 0; tagIndex < filter.GetWithCount(); ++tagIndex )
+	{
+		TagId tag = filter.GetWith( tagIndex );
+		size_t columnWordCount = tag < m_Columns.GetSize() ? Min( m_Columns[ tag ].GetSize(), wordCount ) : 0;
+		const TagWord *pColumn = columnWordCount ? m_Columns[ tag ].GetData() : NULL;
+
+		for ( size_t word = 0; word < columnWordCount; ++word )
+		{
+			pMask[ word ] &= pColumn[ word ];
+		}
+
+		for ( size_t word = columnWordCount; word < wordCount; ++word )
+		{
+			pMask[ word ] = 0;
+		}
+	}
+
+	for ( size_t tagIndex = 0; tagIndex < filter.GetWithoutCount(); ++tagIndex )
+	{
+		TagId tag = filter.GetWithout( tagIndex );
+		size_t columnWordCount = tag < m_Columns.GetSize() ? Min( m_Columns[ tag ].GetSize(), wordCount ) : 0;
+		const TagWord *pColumn = columnWordCount ? m_Columns[ tag ].GetData() : NULL;
+
+		for ( size_t word = 0; word < columnWordCount; ++word )
+		{
+			pMask[ word ] &= ~pColumn[ word ];
+		}
+	}
+}
+
+void TagColumns::Grow( TagId tag, size_t wordCount )
+{
+	HELIUM_ASSERT( tag < GetTagCount() );
+
+	if ( tag >= m_Columns.GetSize() )
+	{
+		m_Columns.Resize( GetTagCount() );
+	}
+
+	DynamicArray< TagWord > &rColumn = m_Columns[ tag ];
+	rColumn.Reserve( wordCount );
+	while ( rColumn.GetSize() < wordCount )
+	{
+		rColumn.Push( 0 );
+	}
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "Framework/Framework.h"
+
+#include "Foundation/DynamicArray.h"
+
+//! Add to any struct that will be used as an entity tag
+#define HELIUM_DECLARE_TAG( __Type ) \
+	static Helium::Tags::TagRegistrar s_TagRegistrar;
+
+#define HELIUM_DEFINE_TAG( __Type ) \
+	Helium::Tags::TagRegistrar __Type::s_TagRegistrar( #__Type );
+
+namespace Helium
+{
+	namespace Tags
+	{
+		typedef uint16_t TagId;
+
+		//! Tags carry no data, an entity either has one or it doesn't. They are stored as one bit per entity in a
+		//! column parallel to the entities of a slice, so setting, clearing and testing a tag is a single bit operation
+		//! and filtering a slice by tags touches 64 entities per word without looking at any component memory.
+		static const size_t MAX_TAG_COUNT = 256;
+
+		typedef uint64_t TagWord;
+		static const size_t TAG_WORD_BITS = 64;
+
+		struct HELIUM_FRAMEWORK_API TagRegistrar
+		{
+			TagRegistrar( const char *name );
+
+			TagId m_TagId;
+		};
+
+		HELIUM_FRAMEWORK_API size_t      GetTagCount();
+		HELIUM_FRAMEWORK_API const char* GetTagName( TagId tag );
+
+		template <class T> TagId GetTag() { return T::s_TagRegistrar.m_TagId; }
+
+		//! Tags an entity must have (With) or must not have (Without) to be visited by a query
+		class HELIUM_FRAMEWORK_API TagFilter
+		{
+		public:
+			//! Maximum number of tags on either side of a filter
+			static const size_t MAX_TAGS = 8;
+
+			inline TagFilter();
+
+			inline TagFilter&     With( TagId tag );
+			inline TagFilter&     Without( TagId tag );
+			template <class T> TagFilter& With() { return With( GetTag<T>() ); }
+			template <class T> TagFilter& Without() { return Without( GetTag<T>() ); }
+
+			inline bool           IsEmpty() const;
+			inline size_t         GetWithCount() const;
+			inline TagId          GetWith( size_t index ) const;
+			inline size_t         GetWithoutCount() const;
+			inline TagId          GetWithout( size_t index ) const;
+
+		private:
+			TagId                 m_With[ MAX_TAGS ];
+			TagId                 m_Without[ MAX_TAGS ];
+			uint16_t              m_WithCount;
+			uint16_t              m_WithoutCount;
+		};
+
+		//! One bit per slice entity for every tag, indexed by the entity's slice index. Columns grow lazily the first
+		//! time a bit past their end is set, bits past the end of a column read as clear. Not thread safe, two entities
+		//! can share a word, so tags must not be changed from parallel component passes.
+		class HELIUM_FRAMEWORK_API TagColumns
+		{
+		public:
+			inline void           Set( TagId tag, size_t index );
+			inline void           Clear( TagId tag, size_t index );
+			inline bool           Test( TagId tag, size_t index ) const;
+
+			//! Keeps the columns in step with DynamicArray::RemoveSwap() on the entity list, the bits of the last entity
+			//! move to the removed index and the last index is cleared for the next entity added
+			void                  RemoveSwap( size_t index, size_t lastIndex );
+
+			//! Fills rMask with one bit for each of the first count entities, set if the entity passes the filter
+			void                  BuildMask( const TagFilter &filter, size_t count, DynamicArray< TagWord > &rMask ) const;
+
+		private:
+			void                  Grow( TagId tag, size_t wordCount );
+
+			DynamicArray< DynamicArray< TagWord > > m_Columns;  //< Indexed by tag
+		};
+	}
+}
+
+#include "Framework/EntityTags.inl"
@@ -0,0 +1,84 @@
+
+namespace Helium
+{
+	Tags::TagFilter::TagFilter()
+		: m_WithCount( 0 )
+		, m_WithoutCount( 0 )
+	{
+
+	}
+
+	Tags::TagFilter& Tags::TagFilter::With( TagId tag )
+	{
+		HELIUM_ASSERT( tag < GetTagCount() );
+		HELIUM_ASSERT( m_WithCount < MAX_TAGS );
+		m_With[ m_WithCount++ ] = tag;
+		return *this;
+	}
+
+	Tags::TagFilter& Tags::TagFilter::Without( TagId tag )
+	{
+		HELIUM_ASSERT( tag < GetTagCount() );
+		HELIUM_ASSERT( m_WithoutCount < MAX_TAGS );
+		m_Without[ m_WithoutCount++ ] = tag;
+		return *this;
+	}
+
+	bool Tags::TagFilter::IsEmpty() const
+	{
+		return !m_WithCount && !m_WithoutCount;
+	}
+
+	size_t Tags::TagFilter::GetWithCount() const
+	{
+		return m_WithCount;
+	}
+
+	Tags::TagId Tags::TagFilter::GetWith( size_t index ) const
+	{
+		HELIUM_ASSERT( index < m_WithCount );
+		return m_With[ index ];
+	}
+
+	size_t Tags::TagFilter::GetWithoutCount() const
+	{
+		return m_WithoutCount;
+	}
+
+	Tags::TagId Tags::TagFilter::GetWithout( size_t index ) const
+	{
+		HELIUM_ASSERT( index < m_WithoutCount );
+		return m_Without[ index ];
+	}
+
+	void Tags::TagColumns::Set( TagId tag, size_t index )
+	{
+		size_t word = index / TAG_WORD_BITS;
+		if ( tag >= m_Columns.GetSize() || word >= m_Columns[ tag ].GetSize() )
+		{
+			Grow( tag, word + 1 );
+		}
+
+		m_Columns[ tag ][ word ] |= TagWord( 1 ) << ( index % TAG_WORD_BITS );
+	}
+
+	void Tags::TagColumns::Clear( TagId tag, size_t index )
+	{
+		size_t word = index / TAG_WORD_BITS;
+		if ( tag < m_Columns.GetSize() && word < m_Columns[ tag ].GetSize() )
+		{
+			m_Columns[ tag ][ word ] &= ~( TagWord( 1 ) << ( index % TAG_WORD_BITS ) );
+		}
+	}
+
+	bool Tags::TagColumns::Test( TagId tag, size_t index ) const
+	{
+		size_t word = index / TAG_WORD_BITS;
+		if ( tag < m_Columns.GetSize() && word < m_Columns[ tag ].GetSize() )
+		{
+			return ( ( m_Columns[ tag ][ word ] >> ( index % TAG_WORD_BITS ) ) & 1 ) != 0;
+		}
+
+		return false;
+	}
+}
@@ -0,0 +1,202 @@
+#include "FrameworkPch.h"
+#include "Framework/FrameProfiler.h"
+
+#include "Platform/Atomic.h"
+#include "Foundation/FileStream.h"
+#include "EngineJobs/JobManager.h"
+
+using namespace Helium;
+
+bool             FrameProfiler::sm_Enabled = false;
+ProfileEvent*    FrameProfiler::sm_pEvents = NULL;
+volatile int32_t FrameProfiler::sm_NextEvent = 0;
+uint32_t         FrameProfiler::sm_FrameIndex = 0;
+uint64_t         FrameProfiler::sm_FrameStartTicks = 0;
+
+static const uint32_t EVENT_INDEX_MASK = FrameProfiler::EVENT_CAPACITY - 1;
+
+void FrameProfiler::SetEnabled( bool bEnabled )
+{
+	if ( bEnabled && !sm_pEvents )
+	{
+		sm_pEvents = new ProfileEvent[ EVENT_CAPACITY ];
+		HELIUM_ASSERT( sm_pEvents );
+		Clear();
+	}
+
+	sm_Enabled = bEnabled;
+}
+
+void FrameProfiler::Shutdown()
+{
+	sm_Enabled = false;
+
+	delete [] sm_pEvents;
+	sm_pEvents = NULL;
+	sm_NextEvent = 0;
+}
+
+void FrameProfiler::BeginFrame()
+{
+	++sm_FrameIndex;
+
+	if ( sm_Enabled )
+	{
+		sm_FrameStartTicks = Timer::GetTickCount();
+	}
+}
+
+void FrameProfiler::EndFrame()
+{
+	if ( sm_Enabled && sm_FrameStartTicks )
+	{
+		Record( ProfileEventTypes::Frame, "Frame", sm_FrameStartTicks, Timer::GetTickCount(), sm_FrameIndex );
+	}
+}
+
+void FrameProfiler::Record( ProfileEventType type, const char *pName, uint64_t startTicks, uint64_t endTicks, uint32_t count )
+{
+	if ( !sm_Enabled )
+	{
+		return;
+	}
+
+	HELIUM_ASSERT( sm_pEvents );
+
+	// Claim a slot. Writers never wait on each other, a slot being rewritten is marked so readers skip it.
+	int32_t sequence = AtomicIncrement( sm_NextEvent ) - 1;
+	ProfileEvent &rEvent = sm_pEvents[ static_cast< uint32_t >( sequence ) & EVENT_INDEX_MASK ];
+	AtomicExchangeAcquire( rEvent.m_Sequence, -1 );
+
+	JobManager *pJobManager = JobManager::GetInstance();
+	uint32_t workerIndex = pJobManager ? pJobManager->GetCurrentWorkerIndex() : Invalid< uint32_t >();
+
+	rEvent.m_Name = pName;
+	rEvent.m_StartTicks = startTicks;
+	rEvent.m_EndTicks = endTicks;
+	rEvent.m_Frame = sm_FrameIndex;
+	rEvent.m_Count = count;
+	rEvent.m_Type = static_cast< uint16_t >( type );
+	rEvent.m_Thread = static_cast< uint16_t >( IsValid( workerIndex ) ? workerIndex + 1 : 0 );
+
+	AtomicExchangeRelease( rEvent.m_Sequence, sequence );
+}
+
+size_t FrameProfiler::GetEvents( DynamicArray< ProfileEvent > &rEvents )
+{
+	rEvents.Resize( 0 );
+
+	if ( !sm_pEvents )
+	{
+		return 0;
+	}
+
+	int32_t end = sm_NextEvent;
+	int32_t begin = Max< int32_t >( 0, end - static_cast< int32_t >( EVENT_CAPACITY ) );
+	rEvents.Reserve( static_cast< size_t >( end - begin ) );
+
+	for ( int32_t sequence = begin; sequence < end; ++sequence )
+	{
+		const ProfileEvent &rEvent = sm_pEvents[ static_cast< uint32_t >( sequence ) & EVENT_INDEX_MASK ];
+
+		// Skip events that are still being written, or that were overwritten while we copied them
+		if ( rEvent.m_Sequence != sequence )
+		{
+			continue;
+		}
+
+		ProfileEvent copy = rEvent;
+		if ( rEvent.m_Sequence == sequence )
+		{
+			rEvents.Push( copy );
+		}
+	}
+
+	return rEvents.GetSize();
+}
+
+void FrameProfiler::Clear()
+{
+	if ( sm_pEvents )
+	{
+		for ( uint32_t i = 0; i < EVENT_CAPACITY; ++i )
+		{
+			sm_pEvents[ i ].m_Sequence = -1;
+		}
+	}
+
+	sm_NextEvent = 0;
+}
+
+bool FrameProfiler::ExportChromeTrace( const char *pFileName )
+{
+	HELIUM_ASSERT( pFileName );
+
+	DynamicArray< ProfileEvent > events;
+	GetEvents( events );
+
+	FileStream* pStream = FileStream::OpenFileStream( pFileName, FileStream::MODE_WRITE, true );
+	if ( !pStream )
+	{
+		HELIUM_TRACE( TraceLevels::Error, TXT( "FrameProfiler: Failed to open \"%s\" for writing.\n" ), pFileName );
+		return false;
+	}
+
+	static const char *s_Categories[] = { "frame", "task", "world", "query" };
+	static const char *s_CountNames[] = { "frame", "index", "world", "tuples" };
+
+	uint64_t baseTicks = Invalid< uint64_t >();
+	for ( DynamicArray< ProfileEvent >::ConstIterator iter = events.Begin(); iter != events.End(); ++iter )
+	{
+		baseTicks = Min( baseTicks, iter->m_StartTicks );
+	}
+
+	float64_t microsecondsPerTick = Timer::GetSecondsPerTick() * 1000000.0;
+
+	static const char s_Header[] = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+	pStream->Write( s_Header, 1, sizeof( s_Header ) - 1 );
+
+	char buffer[ 512 ];
+	for ( size_t index = 0; index < events.GetSize(); ++index )
+	{
+		const ProfileEvent &rEvent = events[ index ];
+		HELIUM_ASSERT( rEvent.m_Type < HELIUM_ARRAY_COUNT( s_Categories ) );
+
+		char unnamed[ 32 ];
+		const char *pName = rEvent.m_Name;
+		if ( !pName )
+		{
+			StringPrint( unnamed, "%s %" PRIu32, s_Categories[ rEvent.m_Type ], rEvent.m_Count );
+			unnamed[ HELIUM_ARRAY_COUNT( unnamed ) - 1 ] = '\0';
+			pName = unnamed;
+		}
+
+		int length = StringPrint(
+			buffer,
+			"%s{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":%" PRIu16 ",\"ts\":%.3f,\"dur\":%.3f,"
+			"\"args\":{\"frame\":%" PRIu32 ",\"%s\":%" PRIu32 "}}",
+			index ? ",\n" : "",
+			pName,
+			s_Categories[ rEvent.m_Type ],
+			rEvent.m_Thread,
+			static_cast< float64_t >( rEvent.m_StartTicks - baseTicks ) * microsecondsPerTick,
+			static_cast< float64_t >( rEvent.m_EndTicks - rEvent.m_StartTicks ) * microsecondsPerTick,
+			rEvent.m_Frame,
+			s_CountNames[ rEvent.m_Type ],
+			rEvent.m_Count );
+		buffer[ HELIUM_ARRAY_COUNT( buffer ) - 1 ] = '\0';
+
+		if ( length > 0 )
+		{
+			pStream->Write( buffer, 1, Min< size_t >( static_cast< size_t >( length ), HELIUM_ARRAY_COUNT( buffer ) - 1 ) );
+		}
+	}
+
+	static const char s_Footer[] = "\n]}\n";
+	pStream->Write( s_Footer, 1, sizeof( s_Footer ) - 1 );
+
+	delete pStream;
+
+	HELIUM_TRACE( TraceLevels::Info, TXT( "FrameProfiler: Wrote %" ) PRIuSZ TXT( " events to \"%s\".\n" ), events.GetSize(), pFileName );
+	return true;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Framework/Framework.h"
+
+#include "Platform/Timer.h"
+#include "Foundation/DynamicArray.h"
+
+namespace Helium
+{
+	namespace ProfileEventTypes
+	{
+		enum ProfileEventType
+		{
+			Frame,  // One WorldManager::Update()
+			Task,   // One scheduled task, m_Count is its index in the schedule
+			World,  // One world within a task that updates worlds through ForEachWorld(), m_Count is the world index
+			Query,  // One component query, m_Count is the number of tuples visited
+		};
+	}
+	typedef ProfileEventTypes::ProfileEventType ProfileEventType;
+
+	struct ProfileEvent
+	{
+		const char*       m_Name;        //< May be NULL (task names only exist in tools builds)
+		uint64_t          m_StartTicks;
+		uint64_t          m_EndTicks;
+		uint32_t          m_Frame;
+		uint32_t          m_Count;
+		uint16_t          m_Type;
+		uint16_t          m_Thread;      //< 0 for threads outside the job manager, otherwise worker index + 1
+		volatile int32_t  m_Sequence;    //< Ring position the event was written for, -1 while being written
+	};
+
+	//! Records per-frame, per-task, per-world and per-query timings into a fixed size ring that any thread can write to
+	//! without locking. Recording is off until SetEnabled( true ), and costs a single branch per scope while off.
+	//! Events can be read back at any time or exported in Chrome's trace event format (load in chrome://tracing).
+	class HELIUM_FRAMEWORK_API FrameProfiler
+	{
+	public:
+		//! Number of events kept, older events are overwritten (must be a power of two)
+		static const uint32_t EVENT_CAPACITY = 1 << 16;
+
+		static void            SetEnabled( bool bEnabled );
+		static inline bool     IsEnabled();
+		static void            Shutdown();
+
+		static void            BeginFrame();
+		static void            EndFrame();
+		static inline uint32_t GetFrameIndex();
+
+		static void            Record( ProfileEventType type, const char *pName, uint64_t startTicks, uint64_t endTicks, uint32_t count );
+		static size_t          GetEvents( DynamicArray< ProfileEvent > &rEvents );
+		static void            Clear();
+		static bool            ExportChromeTrace( const char *pFileName );
+
+		//! Records an event covering the lifetime of the scope
+		class Scope
+		{
+		public:
+			inline Scope( ProfileEventType type, const char *pName, uint32_t count = 0 );
+			inline ~Scope();
+
+			inline void SetCount( uint32_t count );
+
+		private:
+			const char*       m_Name;
+			uint64_t          m_StartTicks;
+			uint32_t          m_Count;
+			ProfileEventType  m_Type;
+			bool              m_Active;
+		};
+
+	private:
+		static bool             sm_Enabled;
+		static ProfileEvent*    sm_pEvents;
+		static volatile int32_t sm_NextEvent;
+		static uint32_t         sm_FrameIndex;
+		static uint64_t         sm_FrameStartTicks;
+	};
+}
+
+#include "Framework/FrameProfiler.inl"
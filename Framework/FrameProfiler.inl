@@ -0,0 +1,39 @@
+
+namespace Helium
+{
+	bool FrameProfiler::IsEnabled()
+	{
+		return sm_Enabled;
+	}
+
+	uint32_t FrameProfiler::GetFrameIndex()
+	{
+		return sm_FrameIndex;
+	}
+
+	FrameProfiler::Scope::Scope( ProfileEventType type, const char *pName, uint32_t count )
+		: m_Name( pName )
+		, m_StartTicks( 0 )
+		, m_Count( count )
+		, m_Type( type )
+		, m_Active( FrameProfiler::IsEnabled() )
+	{
+		if ( m_Active )
+		{
+			m_StartTicks = Timer::GetTickCount();
+		}
+	}
+
+	FrameProfiler::Scope::~Scope()
+	{
+		if ( m_Active )
+		{
+			FrameProfiler::Record( m_Type, m_Name, m_StartTicks, Timer::GetTickCount(), m_Count );
+		}
+	}
+
+	void FrameProfiler::Scope::SetCount( uint32_t count )
+	{
+		m_Count = count;
+	}
+}
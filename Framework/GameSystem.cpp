@@ -10,6 +10,7 @@
 #include "Platform/Process.h"
 #include "Engine/Config.h"
 #include "Engine/CacheManager.h"
+#include "EngineJobs/JobManager.h"
 #include "Framework/MemoryHeapPreInitialization.h"
 #include "Framework/AssetLoaderInitialization.h"
 #include "Framework/ConfigInitialization.h"
@@ -19,6 +20,7 @@
 #include "Framework/WorldManager.h"
 #include "Framework/SceneDefinition.h"
 #include "Framework/TaskScheduler.h"
+#include "Framework/FrameProfiler.h"
 
 #if !HELIUM_SHARED
 namespace Helium
@@ -37,7 +39,9 @@ GameSystem::GameSystem()
 : m_pAssetLoaderInitialization( NULL )
 , m_pRendererInitialization( NULL )
 , m_pWindowManagerInitialization( NULL )
+, m_TickType( TickTypes::RenderingGame )
 , m_bStopRunning( false )
+, m_bFrameProfilerTraceWritten( false )
 {
 }
 
@@ -87,6 +91,7 @@ bool GameSystem::Initialize(
 #endif
 
 	AsyncLoader::Startup();
+	JobManager::Startup();
 	CacheManager::Startup();
 	Reflect::Startup();
 
@@ -120,7 +125,7 @@ bool GameSystem::Initialize(
 
 	Components::Startup( m_spSystemDefinition.Get() );
 
-	TaskScheduler::CalculateSchedule( TickTypes::RenderingGame, m_Schedule );
+	TaskScheduler::CalculateSchedule( m_TickType, m_Schedule );
 
 	rWindowManagerInitialization.Startup();
 	m_pWindowManagerInitialization = &rWindowManagerInitialization;
@@ -139,6 +144,25 @@ bool GameSystem::Initialize(
 	
 	WorldManager::Startup();
 
+	if ( m_spSystemDefinition && m_spSystemDefinition->m_FixedTimeStep > 0.0f )
+	{
+		WorldManager* pWorldManager = WorldManager::GetInstance();
+		HELIUM_ASSERT( pWorldManager );
+		pWorldManager->SetFixedTimeStep( m_spSystemDefinition->m_FixedTimeStep, Max< uint32_t >( m_spSystemDefinition->m_MaxFixedStepsPerFrame, 1 ) );
+	}
+
+	if ( m_spSystemDefinition && m_spSystemDefinition->m_ParallelWorldUpdate )
+	{
+		WorldManager* pWorldManager = WorldManager::GetInstance();
+		HELIUM_ASSERT( pWorldManager );
+		pWorldManager->SetParallelWorldUpdate( true );
+	}
+
+	if ( m_spSystemDefinition && !m_spSystemDefinition->m_FrameProfilerTracePath.IsEmpty() )
+	{
+		FrameProfiler::SetEnabled( true );
+	}
+
 	// Initialization complete.
 	return true;
 }
@@ -148,6 +172,9 @@ bool GameSystem::Initialize(
 /// @see Initialize()
 void GameSystem::Cleanup()
 {
+	// The WorldManager shuts the profiler down with it
+	WriteFrameProfilerTrace();
+
 	WorldManager::Shutdown();
 
 	if( m_pRendererInitialization )
@@ -181,6 +208,7 @@ void GameSystem::Cleanup()
 	Reflect::Shutdown();
 	AssetType::Shutdown();
 	Asset::Shutdown();
+	JobManager::Shutdown();
 	AsyncLoader::Shutdown();
 
 	Reflect::ObjectRefCountSupport::Shutdown();
@@ -206,6 +234,8 @@ int32_t GameSystem::Run()
 		WorldManager* pWorldManager = WorldManager::GetInstance();
 		HELIUM_ASSERT( pWorldManager );
 		pWorldManager->Update( m_Schedule );
+
+		UpdateFrameProfilerTrace();
 	}
 
 	m_bStopRunning = false;
@@ -213,6 +243,38 @@ int32_t GameSystem::Run()
 	return 0;
 }
 
+/// Write the frame profiler trace once the number of frames set in the SystemDefinition have run.
+///
+/// Call once per frame from Run().  Does nothing if the trace is only written at shutdown.
+///
+/// @see WriteFrameProfilerTrace()
+void GameSystem::UpdateFrameProfilerTrace()
+{
+	if ( m_spSystemDefinition &&
+		m_spSystemDefinition->m_FrameProfilerTraceFrames &&
+		FrameProfiler::GetFrameIndex() >= m_spSystemDefinition->m_FrameProfilerTraceFrames )
+	{
+		WriteFrameProfilerTrace();
+	}
+}
+
+/// Write the events recorded by the frame profiler to the trace file named in the SystemDefinition and stop
+/// recording.  Only the first call writes anything.
+///
+/// @see UpdateFrameProfilerTrace()
+void GameSystem::WriteFrameProfilerTrace()
+{
+	if ( m_bFrameProfilerTraceWritten || !FrameProfiler::IsEnabled() || !m_spSystemDefinition )
+	{
+		return;
+	}
+
+	m_bFrameProfilerTraceWritten = true;
+
+	FrameProfiler::SetEnabled( false );
+	FrameProfiler::ExportChromeTrace( *m_spSystemDefinition->m_FrameProfilerTracePath );
+}
+
 /// Get the singleton GameSystem instance.
 ///
 /// @return  Pointer to the GameSystem instance.
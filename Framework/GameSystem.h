@@ -57,6 +57,9 @@ namespace Helium
 		virtual void StopRunning();
 
 	protected:
+		void UpdateFrameProfilerTrace();
+		void WriteFrameProfilerTrace();
+
 		/// Module file name.
 		String m_moduleName;
 
@@ -69,6 +72,8 @@ namespace Helium
 		SystemDefinitionPtr          m_spSystemDefinition;
 		AssetAwareThreadSynchronizer m_AssetSyncUtility;
 		TaskSchedule                 m_Schedule;
+		uint32_t                     m_TickType;     // TickTypes the schedule is calculated for
 		bool                         m_bStopRunning;
+		bool                         m_bFrameProfilerTraceWritten;
 	};
 }
@@ -0,0 +1,16 @@
+#include "FrameworkPch.h"
+#include "Framework/NullWindowManagerInitialization.h"
+
+using namespace Helium;
+
+/// @copydoc WindowManagerInitialization::Startup()
+void NullWindowManagerInitialization::Startup()
+{
+    // No WindowManager instance is created.
+}
+
+/// @copydoc WindowManagerInitialization::Shutdown()
+void NullWindowManagerInitialization::Shutdown()
+{
+
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "Framework/WindowManagerInitialization.h"
+
+namespace Helium
+{
+	/// Window manager initializer that creates no window manager, for applications without a display.
+	class HELIUM_FRAMEWORK_API NullWindowManagerInitialization : public WindowManagerInitialization
+	{
+	public:
+		/// @name Window Manager Initialization
+		//@{
+		virtual void Startup();
+		virtual void Shutdown();
+		//@}
+	};
+}
@@ -2,8 +2,41 @@
 #include "FrameworkPch.h"
 #include "Framework/ParameterSet.h"
 
+#include "Platform/Locks.h"
+
+#include <algorithm>
+
 using namespace Helium;
 
+namespace
+{
+	// Names are pooled, so ordering by the pooled string pointer is enough to binary search on
+	struct ParameterIndexEntryLess
+	{
+		bool operator()( const ParameterIndex::Entry &rLeft, const ParameterIndex::Entry &rRight ) const
+		{
+			return rLeft.m_Name.Get() < rRight.m_Name.Get();
+		}
+	};
+
+	// Indices of every ParameterSet type searched so far, freed at exit
+	struct ParameterIndexCache
+	{
+		~ParameterIndexCache()
+		{
+			for ( DynamicArray< ParameterIndex * >::Iterator iter = m_Indices.Begin(); iter != m_Indices.End(); ++iter )
+			{
+				delete *iter;
+			}
+		}
+
+		DynamicArray< ParameterIndex * > m_Indices;
+		Mutex m_Lock;
+	};
+
+	ParameterIndexCache g_ParameterIndexCache;
+}
+
 //////////////////////////////////////////////////////////////////////////
 // ParameterSet
 
@@ -11,20 +44,21 @@ HELIUM_DEFINE_ABSTRACT( Helium::ParameterSet )
 
 ParameterSet::ParameterSet()
 	: m_NextParams( NULL )
+	, m_Index( NULL )
 {
 
 }
 
 void ParameterSet::EnumerateParameters( DynamicArray<Parameter> &parameters ) const
 {
-	const Reflect::MetaStruct *structure = GetMetaClass();
-	for (DynamicArray< Reflect::Field >::ConstIterator iter = structure->m_Fields.Begin();
-		iter != structure->m_Fields.End(); ++iter)
+	const ParameterIndex &rIndex = GetParameterIndex();
+	for (DynamicArray< ParameterIndex::Entry >::ConstIterator iter = rIndex.m_Entries.Begin();
+		iter != rIndex.m_Entries.End(); ++iter)
 	{
 		Parameter *p = parameters.New();
-		p->m_Name = Name( iter->m_Name ); // Kind of sucks that we do string lookup here! Could we do something better like have names in the field object?
-		p->m_Pointer = Reflect::Pointer( &*iter, const_cast< ParameterSet * >( this ), const_cast< ParameterSet *>( this ) );
-		p->m_Translator = iter->m_Translator;
+		p->m_Name = iter->m_Name;
+		p->m_Pointer = Reflect::Pointer( iter->m_Field, const_cast< ParameterSet * >( this ), const_cast< ParameterSet *>( this ) );
+		p->m_Translator = iter->m_Field->m_Translator;
 	}
 
 	if ( m_NextParams )
@@ -33,6 +67,71 @@ void ParameterSet::EnumerateParameters( DynamicArray<Parameter> &parameters ) co
 	}
 }
 
+bool ParameterSet::FindParameter( Name name, Parameter &rParameter ) const
+{
+	ParameterIndex::Entry key;
+	key.m_Name = name;
+	key.m_Field = NULL;
+
+	for ( const ParameterSet *pSet = this; pSet; pSet = pSet->m_NextParams )
+	{
+		const ParameterIndex &rIndex = pSet->GetParameterIndex();
+		const ParameterIndex::Entry *pBegin = rIndex.m_Entries.GetData();
+		const ParameterIndex::Entry *pEnd = pBegin + rIndex.m_Entries.GetSize();
+
+		const ParameterIndex::Entry *pEntry = std::lower_bound( pBegin, pEnd, key, ParameterIndexEntryLess() );
+		if ( pEntry != pEnd && pEntry->m_Name == name )
+		{
+			rParameter.m_Name = name;
+			rParameter.m_Pointer = Reflect::Pointer( pEntry->m_Field, const_cast< ParameterSet * >( pSet ), const_cast< ParameterSet *>( pSet ) );
+			rParameter.m_Translator = pEntry->m_Field->m_Translator;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+const ParameterIndex &ParameterSet::GetParameterIndex() const
+{
+	const Reflect::MetaStruct *structure = GetMetaClass();
+	HELIUM_ASSERT( structure );
+
+	if ( m_Index && m_Index->m_Structure == structure )
+	{
+		return *m_Index;
+	}
+
+	MutexScopeLock scopeLock( g_ParameterIndexCache.m_Lock );
+
+	DynamicArray< ParameterIndex * > &rIndices = g_ParameterIndexCache.m_Indices;
+	for ( DynamicArray< ParameterIndex * >::Iterator iter = rIndices.Begin(); iter != rIndices.End(); ++iter )
+	{
+		if ( (*iter)->m_Structure == structure )
+		{
+			m_Index = *iter;
+			return *m_Index;
+		}
+	}
+
+	ParameterIndex *pIndex = new ParameterIndex;
+	pIndex->m_Structure = structure;
+	pIndex->m_Entries.Reserve( structure->m_Fields.GetSize() );
+	for (DynamicArray< Reflect::Field >::ConstIterator iter = structure->m_Fields.Begin();
+		iter != structure->m_Fields.End(); ++iter)
+	{
+		ParameterIndex::Entry *pEntry = pIndex->m_Entries.New();
+		pEntry->m_Name = Name( iter->m_Name );
+		pEntry->m_Field = &*iter;
+	}
+
+	std::sort( pIndex->m_Entries.GetData(), pIndex->m_Entries.GetData() + pIndex->m_Entries.GetSize(), ParameterIndexEntryLess() );
+
+	rIndices.Push( pIndex );
+	m_Index = pIndex;
+	return *m_Index;
+}
+
 void ParameterSet::PopulateMetaType( Reflect::MetaStruct& comp )
 {
 
@@ -23,7 +23,21 @@ namespace Helium
 
 	typedef Helium::StrongPtr< class ParameterSet > ParameterSetPtr;
 
-	// TODO: Special registration, possibly for precalculating data and verifying no incompatible parameters
+	// Parameter names and fields of one ParameterSet type, sorted by name so a parameter is found with a binary search
+	// rather than by building a Name from every field name. Built the first time a set of the type is searched and
+	// shared by every set of that type.
+	struct ParameterIndex
+	{
+		struct Entry
+		{
+			Name                  m_Name;
+			const Reflect::Field *m_Field;
+		};
+
+		const Reflect::MetaStruct *m_Structure;
+		DynamicArray< Entry >      m_Entries;
+	};
+
 	class HELIUM_FRAMEWORK_API ParameterSet : public Reflect::Object
 	{
 	public:
@@ -33,19 +47,33 @@ namespace Helium
 		ParameterSet();
 		void EnumerateParameters( DynamicArray<Parameter> &parameters ) const;
 
+		// Finds the named parameter in this set or the rest of the chain. The first set in the chain that has the
+		// parameter wins, the same as the first of duplicates returned by EnumerateParameters().
+		bool FindParameter( Name name, Parameter &rParameter ) const;
+
 		template <class T>
 		T *FindParameterSet();
 
 	private:
 		friend class ParameterSetBuilder;
+
+		const ParameterIndex &GetParameterIndex() const;
+
 		ParameterSetPtr m_NextParams;
+		mutable const ParameterIndex *m_Index;  //< Cached from the shared index of this set's type
 	};
 
+	// Chains parameter sets together. A builder that is kept around and Reset() between uses hands back the sets it
+	// made last time (when the same types are added in the same order) instead of allocating new ones, so the fields of
+	// a reused set hold whatever was written to them on the previous use. Don't reset a builder while anything still
+	// holds the set it built.
 	class ParameterSetBuilder
 	{
 	public:
 		ParameterSetBuilder( ParameterSet *parameterSet = 0)
 			: m_ParameterSet( parameterSet )
+			, m_BaseSet( parameterSet )
+			, m_AddedCount( 0 )
 		{
 			
 		}
@@ -54,7 +82,18 @@ namespace Helium
 		T *AddParameterSet()
 		{
 			ParameterSetPtr temp = m_ParameterSet;
-			m_ParameterSet = new T();
+			if ( m_AddedCount < m_AddedSets.GetSize() && m_AddedSets[ m_AddedCount ]->GetMetaClass() == Reflect::GetMetaClass<T>() )
+			{
+				m_ParameterSet = m_AddedSets[ m_AddedCount ];
+			}
+			else
+			{
+				m_ParameterSet = new T();
+				m_AddedSets.Resize( m_AddedCount );
+				m_AddedSets.Push( m_ParameterSet );
+			}
+
+			++m_AddedCount;
 			m_ParameterSet->m_NextParams = temp;
 			return static_cast<T *>(m_ParameterSet.Get());
 		}
@@ -64,8 +103,18 @@ namespace Helium
 			return m_ParameterSet.Get();
 		}
 
+		// Start a new chain on top of the set the builder was created with, keeping the sets added so far for reuse
+		void Reset()
+		{
+			m_ParameterSet = m_BaseSet;
+			m_AddedCount = 0;
+		}
+
 	private:
 		ParameterSetPtr m_ParameterSet;
+		ParameterSetPtr m_BaseSet;
+		DynamicArray< ParameterSetPtr > m_AddedSets;  //< In the order they were added
+		size_t m_AddedCount;
 	};
 
 #if 0
@@ -22,7 +22,7 @@ namespace Helium
 				return static_cast<T *>( parameterSet );
 			}
 
-			parameterSet = m_NextParams;
+			parameterSet = parameterSet->m_NextParams;
 		}
 
 		// Give up, we did not find T in the chain
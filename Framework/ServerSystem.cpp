@@ -0,0 +1,283 @@
+#include "FrameworkPch.h"
+#include "Framework/ServerSystem.h"
+
+#include "Platform/Thread.h"
+#include "Platform/Timer.h"
+#include "Engine/AssetLoader.h"
+#include "Framework/WorldManager.h"
+
+#include <algorithm>
+
+using namespace Helium;
+
+static uint32_t g_InitCount = 0;
+
+/// Default number of server ticks per second.
+static const uint32_t DEFAULT_TICK_RATE = 30;
+/// Default seconds between tick stats reports.
+static const float32_t DEFAULT_REPORT_INTERVAL = 10.0f;
+/// Default remaining wait, in milliseconds, below which the server yields instead of sleeping.
+static const float32_t DEFAULT_SPIN_THRESHOLD = 2.0f;
+
+static uint64_t SecondsToTicks( float64_t seconds )
+{
+	return static_cast< uint64_t >( seconds * static_cast< float64_t >( Timer::GetTicksPerSecond() ) );
+}
+
+static float32_t TicksToMilliseconds( uint64_t ticks )
+{
+	return static_cast< float32_t >( static_cast< float64_t >( ticks ) * Timer::GetSecondsPerTick() * 1000.0 );
+}
+
+/// Constructor.
+ServerTickStats::ServerTickStats()
+: m_TickCount( 0 )
+, m_OverrunCount( 0 )
+, m_P50Milliseconds( 0.0f )
+, m_P99Milliseconds( 0.0f )
+, m_MaxMilliseconds( 0.0f )
+, m_BusyFraction( 0.0f )
+{
+}
+
+/// Constructor.
+ServerSystem::ServerSystem()
+: m_TickRate( DEFAULT_TICK_RATE )
+, m_ReportInterval( DEFAULT_REPORT_INTERVAL )
+, m_SpinThreshold( DEFAULT_SPIN_THRESHOLD )
+, m_OverrunCount( 0 )
+{
+	m_TickType = TickTypes::HeadlessGame;
+}
+
+/// Initialize this system without a window manager or renderer.
+///
+/// @param[in] rMemoryHeapPreInitialization  Interface for performing any necessary pre-initialization of dynamic
+///                                          memory heaps.
+/// @param[in] rAssetLoaderInitialization    Interface for creating and initializing the main AssetLoader instance.
+/// @param[in] rConfigInitialization         Interface for initializing application configuration settings.
+/// @param[in] rSystemDefinitionPath         Path of the SystemDefinition to load.
+///
+/// @return  True if initialization was successful, false if not.
+bool ServerSystem::Initialize(
+	MemoryHeapPreInitialization& rMemoryHeapPreInitialization,
+	AssetLoaderInitialization& rAssetLoaderInitialization,
+	ConfigInitialization& rConfigInitialization,
+	AssetPath &rSystemDefinitionPath)
+{
+	return GameSystem::Initialize(
+		rMemoryHeapPreInitialization,
+		rAssetLoaderInitialization,
+		rConfigInitialization,
+		m_NullWindowManagerInitialization,
+		m_NullRendererInitialization,
+		rSystemDefinitionPath );
+}
+
+/// Set the target number of server ticks per second.
+///
+/// @param[in] ticksPerSecond  Tick rate.
+///
+/// @see GetTickRate()
+void ServerSystem::SetTickRate( uint32_t ticksPerSecond )
+{
+	HELIUM_ASSERT( ticksPerSecond > 0 );
+	m_TickRate = ticksPerSecond;
+}
+
+/// Set how often tick time statistics are reported.
+///
+/// @param[in] seconds  Seconds between reports.
+///
+/// @see GetLastTickStats()
+void ServerSystem::SetReportInterval( float32_t seconds )
+{
+	HELIUM_ASSERT( seconds > 0.0f );
+	m_ReportInterval = seconds;
+}
+
+/// Set the remaining wait below which the server gives up sleeping and yields until the next tick.
+///
+/// Larger values make tick starts more precise at the cost of more CPU time spent waiting.
+///
+/// @param[in] milliseconds  Spin threshold.
+void ServerSystem::SetSpinThreshold( float32_t milliseconds )
+{
+	HELIUM_ASSERT( milliseconds >= 0.0f );
+	m_SpinThreshold = milliseconds;
+}
+
+/// Run the server loop.
+///
+/// This will not return until StopRunning() is called.
+///
+/// @return  Result code of application execution.
+int32_t ServerSystem::Run()
+{
+	const uint64_t tickInterval = Max< uint64_t >( Timer::GetTicksPerSecond() / m_TickRate, 1 );
+	const uint64_t reportInterval = Max< uint64_t >( SecondsToTicks( m_ReportInterval ), 1 );
+	const uint64_t spinThreshold = SecondsToTicks( m_SpinThreshold * 0.001 );
+
+	uint64_t nextTickStart = Timer::GetTickCount();
+	uint64_t windowStart = nextTickStart;
+
+	m_TickDurations.Reserve( static_cast< size_t >( reportInterval / tickInterval ) + 1 );
+
+	while ( !m_bStopRunning )
+	{
+		WaitUntil( nextTickStart, spinThreshold );
+
+		uint64_t tickStart = Timer::GetTickCount();
+
+		AssetLoader::GetInstance()->Tick();
+		m_AssetSyncUtility.Sync();
+
+		WorldManager* pWorldManager = WorldManager::GetInstance();
+		HELIUM_ASSERT( pWorldManager );
+		pWorldManager->Update( m_Schedule );
+
+		UpdateFrameProfilerTrace();
+
+		uint64_t tickEnd = Timer::GetTickCount();
+		uint64_t tickDuration = tickEnd - tickStart;
+
+		m_TickDurations.Push( tickDuration );
+		if ( tickDuration > tickInterval )
+		{
+			++m_OverrunCount;
+		}
+
+		// Don't run a burst of ticks to catch up after an overrun, the WorldManager clock already accounts for the
+		// lost time
+		nextTickStart += tickInterval;
+		if ( nextTickStart < tickEnd )
+		{
+			nextTickStart = tickEnd;
+		}
+
+		if ( tickEnd - windowStart >= reportInterval )
+		{
+			ReportTickStats( tickEnd - windowStart );
+			windowStart = tickEnd;
+		}
+	}
+
+	if ( !m_TickDurations.IsEmpty() )
+	{
+		ReportTickStats( Timer::GetTickCount() - windowStart );
+	}
+
+	m_bStopRunning = false;
+
+	return 0;
+}
+
+/// Wait until the timer reaches the given tick count.
+///
+/// Sleeps while the wait is longer than the spin threshold, since a sleep can overshoot by a scheduler quantum, and
+/// yields the rest of the way.
+///
+/// @param[in] tickCount      Timer tick count to wait for.
+/// @param[in] spinThreshold  Remaining timer ticks below which to yield rather than sleep.
+void ServerSystem::WaitUntil( uint64_t tickCount, uint64_t spinThreshold ) const
+{
+	for( ;; )
+	{
+		uint64_t now = Timer::GetTickCount();
+		if( now >= tickCount )
+		{
+			return;
+		}
+
+		uint64_t remaining = tickCount - now;
+		if( remaining > spinThreshold )
+		{
+			uint32_t sleepMilliseconds = static_cast< uint32_t >( TicksToMilliseconds( remaining - spinThreshold ) );
+			if( sleepMilliseconds )
+			{
+				Thread::Sleep( sleepMilliseconds );
+				continue;
+			}
+		}
+
+		Thread::Yield();
+	}
+}
+
+/// Compute the stats for the current reporting window, report them and start a new window.
+///
+/// @param[in] windowTickCount  Timer ticks since the start of the window.
+void ServerSystem::ReportTickStats( uint64_t windowTickCount )
+{
+	HELIUM_ASSERT( !m_TickDurations.IsEmpty() );
+
+	uint64_t busyTicks = 0;
+	for ( DynamicArray< uint64_t >::ConstIterator iter = m_TickDurations.Begin(); iter != m_TickDurations.End(); ++iter )
+	{
+		busyTicks += *iter;
+	}
+
+	uint64_t *pDurations = m_TickDurations.GetData();
+	size_t count = m_TickDurations.GetSize();
+	std::sort( pDurations, pDurations + count );
+
+	ServerTickStats &rStats = m_LastTickStats;
+	rStats.m_TickCount = static_cast< uint32_t >( count );
+	rStats.m_OverrunCount = m_OverrunCount;
+	rStats.m_P50Milliseconds = TicksToMilliseconds( pDurations[ ( count - 1 ) / 2 ] );
+	rStats.m_P99Milliseconds = TicksToMilliseconds( pDurations[ ( ( count - 1 ) * 99 ) / 100 ] );
+	rStats.m_MaxMilliseconds = TicksToMilliseconds( pDurations[ count - 1 ] );
+	rStats.m_BusyFraction = windowTickCount
+		? static_cast< float32_t >( static_cast< float64_t >( busyTicks ) / static_cast< float64_t >( windowTickCount ) )
+		: 0.0f;
+
+	HELIUM_TRACE(
+		TraceLevels::Info,
+		TXT( "ServerSystem: %u ticks at %u Hz, p50 %.2f ms, p99 %.2f ms, max %.2f ms, %u overruns, %.1f%% busy\n" ),
+		rStats.m_TickCount,
+		m_TickRate,
+		rStats.m_P50Milliseconds,
+		rStats.m_P99Milliseconds,
+		rStats.m_MaxMilliseconds,
+		rStats.m_OverrunCount,
+		rStats.m_BusyFraction * 100.0f );
+
+	m_TickDurations.Resize( 0 );
+	m_OverrunCount = 0;
+}
+
+/// Get the singleton ServerSystem instance.
+///
+/// @return  Pointer to the ServerSystem instance, or null if the running system is not a server.
+///
+/// @see Startup(), Shutdown()
+ServerSystem* ServerSystem::GetInstance()
+{
+	return g_InitCount ? static_cast< ServerSystem* >( sm_pInstance ) : NULL;
+}
+
+/// Create a ServerSystem instance as the singleton GameSystem instance.
+///
+/// @see Shutdown(), GetInstance()
+void ServerSystem::Startup()
+{
+	if ( ++g_InitCount == 1 )
+	{
+		HELIUM_ASSERT( !sm_pInstance );
+		sm_pInstance = new ServerSystem;
+		HELIUM_ASSERT( sm_pInstance );
+	}
+}
+
+/// Delete the ServerSystem singleton.
+///
+/// @see Startup(), GetInstance()
+void ServerSystem::Shutdown()
+{
+	if ( --g_InitCount == 0 )
+	{
+		HELIUM_ASSERT( sm_pInstance );
+		delete static_cast< ServerSystem* >( sm_pInstance );
+		sm_pInstance = NULL;
+	}
+}
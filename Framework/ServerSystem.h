@@ -0,0 +1,94 @@
+#pragma once
+
+#include "Framework/GameSystem.h"
+#include "Framework/NullRendererInitialization.h"
+#include "Framework/NullWindowManagerInitialization.h"
+
+namespace Helium
+{
+	/// Tick time statistics over one reporting window of a ServerSystem.
+	struct HELIUM_FRAMEWORK_API ServerTickStats
+	{
+		ServerTickStats();
+
+		/// Ticks run during the window.
+		uint32_t m_TickCount;
+		/// Ticks that took longer than the tick interval.
+		uint32_t m_OverrunCount;
+		/// Median tick time in milliseconds.
+		float32_t m_P50Milliseconds;
+		/// 99th percentile tick time in milliseconds.
+		float32_t m_P99Milliseconds;
+		/// Longest tick time in milliseconds.
+		float32_t m_MaxMilliseconds;
+		/// Fraction of the window spent running ticks rather than waiting for the next one.
+		float32_t m_BusyFraction;
+	};
+
+	/// Game system for dedicated servers.
+	///
+	/// Runs without a window or renderer, schedules only TickTypes::HeadlessGame tasks and updates the worlds at a
+	/// fixed tick rate, sleeping (then yielding for the last stretch, which the OS scheduler can't be trusted with)
+	/// between ticks.  Tick times are collected and reported as percentiles once per reporting window so each server
+	/// instance's CPU cost can be tracked.
+	class HELIUM_FRAMEWORK_API ServerSystem : public GameSystem
+	{
+	public:
+		/// @name Construction/Destruction
+		//@{
+		ServerSystem();
+		//@}
+
+		/// @name Initialization
+		//@{
+		using GameSystem::Initialize;
+		bool Initialize(
+			MemoryHeapPreInitialization& rMemoryHeapPreInitialization,
+			AssetLoaderInitialization& rAssetLoaderInitialization,
+			ConfigInitialization& rConfigInitialization,
+			AssetPath &rSystemDefinitionPath);
+		//@}
+
+		/// @name Application Loop
+		//@{
+		virtual int32_t Run() override;
+
+		void SetTickRate( uint32_t ticksPerSecond );
+		inline uint32_t GetTickRate() const;
+		void SetReportInterval( float32_t seconds );
+		void SetSpinThreshold( float32_t milliseconds );
+
+		inline const ServerTickStats& GetLastTickStats() const;
+		//@}
+
+		/// @name Static Initialization
+		//@{
+		static ServerSystem* GetInstance();
+		static void Startup();
+		static void Shutdown();
+		//@}
+
+	private:
+		void WaitUntil( uint64_t tickCount, uint64_t spinThreshold ) const;
+		void ReportTickStats( uint64_t windowTickCount );
+
+		NullWindowManagerInitialization m_NullWindowManagerInitialization;
+		NullRendererInitialization      m_NullRendererInitialization;
+
+		/// Target ticks per second.
+		uint32_t m_TickRate;
+		/// Seconds between stats reports.
+		float32_t m_ReportInterval;
+		/// Remaining wait, in milliseconds, below which the server yields instead of sleeping.
+		float32_t m_SpinThreshold;
+
+		/// Duration of each tick in the current reporting window, in timer ticks.
+		DynamicArray< uint64_t > m_TickDurations;
+		/// Ticks in the current reporting window that overran the tick interval.
+		uint32_t m_OverrunCount;
+		/// Stats for the last complete reporting window.
+		ServerTickStats m_LastTickStats;
+	};
+}
+
+#include "Framework/ServerSystem.inl"
@@ -0,0 +1,22 @@
+namespace Helium
+{
+	/// Get the target number of server ticks per second.
+	///
+	/// @return  Tick rate.
+	///
+	/// @see SetTickRate()
+	uint32_t ServerSystem::GetTickRate() const
+	{
+		return m_TickRate;
+	}
+
+	/// Get the tick time statistics of the last complete reporting window.
+	///
+	/// @return  Tick stats.
+	///
+	/// @see SetReportInterval()
+	const ServerTickStats& ServerSystem::GetLastTickStats() const
+	{
+		return m_LastTickStats;
+	}
+}
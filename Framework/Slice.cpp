@@ -73,47 +73,190 @@ Entity* Slice::CreateEntity(EntityDefinition *pEntityDefinition, ParameterSet *p
     return entity.Get();
 }
 
+/// Create several entities from the same definition at once.
+///
+/// Component definitions, parameter bindings and pool space are prepared once for the whole batch rather than once per
+/// entity, so this is considerably cheaper than calling CreateEntity() in a loop.
+///
+/// @param[in]  pEntityDefinition  Definition to create the entities from.
+/// @param[in]  count              Number of entities to create.
+/// @param[in]  pParameterSet      Parameters shared by every entity, may be NULL.
+/// @param[out] pEntities          If not NULL, the created entities are appended to this array.
+///
+/// @return  Number of entities created.
+///
+/// @see CreateEntity()
+size_t Slice::CreateEntities(
+    EntityDefinition *pEntityDefinition, size_t count, ParameterSet *pParameterSet, DynamicArray< Entity* > *pEntities )
+{
+    const ParameterSet *pConstParameterSet = pParameterSet;
+    return CreateEntitiesInternal( pEntityDefinition, count, &pConstParameterSet, pParameterSet ? 1 : 0, pEntities );
+}
+
+/// Create several entities from the same definition at once, each with its own parameters.
+///
+/// @param[in]  pEntityDefinition  Definition to create the entities from.
+/// @param[in]  parameterSets      Parameters for each entity, one entity is created per entry.
+/// @param[out] pEntities          If not NULL, the created entities are appended to this array.
+///
+/// @return  Number of entities created.
+///
+/// @see CreateEntity()
+size_t Slice::CreateEntities(
+    EntityDefinition *pEntityDefinition, const DynamicArray< ParameterSetPtr > &parameterSets, DynamicArray< Entity* > *pEntities )
+{
+    DynamicArray< const ParameterSet* > parameterSetPointers;
+    parameterSetPointers.Reserve( parameterSets.GetSize() );
+    for( DynamicArray< ParameterSetPtr >::ConstIterator iter = parameterSets.Begin(); iter != parameterSets.End(); ++iter )
+    {
+        parameterSetPointers.Push( iter->Get() );
+    }
+
+    return CreateEntitiesInternal(
+        pEntityDefinition, parameterSets.GetSize(), parameterSetPointers.GetData(), parameterSets.GetSize(), pEntities );
+}
+
+size_t Slice::CreateEntitiesInternal(
+    EntityDefinition *pEntityDefinition, 
+    size_t count, 
+    const ParameterSet * const *ppParameterSets, 
+    size_t parameterSetCount, 
+    DynamicArray< Entity* > *pEntities )
+{
+    HELIUM_ASSERT( pEntityDefinition );
+    if( !pEntityDefinition )
+    {
+        HELIUM_TRACE( TraceLevels::Error, TXT( "Slice::CreateEntities(): EntityDefinition is NULL.\n" ) );
+        return 0;
+    }
+
+    if( !count )
+    {
+        return 0;
+    }
+
+    // Create and register every entity first, so each one can find its world while its components are deployed
+    DynamicArray< Entity* > entities;
+    entities.Reserve( count );
+    m_entities.Reserve( m_entities.GetSize() + count );
+
+    for( size_t i = 0; i < count; ++i )
+    {
+        EntityPtr entity = pEntityDefinition->CreateEntity();
+        HELIUM_ASSERT( entity.Get() );
+        if( !entity )
+        {
+            HELIUM_TRACE( TraceLevels::Error, TXT( "Slice::CreateEntities(): Call to EntityDefinition::CreateEntity failed.\n" ) );
+            break;
+        }
+
+        size_t sliceIndex = m_entities.Push( entity );
+        HELIUM_ASSERT( IsValid( sliceIndex ) );
+        entity->SetSliceInfo( this, sliceIndex );
+
+        entities.Push( entity.Get() );
+    }
+
+    // Fewer entities than parameter sets only happens on failure, in which case the sets still line up by index
+    size_t createdCount = entities.GetSize();
+    pEntityDefinition->FinalizeEntities(
+        entities.GetData(), createdCount, ppParameterSets, parameterSetCount == count ? createdCount : parameterSetCount );
+
+    if( pEntities )
+    {
+        pEntities->AddArray( entities.GetData(), createdCount );
+    }
+
+    return createdCount;
+}
+
 /// Destroy an entity in this slice.
 ///
 /// @param[in] pEntity  EntityDefinition to destroy.
 ///
 /// @return  True if entity destruction was successful, false if not.
 ///
-/// @see CreateEntity()
+/// @see CreateEntity(), DestroyEntities()
 bool Slice::DestroyEntity( Entity* pEntity )
 {
     HELIUM_ASSERT( pEntity );
 
-    // Make sure the entity is part of this slice.
-    if( pEntity->GetSlice().Get() != this )
+    return DestroyEntities( &pEntity, 1 ) == 1;
+}
+
+/// Destroy several entities in this slice at once.
+///
+/// The components of all of the entities are freed together, pool by pool, so the cost of this depends only on the
+/// number of entities (and components) destroyed.  Entities that are not part of this slice are skipped.
+///
+/// @param[in] ppEntities  Entities to destroy.  Each entity must appear at most once.
+/// @param[in] count       Number of entities in ppEntities.
+///
+/// @return  Number of entities destroyed.
+///
+/// @see DestroyEntity()
+size_t Slice::DestroyEntities( Entity* const* ppEntities, size_t count )
+{
+    HELIUM_ASSERT( ppEntities || count == 0 );
+
+    // Free the components of every entity in one pass.
+    DynamicArray< ComponentCollection* > collections;
+    collections.Reserve( count );
+
+    for( size_t entityIndex = 0; entityIndex < count; ++entityIndex )
     {
-        HELIUM_TRACE(
-            TraceLevels::Error,
-            TXT( "Slice::DestroyEntity(): Entity is not part of slice \"%s\".\n" ),
-            *pEntity->GetDefinitionPath().ToString(),
-            *GetSceneDefinition()->GetPath().ToString() );
+        Entity* pEntity = ppEntities[ entityIndex ];
+        HELIUM_ASSERT( pEntity );
 
-        return false;
-    }
+        // Make sure the entity is part of this slice.
+        if( pEntity->GetSlice().Get() != this )
+        {
+            HELIUM_TRACE(
+                TraceLevels::Error,
+                TXT( "Slice::DestroyEntities(): Entity \"%s\" is not part of this slice.\n" ),
+                *pEntity->GetDefinitionPath().ToString() );
 
-    // Clear the entity's references back to this slice and remove it from the entity list.
-    size_t index = pEntity->GetSliceIndex();
-    HELIUM_ASSERT( index < m_entities.GetSize() );
+            continue;
+        }
 
-    pEntity->ClearSliceInfo();
-    m_entities.RemoveSwap( index );
+        collections.Push( &pEntity->GetComponents() );
+    }
+
+    World* pWorld = GetWorld();
+    if( pWorld && !collections.IsEmpty() )
+    {
+        pWorld->GetComponentManager()->ReleaseComponents( collections.GetData(), collections.GetSize() );
+    }
 
-    // Update the index of the entity which has been moved to fill the entity list entry we just removed.
-    size_t entityCount = m_entities.GetSize();
-    if( index < entityCount )
+    // Clear the entities' references back to this slice and remove them from the entity list.  Removing an entity may
+    // release the last reference to it, so it must not be touched afterwards.
+    for( size_t entityIndex = 0; entityIndex < count; ++entityIndex )
     {
-        Entity* pMovedEntity = m_entities[ index ];
-        HELIUM_ASSERT( pMovedEntity );
-        HELIUM_ASSERT( pMovedEntity->GetSliceIndex() == entityCount );
-        pMovedEntity->SetSliceIndex( index );
+        Entity* pEntity = ppEntities[ entityIndex ];
+        if( pEntity->GetSlice().Get() != this )
+        {
+            continue;
+        }
+
+        size_t index = pEntity->GetSliceIndex();
+        HELIUM_ASSERT( index < m_entities.GetSize() );
+
+        pEntity->ClearSliceInfo();
+        m_tagColumns.RemoveSwap( index, m_entities.GetSize() - 1 );
+        m_entities.RemoveSwap( index );
+
+        // Update the index of the entity which has been moved to fill the entity list entry we just removed.
+        size_t entityCount = m_entities.GetSize();
+        if( index < entityCount )
+        {
+            Entity* pMovedEntity = m_entities[ index ];
+            HELIUM_ASSERT( pMovedEntity );
+            HELIUM_ASSERT( pMovedEntity->GetSliceIndex() == entityCount );
+            pMovedEntity->SetSliceIndex( index );
+        }
     }
 
-    return true;
+    return collections.GetSize();
 }
 
 
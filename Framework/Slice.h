@@ -2,6 +2,7 @@
 
 #include "Framework/Framework.h"
 
+#include "Framework/EntityTags.h"
 #include "Framework/ParameterSet.h"
 #include "Reflect/Object.h"
 
@@ -39,7 +40,12 @@ namespace Helium
         /// @name EntityDefinition Creation
         //@{
 		virtual Helium::Entity* CreateEntity(EntityDefinition *pEntityDefinition, ParameterSet *pParameterSet = NULL);
+        size_t CreateEntities(
+            EntityDefinition *pEntityDefinition, size_t count, ParameterSet *pParameterSet = NULL, DynamicArray< Entity* > *pEntities = NULL );
+        size_t CreateEntities(
+            EntityDefinition *pEntityDefinition, const DynamicArray< ParameterSetPtr > &parameterSets, DynamicArray< Entity* > *pEntities = NULL );
         virtual bool DestroyEntity( Entity* pEntity );
+        size_t DestroyEntities( Entity* const* ppEntities, size_t count );
         //@}
 
         /// @name EntityDefinition Access
@@ -48,6 +54,12 @@ namespace Helium
         Entity* GetEntity( size_t index ) const;
         //@}
 
+        /// @name Entity Tags
+        //@{
+        inline Tags::TagColumns& GetTagColumns();
+        inline const Tags::TagColumns& GetTagColumns() const;
+        //@}
+
         /// @name World Registration
         //@{
         World *GetWorld();
@@ -61,10 +73,19 @@ namespace Helium
         Helium::SceneDefinition *GetSceneDefinition() const;
 
     private:
+        size_t CreateEntitiesInternal(
+            EntityDefinition *pEntityDefinition, 
+            size_t count, 
+            const ParameterSet * const *ppParameterSets, 
+            size_t parameterSetCount, 
+            DynamicArray< Entity* > *pEntities );
+
         Helium::SceneDefinitionPtr m_spSceneDefinition;
 
         /// Entities.
         DynamicArray< EntityPtr > m_entities;
+        /// Entity tags, one bit per tag parallel to m_entities.
+        Tags::TagColumns m_tagColumns;
 
         /// Slice world.
         WorldWPtr m_spWorld;
@@ -21,4 +21,20 @@ namespace Helium
         return m_entities.GetSize();
     }
 
+    /// Get the tag bits of the entities in this slice, indexed by entity slice index.
+    ///
+    /// @return  Tag columns.
+    ///
+    /// @see Entity::SetTag()
+    Tags::TagColumns& Slice::GetTagColumns()
+    {
+        return m_tagColumns;
+    }
+
+    /// @copydoc GetTagColumns()
+    const Tags::TagColumns& Slice::GetTagColumns() const
+    {
+        return m_tagColumns;
+    }
+
 }
@@ -0,0 +1,418 @@
+#include "FrameworkPch.h"
+#include "Framework/SliceStreamer.h"
+
+#include "Platform/Timer.h"
+#include "Foundation/Numeric.h"
+#include "Engine/AssetLoader.h"
+#include "Framework/World.h"
+#include "Framework/Slice.h"
+#include "Framework/Entity.h"
+#include "Framework/SceneDefinition.h"
+
+using namespace Helium;
+
+const float32_t SliceStreamer::DEFAULT_TIME_BUDGET = 2.0f;
+
+/// Constructor.
+SliceStreamer::SliceStreamer()
+: m_pWorld( NULL )
+, m_timeBudget( DEFAULT_TIME_BUDGET )
+{
+}
+
+/// Destructor.
+SliceStreamer::~SliceStreamer()
+{
+	HELIUM_ASSERT( m_slices.IsEmpty() );
+}
+
+/// Initialize this streamer.
+///
+/// @param[in] pWorld  World to stream slices into.
+///
+/// @see Cleanup()
+void SliceStreamer::Initialize( World* pWorld )
+{
+	HELIUM_ASSERT( pWorld );
+	HELIUM_ASSERT( !m_pWorld );
+	m_pWorld = pWorld;
+}
+
+/// Unload every streamed slice immediately and forget about them.
+///
+/// @see Initialize()
+void SliceStreamer::Cleanup()
+{
+	AssetLoader* pAssetLoader = AssetLoader::GetInstance();
+
+	for( DynamicArray< StreamedSlice >::Iterator iter = m_slices.Begin(); iter != m_slices.End(); ++iter )
+	{
+		if( iter->m_State == StreamedSliceStates::Loading && pAssetLoader )
+		{
+			// Loads can't be cancelled, finish it so the request is released
+			AssetPtr spAsset;
+			pAssetLoader->FinishLoad( iter->m_LoadRequestId, spAsset );
+		}
+
+		if( iter->m_spSlice )
+		{
+			while( !TickUnloading( *iter, 0 ) )
+			{
+			}
+		}
+
+		ReleaseSlice( *iter );
+	}
+
+	m_slices.Clear();
+	m_pointsOfInterest.Clear();
+	m_unloadEntities.Clear();
+	m_pWorld = NULL;
+}
+
+/// Add a slice to stream in and out around the points of interest.
+///
+/// @param[in] scenePath     Path of the SceneDefinition to instantiate in the slice.
+/// @param[in] rCenter       Center of the slice.
+/// @param[in] loadRadius    Distance from the center within which a point of interest loads the slice.
+/// @param[in] unloadRadius  Distance from the center beyond which every point of interest must be for the slice to
+///                          unload.  Must be at least the load radius.
+///
+/// @return  Index of the streamed slice.
+///
+/// @see SetPointsOfInterest(), GetStreamedSliceState()
+size_t SliceStreamer::AddStreamedSlice( AssetPath scenePath, const Simd::Vector3& rCenter, float32_t loadRadius, float32_t unloadRadius )
+{
+	HELIUM_ASSERT( !scenePath.IsEmpty() );
+	HELIUM_ASSERT( loadRadius >= 0.0f );
+	HELIUM_ASSERT( unloadRadius >= loadRadius );
+
+	StreamedSlice* pSlice = m_slices.New();
+	HELIUM_ASSERT( pSlice );
+	pSlice->m_Center = rCenter;
+	pSlice->m_ScenePath = scenePath;
+	pSlice->m_LoadRadiusSquared = loadRadius * loadRadius;
+	pSlice->m_UnloadRadiusSquared = unloadRadius * unloadRadius;
+	pSlice->m_State = StreamedSliceStates::Unloaded;
+	pSlice->m_bWanted = false;
+	SetInvalid( pSlice->m_LoadRequestId );
+	pSlice->m_NextEntityIndex = 0;
+
+	return m_slices.GetSize() - 1;
+}
+
+/// Get the slice instantiated for a streamed slice.
+///
+/// @param[in] index  Streamed slice index, as returned by AddStreamedSlice().
+///
+/// @return  Slice while the streamed slice is instantiating, loaded or unloading, null otherwise.
+Slice* SliceStreamer::GetStreamedSlice( size_t index ) const
+{
+	HELIUM_ASSERT( index < m_slices.GetSize() );
+	return m_slices[ index ].m_spSlice;
+}
+
+/// Set the points around which slices are kept loaded, such as the players' positions.
+///
+/// @param[in] pPoints     Points of interest.
+/// @param[in] pointCount  Number of points of interest.
+void SliceStreamer::SetPointsOfInterest( const Simd::Vector3* pPoints, size_t pointCount )
+{
+	HELIUM_ASSERT( pPoints || pointCount == 0 );
+
+	m_pointsOfInterest.Resize( 0 );
+	m_pointsOfInterest.Reserve( pointCount );
+	for( size_t pointIndex = 0; pointIndex < pointCount; ++pointIndex )
+	{
+		m_pointsOfInterest.Push( pPoints[ pointIndex ] );
+	}
+}
+
+/// Advance streaming for the current frame.
+///
+/// Scene definition loads are started and polled, then slices that are no longer wanted have entities destroyed and
+/// slices that are wanted have entities created until the time budget is spent.  Must not run concurrently with
+/// anything else that accesses the world's slices or components.
+void SliceStreamer::Update()
+{
+	if( m_slices.IsEmpty() )
+	{
+		return;
+	}
+
+	HELIUM_ASSERT( m_pWorld );
+
+	uint64_t deadline = Timer::GetTickCount() + static_cast< uint64_t >(
+		static_cast< float64_t >( m_timeBudget ) * 0.001 * static_cast< float64_t >( Timer::GetTicksPerSecond() ) );
+
+	UpdateWanted();
+
+	// Start and finish loads, and turn around slices that are no longer wanted
+	for( DynamicArray< StreamedSlice >::Iterator iter = m_slices.Begin(); iter != m_slices.End(); ++iter )
+	{
+		StreamedSlice& rSlice = *iter;
+
+		switch( rSlice.m_State )
+		{
+		case StreamedSliceStates::Unloaded:
+			if( rSlice.m_bWanted )
+			{
+				AssetLoader* pAssetLoader = AssetLoader::GetInstance();
+				HELIUM_ASSERT( pAssetLoader );
+
+				rSlice.m_LoadRequestId = pAssetLoader->BeginLoadObject( rSlice.m_ScenePath );
+				if( IsInvalid( rSlice.m_LoadRequestId ) )
+				{
+					HELIUM_TRACE(
+						TraceLevels::Error,
+						TXT( "SliceStreamer::Update(): Failed to begin loading scene \"%s\".\n" ),
+						*rSlice.m_ScenePath.ToString() );
+
+					rSlice.m_State = StreamedSliceStates::Failed;
+				}
+				else
+				{
+					rSlice.m_State = StreamedSliceStates::Loading;
+				}
+			}
+			break;
+
+		case StreamedSliceStates::Loading:
+			TickLoading( rSlice );
+			break;
+
+		case StreamedSliceStates::Instantiating:
+		case StreamedSliceStates::Loaded:
+			if( !rSlice.m_bWanted )
+			{
+				rSlice.m_State = StreamedSliceStates::Unloading;
+			}
+			break;
+
+		case StreamedSliceStates::Failed:
+			if( !rSlice.m_bWanted )
+			{
+				rSlice.m_State = StreamedSliceStates::Unloaded;
+			}
+			break;
+
+		default:
+			break;
+		}
+	}
+
+	// Unload first, so memory is freed before more is used.  An unload that has started always finishes, even if the
+	// slice is wanted again, and the slice loads again afterwards.
+	for( DynamicArray< StreamedSlice >::Iterator iter = m_slices.Begin(); iter != m_slices.End(); ++iter )
+	{
+		if( iter->m_State == StreamedSliceStates::Unloading && TickUnloading( *iter, deadline ) )
+		{
+			ReleaseSlice( *iter );
+		}
+	}
+
+	for( DynamicArray< StreamedSlice >::Iterator iter = m_slices.Begin(); iter != m_slices.End(); ++iter )
+	{
+		if( iter->m_State == StreamedSliceStates::Instantiating && TickInstantiating( *iter, deadline ) )
+		{
+			// The definition is kept so the entity definitions stay resident for as long as their entities exist
+			iter->m_State = StreamedSliceStates::Loaded;
+		}
+	}
+}
+
+/// Work out which slices should be loaded given the current points of interest.
+void SliceStreamer::UpdateWanted()
+{
+	for( DynamicArray< StreamedSlice >::Iterator sliceIter = m_slices.Begin(); sliceIter != m_slices.End(); ++sliceIter )
+	{
+		StreamedSlice& rSlice = *sliceIter;
+
+		float32_t closestDistanceSquared = NumericLimits< float32_t >::Maximum;
+		for( DynamicArray< Simd::Vector3 >::ConstIterator pointIter = m_pointsOfInterest.Begin();
+			pointIter != m_pointsOfInterest.End(); ++pointIter )
+		{
+			closestDistanceSquared = Min( closestDistanceSquared, ( *pointIter - rSlice.m_Center ).GetMagnitudeSquared() );
+		}
+
+		// Between the two radii the slice stays as it is
+		if( closestDistanceSquared <= rSlice.m_LoadRadiusSquared )
+		{
+			rSlice.m_bWanted = true;
+		}
+		else if( closestDistanceSquared > rSlice.m_UnloadRadiusSquared )
+		{
+			rSlice.m_bWanted = false;
+		}
+	}
+}
+
+/// Poll the scene definition load of a slice and create the slice once it has loaded.
+///
+/// @param[in] rSlice  Slice in the Loading state.
+///
+/// @return  True if the load has finished (whether or not it succeeded), false if it is still in progress.  A slice
+///          that failed to load or be added to the world is left in the Failed state.
+bool SliceStreamer::TickLoading( StreamedSlice& rSlice )
+{
+	HELIUM_ASSERT( rSlice.m_State == StreamedSliceStates::Loading );
+
+	AssetLoader* pAssetLoader = AssetLoader::GetInstance();
+	HELIUM_ASSERT( pAssetLoader );
+
+	AssetPtr spAsset;
+	if( !pAssetLoader->TryFinishLoad( rSlice.m_LoadRequestId, spAsset ) )
+	{
+		return false;
+	}
+
+	SetInvalid( rSlice.m_LoadRequestId );
+	rSlice.m_State = StreamedSliceStates::Unloaded;
+
+	SceneDefinition* pSceneDefinition = Reflect::SafeCast< SceneDefinition >( spAsset.Get() );
+	if( !pSceneDefinition )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			TXT( "SliceStreamer::TickLoading(): \"%s\" did not load as a SceneDefinition.\n" ),
+			*rSlice.m_ScenePath.ToString() );
+
+		rSlice.m_State = StreamedSliceStates::Failed;
+		return true;
+	}
+
+	// Dropping the definition here lets it be released again if the slice was unwanted while loading
+	if( !rSlice.m_bWanted )
+	{
+		return true;
+	}
+
+	SlicePtr spSlice = Reflect::AssertCast< Slice >( Slice::CreateObject() );
+	HELIUM_ASSERT( spSlice );
+	spSlice->Initialize( pSceneDefinition );
+	if( !m_pWorld->AddSlice( spSlice ) )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			TXT( "SliceStreamer::TickLoading(): Failed to add the slice for \"%s\" to the world.\n" ),
+			*rSlice.m_ScenePath.ToString() );
+
+		rSlice.m_State = StreamedSliceStates::Failed;
+		return true;
+	}
+
+	rSlice.m_spSceneDefinition = pSceneDefinition;
+	rSlice.m_spSlice = spSlice;
+	rSlice.m_NextEntityIndex = 0;
+	rSlice.m_State = StreamedSliceStates::Instantiating;
+
+	return true;
+}
+
+/// Create entities of a slice until all are created or the deadline passes.
+///
+/// Consecutive entries of the scene that use the same entity definition are created together through
+/// Slice::CreateEntities(), up to INSTANTIATE_BATCH_SIZE at a time.  At least one batch is created per call so every
+/// slice makes progress.
+///
+/// @param[in] rSlice    Slice in the Instantiating state.
+/// @param[in] deadline  Timer tick count at which to stop.
+///
+/// @return  True if every entity of the slice has been created.
+bool SliceStreamer::TickInstantiating( StreamedSlice& rSlice, uint64_t deadline )
+{
+	HELIUM_ASSERT( rSlice.m_State == StreamedSliceStates::Instantiating );
+
+	SceneDefinition* pSceneDefinition = rSlice.m_spSceneDefinition;
+	Slice* pSlice = rSlice.m_spSlice;
+	HELIUM_ASSERT( pSceneDefinition );
+	HELIUM_ASSERT( pSlice );
+
+	size_t entityDefinitionCount = pSceneDefinition->GetEntityDefinitionCount();
+	while( rSlice.m_NextEntityIndex < entityDefinitionCount )
+	{
+		EntityDefinition* pEntityDefinition = pSceneDefinition->GetEntityDefinition( rSlice.m_NextEntityIndex++ );
+
+		size_t batchSize = 1;
+		while( batchSize < INSTANTIATE_BATCH_SIZE &&
+			rSlice.m_NextEntityIndex < entityDefinitionCount &&
+			pSceneDefinition->GetEntityDefinition( rSlice.m_NextEntityIndex ) == pEntityDefinition )
+		{
+			++rSlice.m_NextEntityIndex;
+			++batchSize;
+		}
+
+		if( pEntityDefinition )
+		{
+			pSlice->CreateEntities( pEntityDefinition, batchSize );
+		}
+
+		if( Timer::GetTickCount() >= deadline )
+		{
+			break;
+		}
+	}
+
+	return rSlice.m_NextEntityIndex >= entityDefinitionCount;
+}
+
+/// Destroy entities of a slice, a batch at a time, until all are destroyed or the deadline passes.
+///
+/// At least one batch is destroyed per call so every slice makes progress.
+///
+/// @param[in] rSlice    Slice being unloaded.
+/// @param[in] deadline  Timer tick count at which to stop.
+///
+/// @return  True if every entity of the slice has been destroyed.
+bool SliceStreamer::TickUnloading( StreamedSlice& rSlice, uint64_t deadline )
+{
+	Slice* pSlice = rSlice.m_spSlice;
+	HELIUM_ASSERT( pSlice );
+
+	for( size_t entityCount = pSlice->GetEntityCount(); entityCount != 0; entityCount = pSlice->GetEntityCount() )
+	{
+		// Destroy from the end of the slice, last entity first.  Slice::DestroyEntities() removes entities in the order
+		// given by swapping in the last one, so each removal takes the last entity and none have to be moved.
+		size_t batchSize = Min( entityCount, UNLOAD_BATCH_SIZE );
+
+		m_unloadEntities.Resize( 0 );
+		for( size_t entityIndex = entityCount; entityIndex > entityCount - batchSize; --entityIndex )
+		{
+			m_unloadEntities.Push( pSlice->GetEntity( entityIndex - 1 ) );
+		}
+
+		size_t destroyedCount = pSlice->DestroyEntities( m_unloadEntities.GetData(), batchSize );
+		HELIUM_ASSERT( destroyedCount == batchSize );
+		HELIUM_UNREF( destroyedCount );
+
+		if( Timer::GetTickCount() >= deadline )
+		{
+			break;
+		}
+	}
+
+	m_unloadEntities.Resize( 0 );
+
+	return pSlice->GetEntityCount() == 0;
+}
+
+/// Detach a slice with no entities left from the world and release its scene definition.
+///
+/// @param[in] rSlice  Slice to release.
+void SliceStreamer::ReleaseSlice( StreamedSlice& rSlice )
+{
+	if( rSlice.m_spSlice )
+	{
+		HELIUM_ASSERT( rSlice.m_spSlice->GetEntityCount() == 0 );
+		if( rSlice.m_spSlice->GetWorld() )
+		{
+			HELIUM_VERIFY( m_pWorld->RemoveSlice( rSlice.m_spSlice ) );
+		}
+
+		rSlice.m_spSlice.Release();
+	}
+
+	rSlice.m_spSceneDefinition.Release();
+	rSlice.m_NextEntityIndex = 0;
+	rSlice.m_State = StreamedSliceStates::Unloaded;
+}
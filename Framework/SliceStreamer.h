@@ -0,0 +1,131 @@
+#pragma once
+
+#include "Framework/Framework.h"
+
+#include "Engine/AssetPath.h"
+#include "Foundation/DynamicArray.h"
+#include "Foundation/SmartPtr.h"
+#include "MathSimd/Vector3.h"
+
+namespace Helium
+{
+	class World;
+	class Entity;
+
+	class Slice;
+	typedef Helium::StrongPtr< Slice > SlicePtr;
+
+	class SceneDefinition;
+	typedef Helium::StrongPtr< SceneDefinition > SceneDefinitionPtr;
+
+	namespace StreamedSliceStates
+	{
+		enum StreamedSliceState
+		{
+			Unloaded,       // Nothing is loaded or instantiated
+			Loading,        // Waiting on the AssetLoader for the scene definition
+			Instantiating,  // Creating the scene's entities, a few each frame
+			Loaded,         // Every entity of the scene has been created
+			Unloading,      // Destroying the slice's entities, a few each frame
+			Failed,         // The scene failed to load or its slice couldn't be added, retried once no longer wanted
+		};
+	}
+	typedef StreamedSliceStates::StreamedSliceState StreamedSliceState;
+
+	/// Streams slices into and out of a world around points of interest.
+	///
+	/// Each streamed slice is a SceneDefinition placed at a center point.  It is loaded once any point of interest comes
+	/// within its load radius and unloaded once every point of interest is beyond its unload radius (which should be
+	/// larger, so a point sitting on the boundary doesn't load and unload the slice every frame).  Scene definitions are
+	/// loaded asynchronously through the AssetLoader, and entities are created and destroyed in small steps within a
+	/// per-frame time budget, so a large level never stalls a frame and only the slices near a point of interest are
+	/// resident.  A slice whose scene fails to load is not retried until it has stopped being wanted, so a bad path
+	/// doesn't cost a load attempt and an error every frame.
+	class HELIUM_FRAMEWORK_API SliceStreamer : NonCopyable
+	{
+	public:
+		/// Default per-frame time budget for creating and destroying entities, in milliseconds.
+		static const float32_t DEFAULT_TIME_BUDGET;
+		/// Most entities created between time budget checks while instantiating.
+		static const size_t INSTANTIATE_BATCH_SIZE = 32;
+		/// Number of entities destroyed between time budget checks while unloading.
+		static const size_t UNLOAD_BATCH_SIZE = 32;
+
+		/// @name Construction/Destruction
+		//@{
+		SliceStreamer();
+		~SliceStreamer();
+		//@}
+
+		/// @name Initialization
+		//@{
+		void Initialize( World* pWorld );
+		void Cleanup();
+		//@}
+
+		/// @name Streamed Slices
+		//@{
+		size_t AddStreamedSlice( AssetPath scenePath, const Simd::Vector3& rCenter, float32_t loadRadius, float32_t unloadRadius );
+		inline size_t GetStreamedSliceCount() const;
+		inline StreamedSliceState GetStreamedSliceState( size_t index ) const;
+		Slice* GetStreamedSlice( size_t index ) const;
+		//@}
+
+		/// @name Streaming Control
+		//@{
+		void SetPointsOfInterest( const Simd::Vector3* pPoints, size_t pointCount );
+		inline void SetTimeBudget( float32_t milliseconds );
+		inline float32_t GetTimeBudget() const;
+
+		void Update();
+		//@}
+
+	private:
+		/// Streaming information for a single slice.
+		struct StreamedSlice
+		{
+			/// Center of the slice.
+			Simd::Vector3 m_Center;
+			/// Path of the scene definition to instantiate.
+			AssetPath m_ScenePath;
+			/// Squared distance within which a point of interest loads the slice.
+			float32_t m_LoadRadiusSquared;
+			/// Squared distance beyond which every point of interest must be for the slice to unload.
+			float32_t m_UnloadRadiusSquared;
+			/// Current streaming state.
+			StreamedSliceState m_State;
+			/// True if the slice should be loaded given the current points of interest.
+			bool m_bWanted;
+			/// AssetLoader request for the scene definition while loading.
+			size_t m_LoadRequestId;
+			/// Scene definition, held while the slice is instantiated.
+			SceneDefinitionPtr m_spSceneDefinition;
+			/// Slice holding the instantiated entities.
+			SlicePtr m_spSlice;
+			/// Index of the next entity definition to instantiate.
+			size_t m_NextEntityIndex;
+		};
+
+		/// @name Streaming Steps
+		//@{
+		void UpdateWanted();
+		bool TickLoading( StreamedSlice& rSlice );
+		bool TickInstantiating( StreamedSlice& rSlice, uint64_t deadline );
+		bool TickUnloading( StreamedSlice& rSlice, uint64_t deadline );
+		void ReleaseSlice( StreamedSlice& rSlice );
+		//@}
+
+		/// World to stream slices into.
+		World* m_pWorld;
+		/// Streamed slices.
+		DynamicArray< StreamedSlice > m_slices;
+		/// Points around which slices are loaded.
+		DynamicArray< Simd::Vector3 > m_pointsOfInterest;
+		/// Per-frame time budget for creating and destroying entities, in milliseconds.
+		float32_t m_timeBudget;
+		/// Entities gathered for batched destruction (kept to avoid reallocating every frame).
+		DynamicArray< Entity* > m_unloadEntities;
+	};
+}
+
+#include "Framework/SliceStreamer.inl"
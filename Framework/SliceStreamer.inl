@@ -0,0 +1,46 @@
+namespace Helium
+{
+	/// Get the number of streamed slices.
+	///
+	/// @return  Streamed slice count.
+	///
+	/// @see AddStreamedSlice()
+	size_t SliceStreamer::GetStreamedSliceCount() const
+	{
+		return m_slices.GetSize();
+	}
+
+	/// Get the streaming state of a slice.
+	///
+	/// @param[in] index  Streamed slice index, as returned by AddStreamedSlice().
+	///
+	/// @return  Current streaming state.
+	StreamedSliceState SliceStreamer::GetStreamedSliceState( size_t index ) const
+	{
+		HELIUM_ASSERT( index < m_slices.GetSize() );
+		return m_slices[ index ].m_State;
+	}
+
+	/// Set the time Update() may spend creating and destroying entities each frame.
+	///
+	/// Loads and unloads make progress every frame regardless, at least one batch of entities is created or destroyed.
+	///
+	/// @param[in] milliseconds  Time budget.
+	///
+	/// @see GetTimeBudget()
+	void SliceStreamer::SetTimeBudget( float32_t milliseconds )
+	{
+		HELIUM_ASSERT( milliseconds >= 0.0f );
+		m_timeBudget = milliseconds;
+	}
+
+	/// Get the time Update() may spend creating and destroying entities each frame.
+	///
+	/// @return  Time budget in milliseconds.
+	///
+	/// @see SetTimeBudget()
+	float32_t SliceStreamer::GetTimeBudget() const
+	{
+		return m_timeBudget;
+	}
+}
@@ -1,6 +1,8 @@
 #include "FrameworkPch.h"
 #include "Framework/StateMachine.h"
 #include "Reflect/TranslatorDeduction.h"
+#include "Foundation/Numeric.h"
+#include "EngineJobs/JobManager.h"
 
 using namespace Helium;
 
@@ -9,7 +11,6 @@ HELIUM_DEFINE_BASE_STRUCT( Helium::StateTransition );
 Helium::StateTransition::StateTransition() 
 : m_RequiredPredicateResult(true)
 , m_MinimumTimeInState(0.0f)
-, m_NextState(NULL)
 {
 
 }
@@ -45,6 +46,7 @@ void StateMachineDefinition::PopulateMetaType( Reflect::MetaStruct& comp )
 
 /// Constructor.
 StateMachineDefinition::StateMachineDefinition()
+: m_InitialState( Invalid< uint32_t >() )
 {
 }
 
@@ -55,14 +57,14 @@ StateMachineDefinition::~StateMachineDefinition()
 
 void StateMachineDefinition::FinalizeLoad()
 {
-	typedef HashMap< Name, State * > HM_States;
+	typedef HashMap< Name, uint32_t > HM_States;
 	HM_States stateLookupMap;
 
 	// Populate the state lookup map
-	for ( DynamicArray<State>::Iterator stateIter = m_States.Begin();
-		stateIter != m_States.End(); ++stateIter )
+	for ( uint32_t stateIndex = 0; stateIndex < m_States.GetSize(); ++stateIndex )
 	{
-		if (stateIter->m_StateName.IsEmpty())
+		const State &rState = m_States[ stateIndex ];
+		if (rState.m_StateName.IsEmpty())
 		{
 			HELIUM_TRACE(
 				TraceLevels::Warning,
@@ -72,7 +74,7 @@ void StateMachineDefinition::FinalizeLoad()
 			continue;
 		}
 
-		HM_States::Iterator mapIter = stateLookupMap.Find(stateIter->m_StateName);
+		HM_States::Iterator mapIter = stateLookupMap.Find(rState.m_StateName);
 
 		if ( mapIter != stateLookupMap.End() )
 		{
@@ -80,58 +82,73 @@ void StateMachineDefinition::FinalizeLoad()
 				TraceLevels::Warning,
 				"StateMachine '%s' has multiple states with the name '%s'\n",
 				*GetPath().ToString(),
-				*stateIter->m_StateName);
+				*rState.m_StateName);
 
 			continue;
 		}
 
-		stateLookupMap.Insert( mapIter, HM_States::ValueType( stateIter->m_StateName, &*stateIter ) );
+		stateLookupMap.Insert( mapIter, HM_States::ValueType( rState.m_StateName, stateIndex ) );
 	}
 
-	// Set up the states/transitions
-	for (DynamicArray<State>::Iterator stateIter = m_States.Begin();
-		stateIter != m_States.End(); ++stateIter)
+	m_CompiledStates.Resize( 0 );
+	m_CompiledStates.Reserve( m_States.GetSize() );
+	m_CompiledTransitions.Resize( 0 );
+
+	// Set up the states/transitions. Every state gets a compiled entry so indices match m_States, unnamed and
+	// duplicate states just have no transitions and can't be reached.
+	for ( uint32_t stateIndex = 0; stateIndex < m_States.GetSize(); ++stateIndex )
 	{
-		if (stateIter->m_StateName.IsEmpty())
+		State &rState = m_States[ stateIndex ];
+
+		CompiledState &rCompiledState = *m_CompiledStates.New();
+		rCompiledState.m_FirstTransition = static_cast< uint32_t >( m_CompiledTransitions.GetSize() );
+		rCompiledState.m_TransitionCount = 0;
+		rCompiledState.m_EarliestTransitionTime = NumericLimits< float >::Maximum;
+		rCompiledState.m_StateBitmask = 0;
+		rCompiledState.m_pOnEnterAction = rState.m_OnEnterAction.Get();
+		rCompiledState.m_pOnExitAction = rState.m_OnExitAction.Get();
+
+		if (rState.m_StateName.IsEmpty())
 		{
 			// We gave an error message for this already
 			continue;
 		}
 
 		{
-			HM_States::Iterator mapIter = stateLookupMap.Find(stateIter->m_StateName);
-			if (mapIter == stateLookupMap.End() || mapIter->Second() != &*stateIter)
+			HM_States::Iterator mapIter = stateLookupMap.Find(rState.m_StateName);
+			if (mapIter == stateLookupMap.End() || mapIter->Second() != stateIndex)
 			{
 				// We had multiple states of the same name and this was a dupe, so skip it
 				continue;
 			}
 		}
 
-		if ( !stateIter->m_StateFlags.IsEmpty() )
+		rState.m_StateBitmask = 0;
+		if ( !rState.m_StateFlags.IsEmpty() )
 		{
 			if ( !m_StateFlagSet.ReferencesObject() )
 			{
 				HELIUM_TRACE(
 					TraceLevels::Warning,
 					"State '%s' located in StateMachine '%s' has values in m_StateFlags, but there is no FlagSetDefinition set in the state machine.\n",
-					*stateIter->m_StateName,
+					*rState.m_StateName,
 					*GetPath().ToString());
 			}
 			else
 			{
-				for ( DynamicArray< Name >::Iterator flagIter = stateIter->m_StateFlags.Begin();
-					flagIter != stateIter->m_StateFlags.End(); ++flagIter )
+				for ( DynamicArray< Name >::Iterator flagIter = rState.m_StateFlags.Begin();
+					flagIter != rState.m_StateFlags.End(); ++flagIter )
 				{
 					StateBitmask bits = 0;
 					if (m_StateFlagSet->GetFlag(*flagIter, bits))
 					{
-						stateIter->m_StateBitmask |= bits;
+						rState.m_StateBitmask |= bits;
 					}
 					else
 					{
 						HELIUM_TRACE(
 							TraceLevels::Warning,
-							"BulletBodyComponentDefinition::FinalizeLoad - Body '%s' refers to a body flag '%s' in field m_AssignedGroupFlags that does not exist. Is the flag defined in '%s'?\n",
+							"StateMachineDefinition::FinalizeLoad - StateMachine '%s' refers to a state flag '%s' in field m_StateFlags that does not exist. Is the flag defined in '%s'?\n",
 							*GetPath().ToString(),
 							**flagIter,
 							*m_StateFlagSet->GetPath().ToString());
@@ -140,9 +157,11 @@ void StateMachineDefinition::FinalizeLoad()
 			}
 		}
 
+		rCompiledState.m_StateBitmask = rState.m_StateBitmask;
+
 		// Set up the transitions
-		for (DynamicArray<StateTransition>::Iterator transitionIter = stateIter->m_Transitions.Begin();
-			transitionIter != stateIter->m_Transitions.End(); ++transitionIter)
+		for (DynamicArray<StateTransition>::Iterator transitionIter = rState.m_Transitions.Begin();
+			transitionIter != rState.m_Transitions.End(); ++transitionIter)
 		{
 			HM_States::Iterator mapIter = stateLookupMap.Find(transitionIter->m_NextStateName);
 			if (mapIter == stateLookupMap.End())
@@ -150,18 +169,26 @@ void StateMachineDefinition::FinalizeLoad()
 				HELIUM_TRACE(
 					TraceLevels::Warning,
 					"Transition in state '%s' located in state machine '%s' refers to a state named '%s', but that state is not in this state machine\n",
-					*stateIter->m_StateName,
+					*rState.m_StateName,
 					*GetPath().ToString(),
 					*transitionIter->m_NextStateName);
 
 				continue;
 			}
 
-			transitionIter->m_NextState = mapIter->Second();
+			CompiledTransition &rTransition = *m_CompiledTransitions.New();
+			rTransition.m_MinimumTimeInState = transitionIter->m_MinimumTimeInState;
+			rTransition.m_NextState = mapIter->Second();
+			rTransition.m_pRequiredPredicate = transitionIter->m_RequiredPredicate.Get();
+			rTransition.m_RequiredPredicateResult = transitionIter->m_RequiredPredicateResult;
+
+			++rCompiledState.m_TransitionCount;
+			rCompiledState.m_EarliestTransitionTime = Min( rCompiledState.m_EarliestTransitionTime, rTransition.m_MinimumTimeInState );
 		}
 	}
 
 	// Set the initial state
+	SetInvalid( m_InitialState );
 	HM_States::Iterator mapIter = stateLookupMap.Find(m_InitialStateName);
 	if (mapIter != stateLookupMap.End())
 	{
@@ -171,52 +198,135 @@ void StateMachineDefinition::FinalizeLoad()
 	{
 		HELIUM_TRACE(
 			TraceLevels::Warning,
-			"StateMachine '%s' refers to an initial state named '%s', but this state does not exist in the state machine.",
+			"StateMachine '%s' refers to an initial state named '%s', but this state does not exist in the state machine.\n",
 			*GetPath().ToString(),
 			*m_InitialStateName);
 	}
 }
 
+/// Most transitions a single instance takes in one tick. Transitions with no minimum time in state consume no time,
+/// so a cycle of them whose predicates all pass would otherwise never finish the tick.
+static const uint32_t MAX_TRANSITIONS_PER_TICK = 16;
+
+StateMachineInstance::StateMachineInstance()
+: m_CurrentState( Invalid< uint32_t >() )
+, m_TimeInState( 0.0f )
+{
+
+}
+
 void StateMachineInstance::Initialize( World &world, const StateMachineDefinition *pStateMachineDefinition )
 {
 	HELIUM_ASSERT( pStateMachineDefinition );
 	m_Definition = pStateMachineDefinition;
 	m_CurrentState = pStateMachineDefinition->m_InitialState;
-	OnEnterState( world, m_CurrentState );
+	if ( IsValid( m_CurrentState ) )
+	{
+		OnEnterState( world, m_CurrentState );
+	}
 }
 
 void StateMachineInstance::Tick( World &world, float dt )
 {
+	if ( IsInvalid( m_CurrentState ) )
+	{
+		return;
+	}
+
+	const StateMachineDefinition &rDefinition = *m_Definition;
 	float timeInTick = dt;
 
-	while ( timeInTick > 0.0f )
+	for ( uint32_t transitionCount = 0; timeInTick > 0.0f && transitionCount < MAX_TRANSITIONS_PER_TICK; ++transitionCount )
 	{
-		bool m_Transitioned = false;
-		for ( DynamicArray<StateTransition>::Iterator iter = m_CurrentState->m_Transitions.Begin();
-			iter != m_CurrentState->m_Transitions.End(); ++iter )
+		const CompiledState &rState = rDefinition.m_CompiledStates[ m_CurrentState ];
+		if ( m_TimeInState + timeInTick < rState.m_EarliestTransitionTime )
+		{
+			break;
+		}
+
+		const CompiledTransition *pTransition = rDefinition.m_CompiledTransitions.GetData() + rState.m_FirstTransition;
+		const CompiledTransition *pTransitionEnd = pTransition + rState.m_TransitionCount;
+		for ( ; pTransition != pTransitionEnd; ++pTransition )
 		{
 			float timeToConsume;
-			if ( EvaluateTransition( world, *iter, timeInTick, timeToConsume ) )
+			if ( EvaluateTransition( world, *pTransition, timeInTick, timeToConsume ) )
 			{
 				timeInTick -= timeToConsume;
 				m_TimeInState += timeToConsume;
 
-				DoTransition( world, m_CurrentState, iter->m_NextState );
-
-				m_Transitioned = true;
+				DoTransition( world, pTransition->m_NextState );
 				break;
 			}
 		}
 
-		if ( !m_Transitioned )
+		if ( pTransition == pTransitionEnd )
 		{
-			m_TimeInState += timeInTick;
 			break;
 		}
 	}
+
+	m_TimeInState += timeInTick;
+}
+
+namespace
+{
+	struct TickAllData
+	{
+		World *m_pWorld;
+		StateMachineInstance * const *m_ppInstances;
+		float m_DeltaSeconds;
+	};
+}
+
+void StateMachineInstance::TickAll( World &world, StateMachineInstance * const *ppInstances, size_t count, float dt, bool bParallel )
+{
+	HELIUM_ASSERT( ppInstances || !count );
+
+	TickAllData data;
+	data.m_pWorld = &world;
+	data.m_ppInstances = ppInstances;
+	data.m_DeltaSeconds = dt;
+
+	if ( bParallel )
+	{
+		JobManager::ParallelFor( count, 0, TickRange, &data );
+	}
+	else
+	{
+		TickRange( &data, 0, count );
+	}
+}
+
+void StateMachineInstance::TickRange( void *pData, size_t start, size_t end )
+{
+	HELIUM_ASSERT( pData );
+	const TickAllData &rData = *static_cast< const TickAllData * >( pData );
+	const float dt = rData.m_DeltaSeconds;
+
+	for ( size_t index = start; index < end; ++index )
+	{
+		StateMachineInstance *pInstance = rData.m_ppInstances[ index ];
+		HELIUM_ASSERT( pInstance );
+
+		if ( IsInvalid( pInstance->m_CurrentState ) )
+		{
+			continue;
+		}
+
+		// Most instances sit in their state for many ticks, so only the timer and the state's earliest transition
+		// time are touched for them
+		const CompiledState &rState = pInstance->m_Definition->m_CompiledStates[ pInstance->m_CurrentState ];
+		if ( pInstance->m_TimeInState + dt < rState.m_EarliestTransitionTime )
+		{
+			pInstance->m_TimeInState += dt;
+			continue;
+		}
+
+		pInstance->Tick( *rData.m_pWorld, dt );
+	}
 }
 
-bool StateMachineInstance::EvaluateTransition( World &world, StateTransition &transition, float dt, float &timeToConsume )
+bool StateMachineInstance::EvaluateTransition( World &world, const CompiledTransition &transition, float dt, float &timeToConsume ) const
 {
 	if ( m_TimeInState + dt < transition.m_MinimumTimeInState )
 	{
@@ -224,52 +334,54 @@ bool StateMachineInstance::EvaluateTransition( World &world, StateTransition &tr
 	}
 
 	// Do additional checking
-	if ( transition.m_RequiredPredicate && !transition.m_RequiredPredicate->Evaluate( world, NULL ) )
+	if ( transition.m_pRequiredPredicate && transition.m_pRequiredPredicate->Evaluate( world, NULL ) != transition.m_RequiredPredicateResult )
 	{
 		return false;
 	}
 
-	timeToConsume = transition.m_MinimumTimeInState - m_TimeInState;
-	HELIUM_ASSERT(timeToConsume >= 0.0f);
+	// A transition held back only by its predicate fires as soon as the predicate passes, without consuming time
+	timeToConsume = Max( transition.m_MinimumTimeInState - m_TimeInState, 0.0f );
 	HELIUM_ASSERT(timeToConsume <= dt);
 	return true;
 }
 
-void StateMachineInstance::DoTransition( World &world, State *pOldState, State *pNewState )
+void StateMachineInstance::DoTransition( World &world, uint32_t newState )
 {
 	OnExitState( world, m_CurrentState );
 
-	m_CurrentState = pNewState;
+	m_CurrentState = newState;
 
 	OnEnterState( world, m_CurrentState );
 }
 
-void StateMachineInstance::OnEnterState( World &world, State *pState )
+void StateMachineInstance::OnEnterState( World &world, uint32_t state )
 {
 	HELIUM_TRACE(
 		TraceLevels::Debug,
 		"StateMachineInstance::OnEnterState %x %s\n",
 		this,
-		*pState->m_StateName);
+		*m_Definition->m_States[ state ].m_StateName);
 
 	m_TimeInState = 0.0f;
 
-	if (pState->m_OnEnterAction)
+	Action *pAction = m_Definition->m_CompiledStates[ state ].m_pOnEnterAction;
+	if (pAction)
 	{
-		pState->m_OnEnterAction->PerformAction( world, NULL );
+		pAction->PerformAction( world, NULL );
 	}
 }
 
-void StateMachineInstance::OnExitState( World &world, State *pState )
+void StateMachineInstance::OnExitState( World &world, uint32_t state )
 {
 	HELIUM_TRACE(
 		TraceLevels::Debug,
 		"StateMachineInstance::OnExitState %x %s\n",
 		this,
-		*pState->m_StateName);
+		*m_Definition->m_States[ state ].m_StateName);
 
-	if (pState->m_OnExitAction)
+	Action *pAction = m_Definition->m_CompiledStates[ state ].m_pOnExitAction;
+	if (pAction)
 	{
-		pState->m_OnExitAction->PerformAction( world, NULL );
+		pAction->PerformAction( world, NULL );
 	}
 }
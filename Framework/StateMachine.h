@@ -33,7 +33,6 @@ namespace Helium
 		PredicatePtr m_RequiredPredicate;
 		bool m_RequiredPredicateResult;
 
-		State *m_NextState; // Generated based on m_NextStateName
 	};
 
 	class HELIUM_FRAMEWORK_API State : public Reflect::Struct
@@ -78,11 +77,40 @@ namespace Helium
 	private:
 		friend StateMachineInstance;
 
+		/// State flattened for ticking, indexed the same as m_States.
+		struct CompiledState
+		{
+			/// Index of the state's first transition in m_CompiledTransitions.
+			uint32_t m_FirstTransition;
+			/// Number of transitions out of the state.
+			uint32_t m_TransitionCount;
+			/// Smallest minimum time in state of any transition out of the state (no transition can fire before it).
+			float m_EarliestTransitionTime;
+			/// Flags set while in the state.
+			StateBitmask m_StateBitmask;
+			/// Action performed on entering the state, may be NULL.
+			Action *m_pOnEnterAction;
+			/// Action performed on leaving the state, may be NULL.
+			Action *m_pOnExitAction;
+		};
+
+		/// Transition flattened for ticking. Transitions to unknown states are left out.
+		struct CompiledTransition
+		{
+			float m_MinimumTimeInState;
+			uint32_t m_NextState;
+			Predicate *m_pRequiredPredicate;
+			bool m_RequiredPredicateResult;
+		};
+
 		DynamicArray<State> m_States;
 		FlagSetDefinitionPtr m_StateFlagSet;
 		Name m_InitialStateName;
 
-		State *m_InitialState; // Generated based on name
+		// Generated by FinalizeLoad()
+		DynamicArray<CompiledState> m_CompiledStates;
+		DynamicArray<CompiledTransition> m_CompiledTransitions;
+		uint32_t m_InitialState;
 	};
 	typedef Helium::StrongPtr<StateMachineDefinition> StateMachineDefinitionPtr;
 	typedef Helium::StrongPtr<const StateMachineDefinition> ConstStateMachineDefinitionPtr;
@@ -90,25 +118,37 @@ namespace Helium
 	class HELIUM_FRAMEWORK_API StateMachineInstance : public Reflect::Object
 	{
 	public:
-		StateMachineInstance() { }
+		StateMachineInstance();
 		virtual ~StateMachineInstance() { }
 
 		void Initialize( World &world, const StateMachineDefinition *pStateMachineDefinition );
 
-		void Tick( World &pWorld, float dt );
+		void Tick( World &world, float dt );
 
-		bool EvaluateTransition( World &world, StateTransition &transition, float dt, float &timeToConsume );
-		void DoTransition( World &world, State *pOldState, State *pNewState );
-		void OnEnterState( World &world, State *pState );
-		void OnExitState( World &world, State *pState );
+		// Ticks many instances in one pass. Instances that can't leave their state this tick only have their timer
+		// advanced, without evaluating any predicates. With bParallel set the instances are split across the job
+		// manager's threads, so every predicate and action they use must be safe to run concurrently.
+		static void TickAll( World &world, StateMachineInstance * const *ppInstances, size_t count, float dt, bool bParallel = false );
 
-		StateBitmask GetCurrentFlags() const { return m_CurrentState ? m_CurrentState->m_StateBitmask : 0; }
+		inline StateBitmask GetCurrentFlags() const;
+		inline uint32_t GetCurrentState() const;
+		inline float GetTimeInState() const;
 
 	private:
+		typedef StateMachineDefinition::CompiledState CompiledState;
+		typedef StateMachineDefinition::CompiledTransition CompiledTransition;
+
+		bool EvaluateTransition( World &world, const CompiledTransition &transition, float dt, float &timeToConsume ) const;
+		void DoTransition( World &world, uint32_t newState );
+		void OnEnterState( World &world, uint32_t state );
+		void OnExitState( World &world, uint32_t state );
+
+		static void TickRange( void *pData, size_t start, size_t end );
+
 		ConstStateMachineDefinitionPtr m_Definition;
 
-		// Current state
-		State *m_CurrentState;
+		// Current state, index into the definition's states
+		uint32_t m_CurrentState;
 		float m_TimeInState;
 
 		DynamicArray<StateMachineInstance> m_SubStateMachines;
@@ -26,4 +26,19 @@ namespace Helium
 	{
 		return !( *this == _rhs );
 	}
+
+	StateBitmask StateMachineInstance::GetCurrentFlags() const
+	{
+		return IsValid( m_CurrentState ) ? m_Definition->m_CompiledStates[ m_CurrentState ].m_StateBitmask : 0;
+	}
+
+	uint32_t StateMachineInstance::GetCurrentState() const
+	{
+		return m_CurrentState;
+	}
+
+	float StateMachineInstance::GetTimeInState() const
+	{
+		return m_TimeInState;
+	}
 }
\ No newline at end of file
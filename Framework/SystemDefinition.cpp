@@ -28,6 +28,24 @@ void SystemDefinition::PopulateMetaType( Reflect::MetaStruct& comp )
 {
 	comp.AddField( &SystemDefinition::m_SystemComponents, "m_SystemComponents" );
 	comp.AddField( &SystemDefinition::m_ComponentTypeConfigs, "m_ComponentTypeConfigs" );
+	comp.AddField( &SystemDefinition::m_UseArchetypeStorage, "m_UseArchetypeStorage" );
+	comp.AddField( &SystemDefinition::m_ReportComponentMemoryLayout, "m_ReportComponentMemoryLayout" );
+	comp.AddField( &SystemDefinition::m_FixedTimeStep, "m_FixedTimeStep" );
+	comp.AddField( &SystemDefinition::m_MaxFixedStepsPerFrame, "m_MaxFixedStepsPerFrame" );
+	comp.AddField( &SystemDefinition::m_ParallelWorldUpdate, "m_ParallelWorldUpdate" );
+	comp.AddField( &SystemDefinition::m_FrameProfilerTracePath, "m_FrameProfilerTracePath" );
+	comp.AddField( &SystemDefinition::m_FrameProfilerTraceFrames, "m_FrameProfilerTraceFrames" );
+}
+
+Helium::SystemDefinition::SystemDefinition()
+	: m_UseArchetypeStorage(false)
+	, m_ReportComponentMemoryLayout(false)
+	, m_FixedTimeStep(0.0f)
+	, m_MaxFixedStepsPerFrame(8)
+	, m_ParallelWorldUpdate(false)
+	, m_FrameProfilerTraceFrames(0)
+{
+
 }
 
 void SystemDefinition::Initialize()
@@ -59,19 +77,29 @@ void SystemDefinition::Cleanup()
 //////////////////////////////////////////////////////////////////////////
 // ComponentTypeConfig
 
+HELIUM_DEFINE_ENUM( Helium::EComponentPoolOverflow );
 HELIUM_DEFINE_BASE_STRUCT( ComponentTypeConfig );
 
+ComponentTypeConfig::ComponentTypeConfig()
+	: m_PoolSize( static_cast<uint32_t>( -1 ) )
+	, m_OverflowPolicy( EComponentPoolOverflow::DEFAULT )
+{
+
+}
+
 void ComponentTypeConfig::PopulateMetaType( Reflect::MetaStruct& comp )
 {
 	comp.AddField( &ComponentTypeConfig::m_ComponentTypeName, "m_ComponentTypeName" );
 	comp.AddField( &ComponentTypeConfig::m_PoolSize, "m_PoolSize" );
+	comp.AddField( &ComponentTypeConfig::m_OverflowPolicy, "m_OverflowPolicy" );
 }
 
 bool ComponentTypeConfig::operator==( const ComponentTypeConfig& _rhs ) const
 {
 	return ( 
 		m_ComponentTypeName == _rhs.m_ComponentTypeName &&
-		m_PoolSize == _rhs.m_PoolSize
+		m_PoolSize == _rhs.m_PoolSize &&
+		m_OverflowPolicy == _rhs.m_OverflowPolicy
 		);
 }
 
@@ -60,13 +60,38 @@ namespace Helium
 	};
 	typedef Helium::StrongPtr< SystemComponent > SystemComponentDefinitionPtr;
 
+	// What a component pool does when all of its components are allocated (see Components::PoolOverflowPolicy)
+	struct HELIUM_FRAMEWORK_API EComponentPoolOverflow : Reflect::Enum
+	{
+		enum Enum
+		{
+			DEFAULT,
+			FAIL,
+			GROW,
+			GROW_AND_WARN,
+		};
+
+		HELIUM_DECLARE_ENUM( EComponentPoolOverflow );
+
+		static void PopulateMetaType( Helium::Reflect::MetaEnum& info )
+		{
+			info.AddElement( DEFAULT,        TXT( "DEFAULT" ) );
+			info.AddElement( FAIL,           TXT( "FAIL" ) );
+			info.AddElement( GROW,           TXT( "GROW" ) );
+			info.AddElement( GROW_AND_WARN,  TXT( "GROW_AND_WARN" ) );
+		}
+	};
+
 	struct HELIUM_FRAMEWORK_API ComponentTypeConfig : public Reflect::Struct
 	{
 		HELIUM_DECLARE_BASE_STRUCT( ComponentTypeConfig );
 		static void PopulateMetaType( Reflect::MetaStruct& comp );
 
+		ComponentTypeConfig();
+
 		Name m_ComponentTypeName;
 		uint32_t m_PoolSize; // -1 Means use the hard coded default, 0 means don't create any instances
+		EComponentPoolOverflow m_OverflowPolicy; // DEFAULT means grow and warn
 
 		inline bool operator==( const ComponentTypeConfig& _rhs ) const;
 		inline bool operator!=( const ComponentTypeConfig& _rhs ) const;
@@ -77,11 +102,20 @@ namespace Helium
 		HELIUM_DECLARE_ASSET( Helium::SystemDefinition, Helium::Asset )
 		static void PopulateMetaType( Reflect::MetaStruct& comp );
 
+		SystemDefinition();
+
 		void Initialize();
 		void Cleanup();
 
 		DynamicArray< ComponentTypeConfig > m_ComponentTypeConfigs;
 		DynamicArray< SystemComponentDefinitionPtr > m_SystemComponents;
+		bool m_UseArchetypeStorage; // Index component collections by archetype so queries can sweep contiguous columns
+		bool m_ReportComponentMemoryLayout; // Trace the memory layout of every component type on startup
+		float32_t m_FixedTimeStep; // Seconds per simulation step for fixed cadence tasks, 0 runs every task once per frame
+		uint32_t m_MaxFixedStepsPerFrame; // Simulation time beyond this many steps in one frame is dropped
+		bool m_ParallelWorldUpdate; // Update each world with its own job instead of each task updating every world in turn
+		String m_FrameProfilerTracePath; // Record frame timings and write them to this file as a Chrome trace, empty leaves the profiler off
+		uint32_t m_FrameProfilerTraceFrames; // Write the trace after this many frames instead of at shutdown, 0 waits for shutdown
 	};
 	typedef Helium::StrongPtr< SystemDefinition > SystemDefinitionPtr;
 }
@@ -2,14 +2,81 @@
 #include "FrameworkPch.h"
 #include "TaskScheduler.h"
 #include "Foundation/Map.h"
+#include "Platform/Atomic.h"
+#include "Platform/Locks.h"
+#include "Platform/MemoryHeap.h"
+#include "EngineJobs/JobManager.h"
+#include "Framework/Components.h"
+#include "Framework/FrameProfiler.h"
 
 using namespace Helium;
 
 
 TaskDefinition *TaskDefinition::s_FirstTaskDefinition = NULL;
 bool TaskScheduler::m_ContractsDefined = false;
+bool TaskScheduler::m_ParallelExecution = true;
 
 bool InsertToTaskList(A_TaskDefinitionPtr &rTaskInfoList, DynamicArray<TaskFunc> &rTaskFuncList, A_TaskDefinitionPtr &rTaskStack, const TaskDefinition *pTask, uint32_t tickType);
+void BuildTaskGraph(TaskSchedule &rSchedule);
+
+namespace
+{
+	bool ComponentTypesOverlap(const Components::TypeData *pA, const Components::TypeData *pB)
+	{
+		if (pA == pB)
+		{
+			return true;
+		}
+
+		// Accessing a type also accesses every type implementing it, so parent/child types overlap
+		for (DynamicArray<Components::TypeId>::ConstIterator iter = pA->m_ImplementedTypes.Begin(); iter != pA->m_ImplementedTypes.End(); ++iter)
+		{
+			if (*iter == pB->m_TypeId)
+			{
+				return true;
+			}
+		}
+
+		for (DynamicArray<Components::TypeId>::ConstIterator iter = pB->m_ImplementedTypes.Begin(); iter != pB->m_ImplementedTypes.End(); ++iter)
+		{
+			if (*iter == pA->m_TypeId)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	bool AnyComponentTypesOverlap(const DynamicArray<const Components::TypeData *> &rA, const DynamicArray<const Components::TypeData *> &rB)
+	{
+		for (DynamicArray<const Components::TypeData *>::ConstIterator iterA = rA.Begin(); iterA != rA.End(); ++iterA)
+		{
+			for (DynamicArray<const Components::TypeData *>::ConstIterator iterB = rB.Begin(); iterB != rB.End(); ++iterB)
+			{
+				if (ComponentTypesOverlap(*iterA, *iterB))
+				{
+					return true;
+				}
+			}
+		}
+
+		return false;
+	}
+}
+
+bool TaskContract::ConflictsWith(const TaskContract &rOther) const
+{
+	// Tasks that don't tell us what they touch are assumed to touch everything
+	if (!m_DeclaresComponentAccess || !rOther.m_DeclaresComponentAccess)
+	{
+		return true;
+	}
+
+	return AnyComponentTypesOverlap(m_WriteComponents, rOther.m_WriteComponents) ||
+		AnyComponentTypesOverlap(m_WriteComponents, rOther.m_ReadComponents) ||
+		AnyComponentTypesOverlap(m_ReadComponents, rOther.m_WriteComponents);
+}
 
 bool TaskScheduler::CalculateSchedule(uint32_t tickType, TaskSchedule &schedule)
 {	
@@ -205,9 +272,158 @@ bool TaskScheduler::CalculateSchedule(uint32_t tickType, TaskSchedule &schedule)
 	}
 #endif
 
+	BuildTaskGraph(schedule);
+
 	return true;
 }
 
+// Walk the required tasks of pTask, collecting the schedule indices of the closest scheduled tasks. Abstract tasks and
+// tasks that were dropped for this tick type are passed through so that ordering through them is preserved.
+void CollectScheduledPredecessors(const TaskDefinition *pTask, const A_TaskDefinitionPtr &rScheduleInfo, DynamicArray<uint32_t> &rPredecessors, A_TaskDefinitionPtr &rVisited)
+{
+	for (A_TaskDefinitionPtr::ConstIterator required_iter = pTask->m_RequiredTasks.Begin();
+		required_iter != pTask->m_RequiredTasks.End(); ++required_iter)
+	{
+		const TaskDefinition *pRequired = *required_iter;
+
+		bool already_visited = false;
+		for (A_TaskDefinitionPtr::ConstIterator visited_iter = rVisited.Begin(); visited_iter != rVisited.End(); ++visited_iter)
+		{
+			if (*visited_iter == pRequired)
+			{
+				already_visited = true;
+				break;
+			}
+		}
+
+		if (already_visited)
+		{
+			continue;
+		}
+
+		rVisited.Push(pRequired);
+
+		bool scheduled = false;
+		for (size_t i = 0; i < rScheduleInfo.GetSize(); ++i)
+		{
+			if (rScheduleInfo[i] == pRequired)
+			{
+				rPredecessors.Push(static_cast<uint32_t>(i));
+				scheduled = true;
+				break;
+			}
+		}
+
+		if (!scheduled)
+		{
+			CollectScheduledPredecessors(pRequired, rScheduleInfo, rPredecessors, rVisited);
+		}
+	}
+}
+
+// Build the dependency graph used by ExecuteScheduleParallel(). Only edges from earlier to later tasks in the serial
+// schedule are kept, so the graph is always acyclic and never orders anything differently than the serial schedule.
+void BuildTaskGraph(TaskSchedule &rSchedule)
+{
+	const size_t taskCount = rSchedule.m_ScheduleInfo.GetSize();
+
+	rSchedule.m_PredecessorCounts.Resize(0);
+	rSchedule.m_PredecessorCounts.Add(0, taskCount);
+	rSchedule.m_Successors.Resize(0);
+	rSchedule.m_Successors.Resize(taskCount);
+
+	DynamicArray<uint32_t> predecessors;
+	A_TaskDefinitionPtr visited;
+	DynamicArray<bool> isPredecessor;
+
+	// Phases only follow order requirements, conflicting access just keeps tasks within a phase from overlapping
+	DynamicArray< DynamicArray<uint32_t> > orderSuccessors;
+	orderSuccessors.Resize(taskCount);
+	DynamicArray<bool> afterFixed;
+	afterFixed.Add(false, taskCount);
+
+	for (size_t taskIndex = 0; taskIndex < taskCount; ++taskIndex)
+	{
+		const TaskDefinition *pTask = rSchedule.m_ScheduleInfo[taskIndex];
+
+		predecessors.Resize(0);
+		visited.Resize(0);
+		CollectScheduledPredecessors(pTask, rSchedule.m_ScheduleInfo, predecessors, visited);
+
+		isPredecessor.Resize(0);
+		isPredecessor.Add(false, taskIndex);
+		for (DynamicArray<uint32_t>::Iterator iter = predecessors.Begin(); iter != predecessors.End(); ++iter)
+		{
+			if (*iter < taskIndex)
+			{
+				isPredecessor[*iter] = true;
+				orderSuccessors[*iter].Push(static_cast<uint32_t>(taskIndex));
+
+				if (afterFixed[*iter] || rSchedule.m_ScheduleInfo[*iter]->m_Contract.GetCadence() == TaskCadences::Fixed)
+				{
+					afterFixed[taskIndex] = true;
+				}
+			}
+		}
+
+		// Tasks that aren't ordered against each other still must not overlap if their component access conflicts
+		for (size_t priorIndex = 0; priorIndex < taskIndex; ++priorIndex)
+		{
+			if (!isPredecessor[priorIndex] && pTask->m_Contract.ConflictsWith(rSchedule.m_ScheduleInfo[priorIndex]->m_Contract))
+			{
+				isPredecessor[priorIndex] = true;
+			}
+		}
+
+		for (size_t priorIndex = 0; priorIndex < taskIndex; ++priorIndex)
+		{
+			if (isPredecessor[priorIndex])
+			{
+				rSchedule.m_Successors[priorIndex].Push(static_cast<uint32_t>(taskIndex));
+				++rSchedule.m_PredecessorCounts[taskIndex];
+			}
+		}
+	}
+
+	// Variable cadence tasks that a fixed cadence task waits on run before the simulation steps, the rest after them
+	DynamicArray<bool> beforeFixed;
+	beforeFixed.Add(false, taskCount);
+	rSchedule.m_Phases.Resize(taskCount);
+
+	for (size_t taskIndex = taskCount; taskIndex-- > 0; )
+	{
+		for (DynamicArray<uint32_t>::Iterator iter = orderSuccessors[taskIndex].Begin(); iter != orderSuccessors[taskIndex].End(); ++iter)
+		{
+			if (beforeFixed[*iter] || rSchedule.m_ScheduleInfo[*iter]->m_Contract.GetCadence() == TaskCadences::Fixed)
+			{
+				beforeFixed[taskIndex] = true;
+				break;
+			}
+		}
+	}
+
+	for (size_t taskIndex = 0; taskIndex < taskCount; ++taskIndex)
+	{
+		const TaskDefinition *pTask = rSchedule.m_ScheduleInfo[taskIndex];
+		if (pTask->m_Contract.GetCadence() == TaskCadences::Fixed)
+		{
+			rSchedule.m_Phases[taskIndex] = SchedulePhases::Simulation;
+		}
+		else if (beforeFixed[taskIndex] && afterFixed[taskIndex])
+		{
+			// Ordered between two simulation tasks, the only place it can go is inside the simulation step
+#if HELIUM_TOOLS
+			HELIUM_TRACE(TraceLevels::Warning, TXT( "Task %s is ordered between fixed cadence tasks and will run with every simulation step\n" ), pTask->m_Name);
+#endif
+			rSchedule.m_Phases[taskIndex] = SchedulePhases::Simulation;
+		}
+		else
+		{
+			rSchedule.m_Phases[taskIndex] = static_cast<uint8_t>(beforeFixed[taskIndex] ? SchedulePhases::PreSimulation : SchedulePhases::PostSimulation);
+		}
+	}
+}
+
 bool InsertToTaskList(A_TaskDefinitionPtr &rTaskInfoList, DynamicArray<TaskFunc> &rTaskFuncList, A_TaskDefinitionPtr &rTaskStack, const TaskDefinition *pTask, uint32_t tickType)
 {
 	// Don't add functions that do not run under the given tick type
@@ -280,13 +496,318 @@ bool InsertToTaskList(A_TaskDefinitionPtr &rTaskInfoList, DynamicArray<TaskFunc>
 	return true;
 }
 
-void TaskScheduler::ExecuteSchedule( const TaskSchedule &schedule, DynamicArray< WorldPtr > &rWorlds )
+namespace
+{
+	void RunTask( const TaskSchedule &rSchedule, uint32_t taskIndex, DynamicArray< WorldPtr > &rWorlds )
+	{
+#if HELIUM_TOOLS
+		FrameProfiler::Scope profileScope( ProfileEventTypes::Task, rSchedule.m_ScheduleInfo[taskIndex]->m_Name, taskIndex );
+#else
+		FrameProfiler::Scope profileScope( ProfileEventTypes::Task, NULL, taskIndex );
+#endif
+
+		rSchedule.m_ScheduleFunc[taskIndex]( rWorlds );
+	}
+}
+
+void TaskScheduler::ExecuteSchedule( const TaskSchedule &schedule, DynamicArray< WorldPtr > &rWorlds, uint32_t phases )
+{
+	if ( m_ParallelExecution && JobManager::GetInstance() && schedule.m_PredecessorCounts.GetSize() == schedule.m_ScheduleFunc.GetSize() )
+	{
+		ExecuteScheduleParallel( schedule, rWorlds, phases );
+	}
+	else
+	{
+		ExecuteScheduleSerial( schedule, rWorlds, phases );
+	}
+}
+
+void TaskScheduler::ExecuteScheduleSerial( const TaskSchedule &schedule, DynamicArray< WorldPtr > &rWorlds, uint32_t phases )
 {
-	int i = 0;
-	for (DynamicArray<TaskFunc>::ConstIterator iter = schedule.m_ScheduleFunc.Begin(); iter != schedule.m_ScheduleFunc.End(); ++iter)
+	// Schedules built before phases existed run everything
+	const bool allPhases = ( phases == SchedulePhases::All ) || schedule.m_Phases.GetSize() != schedule.m_ScheduleFunc.GetSize();
+
+	for (uint32_t i = 0; i < schedule.m_ScheduleFunc.GetSize(); ++i)
+	{
+		HELIUM_ASSERT(schedule.m_ScheduleInfo[i]->m_Func == schedule.m_ScheduleFunc[i]);
+		if ( allPhases || ( schedule.m_Phases[i] & phases ) )
+		{
+			RunTask( schedule, i, rWorlds );
+		}
+	}
+}
+
+namespace
+{
+	struct ParallelScheduleState;
+
+	struct ParallelTaskJob
+	{
+		ParallelScheduleState *m_pState;
+		uint32_t m_TaskIndex;
+	};
+
+	struct ParallelScheduleState
+	{
+		const TaskSchedule *m_pSchedule;
+		DynamicArray< WorldPtr > *m_pWorlds;
+		ParallelTaskJob *m_pJobs;
+
+		// Tasks in the phases being executed
+		const bool *m_pInPhase;
+
+		// Number of unfinished predecessors of each task
+		volatile int32_t *m_pPendingPredecessors;
+		// Number of tasks that have not finished yet
+		volatile int32_t m_PendingTasks;
+
+		// Tasks that didn't declare their component access run exclusively on the thread executing the schedule
+		// (many of them, such as rendering and window updates, are not safe to run anywhere else)
+		Locker< DynamicArray< uint32_t >, SpinLock > m_ExclusiveQueue;
+
+		JobCounter m_Counter;
+	};
+
+	void RunParallelTaskJob( void *pData );
+
+	void ReleaseTask( ParallelScheduleState &rState, uint32_t taskIndex )
+	{
+		const TaskDefinition *pTask = rState.m_pSchedule->m_ScheduleInfo[taskIndex];
+		if ( pTask->m_Contract.m_DeclaresComponentAccess )
+		{
+			JobManager::Spawn( RunParallelTaskJob, &rState.m_pJobs[taskIndex], rState.m_Counter );
+		}
+		else
+		{
+			Locker< DynamicArray< uint32_t >, SpinLock >::Handle handle( rState.m_ExclusiveQueue );
+			handle->Push( taskIndex );
+		}
+	}
+
+	void FinishTask( ParallelScheduleState &rState, uint32_t taskIndex )
+	{
+		const DynamicArray<uint32_t> &rSuccessors = rState.m_pSchedule->m_Successors[taskIndex];
+		for ( DynamicArray<uint32_t>::ConstIterator iter = rSuccessors.Begin(); iter != rSuccessors.End(); ++iter )
+		{
+			if ( rState.m_pInPhase[*iter] && AtomicDecrementRelease( rState.m_pPendingPredecessors[*iter] ) == 0 )
+			{
+				ReleaseTask( rState, *iter );
+			}
+		}
+
+		AtomicDecrementRelease( rState.m_PendingTasks );
+	}
+
+	void RunParallelTaskJob( void *pData )
+	{
+		HELIUM_ASSERT( pData );
+		ParallelTaskJob *pJob = static_cast<ParallelTaskJob *>( pData );
+		ParallelScheduleState &rState = *pJob->m_pState;
+
+		RunTask( *rState.m_pSchedule, pJob->m_TaskIndex, *rState.m_pWorlds );
+		FinishTask( rState, pJob->m_TaskIndex );
+	}
+}
+
+void TaskScheduler::ExecuteScheduleParallel( const TaskSchedule &schedule, DynamicArray< WorldPtr > &rWorlds, uint32_t phases )
+{
+	const size_t taskCount = schedule.m_ScheduleFunc.GetSize();
+	HELIUM_ASSERT( schedule.m_PredecessorCounts.GetSize() == taskCount );
+	HELIUM_ASSERT( schedule.m_Successors.GetSize() == taskCount );
+
+	if ( !taskCount )
+	{
+		return;
+	}
+
+	StackMemoryHeap<>& rStackHeap = ThreadLocalStackAllocator::GetMemoryHeap();
+	StackMemoryHeap<>::Marker stackMarker( rStackHeap );
+
+	ParallelScheduleState state;
+	state.m_pSchedule = &schedule;
+	state.m_pWorlds = &rWorlds;
+	state.m_pJobs = static_cast< ParallelTaskJob * >( rStackHeap.Allocate( sizeof( ParallelTaskJob ) * taskCount ) );
+	state.m_pPendingPredecessors = static_cast< volatile int32_t * >( rStackHeap.Allocate( sizeof( int32_t ) * taskCount ) );
+	bool *pInPhase = static_cast< bool * >( rStackHeap.Allocate( sizeof( bool ) * taskCount ) );
+	state.m_pInPhase = pInPhase;
+	HELIUM_ASSERT( state.m_pJobs );
+	HELIUM_ASSERT( state.m_pPendingPredecessors );
+	HELIUM_ASSERT( pInPhase );
+
+	// Schedules built before phases existed run everything
+	const bool allPhases = ( phases == SchedulePhases::All ) || schedule.m_Phases.GetSize() != taskCount;
+
+	int32_t pendingTasks = 0;
+	for ( uint32_t i = 0; i < taskCount; ++i )
+	{
+		state.m_pJobs[i].m_pState = &state;
+		state.m_pJobs[i].m_TaskIndex = i;
+		state.m_pPendingPredecessors[i] = 0;
+		pInPhase[i] = allPhases || ( schedule.m_Phases[i] & phases ) != 0;
+		pendingTasks += pInPhase[i] ? 1 : 0;
+	}
+
+	if ( !pendingTasks )
+	{
+		return;
+	}
+
+	// Only wait on predecessors that are being executed, earlier phases have already finished
+	for ( uint32_t i = 0; i < taskCount; ++i )
+	{
+		if ( !pInPhase[i] )
+		{
+			continue;
+		}
+
+		const DynamicArray<uint32_t> &rSuccessors = schedule.m_Successors[i];
+		for ( DynamicArray<uint32_t>::ConstIterator iter = rSuccessors.Begin(); iter != rSuccessors.End(); ++iter )
+		{
+			if ( pInPhase[*iter] )
+			{
+				++state.m_pPendingPredecessors[*iter];
+			}
+		}
+	}
+
+	state.m_PendingTasks = pendingTasks;
+
+	for ( uint32_t i = 0; i < taskCount; ++i )
+	{
+		if ( pInPhase[i] && state.m_pPendingPredecessors[i] == 0 )
+		{
+			ReleaseTask( state, i );
+		}
+	}
+
+	while ( state.m_PendingTasks != 0 )
 	{
-		(*iter)( rWorlds );
-		HELIUM_ASSERT(schedule.m_ScheduleInfo[i++]->m_Func == *iter);
+		uint32_t exclusiveTaskIndex = Invalid< uint32_t >();
+		{
+			Locker< DynamicArray< uint32_t >, SpinLock >::Handle handle( state.m_ExclusiveQueue );
+			if ( !handle->IsEmpty() )
+			{
+				exclusiveTaskIndex = handle->Pop();
+			}
+		}
+
+		if ( IsValid( exclusiveTaskIndex ) )
+		{
+			RunTask( schedule, exclusiveTaskIndex, rWorlds );
+			FinishTask( state, exclusiveTaskIndex );
+		}
+		else if ( !JobManager::TryRunJob() )
+		{
+			Thread::Yield();
+		}
+	}
+
+	JobManager::Wait( state.m_Counter );
+}
+
+namespace
+{
+	struct WorldScheduleJob
+	{
+		const TaskSchedule *m_pSchedule;
+		DynamicArray< WorldPtr > *m_pWorlds;  //< Holds only the world this job updates
+		const bool *m_pInPhase;
+		uint32_t m_FirstTask;
+		uint32_t m_EndTask;
+	};
+
+	void RunWorldScheduleJob( void *pData )
+	{
+		HELIUM_ASSERT( pData );
+		WorldScheduleJob &rJob = *static_cast< WorldScheduleJob * >( pData );
+
+		for ( uint32_t i = rJob.m_FirstTask; i < rJob.m_EndTask; ++i )
+		{
+			if ( rJob.m_pInPhase[i] )
+			{
+				RunTask( *rJob.m_pSchedule, i, *rJob.m_pWorlds );
+			}
+		}
+	}
+}
+
+void TaskScheduler::ExecuteSchedulePerWorld( const TaskSchedule &schedule, DynamicArray< WorldPtr > &rWorlds, DynamicArray< DynamicArray< WorldPtr > > &rWorldLists, uint32_t phases )
+{
+	const size_t taskCount = schedule.m_ScheduleFunc.GetSize();
+	const size_t worldCount = rWorlds.GetSize();
+
+	if ( !JobManager::GetInstance() || worldCount < 2 )
+	{
+		ExecuteSchedule( schedule, rWorlds, phases );
+		return;
+	}
+
+	rWorldLists.Resize( worldCount );
+	for ( size_t worldIndex = 0; worldIndex < worldCount; ++worldIndex )
+	{
+		DynamicArray< WorldPtr > &rWorldList = rWorldLists[ worldIndex ];
+		if ( rWorldList.GetSize() != 1 || rWorldList[ 0 ].Get() != rWorlds[ worldIndex ].Get() )
+		{
+			rWorldList.Resize( 0 );
+			rWorldList.Push( rWorlds[ worldIndex ] );
+		}
+	}
+
+	StackMemoryHeap<>& rStackHeap = ThreadLocalStackAllocator::GetMemoryHeap();
+	StackMemoryHeap<>::Marker stackMarker( rStackHeap );
+
+	WorldScheduleJob *pJobs = static_cast< WorldScheduleJob * >( rStackHeap.Allocate( sizeof( WorldScheduleJob ) * worldCount ) );
+	bool *pInPhase = static_cast< bool * >( rStackHeap.Allocate( sizeof( bool ) * Max< size_t >( taskCount, 1 ) ) );
+	HELIUM_ASSERT( pJobs );
+	HELIUM_ASSERT( pInPhase );
+
+	// Schedules built before phases existed run everything
+	const bool allPhases = ( phases == SchedulePhases::All ) || schedule.m_Phases.GetSize() != taskCount;
+	for ( uint32_t i = 0; i < taskCount; ++i )
+	{
+		pInPhase[i] = allPhases || ( schedule.m_Phases[i] & phases ) != 0;
+	}
+
+	// The schedule is in dependency order, so running each world through a run of tasks before moving on keeps every
+	// ordering requirement within a world. Worlds share nothing a declared task may touch, so they don't wait on each
+	// other until a task that has to see every world at once.
+	uint32_t taskIndex = 0;
+	while ( taskIndex < taskCount )
+	{
+		if ( !pInPhase[taskIndex] )
+		{
+			++taskIndex;
+			continue;
+		}
+
+		if ( !schedule.m_ScheduleInfo[taskIndex]->m_Contract.m_DeclaresComponentAccess )
+		{
+			RunTask( schedule, taskIndex, rWorlds );
+			++taskIndex;
+			continue;
+		}
+
+		uint32_t endIndex = taskIndex + 1;
+		while ( endIndex < taskCount && ( !pInPhase[endIndex] || schedule.m_ScheduleInfo[endIndex]->m_Contract.m_DeclaresComponentAccess ) )
+		{
+			++endIndex;
+		}
+
+		JobCounter counter;
+		for ( size_t worldIndex = 0; worldIndex < worldCount; ++worldIndex )
+		{
+			WorldScheduleJob &rJob = pJobs[ worldIndex ];
+			rJob.m_pSchedule = &schedule;
+			rJob.m_pWorlds = &rWorldLists[ worldIndex ];
+			rJob.m_pInPhase = pInPhase;
+			rJob.m_FirstTask = taskIndex;
+			rJob.m_EndTask = endIndex;
+
+			JobManager::Spawn( RunWorldScheduleJob, &rJob, counter );
+		}
+
+		JobManager::Wait( counter );
+		taskIndex = endIndex;
 	}
 }
 
@@ -298,6 +819,10 @@ void Helium::TaskScheduler::ResetContracts()
 		task->m_RequiredTasks.Clear();
 		task->m_Contract.m_ContributedDependencies.Clear();
 		task->m_Contract.m_OrderRequirements.Clear();
+		task->m_Contract.m_ReadComponents.Clear();
+		task->m_Contract.m_WriteComponents.Clear();
+		task->m_Contract.m_DeclaresComponentAccess = false;
+		task->m_Contract.m_Cadence = TaskCadences::Default;
 		task = task->m_Next;
 	}
 
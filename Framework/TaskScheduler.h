@@ -6,6 +6,8 @@
 #include "Foundation/DynamicArray.h"
 #include "Foundation/ReferenceCounting.h"
 
+#include "Framework/FrameProfiler.h"
+
 #define HELIUM_DECLARE_TASK(__Type)                         \
 		__Type();                                           \
 		static __Type m_This; 
@@ -38,6 +40,11 @@ namespace Helium
 {	
 	struct TaskDefinition;
 
+	namespace Components
+	{
+		struct TypeData;
+	}
+
 	namespace OrderRequirementTypes
 	{
 		enum OrderRequirementType
@@ -67,6 +74,34 @@ namespace Helium
 	}
 	typedef TickTypes::TickType TickType;
 
+	// How often a task runs when the WorldManager is stepping the simulation at a fixed rate. With a variable time step
+	// every task runs once per frame regardless of its cadence.
+	namespace TaskCadences
+	{
+		enum TaskCadence
+		{
+			Default,            // Fixed for gameplay tasks that are not needed for rendering, Variable for everything else
+			Fixed,              // Once per simulation step, zero or more times per frame
+			Variable,           // Once per frame
+		};
+	}
+	typedef TaskCadences::TaskCadence TaskCadence;
+
+	// Parts of a schedule that can be executed separately. Variable cadence tasks that fixed cadence tasks depend on
+	// run before the simulation steps, the rest run after them.
+	namespace SchedulePhases
+	{
+		enum SchedulePhase
+		{
+			PreSimulation       = 1<<0,
+			Simulation          = 1<<1,
+			PostSimulation      = 1<<2,
+
+			All                 = PreSimulation | Simulation | PostSimulation
+		};
+	}
+	typedef SchedulePhases::SchedulePhase SchedulePhase;
+
 	struct OrderRequirement
 	{
 		TaskDefinition *m_Dependency;
@@ -78,6 +113,8 @@ namespace Helium
 	{
 		TaskContract()
 			: m_TickType( TickTypes::Never )
+			, m_Cadence( TaskCadences::Default )
+			, m_DeclaresComponentAccess( false )
 		{
 
 		}
@@ -126,13 +163,66 @@ namespace Helium
 			m_TickType = tickType;
 		}
 
+		void SetCadence(TaskCadence cadence)
+		{
+			m_Cadence = cadence;
+		}
+
+		// Resolves TaskCadences::Default from the tick type
+		TaskCadence GetCadence() const
+		{
+			if ( m_Cadence != TaskCadences::Default )
+			{
+				return m_Cadence;
+			}
+
+			return ( ( m_TickType & TickTypes::Gameplay ) && !( m_TickType & TickTypes::Render ) ) ? TaskCadences::Fixed : TaskCadences::Variable;
+		}
+
+		// Component access declarations let the scheduler run this task concurrently with other tasks it is not
+		// ordered against, as long as their access does not conflict. A task that declares nothing is assumed to
+		// touch anything and never overlaps another task. Tasks that allocate/free components or create/destroy
+		// entities must not declare access, as those modify shared pool state.
+		template <class T>
+		void ReadsComponents()
+		{
+			ReadsComponents(T::GetStaticComponentTypeData());
+		}
+
+		template <class T>
+		void WritesComponents()
+		{
+			WritesComponents(T::GetStaticComponentTypeData());
+		}
+
+		void ReadsComponents(const Components::TypeData &rTypeData)
+		{
+			m_ReadComponents.Push(&rTypeData);
+			m_DeclaresComponentAccess = true;
+		}
+
+		void WritesComponents(const Components::TypeData &rTypeData)
+		{
+			m_WriteComponents.Push(&rTypeData);
+			m_DeclaresComponentAccess = true;
+		}
+
+		// Returns true if this task and the given task could not safely run at the same time
+		bool ConflictsWith(const TaskContract &rOther) const;
+
 		// Every requirement to be before or after another dependency goes here
 		DynamicArray<OrderRequirement> m_OrderRequirements;
 
 		// All dependencies we contribute to fulfilling
 		DynamicArray<const TaskDefinition *> m_ContributedDependencies;
 
+		// Component types this task reads and writes (only meaningful if m_DeclaresComponentAccess is set)
+		DynamicArray<const Components::TypeData *> m_ReadComponents;
+		DynamicArray<const Components::TypeData *> m_WriteComponents;
+
 		TickType m_TickType;
+		TaskCadence m_Cadence;
+		bool m_DeclaresComponentAccess;
 	};
 
 	class World;
@@ -187,17 +277,37 @@ namespace Helium
 	{
 		A_TaskDefinitionPtr m_ScheduleInfo;
 		DynamicArray<TaskFunc> m_ScheduleFunc; // Compact version of our schedule
+
+		// Dependency graph over m_ScheduleFunc used for parallel execution. For each scheduled task we keep the
+		// number of scheduled tasks that must finish before it may start, and the indices of the tasks that wait on it.
+		// Edges come from the order requirements plus any pair of unordered tasks with conflicting component access.
+		DynamicArray<uint32_t> m_PredecessorCounts;
+		DynamicArray< DynamicArray<uint32_t> > m_Successors;
+
+		// SchedulePhase of each scheduled task
+		DynamicArray<uint8_t> m_Phases;
 	};
 
 	class HELIUM_FRAMEWORK_API TaskScheduler
 	{
 	public:
 		static bool CalculateSchedule( uint32_t tickType, TaskSchedule &schedule );
-		static void ExecuteSchedule( const TaskSchedule &schedule, DynamicArray< WorldPtr > &rWorlds );
+		// Runs the tasks in the given SchedulePhases, in dependency order
+		static void ExecuteSchedule( const TaskSchedule &schedule, DynamicArray< WorldPtr > &rWorlds, uint32_t phases = SchedulePhases::All );
+		static void ExecuteScheduleSerial( const TaskSchedule &schedule, DynamicArray< WorldPtr > &rWorlds, uint32_t phases = SchedulePhases::All );
+		static void ExecuteScheduleParallel( const TaskSchedule &schedule, DynamicArray< WorldPtr > &rWorlds, uint32_t phases = SchedulePhases::All );
+		// Runs the schedule as one job per world so independent worlds update on separate threads. Tasks that declare
+		// their component access run inside the world jobs, each seeing a list holding only its world. Tasks that don't
+		// run alone on the calling thread over every world, between the jobs. rWorldLists is scratch space kept by the
+		// caller to avoid rebuilding the single world lists every frame.
+		static void ExecuteSchedulePerWorld( const TaskSchedule &schedule, DynamicArray< WorldPtr > &rWorlds, DynamicArray< DynamicArray< WorldPtr > > &rWorldLists, uint32_t phases = SchedulePhases::All );
 
 		static void ResetContracts();
 
 		static bool m_ContractsDefined;
+
+		// If set (and the JobManager is running), ExecuteSchedule() dispatches independent tasks concurrently
+		static bool m_ParallelExecution;
 	};
 
 	namespace StandardDependencies
@@ -242,10 +352,10 @@ namespace Helium
 	template < void (*Fn)(World *) >
 	void ForEachWorld(DynamicArray< WorldPtr > &rWorlds)
 	{
-		for (DynamicArray< WorldPtr >::Iterator iter = rWorlds.Begin();
-			iter != rWorlds.End(); ++iter)
+		for (size_t worldIndex = 0; worldIndex < rWorlds.GetSize(); ++worldIndex)
 		{
-			Fn( iter->Get() );
+			FrameProfiler::Scope profileScope( ProfileEventTypes::World, NULL, static_cast< uint32_t >( worldIndex ) );
+			Fn( rWorlds[ worldIndex ].Get() );
 		}
 	}
 }
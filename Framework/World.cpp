@@ -1,12 +1,16 @@
 #include "FrameworkPch.h"
 #include "Framework/World.h"
 
+#include "Platform/Atomic.h"
 #include "Rendering/Renderer.h"
 #include "Rendering/RSurface.h"
 #include "Framework/EntityDefinition.h"
 #include "Framework/Slice.h"
 #include "Framework/Entity.h"
 #include "Framework/SceneDefinition.h"
+#include "Framework/WorldSnapshot.h"
+
+#include <algorithm>
 
 namespace Helium
 {
@@ -19,8 +23,27 @@ using namespace Helium;
 
 HELIUM_DEFINE_CLASS( Helium::World );
 
+namespace
+{
+	// Index in its world of the slice an entity belongs to, entities no longer in a slice sort last
+	size_t GetDeferredDestroySliceIndex( const Entity* pEntity )
+	{
+		const Slice* pSlice = pEntity->GetSlice().Get();
+		return pSlice ? pSlice->GetWorldIndex() : Invalid< size_t >();
+	}
+
+	struct DeferredDestroySliceLess
+	{
+		bool operator()( const Entity* pLeft, const Entity* pRight ) const
+		{
+			return GetDeferredDestroySliceIndex( pLeft ) < GetDeferredDestroySliceIndex( pRight );
+		}
+	};
+}
+
 /// Constructor.
 World::World()
+	: m_pDeferredDestroyHead( NULL )
 {
 }
 
@@ -52,6 +75,8 @@ bool World::Initialize()
 
 	AddSlice(m_RootSlice);
 
+	m_SliceStreamer.Initialize( this );
+
 	return true;
 }
 
@@ -60,6 +85,12 @@ bool World::Initialize()
 /// @see Initialize()
 void World::Cleanup()
 {
+	// Release anything still waiting to be destroyed, the queue holds references to the entities.
+	DestroyDeferredEntities();
+
+	// Unload streamed slices while their entities can still find this world.
+	m_SliceStreamer.Cleanup();
+
 	// Remove all slices first.
 	while( !m_Slices.IsEmpty() )
 	{
@@ -73,6 +104,211 @@ void World::Cleanup()
 	m_Components.ReleaseAll();
 }
 
+/// Add an entity to the queue of entities to destroy at the end of the frame.
+///
+/// This is lock-free and can be called from any thread.  Entities should be queued through Entity::DeferredDestroy(),
+/// which makes sure each entity is only queued once.
+///
+/// @param[in] pEntity  Entity to queue.
+///
+/// @see DestroyDeferredEntities()
+void World::EnqueueDeferredDestroy( Entity* pEntity )
+{
+	HELIUM_ASSERT( pEntity );
+	HELIUM_ASSERT( !pEntity->m_spDeferredDestroyReference );
+
+	pEntity->m_spDeferredDestroyReference = pEntity;
+
+	Entity* pHead;
+	do
+	{
+		pHead = m_pDeferredDestroyHead;
+		pEntity->m_pNextDeferredDestroy = pHead;
+	} while( AtomicCompareExchangeRelease( m_pDeferredDestroyHead, pEntity, pHead ) != pHead );
+}
+
+/// Destroy every entity queued by EnqueueDeferredDestroy().
+///
+/// The cost of this is proportional to the number of queued entities rather than the number of live entities.  This
+/// must not run concurrently with anything else that accesses this world's slices or components.
+///
+/// @return  Number of entities destroyed.
+///
+/// @see EnqueueDeferredDestroy()
+size_t World::DestroyDeferredEntities()
+{
+	// Take the whole queue at once, entities queued from here on are picked up on the next call.
+	Entity* pEntity = AtomicExchangeAcquire( m_pDeferredDestroyHead, static_cast< Entity* >( NULL ) );
+	if( !pEntity )
+	{
+		return 0;
+	}
+
+	HELIUM_ASSERT( m_DeferredDestroyEntities.IsEmpty() );
+	for( ; pEntity; pEntity = pEntity->m_pNextDeferredDestroy )
+	{
+		m_DeferredDestroyEntities.Push( pEntity );
+	}
+
+	// Group the entities by slice, then destroy each group with one call so each slice can free its entities'
+	// components in bulk.  Entities already removed from their slice since they were queued sort to the end and are
+	// skipped.
+	Entity** ppEntities = m_DeferredDestroyEntities.GetData();
+	size_t entityCount = m_DeferredDestroyEntities.GetSize();
+	std::sort( ppEntities, ppEntities + entityCount, DeferredDestroySliceLess() );
+
+	size_t destroyedCount = 0;
+	for( size_t groupStart = 0; groupStart < entityCount; )
+	{
+		Slice* pSlice = ppEntities[ groupStart ]->GetSlice().Get();
+		if( !pSlice )
+		{
+			break;
+		}
+
+		HELIUM_ASSERT( pSlice->GetWorld() == this );
+
+		size_t groupEnd = groupStart + 1;
+		while( groupEnd < entityCount && ppEntities[ groupEnd ]->GetSlice().Get() == pSlice )
+		{
+			++groupEnd;
+		}
+
+		destroyedCount += pSlice->DestroyEntities( ppEntities + groupStart, groupEnd - groupStart );
+		groupStart = groupEnd;
+	}
+
+	// Drop the queue's references last, this is where most of the entities are actually freed.
+	for( DynamicArray< Entity* >::Iterator iter = m_DeferredDestroyEntities.Begin();
+		iter != m_DeferredDestroyEntities.End(); ++iter )
+	{
+		Entity* pQueuedEntity = *iter;
+		pQueuedEntity->m_pNextDeferredDestroy = NULL;
+		pQueuedEntity->m_spDeferredDestroyReference.Release();
+	}
+
+	m_DeferredDestroyEntities.Resize( 0 );
+
+	return destroyedCount;
+}
+
+/// Capture the values of every component in this world.
+///
+/// This must not run concurrently with anything that modifies this world's components.
+///
+/// @param[out] rSnapshot  Snapshot to fill, replacing anything it held.
+/// @param[in]  pBase      Earlier full snapshot of this world to only store the changes against, or null to capture
+///                        everything.
+///
+/// @return  True if the snapshot was taken, false if this world is not initialized.
+///
+/// @see Restore()
+bool World::Snapshot( WorldSnapshot& rSnapshot, const WorldSnapshot* pBase )
+{
+	ComponentManager* pComponentManager = GetComponentManager();
+	if( !pComponentManager )
+	{
+		HELIUM_TRACE( TraceLevels::Error, TXT( "World::Snapshot(): World is not initialized.\n" ) );
+		rSnapshot.Clear();
+
+		return false;
+	}
+
+	rSnapshot.Capture( *pComponentManager, pBase );
+
+	return true;
+}
+
+/// Write the component values captured by Snapshot() back into this world.
+///
+/// Only components that still exist are restored, components and entities created or destroyed since the snapshot
+/// are left as they are.  This must not run concurrently with anything that accesses this world's components.
+///
+/// @param[in] rSnapshot  Snapshot of this world.
+/// @param[in] pBase      Full snapshot that rSnapshot was taken against, if it is a delta.
+///
+/// @return  True if every captured component was restored, false if not.
+///
+/// @see Snapshot()
+bool World::Restore( const WorldSnapshot& rSnapshot, const WorldSnapshot* pBase )
+{
+	ComponentManager* pComponentManager = GetComponentManager();
+	if( !pComponentManager )
+	{
+		HELIUM_TRACE( TraceLevels::Error, TXT( "World::Restore(): World is not initialized.\n" ) );
+
+		return false;
+	}
+
+	return rSnapshot.Apply( *pComponentManager, pBase );
+}
+
+// First component in the collection implementing each type, false if any type is missing
+static bool GetTaggedTuple( ComponentCollection &rCollection, const Components::TypeId *types, size_t typesCount, Component **tuple )
+{
+	for ( size_t typeIndex = 0; typeIndex < typesCount; ++typeIndex )
+	{
+		tuple[ typeIndex ] = NULL;
+
+		const DynamicArray< Components::TypeId > &rImplementingTypes = Components::GetTypeData( types[ typeIndex ] )->m_ImplementingTypes;
+		for ( DynamicArray< Components::TypeId >::ConstIterator iter = rImplementingTypes.Begin();
+			iter != rImplementingTypes.End() && !tuple[ typeIndex ]; ++iter)
+		{
+			tuple[ typeIndex ] = rCollection.GetFirst( *iter );
+		}
+
+		if ( !tuple[ typeIndex ] )
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void Helium::QueryTaggedComponentTuplesInternal( World *pWorld, const Tags::TagFilter &filter, const Components::TypeId *types, size_t typesCount, TaggedTupleCallback callback, void *pData )
+{
+	HELIUM_ASSERT( pWorld );
+	HELIUM_ASSERT( typesCount > 0 && typesCount <= ComponentQuery::MAX_TYPES );
+
+	FrameProfiler::Scope profileScope( ProfileEventTypes::Query, Components::GetTypeData( types[0] )->m_Structure->m_Name );
+	uint32_t tupleCount = 0;
+
+	Component *tuple[ ComponentQuery::MAX_TYPES ];
+	DynamicArray< Tags::TagWord > mask;
+
+	for ( size_t sliceIndex = 0; sliceIndex < pWorld->GetSliceCount(); ++sliceIndex )
+	{
+		Slice *pSlice = pWorld->GetSlice( sliceIndex );
+		HELIUM_ASSERT( pSlice );
+
+		pSlice->GetTagColumns().BuildMask( filter, pSlice->GetEntityCount(), mask );
+
+		for ( size_t word = 0; word < mask.GetSize(); ++word )
+		{
+			Tags::TagWord bits = mask[ word ];
+			for ( size_t bit = 0; bits; ++bit, bits >>= 1 )
+			{
+				if ( !( bits & 1 ) )
+				{
+					continue;
+				}
+
+				Entity *pEntity = pSlice->GetEntity( word * Tags::TAG_WORD_BITS + bit );
+				HELIUM_ASSERT( pEntity );
+
+				if ( GetTaggedTuple( pEntity->GetComponents(), types, typesCount, tuple ) )
+				{
+					callback( tuple, pData );
+					++tupleCount;
+				}
+			}
+		}
+	}
+
+	profileScope.SetCount( tupleCount );
+}
+
 ComponentCollection& Helium::World::VirtualGetComponents()
 {
 	return m_Components;
@@ -1,12 +1,16 @@
 #pragma once
 
 #include "Framework/ComponentQuery.h"
+#include "Framework/EntityTags.h"
+#include "Framework/FrameProfiler.h"
 #include "Framework/Framework.h"
+#include "Framework/SliceStreamer.h"
 
 namespace Helium
 {
 	class Entity;
 	class EntityDefinition;
+	class WorldSnapshot;
 	
 	class Slice;
 	typedef Helium::StrongPtr< Slice > SlicePtr;
@@ -64,6 +68,23 @@ namespace Helium
 		Slice* GetSlice( size_t index ) const;
 		//@}
 
+		/// @name Deferred Entity Destruction
+		//@{
+		void EnqueueDeferredDestroy( Entity* pEntity );
+		size_t DestroyDeferredEntities();
+		//@}
+
+		/// @name Slice Streaming
+		//@{
+		inline SliceStreamer& GetSliceStreamer();
+		//@}
+
+		/// @name Snapshots
+		//@{
+		bool Snapshot( WorldSnapshot& rSnapshot, const WorldSnapshot* pBase = NULL );
+		bool Restore( const WorldSnapshot& rSnapshot, const WorldSnapshot* pBase = NULL );
+		//@}
+
 	public:
 		// TEMPORARY!
 		ComponentManagerPtr m_ComponentManager;
@@ -77,6 +98,14 @@ namespace Helium
 		/// Active slices.
 		DynamicArray< SlicePtr > m_Slices;
 		SlicePtr m_RootSlice;
+
+		/// Head of the lock-free list of entities waiting for deferred destruction.
+		Entity* volatile m_pDeferredDestroyHead;
+		/// Entities being destroyed by DestroyDeferredEntities() (kept to avoid reallocating every frame).
+		DynamicArray< Entity* > m_DeferredDestroyEntities;
+
+		/// Streams slices in and out of this world.
+		SliceStreamer m_SliceStreamer;
 	};
 
 	typedef Helium::StrongPtr< World > WorldPtr;
@@ -93,31 +122,208 @@ namespace Helium
 		}
 	}
 
+	// Context is looked up once by the caller (usually once per world) and passed to every call of F
+	template <class A, class Context, void (*F)(Context &, A *)>
+	inline void QueryComponents( World *pWorld, Context &rContext )
+	{ 
+		ComponentManager *pComponentManager = pWorld->GetComponentManager();
+		HELIUM_ASSERT( pComponentManager );
+		for (ImplementingComponentIterator<A> iter( *pComponentManager ); iter.GetBaseComponent(); iter.Advance())
+		{
+			F( rContext, *iter );
+		}
+	}
+
+	// Wraps a tuple handler to count the tuples a query visits for the FrameProfiler
+	template <class Handler>
+	struct CountingTupleHandler
+	{
+		explicit CountingTupleHandler( const Handler &rHandler ) : m_Handler( rHandler ), m_Count( 0 ) { }
+
+		inline void operator()( Component * const *tuple )
+		{
+			++m_Count;
+			m_Handler( tuple );
+		}
+
+		Handler m_Handler;
+		uint32_t m_Count;
+	};
+
+	// Handler is copied from rHandler, the Handler type doubles as the query's call site
+	template <class Handler>
+	inline void QueryComponentTuples( World *pWorld, const Components::TypeId *types, size_t typesCount, const Handler &rHandler )
+	{
+		ComponentManager *pComponentManager = pWorld->GetComponentManager();
+		HELIUM_ASSERT( pComponentManager );
+
+		if ( FrameProfiler::IsEnabled() )
+		{
+			FrameProfiler::Scope profileScope( ProfileEventTypes::Query, Components::GetTypeData( types[0] )->m_Structure->m_Name );
+
+			CountingTupleHandler< Handler > handler( rHandler );
+			ForEachComponentTuple< Handler >( *pComponentManager, types, typesCount, handler );
+			profileScope.SetCount( handler.m_Count );
+		}
+		else
+		{
+			Handler handler( rHandler );
+			ForEachComponentTuple< Handler >( *pComponentManager, types, typesCount, handler );
+		}
+	}
+
+	template <class Handler>
+	inline void QueryComponentTuples( World *pWorld, const Components::TypeId *types, size_t typesCount )
+	{
+		QueryComponentTuples( pWorld, types, typesCount, Handler() );
+	}
+
 	template <class A, class B, void (*F)(A *, B *)>
 	inline void QueryComponents( World *pWorld )
 	{
-		static Components::TypeId types[] = {
+		Components::TypeId types[] = {
 			Components::GetType<A>(),
 			Components::GetType<B>()
 		};
 
-		ComponentManager *pComponentManager = pWorld->GetComponentManager();
-		HELIUM_ASSERT( pComponentManager );
-		QueryComponentsInternal( *pComponentManager, types, HELIUM_ARRAY_COUNT(types), TupleHandler<A, B, F> );
+		QueryComponentTuples< ComponentTupleHandler2<A, B, F> >( pWorld, types, HELIUM_ARRAY_COUNT(types) );
+	}
+
+	template <class A, class B, class Context, void (*F)(Context &, A *, B *)>
+	inline void QueryComponents( World *pWorld, Context &rContext )
+	{
+		Components::TypeId types[] = {
+			Components::GetType<A>(),
+			Components::GetType<B>()
+		};
+
+		QueryComponentTuples( pWorld, types, HELIUM_ARRAY_COUNT(types), ComponentTupleContextHandler2<A, B, Context, F>( rContext ) );
 	}
 	
 	template <class A, class B, class C, void (*F)(A *, B *, C *)>
 	inline void QueryComponents( World *pWorld )
 	{
-		static Components::TypeId types[] = {
+		Components::TypeId types[] = {
 			Components::GetType<A>(),
 			Components::GetType<B>(),
 			Components::GetType<C>()
 		};
 
+		QueryComponentTuples< ComponentTupleHandler3<A, B, C, F> >( pWorld, types, HELIUM_ARRAY_COUNT(types) );
+	}
+
+	template <class A, class B, class C, class D, void (*F)(A *, B *, C *, D *)>
+	inline void QueryComponents( World *pWorld )
+	{
+		Components::TypeId types[] = {
+			Components::GetType<A>(),
+			Components::GetType<B>(),
+			Components::GetType<C>(),
+			Components::GetType<D>()
+		};
+
+		QueryComponentTuples< ComponentTupleHandler4<A, B, C, D, F> >( pWorld, types, HELIUM_ARRAY_COUNT(types) );
+	}
+
+	typedef void (*TaggedTupleCallback)( Component * const *tuple, void *pData );
+
+	// Calls callback once for every entity in the world whose tags pass the filter and that has a component implementing
+	// each of the types, with the first such component of each type. Tags are filtered a word of entities at a time
+	// before any component is looked at.
+	void HELIUM_FRAMEWORK_API QueryTaggedComponentTuplesInternal( World *pWorld, const Tags::TagFilter &filter, const Components::TypeId *types, size_t typesCount, TaggedTupleCallback callback, void *pData );
+
+	// Only visits components owned by entities, an empty filter falls back to the unfiltered archetype query
+	template <class Handler>
+	inline void QueryComponentTuples( World *pWorld, const Tags::TagFilter &filter, const Components::TypeId *types, size_t typesCount )
+	{
+		if ( filter.IsEmpty() )
+		{
+			QueryComponentTuples< Handler >( pWorld, types, typesCount );
+			return;
+		}
+
+		Handler handler;
+		QueryTaggedComponentTuplesInternal( pWorld, filter, types, typesCount, InvokeTupleHandler< Handler >, &handler );
+	}
+
+	template <class A, void (*F)(A *)>
+	inline void QueryComponents( World *pWorld, const Tags::TagFilter &filter )
+	{
+		Components::TypeId types[] = {
+			Components::GetType<A>()
+		};
+
+		QueryComponentTuples< ComponentTupleHandler1<A, F> >( pWorld, filter, types, HELIUM_ARRAY_COUNT(types) );
+	}
+
+	template <class A, class B, void (*F)(A *, B *)>
+	inline void QueryComponents( World *pWorld, const Tags::TagFilter &filter )
+	{
+		Components::TypeId types[] = {
+			Components::GetType<A>(),
+			Components::GetType<B>()
+		};
+
+		QueryComponentTuples< ComponentTupleHandler2<A, B, F> >( pWorld, filter, types, HELIUM_ARRAY_COUNT(types) );
+	}
+
+	template <class A, class B, class C, void (*F)(A *, B *, C *)>
+	inline void QueryComponents( World *pWorld, const Tags::TagFilter &filter )
+	{
+		Components::TypeId types[] = {
+			Components::GetType<A>(),
+			Components::GetType<B>(),
+			Components::GetType<C>()
+		};
+
+		QueryComponentTuples< ComponentTupleHandler3<A, B, C, F> >( pWorld, filter, types, HELIUM_ARRAY_COUNT(types) );
+	}
+
+	template <class A, class B, class C, class D, void (*F)(A *, B *, C *, D *)>
+	inline void QueryComponents( World *pWorld, const Tags::TagFilter &filter )
+	{
+		Components::TypeId types[] = {
+			Components::GetType<A>(),
+			Components::GetType<B>(),
+			Components::GetType<C>(),
+			Components::GetType<D>()
+		};
+
+		QueryComponentTuples< ComponentTupleHandler4<A, B, C, D, F> >( pWorld, filter, types, HELIUM_ARRAY_COUNT(types) );
+	}
+
+	// F is run in parallel, it must only touch its own component (and its own entity) and must make structural changes
+	// (allocating or freeing components) through the command buffer
+	template <class T, void (*F)(T *, ComponentCommandBuffer &)>
+	inline void ParallelForEachComponent( World *pWorld )
+	{
 		ComponentManager *pComponentManager = pWorld->GetComponentManager();
 		HELIUM_ASSERT( pComponentManager );
-		QueryComponentsInternal( *pComponentManager, types, HELIUM_ARRAY_COUNT(types), TupleHandler<A, B, C, F> );
+
+		FrameProfiler::Scope profileScope( ProfileEventTypes::Query, Components::GetTypeData( Components::GetType<T>() )->m_Structure->m_Name );
+		if ( FrameProfiler::IsEnabled() )
+		{
+			profileScope.SetCount( static_cast< uint32_t >( pComponentManager->CountAllocatedComponentsThatImplement( Components::GetType<T>() ) ) );
+		}
+
+		ParallelForEachComponentInternal( *pComponentManager, Components::GetType<T>(), ComponentRangeHandler<T, F>, NULL );
+	}
+
+	// Same as above with a context shared by every call of F, F may be called from several threads at once so it must
+	// only read the context
+	template <class T, class Context, void (*F)(Context &, T *, ComponentCommandBuffer &)>
+	inline void ParallelForEachComponent( World *pWorld, Context &rContext )
+	{
+		ComponentManager *pComponentManager = pWorld->GetComponentManager();
+		HELIUM_ASSERT( pComponentManager );
+
+		FrameProfiler::Scope profileScope( ProfileEventTypes::Query, Components::GetTypeData( Components::GetType<T>() )->m_Structure->m_Name );
+		if ( FrameProfiler::IsEnabled() )
+		{
+			profileScope.SetCount( static_cast< uint32_t >( pComponentManager->CountAllocatedComponentsThatImplement( Components::GetType<T>() ) ) );
+		}
+
+		ParallelForEachComponentInternal( *pComponentManager, Components::GetType<T>(), ComponentRangeContextHandler<T, Context, F>, &rContext );
 	}
 }
 
@@ -19,4 +19,12 @@ namespace Helium
     {
         return m_Slices.GetSize();
     }
+
+    /// Get the streamer that loads and unloads slices around points of interest in this world.
+    ///
+    /// @return  Slice streamer.
+    SliceStreamer& World::GetSliceStreamer()
+    {
+        return m_SliceStreamer;
+    }
 }
@@ -7,6 +7,7 @@
 #include "Framework/Entity.h"
 #include "Framework/SceneDefinition.h"
 #include "Framework/TaskScheduler.h"
+#include "Framework/FrameProfiler.h"
 
 using namespace Helium;
 
@@ -19,6 +20,14 @@ WorldManager::WorldManager()
 , m_frameTickCount( 0 )
 , m_frameDeltaTickCount( 0 )
 , m_frameDeltaSeconds( 0.0f )
+, m_fixedStepSeconds( 0.0f )
+, m_fixedStepTickCount( 0 )
+, m_maxFixedStepsPerFrame( 0 )
+, m_fixedStepAccumulatedTicks( 0 )
+, m_fixedStepsThisFrame( 0 )
+, m_fixedStepCount( 0 )
+, m_interpolationAlpha( 1.0f )
+, m_bParallelWorldUpdate( false )
 , m_bProcessedFirstFrame( false )
 {
 }
@@ -84,6 +93,9 @@ void WorldManager::Cleanup()
 	}
 
 	m_worlds.Clear();
+	m_worldJobLists.Clear();
+
+	FrameProfiler::Shutdown();
 }
 
 /// Get the path to the package containing all world instances.
@@ -168,6 +180,10 @@ bool WorldManager::ReleaseWorld( World* pWorld )
 		if ( m_worlds.GetElement(i).Get() == pWorld )
 		{
 			m_worlds.Remove(i);
+			if ( i < m_worldJobLists.GetSize() )
+			{
+				m_worldJobLists.Remove(i);
+			}
 			return true;
 		}
 	}
@@ -176,34 +192,139 @@ bool WorldManager::ReleaseWorld( World* pWorld )
 }
 
 /// Update all worlds for the current frame.
+///
+/// With a fixed time step, fixed cadence tasks run once for every whole step of time accumulated since the previous
+/// frame (and see the step length as the frame delta) while the remaining tasks run once.
+///
+/// @see SetFixedTimeStep()
 void WorldManager::Update( TaskSchedule &schedule )
 {
+	FrameProfiler::BeginFrame();
+
 	// Update the world time.
 	UpdateTime();
-	
-	Helium::TaskScheduler::ExecuteSchedule( schedule, m_worlds );
-	
-	Components::Tick();
-
-	// TODO: I plan to do a "flag system" - components that are super lightweight.. like bitflags.. that carry no data
-	// but mark an object. This data would be kept parallel with slices/worlds so that they would be far faster to query
-	// than this abomination
+
+	if( !IsFixedTimeStepEnabled() )
+	{
+		ExecuteSchedule( schedule, SchedulePhases::All );
+		DestroyDeferredEntities();
+		UpdateSliceStreaming();
+
+		FrameProfiler::EndFrame();
+		return;
+	}
+
+	ExecuteSchedule( schedule, SchedulePhases::PreSimulation );
+
+	// Run as many simulation steps as there is time for, dropping time rather than letting a slow frame make the next
+	// one slower still.
+	float32_t frameDeltaSeconds = m_frameDeltaSeconds;
+	m_frameDeltaSeconds = m_fixedStepSeconds;
+
+	m_fixedStepAccumulatedTicks += m_frameDeltaTickCount;
+	m_fixedStepsThisFrame = 0;
+	while( m_fixedStepAccumulatedTicks >= m_fixedStepTickCount && m_fixedStepsThisFrame < m_maxFixedStepsPerFrame )
+	{
+		ExecuteSchedule( schedule, SchedulePhases::Simulation );
+		DestroyDeferredEntities();
+
+		m_fixedStepAccumulatedTicks -= m_fixedStepTickCount;
+		++m_fixedStepsThisFrame;
+		++m_fixedStepCount;
+	}
+
+	if( m_fixedStepAccumulatedTicks >= m_fixedStepTickCount )
+	{
+		m_fixedStepAccumulatedTicks %= m_fixedStepTickCount;
+	}
+
+	m_frameDeltaSeconds = frameDeltaSeconds;
+	m_interpolationAlpha = static_cast< float32_t >(
+		static_cast< float64_t >( m_fixedStepAccumulatedTicks ) / static_cast< float64_t >( m_fixedStepTickCount ) );
+
+	ExecuteSchedule( schedule, SchedulePhases::PostSimulation );
+	DestroyDeferredEntities();
+	UpdateSliceStreaming();
+
+	FrameProfiler::EndFrame();
+}
+
+/// Step fixed cadence tasks at a fixed rate rather than once per frame.
+///
+/// @param[in] stepSeconds       Seconds per simulation step, or zero to run every task once per frame.
+/// @param[in] maxStepsPerFrame  Most simulation steps to run in a single frame.  Time beyond this is dropped, so a
+///                              slow frame slows the simulation down instead of costing even more time next frame.
+///
+/// @see IsFixedTimeStepEnabled(), GetInterpolationAlpha(), TaskContract::SetCadence()
+void WorldManager::SetFixedTimeStep( float32_t stepSeconds, uint32_t maxStepsPerFrame )
+{
+	HELIUM_ASSERT( stepSeconds >= 0.0f );
+	HELIUM_ASSERT( maxStepsPerFrame > 0 || stepSeconds == 0.0f );
+
+	m_fixedStepTickCount = stepSeconds > 0.0f
+		? Max< uint64_t >( static_cast< uint64_t >( static_cast< float64_t >( stepSeconds ) * static_cast< float64_t >( Timer::GetTicksPerSecond() ) ), 1 )
+		: 0;
+	m_fixedStepSeconds = m_fixedStepTickCount
+		? static_cast< float32_t >( static_cast< float64_t >( m_fixedStepTickCount ) * Timer::GetSecondsPerTick() )
+		: 0.0f;
+	m_maxFixedStepsPerFrame = maxStepsPerFrame;
+	m_fixedStepAccumulatedTicks = 0;
+	m_fixedStepsThisFrame = 0;
+	m_fixedStepCount = 0;
+	m_interpolationAlpha = m_fixedStepTickCount ? 0.0f : 1.0f;
+}
+
+/// Update each world with its own job rather than having every task update each world in turn.
+///
+/// Worlds then only wait on each other for tasks that do not declare their component access, since those run alone
+/// on the updating thread.  Tasks that do must only touch the world they are given (and state owned by it), as other
+/// worlds are being updated at the same time.
+///
+/// @param[in] bEnabled  True to update worlds in parallel.
+///
+/// @see IsParallelWorldUpdateEnabled(), TaskScheduler::ExecuteSchedulePerWorld()
+void WorldManager::SetParallelWorldUpdate( bool bEnabled )
+{
+	m_bParallelWorldUpdate = bEnabled;
+	if ( !bEnabled )
+	{
+		m_worldJobLists.Clear();
+	}
+}
+
+/// Run the tasks of the given schedule phases over every world.
+///
+/// @param[in] schedule  Schedule to run.
+/// @param[in] phases    SchedulePhases to run.
+void WorldManager::ExecuteSchedule( TaskSchedule &schedule, uint32_t phases )
+{
+	if ( m_bParallelWorldUpdate )
+	{
+		Helium::TaskScheduler::ExecuteSchedulePerWorld( schedule, m_worlds, m_worldJobLists, phases );
+	}
+	else
+	{
+		Helium::TaskScheduler::ExecuteSchedule( schedule, m_worlds, phases );
+	}
+}
+
+/// Destroy the entities queued for destruction in every world.
+void WorldManager::DestroyDeferredEntities()
+{
 	for ( DynamicArray< WorldPtr >::Iterator worldIter = m_worlds.Begin(); worldIter != m_worlds.End(); ++worldIter )
 	{
-		for ( size_t sliceIndex = 0; sliceIndex < (*worldIter)->GetSliceCount(); ++sliceIndex )
-		{
-			Slice *pSlice = (*worldIter)->GetSlice( sliceIndex );
-			for ( size_t entityIndex = 0; entityIndex < pSlice->GetEntityCount(); ++entityIndex )
-			{
-				Entity *pEntity = pSlice->GetEntity( entityIndex );
+		(*worldIter)->DestroyDeferredEntities();
+	}
+}
 
-				if ( pEntity->IsDeferredDestroySet() )
-				{
-					// TODO: I don't like that strong pointers might be holding these references alive.. need to find a way to fix this
-					pSlice->DestroyEntity( pEntity );
-				}
-			}
-		}
+/// Stream slices in and out of every world within each world's streaming time budget.
+///
+/// @see SliceStreamer::Update()
+void WorldManager::UpdateSliceStreaming()
+{
+	for ( DynamicArray< WorldPtr >::Iterator worldIter = m_worlds.Begin(); worldIter != m_worlds.End(); ++worldIter )
+	{
+		(*worldIter)->GetSliceStreamer().Update();
 	}
 }
 
@@ -239,9 +360,9 @@ void WorldManager::Startup()
 /// @see Startup(), GetInstance()
 void WorldManager::Shutdown()
 {
-	if ( --sm_pInstance == 0 )
+	if ( --g_InitCount == 0 )
 	{
-		HELIUM_ASSERT( !sm_pInstance );
+		HELIUM_ASSERT( sm_pInstance );
 		sm_pInstance->Cleanup();
 		delete sm_pInstance;
 		sm_pInstance = NULL;
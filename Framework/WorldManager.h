@@ -45,6 +45,22 @@ namespace Helium
 		inline float32_t GetFrameDeltaSeconds() const;
 		//@}
 
+		/// @name Fixed Time Step
+		//@{
+		void SetFixedTimeStep( float32_t stepSeconds, uint32_t maxStepsPerFrame = 8 );
+		inline bool IsFixedTimeStepEnabled() const;
+		inline float32_t GetFixedTimeStep() const;
+		inline uint32_t GetFixedStepsThisFrame() const;
+		inline uint64_t GetFixedStepCount() const;
+		inline float32_t GetInterpolationAlpha() const;
+		//@}
+
+		/// @name Parallel World Update
+		//@{
+		void SetParallelWorldUpdate( bool bEnabled );
+		inline bool IsParallelWorldUpdateEnabled() const;
+		//@}
+
 		/// @name Static Access
 		//@{
 		static WorldManager* GetInstance();
@@ -67,6 +83,26 @@ namespace Helium
 		/// Seconds elapsed since the previous frame (adjusted for frame rate limits).
 		float32_t m_frameDeltaSeconds;
 
+		/// Seconds per fixed simulation step, or zero to run every task once per frame.
+		float32_t m_fixedStepSeconds;
+		/// Timer ticks per fixed simulation step.
+		uint64_t m_fixedStepTickCount;
+		/// Most simulation steps run in a single frame, time beyond this is dropped.
+		uint32_t m_maxFixedStepsPerFrame;
+		/// Timer ticks not yet consumed by a simulation step.
+		uint64_t m_fixedStepAccumulatedTicks;
+		/// Number of simulation steps run this frame.
+		uint32_t m_fixedStepsThisFrame;
+		/// Total number of simulation steps run.
+		uint64_t m_fixedStepCount;
+		/// Fraction of a simulation step left over this frame, for interpolating rendered state.
+		float32_t m_interpolationAlpha;
+
+		/// True if each world is updated by its own job.
+		bool m_bParallelWorldUpdate;
+		/// One list per world holding only that world, handed to tasks run by the world's job.
+		DynamicArray< DynamicArray< WorldPtr > > m_worldJobLists;
+
 		/// True if the first frame has been processed.
 		bool m_bProcessedFirstFrame;
 
@@ -83,6 +119,13 @@ namespace Helium
 		//@{
 		void UpdateTime();
 		//@}
+
+		/// @name Updating
+		//@{
+		void ExecuteSchedule( TaskSchedule &schedule, uint32_t phases );
+		void DestroyDeferredEntities();
+		void UpdateSliceStreaming();
+		//@}
 	};
 }
 
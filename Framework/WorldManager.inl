@@ -35,4 +35,66 @@ namespace Helium
     {
         return m_frameDeltaSeconds;
     }
+
+    /// Get whether the simulation is being stepped at a fixed rate.
+    ///
+    /// @return  True if fixed cadence tasks run at a fixed rate, false if every task runs once per frame.
+    ///
+    /// @see SetFixedTimeStep(), GetFixedTimeStep()
+    bool WorldManager::IsFixedTimeStepEnabled() const
+    {
+        return m_fixedStepTickCount != 0;
+    }
+
+    /// Get the length of a fixed simulation step.
+    ///
+    /// @return  Seconds per simulation step, or zero if the fixed time step is disabled.
+    ///
+    /// @see SetFixedTimeStep(), IsFixedTimeStepEnabled()
+    float32_t WorldManager::GetFixedTimeStep() const
+    {
+        return m_fixedStepSeconds;
+    }
+
+    /// Get the number of simulation steps run during the current frame.
+    ///
+    /// @return  Simulation steps this frame.
+    ///
+    /// @see GetFixedStepCount()
+    uint32_t WorldManager::GetFixedStepsThisFrame() const
+    {
+        return m_fixedStepsThisFrame;
+    }
+
+    /// Get the number of simulation steps run since the fixed time step was enabled.
+    ///
+    /// @return  Total simulation steps.
+    ///
+    /// @see GetFixedStepsThisFrame()
+    uint64_t WorldManager::GetFixedStepCount() const
+    {
+        return m_fixedStepCount;
+    }
+
+    /// Get how far the current frame is between the last simulation step and the next one.
+    ///
+    /// Rendering should interpolate between the previous and current simulated state by this amount.
+    ///
+    /// @return  Interpolation alpha in the range [0, 1), or one if the fixed time step is disabled.
+    ///
+    /// @see SetFixedTimeStep()
+    float32_t WorldManager::GetInterpolationAlpha() const
+    {
+        return m_interpolationAlpha;
+    }
+
+    /// Get whether worlds are updated in parallel, one job per world.
+    ///
+    /// @return  True if worlds are updated in parallel, false if every task updates each world in turn.
+    ///
+    /// @see SetParallelWorldUpdate()
+    bool WorldManager::IsParallelWorldUpdateEnabled() const
+    {
+        return m_bParallelWorldUpdate;
+    }
 }
\ No newline at end of file
@@ -0,0 +1,460 @@
+#include "FrameworkPch.h"
+#include "Framework/WorldSnapshot.h"
+
+#include "Platform/Atomic.h"
+#include "Reflect/Translator.h"
+#include "Reflect/TranslatorDeduction.h"
+
+using namespace Helium;
+using namespace Helium::Components;
+
+/// Last snapshot ID handed out.
+static volatile int32_t g_LastSnapshotId = 0;
+
+static bool IsPlainDataField( const Reflect::Field* pField );
+
+/// Get whether every field of a structure, including those of its bases, holds plain data.
+///
+/// @param[in] pStruct  Reflected structure.
+///
+/// @return  True if the structure can be captured and restored with a copy.
+static bool IsPlainDataStruct( const Reflect::MetaStruct* pStruct )
+{
+	for( ; pStruct; pStruct = pStruct->m_Base )
+	{
+		for( DynamicArray< Reflect::Field >::ConstIterator iter = pStruct->m_Fields.Begin();
+			iter != pStruct->m_Fields.End(); ++iter )
+		{
+			if( !IsPlainDataField( &*iter ) )
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+/// Get whether the bytes of a field are its whole value, so it can be captured and restored with a copy.
+///
+/// Strings, pointers and containers own memory elsewhere and are left out of snapshots, as are structures holding
+/// any of them.
+///
+/// @param[in] pField  Reflected field.
+///
+/// @return  True if the field holds plain data.
+static bool IsPlainDataField( const Reflect::Field* pField )
+{
+	const Reflect::Translator* pTranslator = pField->m_Translator;
+	if( !pTranslator )
+	{
+		return false;
+	}
+
+	switch( pTranslator->GetReflectionType() )
+	{
+	case Reflect::ReflectionTypes::ScalarTranslator:
+		return static_cast< const Reflect::ScalarTranslator* >( pTranslator )->m_Type != Reflect::ScalarTypes::String;
+
+	case Reflect::ReflectionTypes::EnumerationTranslator:
+		return true;
+
+	case Reflect::ReflectionTypes::StructureTranslator:
+		{
+			const Reflect::MetaStruct* pStruct =
+				static_cast< const Reflect::StructureTranslator* >( pTranslator )->GetMetaStruct();
+
+			return pStruct && IsPlainDataStruct( pStruct );
+		}
+
+	default:
+		return false;
+	}
+}
+
+/// Constructor.
+WorldSnapshot::WorldSnapshot()
+: m_id( 0 )
+, m_baseId( 0 )
+{
+}
+
+/// Release everything held by this snapshot.
+void WorldSnapshot::Clear()
+{
+	m_pools.Clear();
+	m_handles.Clear();
+	m_data.Clear();
+	m_id = 0;
+	m_baseId = 0;
+}
+
+/// Capture the component state of a world, replacing the current contents of this snapshot.
+///
+/// @param[in] rManager  Component manager of the world to capture.
+/// @param[in] pBase     Full snapshot of the same world to store only the changes against, or null to capture
+///                      everything.
+///
+/// @see Apply()
+void WorldSnapshot::Capture( ComponentManager& rManager, const WorldSnapshot* pBase )
+{
+	HELIUM_ASSERT( pBase != this );
+	HELIUM_ASSERT( !pBase || ( !pBase->IsEmpty() && !pBase->IsDelta() ) );
+	if( pBase && ( pBase == this || pBase->IsEmpty() || pBase->IsDelta() ) )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Warning,
+			TXT( "WorldSnapshot::Capture(): Base snapshot must be a full snapshot, capturing everything instead.\n" ) );
+		pBase = NULL;
+	}
+
+	m_pools.Resize( 0 );
+	m_handles.Resize( 0 );
+	m_data.Resize( 0 );
+	m_id = static_cast< uint32_t >( AtomicIncrement( g_LastSnapshotId ) );
+	m_baseId = pBase ? pBase->m_id : 0;
+
+	DynamicArray< FieldSpan > spans;
+
+	size_t typeCount = GetTypeCount();
+	for( size_t typeIndex = 0; typeIndex < typeCount; ++typeIndex )
+	{
+		TypeId typeId = static_cast< TypeId >( typeIndex );
+		const Pool* pPool = rManager.GetPool( typeId );
+		if( !pPool || !pPool->GetAllocatedCount() )
+		{
+			continue;
+		}
+
+		GetFieldSpans( *GetTypeData( typeId ), spans );
+		if( spans.IsEmpty() )
+		{
+			continue;
+		}
+
+		CapturePool( *pPool, spans, pBase );
+	}
+}
+
+/// Write the component state held by this snapshot back into a world.
+///
+/// @param[in] rManager  Component manager of the world the snapshot was captured from.
+/// @param[in] pBase     Snapshot this one is a delta against, if it is a delta.
+///
+/// @return  True if every captured component was restored, false if the base snapshot is missing or some components
+///          no longer exist.
+///
+/// @see Capture()
+bool WorldSnapshot::Apply( ComponentManager& rManager, const WorldSnapshot* pBase ) const
+{
+	if( IsDelta() && ( !pBase || pBase->m_id != m_baseId ) )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			TXT( "WorldSnapshot::Apply(): Snapshot %u is a delta against snapshot %u, which was not given.\n" ),
+			m_id,
+			m_baseId );
+
+		return false;
+	}
+
+	DynamicArray< FieldSpan > spans;
+	DynamicArray< uint8_t* > targets;
+	size_t missingCount = 0;
+
+	for( DynamicArray< PoolRecord >::ConstIterator iter = m_pools.Begin(); iter != m_pools.End(); ++iter )
+	{
+		const PoolRecord& rRecord = *iter;
+
+		GetFieldSpans( *GetTypeData( rRecord.m_TypeId ), spans );
+
+		if( rRecord.m_bDelta )
+		{
+			// Put back the base values first, the delta only holds the spans that changed since
+			const PoolRecord* pBaseRecord = pBase->FindPoolRecord( rRecord.m_TypeId );
+			HELIUM_ASSERT( pBaseRecord && !pBaseRecord->m_bDelta );
+			pBase->ApplyPool( rManager, *pBaseRecord, spans, targets );
+		}
+
+		missingCount += ApplyPool( rManager, rRecord, spans, targets );
+	}
+
+	if( missingCount )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Warning,
+			TXT( "WorldSnapshot::Apply(): %" ) PRIuSZ TXT( " components in snapshot %u no longer exist and were not restored.\n" ),
+			missingCount,
+			m_id );
+
+		return false;
+	}
+
+	return true;
+}
+
+/// Capture the components of one pool.
+///
+/// @param[in] rPool   Pool to capture.
+/// @param[in] rSpans  Plain data field spans of the pool's component type.
+/// @param[in] pBase   Full snapshot to store only the changes against, or null.
+void WorldSnapshot::CapturePool( const Pool& rPool, const DynamicArray< FieldSpan >& rSpans, const WorldSnapshot* pBase )
+{
+	const TypeData* pTypeData = GetTypeData( rPool.GetTypeId() );
+	HELIUM_ASSERT( pTypeData );
+
+	const uintptr_t componentOffset = pTypeData->GetOffsetOfComponent();
+	const uint32_t count = rPool.GetAllocatedCount();
+	Component* const* ppComponents = rPool.GetAllocatedComponents();
+
+	PoolRecord record;
+	record.m_TypeId = rPool.GetTypeId();
+	record.m_ComponentCount = count;
+	record.m_FirstHandle = m_handles.GetSize();
+	record.m_ColumnOffset = m_data.GetSize();
+	record.m_RowSize = 0;
+	for( DynamicArray< FieldSpan >::ConstIterator spanIter = rSpans.Begin(); spanIter != rSpans.End(); ++spanIter )
+	{
+		record.m_RowSize += spanIter->m_Size;
+	}
+
+	m_handles.Reserve( m_handles.GetSize() + count );
+	for( uint32_t componentIndex = 0; componentIndex < count; ++componentIndex )
+	{
+		m_handles.Push( rPool.GetHandle( ppComponents[ componentIndex ] ) );
+	}
+
+	// Only store changes if the base holds exactly the same components, otherwise the rows don't line up
+	const PoolRecord* pBaseRecord = pBase ? pBase->FindPoolRecord( record.m_TypeId ) : NULL;
+	record.m_bDelta =
+		pBaseRecord &&
+		!pBaseRecord->m_bDelta &&
+		pBaseRecord->m_ComponentCount == count &&
+		pBaseRecord->m_RowSize == record.m_RowSize &&
+		MemoryCompare(
+			pBase->m_handles.GetData() + pBaseRecord->m_FirstHandle,
+			m_handles.GetData() + record.m_FirstHandle,
+			count * sizeof( Handle ) ) == 0;
+
+	if( !record.m_bDelta )
+	{
+		m_data.Resize( record.m_ColumnOffset + count * record.m_RowSize );
+		uint8_t* pDest = m_data.GetData() + record.m_ColumnOffset;
+
+		for( DynamicArray< FieldSpan >::ConstIterator spanIter = rSpans.Begin(); spanIter != rSpans.End(); ++spanIter )
+		{
+			const uint32_t spanOffset = spanIter->m_Offset;
+			const uint32_t spanSize = spanIter->m_Size;
+
+			for( uint32_t componentIndex = 0; componentIndex < count; ++componentIndex )
+			{
+				const uint8_t* pSource = reinterpret_cast< const uint8_t* >( ppComponents[ componentIndex ] ) - componentOffset;
+				MemoryCopy( pDest, pSource + spanOffset, spanSize );
+				pDest += spanSize;
+			}
+		}
+	}
+	else
+	{
+		// Each column is a bit per component saying whether the span changed, followed by the changed values
+		const size_t maskSize = ( count + 7 ) / 8;
+		const uint8_t* pBaseColumn = pBase->m_data.GetData() + pBaseRecord->m_ColumnOffset;
+
+		for( DynamicArray< FieldSpan >::ConstIterator spanIter = rSpans.Begin(); spanIter != rSpans.End(); ++spanIter )
+		{
+			const uint32_t spanOffset = spanIter->m_Offset;
+			const uint32_t spanSize = spanIter->m_Size;
+
+			size_t columnStart = m_data.GetSize();
+			m_data.Resize( columnStart + maskSize + count * spanSize );
+
+			uint8_t* pMask = m_data.GetData() + columnStart;
+			uint8_t* pDest = pMask + maskSize;
+			MemorySet( pMask, 0, maskSize );
+
+			for( uint32_t componentIndex = 0; componentIndex < count; ++componentIndex )
+			{
+				const uint8_t* pSource = reinterpret_cast< const uint8_t* >( ppComponents[ componentIndex ] ) - componentOffset + spanOffset;
+				if( MemoryCompare( pSource, pBaseColumn, spanSize ) != 0 )
+				{
+					pMask[ componentIndex / 8 ] |= static_cast< uint8_t >( 1 << ( componentIndex % 8 ) );
+					MemoryCopy( pDest, pSource, spanSize );
+					pDest += spanSize;
+				}
+
+				pBaseColumn += spanSize;
+			}
+
+			m_data.Resize( static_cast< size_t >( pDest - m_data.GetData() ) );
+		}
+	}
+
+	m_pools.Push( record );
+}
+
+/// Restore the components of one pool.
+///
+/// @param[in] rManager  Component manager of the world being restored.
+/// @param[in] rRecord   Captured pool.
+/// @param[in] rSpans    Plain data field spans of the pool's component type.
+/// @param[in] rTargets  Scratch array for the resolved components.
+///
+/// @return  Number of captured components that no longer exist in the world.
+size_t WorldSnapshot::ApplyPool(
+	ComponentManager& rManager,
+	const PoolRecord& rRecord,
+	const DynamicArray< FieldSpan >& rSpans,
+	DynamicArray< uint8_t* >& rTargets ) const
+{
+	const TypeData* pTypeData = GetTypeData( rRecord.m_TypeId );
+	HELIUM_ASSERT( pTypeData );
+
+	const uintptr_t componentOffset = pTypeData->GetOffsetOfComponent();
+	const uint32_t count = rRecord.m_ComponentCount;
+	const Handle* pHandles = m_handles.GetData() + rRecord.m_FirstHandle;
+
+	// Resolve every handle once up front, components freed since the capture (or owned by another world) are skipped.
+	// The pool must also still hold exactly the captured type, as the spans are only valid for that layout.
+	size_t missingCount = 0;
+	rTargets.Resize( count );
+	for( uint32_t componentIndex = 0; componentIndex < count; ++componentIndex )
+	{
+		Component* pComponent = Pool::ResolveHandle( pHandles[ componentIndex ] );
+		if( pComponent &&
+			pComponent->GetComponentManager() == &rManager &&
+			Pool::GetPool( pComponent )->GetTypeId() == rRecord.m_TypeId )
+		{
+			rTargets[ componentIndex ] = reinterpret_cast< uint8_t* >( pComponent ) - componentOffset;
+		}
+		else
+		{
+			rTargets[ componentIndex ] = NULL;
+			++missingCount;
+		}
+	}
+
+	uint8_t* const* ppTargets = rTargets.GetData();
+	const uint8_t* pSource = m_data.GetData() + rRecord.m_ColumnOffset;
+
+	if( !rRecord.m_bDelta )
+	{
+		for( DynamicArray< FieldSpan >::ConstIterator spanIter = rSpans.Begin(); spanIter != rSpans.End(); ++spanIter )
+		{
+			const uint32_t spanOffset = spanIter->m_Offset;
+			const uint32_t spanSize = spanIter->m_Size;
+
+			for( uint32_t componentIndex = 0; componentIndex < count; ++componentIndex )
+			{
+				if( ppTargets[ componentIndex ] )
+				{
+					MemoryCopy( ppTargets[ componentIndex ] + spanOffset, pSource, spanSize );
+				}
+
+				pSource += spanSize;
+			}
+		}
+	}
+	else
+	{
+		const size_t maskSize = ( count + 7 ) / 8;
+
+		for( DynamicArray< FieldSpan >::ConstIterator spanIter = rSpans.Begin(); spanIter != rSpans.End(); ++spanIter )
+		{
+			const uint32_t spanOffset = spanIter->m_Offset;
+			const uint32_t spanSize = spanIter->m_Size;
+
+			const uint8_t* pMask = pSource;
+			pSource += maskSize;
+
+			for( uint32_t componentIndex = 0; componentIndex < count; ++componentIndex )
+			{
+				if( pMask[ componentIndex / 8 ] & ( 1 << ( componentIndex % 8 ) ) )
+				{
+					if( ppTargets[ componentIndex ] )
+					{
+						MemoryCopy( ppTargets[ componentIndex ] + spanOffset, pSource, spanSize );
+					}
+
+					pSource += spanSize;
+				}
+			}
+		}
+	}
+
+	return missingCount;
+}
+
+/// Find the captured state of a component pool.
+///
+/// @param[in] typeId  Component type of the pool.
+///
+/// @return  Captured pool, or null if no components of the type were captured.
+const WorldSnapshot::PoolRecord* WorldSnapshot::FindPoolRecord( TypeId typeId ) const
+{
+	// Pools are captured in type order
+	size_t low = 0;
+	size_t high = m_pools.GetSize();
+	while( low < high )
+	{
+		size_t middle = low + ( high - low ) / 2;
+		if( m_pools[ middle ].m_TypeId < typeId )
+		{
+			low = middle + 1;
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+
+	return ( low < m_pools.GetSize() && m_pools[ low ].m_TypeId == typeId ) ? &m_pools[ low ] : NULL;
+}
+
+/// Get the plain data fields of a component type as contiguous spans, so neighbouring fields are copied at once.
+///
+/// @param[in]  rTypeData  Component type.
+/// @param[out] rSpans     Field spans, sorted by offset.
+void WorldSnapshot::GetFieldSpans( const TypeData& rTypeData, DynamicArray< FieldSpan >& rSpans )
+{
+	rSpans.Resize( 0 );
+
+	for( const Reflect::MetaStruct* pCurrent = rTypeData.m_Structure; pCurrent; pCurrent = pCurrent->m_Base )
+	{
+		for( DynamicArray< Reflect::Field >::ConstIterator iter = pCurrent->m_Fields.Begin();
+			iter != pCurrent->m_Fields.End(); ++iter )
+		{
+			if( !IsPlainDataField( &*iter ) )
+			{
+				continue;
+			}
+
+			FieldSpan span;
+			span.m_Offset = static_cast< uint32_t >( iter->m_Offset );
+			span.m_Size = static_cast< uint32_t >( iter->m_Size * iter->m_Count );
+
+			size_t index = rSpans.GetSize();
+			while( index > 0 && rSpans[ index - 1 ].m_Offset > span.m_Offset )
+			{
+				--index;
+			}
+
+			rSpans.Insert( index, span );
+		}
+	}
+
+	// Merge fields that are back to back in memory
+	size_t mergedCount = 0;
+	for( size_t spanIndex = 0; spanIndex < rSpans.GetSize(); ++spanIndex )
+	{
+		if( mergedCount && rSpans[ mergedCount - 1 ].m_Offset + rSpans[ mergedCount - 1 ].m_Size == rSpans[ spanIndex ].m_Offset )
+		{
+			rSpans[ mergedCount - 1 ].m_Size += rSpans[ spanIndex ].m_Size;
+		}
+		else
+		{
+			rSpans[ mergedCount++ ] = rSpans[ spanIndex ];
+		}
+	}
+
+	rSpans.Resize( mergedCount );
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "Framework/Framework.h"
+#include "Framework/Components.h"
+
+#include "Foundation/DynamicArray.h"
+
+namespace Helium
+{
+	class World;
+
+	/// Binary capture of the component state of a world.
+	///
+	/// Snapshots are taken with World::Snapshot() and applied with World::Restore().  Every component pool is stored as
+	/// columns of raw field bytes: for each span of plain data fields (scalars, enumerations and structures, as laid out by
+	/// the component's Reflect::MetaStruct), the bytes of every allocated component in turn.  Fields that own memory
+	/// elsewhere (strings, pointers and containers) are not captured and are left alone by a restore.
+	///
+	/// A snapshot taken against a base snapshot only stores the field spans that changed since the base, for pools whose
+	/// set of components is unchanged, which keeps per-frame snapshots for rollback small.  Restoring such a delta requires
+	/// the same base snapshot.
+	///
+	/// Snapshots capture component values, not the structure of the world: components are identified by handle, so a
+	/// restore only updates components that still exist, and does not recreate components or entities destroyed since.
+	///
+	/// Only reflected fields are captured, so runtime state a component needs rolled back must be added to its
+	/// PopulateMetaType() (with Reflect::FieldFlags::Discard if it should not be serialized).  State held outside the
+	/// component pools, such as Bullet rigid bodies behind BulletBodyComponent, is not captured at all.
+	class HELIUM_FRAMEWORK_API WorldSnapshot : NonCopyable
+	{
+	public:
+		/// @name Construction/Destruction
+		//@{
+		WorldSnapshot();
+		//@}
+
+		/// @name Snapshot Information
+		//@{
+		inline bool IsEmpty() const;
+		inline bool IsDelta() const;
+		inline uint32_t GetId() const;
+		inline uint32_t GetBaseId() const;
+		inline size_t GetComponentCount() const;
+		inline size_t GetDataSize() const;
+
+		void Clear();
+		//@}
+
+	private:
+		friend class World;
+
+		/// Contiguous run of plain data fields within a component.
+		struct FieldSpan
+		{
+			/// Byte offset from the start of the component's structure.
+			uint32_t m_Offset;
+			/// Byte count.
+			uint32_t m_Size;
+		};
+
+		/// Captured state of a single component pool.
+		struct PoolRecord
+		{
+			/// Component type of the pool.
+			Components::TypeId m_TypeId;
+			/// True if the columns only hold the components that changed since the base snapshot.
+			bool m_bDelta;
+			/// Number of components captured.
+			uint32_t m_ComponentCount;
+			/// Index of the first component handle in m_handles.
+			size_t m_FirstHandle;
+			/// Byte offset of the first column in m_data.
+			size_t m_ColumnOffset;
+			/// Bytes of plain data fields per component.
+			uint32_t m_RowSize;
+		};
+
+		/// @name Capture and Restore
+		//@{
+		void Capture( ComponentManager& rManager, const WorldSnapshot* pBase );
+		bool Apply( ComponentManager& rManager, const WorldSnapshot* pBase ) const;
+
+		void CapturePool( const Components::Pool& rPool, const DynamicArray< FieldSpan >& rSpans, const WorldSnapshot* pBase );
+		size_t ApplyPool(
+			ComponentManager& rManager,
+			const PoolRecord& rRecord,
+			const DynamicArray< FieldSpan >& rSpans,
+			DynamicArray< uint8_t* >& rTargets ) const;
+		const PoolRecord* FindPoolRecord( Components::TypeId typeId ) const;
+
+		static void GetFieldSpans( const Components::TypeData& rTypeData, DynamicArray< FieldSpan >& rSpans );
+		//@}
+
+		/// Captured pools, in type order.
+		DynamicArray< PoolRecord > m_pools;
+		/// Handles of the captured components, in pool roster order.
+		DynamicArray< Components::Handle > m_handles;
+		/// Column data of every captured pool.
+		DynamicArray< uint8_t > m_data;
+		/// Unique ID of this snapshot, zero if empty.
+		uint32_t m_id;
+		/// ID of the snapshot this one is a delta against, zero if it is not a delta.
+		uint32_t m_baseId;
+	};
+}
+
+#include "Framework/WorldSnapshot.inl"
@@ -0,0 +1,54 @@
+namespace Helium
+{
+	/// Get whether this snapshot holds any state.
+	///
+	/// @return  True if nothing has been captured.
+	bool WorldSnapshot::IsEmpty() const
+	{
+		return m_id == 0;
+	}
+
+	/// Get whether this snapshot only holds the state that changed since a base snapshot.
+	///
+	/// @return  True if this is a delta snapshot.
+	///
+	/// @see GetBaseId()
+	bool WorldSnapshot::IsDelta() const
+	{
+		return m_baseId != 0;
+	}
+
+	/// Get the unique ID of this snapshot.
+	///
+	/// @return  Snapshot ID, or zero if the snapshot is empty.
+	uint32_t WorldSnapshot::GetId() const
+	{
+		return m_id;
+	}
+
+	/// Get the ID of the snapshot this one is a delta against.
+	///
+	/// @return  Base snapshot ID, or zero if this is not a delta.
+	///
+	/// @see IsDelta()
+	uint32_t WorldSnapshot::GetBaseId() const
+	{
+		return m_baseId;
+	}
+
+	/// Get the number of components captured.
+	///
+	/// @return  Component count.
+	size_t WorldSnapshot::GetComponentCount() const
+	{
+		return m_handles.GetSize();
+	}
+
+	/// Get the number of bytes of component data held by this snapshot.
+	///
+	/// @return  Data size, in bytes.
+	size_t WorldSnapshot::GetDataSize() const
+	{
+		return m_data.GetSize() + m_handles.GetSize() * sizeof( Components::Handle );
+	}
+}
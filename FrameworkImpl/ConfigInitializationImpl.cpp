@@ -4,6 +4,7 @@
 #include "Engine/Config.h"
 #include "Engine/AssetLoader.h"
 #include "PcSupport/ConfigPc.h"
+#include "PcSupport/AssetPreprocessor.h"
 
 using namespace Helium;
 
@@ -32,5 +33,9 @@ void ConfigInitializationImpl::Startup()
 	HELIUM_TRACE( TraceLevels::Info, TXT( "Saving user configuration.\n" ) );
 	ConfigPc::SaveUserConfig();
 	HELIUM_TRACE( TraceLevels::Info, TXT( "User configuration saved.\n" ) );
+
+	AssetPreprocessor* pAssetPreprocessor = AssetPreprocessor::GetInstance();
+	HELIUM_ASSERT( pAssetPreprocessor );
+	pAssetPreprocessor->ApplyCacheCompressionConfig();
 #endif
 }
@@ -1,6 +1,8 @@
 #include "GraphicsJobsPch.h"
 #include "GraphicsJobs/GraphicsJobsInterface.h"
 
+#include "EngineJobs/JobManager.h"
+
 /// Maximum number of jobs to spawn at once for scene instance buffer updates.
 #define GRAPHICS_SCENE_INSTANCE_UPDATE_JOB_MAX 128
 
@@ -12,13 +14,14 @@ using namespace Helium;
 void UpdateGraphicsSceneConstantBuffersJobSpawner::Run()
 {
 	{
-		// NOTE: These were running in parallel, but now synchronous since we're removing tbb
+		JobCounter counter;
+
 		UpdateGraphicsSceneObjectBuffersJobSpawner objectJob;
 		UpdateGraphicsSceneObjectBuffersJobSpawner::Parameters& rObjectParameters = objectJob.GetParameters();
 		rObjectParameters.sceneObjectCount = m_parameters.sceneObjectCount;
 		rObjectParameters.pSceneObjects = m_parameters.pSceneObjects;
 		rObjectParameters.ppConstantBufferData = m_parameters.ppSceneObjectConstantBufferData;
-		objectJob.Run();
+		JobManager::Spawn( UpdateGraphicsSceneObjectBuffersJobSpawner::RunCallback, &objectJob, counter );
 
 		UpdateGraphicsSceneSubMeshBuffersJobSpawner subMeshJob;
 		UpdateGraphicsSceneSubMeshBuffersJobSpawner::Parameters& rSubMeshParameters = subMeshJob.GetParameters();
@@ -27,5 +30,7 @@ void UpdateGraphicsSceneConstantBuffersJobSpawner::Run()
 		rSubMeshParameters.pSceneObjects = m_parameters.pSceneObjects;
 		rSubMeshParameters.ppConstantBufferData = m_parameters.ppSubMeshConstantBufferData;
 		subMeshJob.Run();
+
+		JobManager::Wait( counter );
 	}
 }
@@ -1,6 +1,8 @@
 #include "GraphicsJobsPch.h"
 #include "GraphicsJobs/GraphicsJobsInterface.h"
 
+#include "EngineJobs/JobManager.h"
+
 /// Maximum number of child jobs to spawn at once.
 static const uint_fast32_t SCENE_OBJECT_CHILD_JOB_MAX = 128;
 /// Maximum number of graphics scene objects to update in each child job.
@@ -26,25 +28,28 @@ void UpdateGraphicsSceneObjectBuffersJobSpawner::Run()
     }
 
     {
+        // Child jobs must remain valid until they have completed, so we keep them here until the wait below.
+        UpdateGraphicsSceneObjectBuffersJob childJobs[ SCENE_OBJECT_CHILD_JOB_MAX ];
+        JobCounter counter;
+
         for( uint_fast32_t jobIndex = 0; jobIndex < jobCount; ++jobIndex )
         {
             uint_fast32_t jobObjectCount = Min( sceneObjectCount, SCENE_OBJECT_CHILD_JOB_OBJECT_COUNT_MAX );
             HELIUM_ASSERT( jobObjectCount != 0 );
             sceneObjectCount -= jobObjectCount;
 
-			// NOTE: These were run in parallel but now synchronous since TBB has been removed
-			UpdateGraphicsSceneObjectBuffersJob job;
-            UpdateGraphicsSceneObjectBuffersJob::Parameters& rParameters = job.GetParameters();
+            UpdateGraphicsSceneObjectBuffersJob& rJob = childJobs[ jobIndex ];
+            UpdateGraphicsSceneObjectBuffersJob::Parameters& rParameters = rJob.GetParameters();
             rParameters.sceneObjectCount = static_cast< uint32_t >( jobObjectCount );
             rParameters.pSceneObjects = pSceneObjects;
             rParameters.ppConstantBufferData = ppConstantBufferData;
-			job.Run();
+            JobManager::Spawn( UpdateGraphicsSceneObjectBuffersJob::RunCallback, &rJob, counter );
 
             pSceneObjects += jobObjectCount;
             ppConstantBufferData += jobObjectCount;
         }
 
-		// This was a continuation task but now just exectues inline here since TBB was removed
+        // Process any remaining objects on this thread while the child jobs run.
         if( sceneObjectCount != 0 )
         {
 			UpdateGraphicsSceneObjectBuffersJobSpawner job;
@@ -54,5 +59,7 @@ void UpdateGraphicsSceneObjectBuffersJobSpawner::Run()
             rParameters.ppConstantBufferData = ppConstantBufferData;
 			job.Run();
         }
+
+        JobManager::Wait( counter );
     }
 }
@@ -1,6 +1,8 @@
 #include "GraphicsJobsPch.h"
 #include "GraphicsJobs/GraphicsJobsInterface.h"
 
+#include "EngineJobs/JobManager.h"
+
 /// Maximum number of child jobs to spawn at once.
 static const uint_fast32_t SUB_MESH_CHILD_JOB_MAX = 128;
 /// Maximum number of sub-meshes to update in each child job.
@@ -28,20 +30,23 @@ void UpdateGraphicsSceneSubMeshBuffersJobSpawner::Run()
     }
 
     {
+        // Child jobs must remain valid until they have completed, so we keep them here until the wait below.
+        UpdateGraphicsSceneSubMeshBuffersJob childJobs[ SUB_MESH_CHILD_JOB_MAX ];
+        JobCounter counter;
+
         for( uint_fast32_t jobIndex = 0; jobIndex < jobCount; ++jobIndex )
         {
-			// These were all in parallel but TBB was removed
             uint_fast32_t jobObjectCount = Min( subMeshCount, SUB_MESH_CHILD_JOB_OBJECT_COUNT_MAX );
             HELIUM_ASSERT( jobObjectCount != 0 );
             subMeshCount -= jobObjectCount;
 
-			UpdateGraphicsSceneSubMeshBuffersJob job;
-            UpdateGraphicsSceneSubMeshBuffersJob::Parameters& rParameters = job.GetParameters();
+            UpdateGraphicsSceneSubMeshBuffersJob& rJob = childJobs[ jobIndex ];
+            UpdateGraphicsSceneSubMeshBuffersJob::Parameters& rParameters = rJob.GetParameters();
             rParameters.subMeshCount = static_cast< uint32_t >( jobObjectCount );
             rParameters.pSubMeshes = pSubMeshes;
             rParameters.pSceneObjects = pSceneObjects;
             rParameters.ppConstantBufferData = ppConstantBufferData;
-			job.Run();
+            JobManager::Spawn( UpdateGraphicsSceneSubMeshBuffersJob::RunCallback, &rJob, counter );
 
             pSubMeshes += jobObjectCount;
             ppConstantBufferData += jobObjectCount;
@@ -49,7 +54,7 @@ void UpdateGraphicsSceneSubMeshBuffersJobSpawner::Run()
 
         if( subMeshCount != 0 )
         {
-			// NOTE: This was a continuation job from above but is now inline since TBB was removed
+			// Process any remaining sub-meshes on this thread while the child jobs run.
 			UpdateGraphicsSceneSubMeshBuffersJobSpawner job;
             UpdateGraphicsSceneSubMeshBuffersJobSpawner::Parameters& rParameters =
                 job.GetParameters();
@@ -59,5 +64,7 @@ void UpdateGraphicsSceneSubMeshBuffersJobSpawner::Run()
             rParameters.ppConstantBufferData = ppConstantBufferData;
 			job.Run();
         }
+
+        JobManager::Wait( counter );
     }
 }
@@ -374,6 +374,7 @@ Helium.DoGameProjectSettings = function( name )
 		"bullet",
 		"mongo-c",
 		"ois",
+		"zlib",
 	}
 
 	if _OPTIONS[ "gfxapi" ] == "opengl" then
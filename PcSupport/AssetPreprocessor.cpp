@@ -11,6 +11,7 @@
 #include "Engine/AssetLoader.h"
 #include "Engine/Resource.h"
 #include "Engine/Config.h"
+#include "PcSupport/CacheCompressionConfig.h"
 #include "PcSupport/PlatformPreprocessor.h"
 #include "PcSupport/ResourceHandler.h"
 #include "Engine/PackageLoader.h"
@@ -51,6 +52,120 @@ void AssetPreprocessor::SetPlatformPreprocessor( Cache::EPlatform platform, Plat
 	m_pPlatformPreprocessors[ platform ] = pPreprocessor;
 }
 
+/// Set the compression to apply to cache entries written for objects of a given type.
+///
+/// Settings apply to the given type and any of its sub-types that do not have a setting of their own.  Entries are
+/// stored uncompressed unless a setting applies.
+///
+/// @param[in] pType  Asset type, or null to set the default for all types.
+/// @param[in] codec  Compression codec.
+/// @param[in] level  Codec-specific compression level.
+///
+/// @see GetCacheCompression()
+void AssetPreprocessor::SetCacheCompression( const AssetType* pType, CompressionCodec codec, int32_t level )
+{
+	HELIUM_ASSERT( static_cast< size_t >( codec ) < static_cast< size_t >( CompressionCodecs::Count ) );
+
+	size_t settingCount = m_compressionSettings.GetSize();
+	for( size_t settingIndex = 0; settingIndex < settingCount; ++settingIndex )
+	{
+		CompressionSetting& rSetting = m_compressionSettings[ settingIndex ];
+		if( rSetting.pType == pType )
+		{
+			rSetting.codec = codec;
+			rSetting.level = level;
+
+			return;
+		}
+	}
+
+	CompressionSetting* pSetting = m_compressionSettings.New();
+	HELIUM_ASSERT( pSetting );
+	pSetting->pType = pType;
+	pSetting->codec = codec;
+	pSetting->level = level;
+}
+
+/// Get the compression to apply to cache entries written for objects of a given type.
+///
+/// @param[in]  pType   Asset type, or null to get the default setting.
+/// @param[out] rCodec  Compression codec.
+/// @param[out] rLevel  Codec-specific compression level.
+///
+/// @see SetCacheCompression()
+void AssetPreprocessor::GetCacheCompression(
+	const AssetType* pType,
+	CompressionCodec& rCodec,
+	int32_t& rLevel ) const
+{
+	rCodec = CompressionCodecs::None;
+	rLevel = COMPRESSION_LEVEL_DEFAULT;
+
+	// Use the setting for the most derived type that has one, falling back to the default setting.
+	size_t settingCount = m_compressionSettings.GetSize();
+	for( ; ; pType = pType->GetBaseType() )
+	{
+		for( size_t settingIndex = 0; settingIndex < settingCount; ++settingIndex )
+		{
+			const CompressionSetting& rSetting = m_compressionSettings[ settingIndex ];
+			if( rSetting.pType == pType )
+			{
+				rCodec = rSetting.codec;
+				rLevel = rSetting.level;
+
+				return;
+			}
+		}
+
+		if( !pType )
+		{
+			break;
+		}
+	}
+}
+
+/// Apply the cache compression settings from the "CacheCompressionConfig" configuration object, if one exists.
+///
+/// This should be called once the configuration has finished loading.  Settings naming an unknown asset type are
+/// ignored.
+///
+/// @see SetCacheCompression()
+void AssetPreprocessor::ApplyCacheCompressionConfig()
+{
+	Config* pConfig = Config::GetInstance();
+	HELIUM_ASSERT( pConfig );
+
+	CacheCompressionConfig* pCompressionConfig =
+		pConfig->GetConfigObject< CacheCompressionConfig >( Name( TXT( "CacheCompressionConfig" ) ) );
+	if( !pCompressionConfig )
+	{
+		return;
+	}
+
+	size_t settingCount = pCompressionConfig->m_Settings.GetSize();
+	for( size_t settingIndex = 0; settingIndex < settingCount; ++settingIndex )
+	{
+		const CacheCompressionSetting& rSetting = pCompressionConfig->m_Settings[ settingIndex ];
+
+		const AssetType* pType = NULL;
+		if( !rSetting.m_AssetType.IsEmpty() )
+		{
+			pType = AssetType::Find( rSetting.m_AssetType );
+			if( !pType )
+			{
+				HELIUM_TRACE(
+					TraceLevels::Warning,
+					TXT( "AssetPreprocessor::ApplyCacheCompressionConfig(): Unknown asset type \"%s\", setting ignored.\n" ),
+					*rSetting.m_AssetType );
+
+				continue;
+			}
+		}
+
+		SetCacheCompression( pType, rSetting.GetCodec(), rSetting.m_Level );
+	}
+}
+
 /// Cache an object for all registered platforms.
 ///
 /// @param[in] pObject                                 Asset to cache.
@@ -108,6 +223,10 @@ bool AssetPreprocessor::CacheObject(
 		objectCacheName = Name( HELIUM_ASSET_CACHE_NAME );
 	}
 
+	CompressionCodec compressionCodec;
+	int32_t compressionLevel;
+	GetCacheCompression( pObject->GetAssetType(), compressionCodec, compressionLevel );
+
 	bool bUpdatedAnyCache = false;
 
 	for( size_t platformIndex = 0; platformIndex < HELIUM_ARRAY_COUNT( m_pPlatformPreprocessors ); ++platformIndex )
@@ -214,7 +333,9 @@ bool AssetPreprocessor::CacheObject(
 			0,
 			objectStreamBuffer.GetData(),
 			timestamp,
-			static_cast< uint32_t >( objectDataSize ) );
+			static_cast< uint32_t >( objectDataSize ),
+			compressionCodec,
+			compressionLevel );
 		if( !bCacheResult )
 		{
 			HELIUM_TRACE(
@@ -257,7 +378,9 @@ bool AssetPreprocessor::CacheObject(
 							static_cast< uint32_t >( subDataBufferIndex ),
 							rSubData.GetData(),
 							timestamp,
-							static_cast< uint32_t >( rSubData.GetSize() ) );
+							static_cast< uint32_t >( rSubData.GetSize() ),
+							compressionCodec,
+							compressionLevel );
 						if( !bCacheResult )
 						{
 							HELIUM_TRACE(
@@ -502,43 +625,26 @@ uint32_t AssetPreprocessor::LoadPersistentResourceData(
 		return Invalid< uint32_t >();
 	}
 
-	FileStream* pFileStream = FileStream::OpenFileStream( pCache->GetCacheFileName(), FileStream::MODE_READ );
-	if( !pFileStream )
+	// Read the entire entry up front, as it may need to be decompressed before it can be parsed.
+	DynamicArray< uint8_t > entryData;
+	if( !pCache->ReadEntry( *pCacheEntry, entryData ) )
 	{
 		HELIUM_TRACE(
 			TraceLevels::Error,
-			( TXT( "AssetPreprocessor::LoadPersistentResourceData(): Failed to open cache file \"%s\" for " )
-			TXT( "retrieving cached object data for \"%s\".\n" ) ),
-			*pCache->GetCacheFileName(),
-			*resourcePath.ToString() );
-
-		return Invalid< uint32_t >();
-	}
-
-	BufferedStream bufferedStream( pFileStream );
-
-	int64_t seekLocation = bufferedStream.Seek( pCacheEntry->offset, SeekOrigins::Begin );
-	if( static_cast< uint64_t >( seekLocation ) != pCacheEntry->offset )
-	{
-		HELIUM_TRACE(
-			TraceLevels::Error,
-			( TXT( "AssetPreprocessor::LoadPersistentResourceData(): Failed to seek to byte offset %" ) PRIu64
-			TXT( " in cache file \"%s\" for retrieving cached object data for \"%s\".\n" ) ),
-			pCacheEntry->offset,
-			*pCache->GetCacheFileName(),
-			*resourcePath.ToString() );
-
-		bufferedStream.Close();
-		delete pFileStream;
+			( TXT( "AssetPreprocessor::LoadPersistentResourceData(): Failed to read cached object data for \"%s\" " )
+			TXT( "from cache file \"%s\".\n" ) ),
+			*resourcePath.ToString(),
+			*pCache->GetCacheFileName() );
 
 		return Invalid< uint32_t >();
 	}
 
-	ByteSwappingStream byteSwapStream( &bufferedStream );
+	StaticMemoryStream entryStream( entryData.GetData(), entryData.GetSize() );
+	ByteSwappingStream byteSwapStream( &entryStream );
 	Stream* pReadStream =
 		( pPreprocessor->SwapBytes()
 		? static_cast< Stream* >( &byteSwapStream )
-		: static_cast< Stream* >( &bufferedStream ) );
+		: static_cast< Stream* >( &entryStream ) );
 
 	uint32_t propertyDataSize = 0;
 	size_t readCount = pReadStream->Read( &propertyDataSize, sizeof( propertyDataSize ), 1 );
@@ -551,10 +657,6 @@ uint32_t AssetPreprocessor::LoadPersistentResourceData(
 			*resourcePath.ToString(),
 			*pCache->GetCacheFileName() );
 
-		byteSwapStream.Close();
-		bufferedStream.Close();
-		delete pFileStream;
-
 		return Invalid< uint32_t >();
 	}
 
@@ -580,70 +682,22 @@ uint32_t AssetPreprocessor::LoadPersistentResourceData(
 			TXT( "large enough to provide the resource sub-data count.\n" ) ),
 			*resourcePath.ToString() );
 
-		byteSwapStream.Close();
-		bufferedStream.Close();
-		delete pFileStream;
-
 		return Invalid< uint32_t >();
 	}
 
-	uint64_t newOffset = pCacheEntry->offset + sizeof( propertyDataSize ) + propertyDataSize;
-	seekLocation = bufferedStream.Seek( newOffset, SeekOrigins::Begin );
-	if( static_cast< uint64_t >( seekLocation ) != newOffset )
-	{
-		HELIUM_TRACE(
-			TraceLevels::Error,
-			( TXT( "AssetPreprocessor::LoadPersistentResourceData(): Failed to seek to byte offset %" ) PRIu64
-			TXT( " in cache file \"%s\" for the cached persistent resource data for \"%s\".\n" ) ),
-			newOffset,
-			*pCache->GetCacheFileName(),
-			*resourcePath.ToString() );
-
-		byteSwapStream.Close();
-		bufferedStream.Close();
-		delete pFileStream;
-
-		return Invalid< uint32_t >();
-	}
-
-	size_t resourceDataStreamSize =
-		pCacheEntry->size - sizeof( propertyDataSize ) - propertyDataSize - sizeof( uint32_t );
+	size_t resourceDataOffset = sizeof( propertyDataSize ) + propertyDataSize;
+	size_t resourceDataStreamSize = pCacheEntry->size - resourceDataOffset - sizeof( uint32_t );
 
 	rPersistentDataBuffer.Reserve( resourceDataStreamSize );
 	rPersistentDataBuffer.Resize( resourceDataStreamSize );
-
-	size_t bytesRead = bufferedStream.Read( rPersistentDataBuffer.GetData(), 1, resourceDataStreamSize );
-	if( bytesRead != resourceDataStreamSize )
-	{
-		HELIUM_TRACE(
-			TraceLevels::Warning,
-			( TXT( "AssetPreprocessor::LoadPersistentResourceData(): Attempted to load %" ) PRIuSZ
-			TXT( " bytes from offset %" ) PRIu64 TXT( " in cache file \"%s\", but only %" ) PRIuSZ
-			TXT( " bytes could be read.\n" ) ),
-			resourceDataStreamSize,
-			newOffset,
-			*pCache->GetCacheFileName(),
-			bytesRead );
-
-		rPersistentDataBuffer.Resize( bytesRead );
-	}
-
 	rPersistentDataBuffer.Trim();
+	MemoryCopy( rPersistentDataBuffer.GetData(), entryData.GetData() + resourceDataOffset, resourceDataStreamSize );
 
 	uint32_t subDataCount = 0;
-	readCount = bufferedStream.Read( &subDataCount, sizeof( subDataCount ), 1 );
-	if( readCount != 1 )
-	{
-		HELIUM_TRACE(
-			TraceLevels::Warning,
-			( TXT( "AssetPreprocessor::LoadPersistentResourceData(): Failed to read resource sub-data count for " )
-			TXT( "\"%s\" from the end of its object data stream.\n" ) ),
-			*resourcePath.ToString() );
-	}
-
-	byteSwapStream.Close();
-	bufferedStream.Close();
-	delete pFileStream;
+	MemoryCopy(
+		&subDataCount,
+		entryData.GetData() + resourceDataOffset + resourceDataStreamSize,
+		sizeof( subDataCount ) );
 
 	return subDataCount;
 }
@@ -745,19 +799,6 @@ bool AssetPreprocessor::LoadCachedResourceData( const AssetPath &path, Resource*
 			return false;
 		}
 
-		FileStream* pFileStream = FileStream::OpenFileStream( resourceCachePath.Data(), FileStream::MODE_READ );
-		if( !pFileStream )
-		{
-			HELIUM_TRACE(
-				TraceLevels::Error,
-				( TXT( "AssetPreprocessor::LoadCachedResourceData(): Failed to open cache file for cache \"%s\" " )
-				TXT( "for resource \"%s\".\n" ) ),
-				*resourceCacheName,
-				*path.ToString() );
-
-			return false;
-		}
-
 		DynamicArray< DynamicArray< uint8_t > >& rSubDataBuffers = rPreprocessedData.subDataBuffers;
 		rSubDataBuffers.Reserve( subDataCount );
 		rSubDataBuffers.Resize( subDataCount );
@@ -775,56 +816,26 @@ bool AssetPreprocessor::LoadCachedResourceData( const AssetPath &path, Resource*
 					*path.ToString(),
 					*resourceCacheName );
 
-				delete pFileStream;
-
 				return false;
 			}
 
-			int64_t newOffset = pFileStream->Seek( pResourceCacheEntry->offset, SeekOrigins::Begin );
-			if( static_cast< uint64_t >( newOffset ) != pResourceCacheEntry->offset )
+			DynamicArray< uint8_t >& rSubData = rSubDataBuffers[ subDataIndex ];
+			if( !pResourceCache->ReadEntry( *pResourceCacheEntry, rSubData ) )
 			{
 				HELIUM_TRACE(
 					TraceLevels::Error,
-					( TXT( "AssetPreprocessor::LoadCachedResourceData(): Failed to seek to offset %" ) PRIu64
-					TXT( " in cache \"%s\" when loading sub-data %" ) PRIu32 TXT( " of resource \"%s\".\n" ) ),
-					pResourceCacheEntry->offset,
+					( TXT( "AssetPreprocessor::LoadCachedResourceData(): Failed to read %" ) PRIu32
+					TXT( " bytes from cache \"%s\" for sub-data %" ) PRIu32 TXT( " of resource \"%s\".\n" ) ),
+					pResourceCacheEntry->size,
 					*resourceCacheName,
 					subDataIndex,
 					*path.ToString() );
 
-				delete pFileStream;
-
 				return false;
 			}
 
-			uint32_t subDataSize = pResourceCacheEntry->size;
-
-			DynamicArray< uint8_t >& rSubData = rSubDataBuffers[ subDataIndex ];
-			rSubData.Reserve( subDataSize );
-			rSubData.Resize( subDataSize );
 			rSubData.Trim();
-
-			size_t bytesRead = pFileStream->Read( rSubData.GetData(), 1, subDataSize );
-			if( bytesRead != subDataSize )
-			{
-				HELIUM_TRACE(
-					TraceLevels::Error,
-					( TXT( "AssetPreprocessor::LoadCachedResourceData(): Failed to read %" ) PRIu32
-					TXT( " bytes from cache \"%s\" for sub-data %" ) PRIu32 TXT( " of resource \"%s\" (only %" )
-					PRIuSZ TXT( " bytes read).\n" ) ),
-					subDataSize,
-					*resourceCacheName,
-					subDataIndex,
-					*path.ToString(),
-					bytesRead );
-
-				delete pFileStream;
-
-				return false;
-			}
 		}
-
-		delete pFileStream;
 	}
 
 	// Loaded.
@@ -7,6 +7,7 @@
 namespace Helium
 {
     class Asset;
+    class AssetType;
     class Resource;
     class PlatformPreprocessor;
 
@@ -23,6 +24,11 @@ namespace Helium
         /// @name Asset Caching
         //@{
         bool CacheObject( const AssetPath &objectPath, Asset* pObject, int64_t timestamp, bool bEvictPlatformPreprocessedResourceData = true );
+
+        void SetCacheCompression(
+            const AssetType* pType, CompressionCodec codec, int32_t level = COMPRESSION_LEVEL_DEFAULT );
+        void GetCacheCompression( const AssetType* pType, CompressionCodec& rCodec, int32_t& rLevel ) const;
+        void ApplyCacheCompressionConfig();
         //@}
 
         /// @name Resource Preprocessing
@@ -38,8 +44,21 @@ namespace Helium
        //@}
 
     private:
+        /// Cache compression setting for an asset type.
+        struct CompressionSetting
+        {
+            /// Asset type (null for the default setting).
+            const AssetType* pType;
+            /// Compression codec.
+            CompressionCodec codec;
+            /// Codec-specific compression level.
+            int32_t level;
+        };
+
         /// Platform-specific preprocessing support.
         PlatformPreprocessor* m_pPlatformPreprocessors[ Cache::PLATFORM_MAX ];
+        /// Cache compression settings.
+        DynamicArray< CompressionSetting > m_compressionSettings;
 
         /// Singleton instance.
         static AssetPreprocessor* sm_pInstance;
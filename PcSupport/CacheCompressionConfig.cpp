@@ -0,0 +1,46 @@
+#include "PcSupportPch.h"
+#include "PcSupport/CacheCompressionConfig.h"
+
+#include "Reflect/TranslatorDeduction.h"
+
+HELIUM_DEFINE_ENUM( Helium::CacheCompressionSetting::ECodec );
+HELIUM_DEFINE_BASE_STRUCT( Helium::CacheCompressionSetting );
+HELIUM_DEFINE_CLASS( Helium::CacheCompressionConfig );
+
+using namespace Helium;
+
+/// Constructor.
+CacheCompressionSetting::CacheCompressionSetting()
+: m_AssetType( NULL_NAME )
+, m_Codec( ECodec::DEFLATE )
+, m_Level( COMPRESSION_LEVEL_DEFAULT )
+{
+}
+
+void CacheCompressionSetting::PopulateMetaType( Reflect::MetaStruct& comp )
+{
+	comp.AddField( &CacheCompressionSetting::m_AssetType, TXT( "m_AssetType" ) );
+	comp.AddField( &CacheCompressionSetting::m_Codec, TXT( "m_Codec" ) );
+	comp.AddField( &CacheCompressionSetting::m_Level, TXT( "m_Level" ) );
+}
+
+/// Get the compression codec matching the configured codec.
+///
+/// @return  Compression codec.
+CompressionCodec CacheCompressionSetting::GetCodec() const
+{
+	switch( m_Codec )
+	{
+	case ECodec::DEFLATE:
+		return CompressionCodecs::Deflate;
+
+	case ECodec::NONE:
+	default:
+		return CompressionCodecs::None;
+	}
+}
+
+void CacheCompressionConfig::PopulateMetaType( Reflect::MetaStruct& comp )
+{
+	comp.AddField( &CacheCompressionConfig::m_Settings, TXT( "m_Settings" ) );
+}
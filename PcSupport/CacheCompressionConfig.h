@@ -0,0 +1,63 @@
+#pragma once
+
+#include "PcSupport/PcSupport.h"
+
+#include "Engine/Asset.h"
+#include "Engine/Compression.h"
+
+namespace Helium
+{
+    /// Compression setting for cache entries of one asset type.
+    struct HELIUM_PC_SUPPORT_API CacheCompressionSetting : Reflect::Struct
+    {
+        /// Compression codec.
+        struct ECodec : Reflect::Enum
+        {
+            enum Enum
+            {
+                NONE,
+                DEFLATE,
+            };
+
+            HELIUM_DECLARE_ENUM( ECodec );
+
+            static void PopulateMetaType( Helium::Reflect::MetaEnum& info )
+            {
+                info.AddElement( NONE,     TXT( "NONE" ) );
+                info.AddElement( DEFLATE,  TXT( "DEFLATE" ) );
+            }
+        };
+
+        HELIUM_DECLARE_BASE_STRUCT( Helium::CacheCompressionSetting );
+        static void PopulateMetaType( Reflect::MetaStruct& comp );
+
+        CacheCompressionSetting();
+
+        inline bool operator==( const CacheCompressionSetting& _rhs ) const;
+        inline bool operator!=( const CacheCompressionSetting& _rhs ) const;
+
+        CompressionCodec GetCodec() const;
+
+        /// Full name of the asset type (e.g. "Helium::Texture2d"), or empty for the default for all types.
+        Name m_AssetType;
+        /// Compression codec.
+        ECodec m_Codec;
+        /// Codec-specific compression level.
+        int32_t m_Level;
+    };
+
+    /// Cache build compression settings, read from the "CacheCompressionConfig" configuration object when the tools
+    /// start up.  Cache entries are stored uncompressed when no configuration object exists.
+    class HELIUM_PC_SUPPORT_API CacheCompressionConfig : public Reflect::Object
+    {
+        HELIUM_DECLARE_CLASS( CacheCompressionConfig, Reflect::Object );
+
+    public:
+        static void PopulateMetaType( Reflect::MetaStruct& comp );
+
+        /// Per-type settings.
+        DynamicArray< CacheCompressionSetting > m_Settings;
+    };
+}
+
+#include "PcSupport/CacheCompressionConfig.inl"
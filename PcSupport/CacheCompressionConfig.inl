@@ -0,0 +1,16 @@
+namespace Helium
+{
+    bool CacheCompressionSetting::operator==( const CacheCompressionSetting& _rhs ) const
+    {
+        return (
+            m_AssetType == _rhs.m_AssetType &&
+            m_Codec == _rhs.m_Codec &&
+            m_Level == _rhs.m_Level
+            );
+    }
+
+    bool CacheCompressionSetting::operator!=( const CacheCompressionSetting& _rhs ) const
+    {
+        return !( *this == _rhs );
+    }
+}
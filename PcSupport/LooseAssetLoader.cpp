@@ -5,6 +5,7 @@
 #include "Foundation/FilePath.h"
 #include "Engine/FileLocations.h"
 #include "Engine/Config.h"
+#include "Engine/CacheManager.h"
 #include "Engine/Resource.h"
 #include "PcSupport/AssetPreprocessor.h"
 #include "PcSupport/LoosePackageLoader.h"
@@ -23,6 +24,7 @@ LooseAssetFileWatcher g_FileWatcher;
 
 /// Constructor.
 LooseAssetLoader::LooseAssetLoader()
+: m_bTocCommitPending( false )
 {
 #if USE_LOOSE_ASSET_FILE_WATCHER
 	g_FileWatcher.StartThread();
@@ -82,6 +84,27 @@ void LooseAssetLoader::TickPackageLoaders()
 	m_packageLoaderMap.TickPackageLoaders();
 }
 
+/// Update the loader, committing cache TOC updates once all outstanding load requests have been processed.
+///
+/// @see AssetLoader::Tick()
+void LooseAssetLoader::Tick()
+{
+	AssetLoader::Tick();
+
+	if ( m_bTocCommitPending )
+	{
+		ConcurrentHashMap< AssetPath, LoadRequest* >::ConstAccessor loadRequestConstAccessor;
+		if ( !m_loadRequestMap.First( loadRequestConstAccessor ) )
+		{
+			m_bTocCommitPending = false;
+
+			CacheManager* pCacheManager = CacheManager::GetInstance();
+			HELIUM_ASSERT( pCacheManager );
+			pCacheManager->CommitTocs();
+		}
+	}
+}
+
 /// @copydoc AssetLoader::OnLoadComplete()
 void LooseAssetLoader::OnLoadComplete( const AssetPath &path, Asset* pAsset, PackageLoader* /*pPackageLoader*/ )
 {
@@ -200,12 +223,13 @@ bool LooseAssetLoader::CacheObject( Asset* pAsset, bool bEvictPlatformPreprocess
 		}
 	}
 
-	// Cache the object.
+	// Cache the object.  The TOCs are committed once the current batch of loads is done.
 	bool bSuccess = pAssetPreprocessor->CacheObject(
 		path,
 		pAsset,
 		objectTimestamp,
 		bEvictPlatformPreprocessedResourceData );
+	m_bTocCommitPending = true;
 	if ( !bSuccess )
 	{
 		HELIUM_TRACE(
@@ -26,6 +26,8 @@ namespace Helium
 		/// @name Loading Interface
 		//@{
 		virtual bool CacheObject( Asset* pObject, bool bEvictPlatformPreprocessedResourceData = true );
+
+		virtual void Tick();
 		//@}
 
 		/// @name Static Initialization
@@ -41,6 +43,9 @@ namespace Helium
 	private:
 		LoosePackageLoaderMap m_packageLoaderMap;
 
+		/// True if objects have been cached since cache TOCs were last committed.
+		bool m_bTocCommitPending;
+
 		/// @name Loading Implementation
 		//@{
 		virtual PackageLoader* GetPackageLoader( AssetPath path );
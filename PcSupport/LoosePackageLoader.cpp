@@ -1361,13 +1361,9 @@ bool LoosePackageLoader::TickDeserialize( LoadRequest* pRequest )
 				HELIUM_ASSERT( pRequest->pCachedObjectDataBuffer );
 				pRequest->cachedObjectDataBufferSize = pEntry->size;
 
-				AsyncLoader* pAsyncLoader = AsyncLoader::GetInstance();
-				HELIUM_ASSERT( pAsyncLoader );
-
-				pRequest->persistentResourceDataLoadId = pAsyncLoader->QueueRequest(
+				pRequest->persistentResourceDataLoadId = pCache->QueueEntryLoad(
+					*pEntry,
 					pRequest->pCachedObjectDataBuffer,
-					pCache->GetCacheFileName(),
-					pEntry->offset,
 					pEntry->size );
 				HELIUM_ASSERT( IsValid( pRequest->persistentResourceDataLoadId ) );
 			}
@@ -4,6 +4,7 @@
 #include "AI.h"
 #include "GameLibrary/GameLogic/AvatarController.h"
 #include "GameLibrary/GameLogic/PlayerManager.h"
+#include "Components/SpatialIndexComponent.h"
 #include "Foundation/Numeric.h"
 #include "Framework/World.h"
 
@@ -33,68 +34,108 @@ void AIComponentChasePlayerDefinition::PopulateMetaType( Helium::Reflect::MetaSt
 //////////////////////////////////////////////////////////////////////////
 // TaskProcessAI
 
-typedef DynamicArray< Pair< PlayerComponent *, Simd::Vector3 > > PlayerList;
-static PlayerList g_PlayerList;
+// Spatial index layer of player avatars, so agents can find the nearest one without looking at every player
+static const uint32_t PLAYER_AVATAR_SPATIAL_LAYER = 1u << 1;
 
-void UpdateAI_ChasePlayer( AIComponentChasePlayer *pAiComponent, AvatarControllerComponent *pController )
+// Per world state shared by every agent, players are kept per world so worlds can be updated at the same time
+struct ChasePlayerContext
 {
-	PlayerComponent *pTarget = NULL;
+	SpatialIndexComponent *m_pSpatialIndex;
+	PlayerManagerComponent *m_pPlayerManager;
+};
+
+void UpdateAI_ChasePlayer( ChasePlayerContext &rContext, AIComponentChasePlayer *pAiComponent, ComponentCommandBuffer & )
+{
+	bool bHasTarget = false;
 	float pTargetDistanceSquared = NumericLimits<float>::Maximum;
 	Simd::Vector3 targetPosition = Simd::Vector3::Zero;
 	Simd::Vector3 myPosition = Simd::Vector3::Zero;
 
 	TransformComponent *pTransform = pAiComponent->GetComponentCollection()->GetFirst<TransformComponent>();
+
+	SpatialIndexComponent *pSpatialIndex = rContext.m_pSpatialIndex;
+	PlayerManagerComponent *pPlayerManager = rContext.m_pPlayerManager;
 	
-	if ( pTransform )
+	if ( pTransform && pSpatialIndex )
+	{
+		myPosition = pTransform->GetPosition();
+
+		TransformComponent *pTargetTransform = NULL;
+		if ( pSpatialIndex->QueryNearest( myPosition, 1, NumericLimits<float>::Maximum, PLAYER_AVATAR_SPATIAL_LAYER, &pTargetTransform ) )
+		{
+			bHasTarget = true;
+			targetPosition = pTargetTransform->GetPosition();
+		}
+	}
+	else if ( pTransform && pPlayerManager )
 	{
+		const PlayerManagerComponent::PlayerPositionList &rPlayers = pPlayerManager->m_PlayerPositions;
+
 		myPosition = pTransform->GetPosition();
-		for (PlayerList::Iterator iter = g_PlayerList.Begin(); iter != g_PlayerList.End(); ++iter)
+		for (PlayerManagerComponent::PlayerPositionList::ConstIterator iter = rPlayers.Begin(); iter != rPlayers.End(); ++iter)
 		{
 			float d = (iter->Second() - myPosition).GetMagnitudeSquared();
 			if ( d < pTargetDistanceSquared )
 			{
 				pTargetDistanceSquared = d;
-				pTarget = iter->First();
+				bHasTarget = true;
 				targetPosition = iter->Second();
 			}
 		}
 	}
 	
-	if ( pTarget )
+	for ( AvatarControllerComponent *pController = pAiComponent->GetComponentCollection()->GetFirst<AvatarControllerComponent>();
+		pController; pController = pController->GetNextComponent() )
 	{
-		Simd::Vector3 moveDir = (targetPosition - myPosition).GetNormalized();
+		if ( bHasTarget )
+		{
+			Simd::Vector3 moveDir = (targetPosition - myPosition).GetNormalized();
 
-		pController->m_MoveDir.SetX( moveDir.GetElement(0));
-		pController->m_MoveDir.SetY( moveDir.GetElement(1));
-		pController->m_AimDir = Simd::Vector3::Zero;
-		pController->m_bShoot = false;
-	}
-	else
-	{
-		pController->m_MoveDir = Simd::Vector2::Zero;
-		pController->m_AimDir = Simd::Vector3::Zero;
-		pController->m_bShoot = false;
+			pController->m_MoveDir.SetX( moveDir.GetElement(0));
+			pController->m_MoveDir.SetY( moveDir.GetElement(1));
+			pController->m_AimDir = Simd::Vector3::Zero;
+			pController->m_bShoot = false;
+		}
+		else
+		{
+			pController->m_MoveDir = Simd::Vector2::Zero;
+			pController->m_AimDir = Simd::Vector3::Zero;
+			pController->m_bShoot = false;
+		}
 	}
 }
 
 void ProcessAI( World *pWorld )
 {
-	g_PlayerList.Clear();
+	PlayerManagerComponent *pPlayerManager = pWorld->GetComponents().GetFirst<PlayerManagerComponent>();
+	SpatialIndexComponent *pSpatialIndex = pWorld->GetComponents().GetFirst<SpatialIndexComponent>();
 
-	for ( ImplementingComponentIterator<PlayerComponent> iterator( *pWorld->GetComponentManager() ); iterator.GetBaseComponent(); iterator.Advance() )
+	if ( pPlayerManager )
 	{
-		if ( iterator->m_Avatar )
-		{
-			TransformComponent *pTransform = iterator->m_Avatar->GetFirst<TransformComponent>();
+		PlayerManagerComponent::PlayerPositionList &rPlayers = pPlayerManager->m_PlayerPositions;
+		rPlayers.Clear();
 
-			if ( pTransform )
+		for ( ImplementingComponentIterator<PlayerComponent> iterator( *pWorld->GetComponentManager() ); iterator.GetBaseComponent(); iterator.Advance() )
+		{
+			if ( iterator->m_Avatar )
 			{
-				g_PlayerList.New( *iterator, pTransform->GetPosition() );
+				TransformComponent *pTransform = iterator->m_Avatar->GetFirst<TransformComponent>();
+
+				if ( pTransform )
+				{
+					rPlayers.New( *iterator, pTransform->GetPosition() );
+
+					if ( pSpatialIndex )
+					{
+						pSpatialIndex->SetLayerMask( pTransform, SPATIAL_INDEX_LAYER_DEFAULT | PLAYER_AVATAR_SPATIAL_LAYER );
+					}
+				}
 			}
 		}
 	}
 
-	QueryComponents< AIComponentChasePlayer, AvatarControllerComponent, UpdateAI_ChasePlayer >( pWorld );
+	ChasePlayerContext context = { pSpatialIndex, pPlayerManager };
+	ParallelForEachComponent< AIComponentChasePlayer, ChasePlayerContext, UpdateAI_ChasePlayer >( pWorld, context );
 }
 
 HELIUM_DEFINE_TASK( TaskProcessAI, ( ForEachWorld< ProcessAI > ), TickTypes::Gameplay )
@@ -103,4 +144,10 @@ void TaskProcessAI::DefineContract( Helium::TaskContract &rContract )
 {
 	rContract.ExecuteAfter<Helium::StandardDependencies::ReceiveInput>();
 	rContract.ExecuteBefore<Helium::StandardDependencies::ProcessPhysics>();
+	rContract.ReadsComponents<AIComponentChasePlayer>();
+	rContract.ReadsComponents<PlayerComponent>();
+	rContract.ReadsComponents<TransformComponent>();
+	rContract.WritesComponents<PlayerManagerComponent>();
+	rContract.WritesComponents<SpatialIndexComponent>();
+	rContract.WritesComponents<AvatarControllerComponent>();
 }
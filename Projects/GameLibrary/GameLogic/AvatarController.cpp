@@ -22,7 +22,9 @@ HELIUM_DEFINE_COMPONENT(GameLibrary::AvatarControllerComponent, EXAMPLE_GAME_MAX
 
 void AvatarControllerComponent::PopulateMetaType( Reflect::MetaStruct& comp )
 {
-
+	comp.AddField( &AvatarControllerComponent::m_AimDir, "m_AimDir", Reflect::FieldFlags::Discard );
+	comp.AddField( &AvatarControllerComponent::m_bShoot, "m_bShoot", Reflect::FieldFlags::Discard );
+	comp.AddField( &AvatarControllerComponent::m_ShootCooldown, "m_ShootCooldown", Reflect::FieldFlags::Discard );
 }
 
 void AvatarControllerComponent::Finalize( const AvatarControllerComponentDefinition &definition )
@@ -67,6 +69,9 @@ HELIUM_DEFINE_TASK( ApplyPlayerInputToAvatarTask, (ForEachWorld< QueryComponents
 void GameLibrary::ApplyPlayerInputToAvatarTask::DefineContract( Helium::TaskContract &rContract )
 {
 	rContract.ExecuteAfter<GameLibrary::GatherInputForPlayers>();
+	rContract.ReadsComponents<PlayerInputComponent>();
+	rContract.ReadsComponents<TransformComponent>();
+	rContract.WritesComponents<AvatarControllerComponent>();
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -151,4 +156,6 @@ void GameLibrary::ControlAvatarTask::DefineContract( Helium::TaskContract &rCont
 {
 	rContract.ExecuteAfter<GameLibrary::ApplyPlayerInputToAvatarTask>();
 	rContract.ExecuteBefore<Helium::StandardDependencies::ProcessPhysics>();
+
+	// Creates bullet entities, so this declares no component access and never overlaps another task
 }
@@ -16,7 +16,8 @@ HELIUM_DEFINE_COMPONENT(GameLibrary::DamageOnContactComponent, 128);
 
 void DamageOnContactComponent::PopulateMetaType( Reflect::MetaStruct& comp )
 {
-
+	comp.AddField( &DamageOnContactComponent::m_DamageAmount, "m_DamageAmount", Reflect::FieldFlags::Discard );
+	comp.AddField( &DamageOnContactComponent::m_DestroySelfOnContact, "m_DestroySelfOnContact", Reflect::FieldFlags::Discard );
 }
 
 void DamageOnContactComponent::Initialize( const DamageOnContactComponentDefinition &definition )
@@ -70,4 +71,7 @@ HELIUM_DEFINE_TASK( ApplyDamageOnContact, (ForEachWorld< QueryComponents< HasPhy
 void GameLibrary::ApplyDamageOnContact::DefineContract( Helium::TaskContract &rContract )
 {
 	rContract.ExecutesWithin<GameLibrary::DoDamage>();
+	rContract.ReadsComponents<HasPhysicalContactsComponent>();
+	rContract.ReadsComponents<DamageOnContactComponent>();
+	rContract.WritesComponents<HealthComponent>();
 }
@@ -14,7 +14,7 @@ HELIUM_DEFINE_COMPONENT(GameLibrary::DamagedComponent, 128);
 
 void DamagedComponent::PopulateMetaType( Reflect::MetaStruct& comp )
 {
-
+	comp.AddField( &DamagedComponent::m_DamageAmount, "m_DamageAmount", Reflect::FieldFlags::Discard );
 }
 
 void DamagedComponent::Initialize( float damageAmount )
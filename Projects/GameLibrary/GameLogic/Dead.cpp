@@ -62,4 +62,6 @@ void TaskDestroyAllDead::DefineContract( Helium::TaskContract &rContract )
 {
 	rContract.ExecuteAfter<GameLibrary::KillAllWithZeroHealth>();
 	rContract.ExecutesWithin<Helium::StandardDependencies::PostPhysicsGameplay>();
+	rContract.ReadsComponents<DespawnOnDeathComponent>();
+	rContract.ReadsComponents<DeadComponent>();
 }
@@ -156,6 +156,9 @@ void EnemyWaveManager::SpawnWave( EnemyWaveDefinition *pWave, ParameterSet_Actio
 	WaveState *pWaveState = m_ActiveWaves.New();
 	pWaveState->m_Entities.Reserve(pParameters->m_Count);
 
+	DynamicArray< ParameterSetPtr > parameterSets;
+	parameterSets.Reserve(pParameters->m_Count);
+
 	for (int i = 0; i < pParameters->m_Count; ++i)
 	{
 		HELIUM_ASSERT(pWave->m_Formation);
@@ -169,12 +172,17 @@ void EnemyWaveManager::SpawnWave( EnemyWaveDefinition *pWave, ParameterSet_Actio
 		ParameterSetBuilder builder;
 		ParameterSet_InitLocated *pInitLocated = builder.AddParameterSet<ParameterSet_InitLocated>();
 		pInitLocated->m_Position = location;
+		parameterSets.Push( builder.GetSet() );
+	}
 
-		HELIUM_ASSERT( pWave->m_Entity );
-		Entity *pEntity = m_pWorld->GetRootSlice()->CreateEntity(pWave->m_Entity, builder.GetSet());
+	HELIUM_ASSERT( pWave->m_Entity );
+	DynamicArray< Entity* > entities;
+	m_pWorld->GetRootSlice()->CreateEntities(pWave->m_Entity, parameterSets, &entities);
 
+	for (DynamicArray< Entity* >::Iterator iter = entities.Begin(); iter != entities.End(); ++iter)
+	{
 		WaveEntityState *pEntityState = pWaveState->m_Entities.New();
-		pEntityState->m_Entity = pEntity;
+		pEntityState->m_Entity = *iter;
 	}
 }
 
@@ -240,6 +248,8 @@ void DoUpdateEnemyWaveManager( EnemyWaveManagerComponent *c )
 void TaskUpdateEnemyWaveManager::DefineContract( TaskContract &rContract )
 {
 	rContract.ExecutesWithin<StandardDependencies::PostPhysicsGameplay>();
+
+	// Spawns enemy entities, so this declares no component access and never overlaps another task
 }
 
 HELIUM_DEFINE_TASK( TaskUpdateEnemyWaveManager, (ForEachWorld< QueryComponents< EnemyWaveManagerComponent, DoUpdateEnemyWaveManager > >), TickTypes::Gameplay );
\ No newline at end of file
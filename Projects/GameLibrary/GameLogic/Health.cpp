@@ -77,4 +77,6 @@ void GameLibrary::KillAllWithZeroHealth::DefineContract( Helium::TaskContract &r
 {
 	rContract.ExecuteAfter<GameLibrary::DoDamage>();
 	rContract.ExecuteBefore<Helium::StandardDependencies::Render>();
+
+	// Allocates DeadComponents, so this declares no component access and never overlaps another task
 }
@@ -16,7 +16,7 @@ HELIUM_DEFINE_COMPONENT(GameLibrary::PlayerComponent, EXAMPLE_GAME_MAX_PLAYERS *
 
 void PlayerComponent::PopulateMetaType( Reflect::MetaStruct& comp )
 {
-
+	comp.AddField( &PlayerComponent::m_RespawnDelay, "m_RespawnDelay", Reflect::FieldFlags::Discard );
 }
 
 void PlayerComponent::Initialize( const PlayerComponentDefinition &definition )
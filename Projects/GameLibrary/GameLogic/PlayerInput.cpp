@@ -128,4 +128,6 @@ void GameLibrary::GatherInputForPlayers::DefineContract( Helium::TaskContract &r
 {
 	rContract.ExecuteAfter<Helium::StandardDependencies::ReceiveInput>();
 	rContract.ExecuteBefore<Helium::StandardDependencies::ProcessPhysics>();
+	rContract.WritesComponents<PlayerInputComponent>();
+	rContract.WritesComponents<GraphicsManagerComponent>();
 }
@@ -64,4 +64,6 @@ HELIUM_DEFINE_TASK(PlayerManagerTick, ( ForEachWorld< TickPlayers > ), TickTypes
 void PlayerManagerTick::DefineContract( TaskContract &rContract )
 {
 	rContract.ExecuteBefore<Helium::StandardDependencies::ReceiveInput>();
+
+	// Creates player entities, so this declares no component access and never overlaps another task
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "GameLibrary/GameLogic/Player.h"
+#include "MathSimd/Vector3.h"
 
 #define EXAMPLE_GAME_MAX_WORLDS (1)
 #define EXAMPLE_GAME_MAX_PLAYERS (4)
@@ -34,6 +35,10 @@ namespace GameLibrary
 
 		Helium::DynamicArray<PlayerInfo> m_Players;
 
+		// Player avatar positions, gathered each frame by TaskProcessAI for the AI components of this world
+		typedef Helium::DynamicArray< Helium::Pair< PlayerComponent *, Helium::Simd::Vector3 > > PlayerPositionList;
+		PlayerPositionList m_PlayerPositions;
+
 		ConstPlayerManagerComponentDefinitionPtr m_Definition;
 	};
 	
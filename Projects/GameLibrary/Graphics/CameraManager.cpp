@@ -161,7 +161,10 @@ void CameraManagerComponent::Tick()
 
 		Helium::TransformComponent *pTransform = m_CurrentCamera->GetComponentCollection()->GetFirst<TransformComponent>();
 
-		pView->SetView(pTransform->GetPosition(), /*pTransform->GetRotation(). **/ Simd::Vector3::BasisZ, m_CurrentCamera->GetUp() );
+		WorldManager* pWorldManager = WorldManager::GetInstance();
+		HELIUM_ASSERT( pWorldManager );
+
+		pView->SetView(pTransform->GetInterpolatedPosition( pWorldManager->GetInterpolationAlpha() ), /*pTransform->GetRotation(). **/ Simd::Vector3::BasisZ, m_CurrentCamera->GetUp() );
 		pView->SetNearClip( m_CurrentCamera->GetNearClip() );
 		pView->SetFarClip( m_CurrentCamera->GetFarClip() );
 		pView->SetHorizontalFov( m_CurrentCamera->GetFov() );
@@ -60,12 +60,9 @@ GameLibrary::ScreenSpaceTextComponentDefinition::ScreenSpaceTextComponentDefinit
 
 }
 
-static GraphicsManagerComponent *g_pGraphicsManager;
-static BufferedDrawer *g_pBufferedDrawer;
-
-void DrawScreenSpaceText( ScreenSpaceTextComponent *pShaderComponent )
+void DrawScreenSpaceText( GraphicsManagerComponent &rGraphicsManager, ScreenSpaceTextComponent *pShaderComponent )
 {
-	pShaderComponent->Render( *g_pGraphicsManager );
+	pShaderComponent->Render( rGraphicsManager );
 };
 
 void DrawScreenSpaceText( World *pWorld )
@@ -74,10 +71,11 @@ void DrawScreenSpaceText( World *pWorld )
 	HELIUM_ASSERT( 0 );
 #else // GRAPHICS_SCENE_BUFFERED_DRAWER
 
-	g_pGraphicsManager = pWorld->GetComponents().GetFirst<GraphicsManagerComponent>();
-	HELIUM_ASSERT( g_pGraphicsManager );
+	// Look the graphics manager up once for this world, worlds may be drawn at the same time
+	GraphicsManagerComponent *pGraphicsManager = pWorld->GetComponents().GetFirst<GraphicsManagerComponent>();
+	HELIUM_ASSERT( pGraphicsManager );
 
-	QueryComponents< ScreenSpaceTextComponent, DrawScreenSpaceText >( pWorld );
+	QueryComponents< ScreenSpaceTextComponent, GraphicsManagerComponent, DrawScreenSpaceText >( pWorld, *pGraphicsManager );
 #endif
 }
 
@@ -87,4 +85,6 @@ HELIUM_DEFINE_TASK( DrawScreenSpaceTextTask, (ForEachWorld< DrawScreenSpaceText
 void GameLibrary::DrawScreenSpaceTextTask::DefineContract( Helium::TaskContract &rContract )
 {
 	rContract.ExecutesWithin<Helium::StandardDependencies::Render>();
+	rContract.ReadsComponents<ScreenSpaceTextComponent>();
+	rContract.WritesComponents<GraphicsManagerComponent>();
 }
@@ -6,6 +6,7 @@
 #include "Graphics/BufferedDrawer.h"
 #include "Graphics/GraphicsManagerComponent.h"
 #include "Framework/World.h"
+#include "Framework/WorldManager.h"
 
 using namespace Helium;
 using namespace GameLibrary;
@@ -43,7 +44,7 @@ void SpriteComponent::Initialize( const SpriteComponentDefinition &definition )
 	m_Dirty = true;
 }
 
-void GameLibrary::SpriteComponent::Render( Helium::BufferedDrawer &rBufferedDrawer, Helium::TransformComponent &rTransform )
+void GameLibrary::SpriteComponent::Render( Helium::BufferedDrawer &rBufferedDrawer, Helium::TransformComponent &rTransform, float32_t alpha )
 {
 	if ( !m_Texture )
 	{
@@ -72,8 +73,8 @@ void GameLibrary::SpriteComponent::Render( Helium::BufferedDrawer &rBufferedDraw
 	// Not really sure why I had to split this into two matrices but it works
 	Helium::Simd::Matrix44 matrix(
 		Helium::Simd::Matrix44::INIT_ROTATION_TRANSLATION, 
-		rTransform.GetRotation() * Simd::Quat(0.0f, 0.0f, m_Rotation),
-		rTransform.GetPosition());
+		rTransform.GetInterpolatedRotation( alpha ) * Simd::Quat(0.0f, 0.0f, m_Rotation),
+		rTransform.GetInterpolatedPosition( alpha ));
 	
 	Helium::Simd::Matrix44 scaling(
 		Helium::Simd::Matrix44::INIT_SCALING, 
@@ -154,12 +155,16 @@ GameLibrary::SpriteComponentDefinition::SpriteComponentDefinition()
 
 }
 
-static BufferedDrawer *g_pBufferedDrawer;
+struct DrawSpritesContext
+{
+	BufferedDrawer *m_pBufferedDrawer;
+	float32_t m_InterpolationAlpha;
+};
 
-void DrawSprite( SpriteComponent *pShaderComponent, Helium::TransformComponent *pTransformComponent )
+void DrawSprite( DrawSpritesContext &rContext, SpriteComponent *pShaderComponent, Helium::TransformComponent *pTransformComponent )
 {
 	// TODO: Make this not use buffered drawer
-	pShaderComponent->Render( *g_pBufferedDrawer, *pTransformComponent );
+	pShaderComponent->Render( *rContext.m_pBufferedDrawer, *pTransformComponent, rContext.m_InterpolationAlpha );
 };
 
 void DrawSprites( World *pWorld )
@@ -168,11 +173,15 @@ void DrawSprites( World *pWorld )
 	HELIUM_ASSERT( 0 );
 #else // GRAPHICS_SCENE_BUFFERED_DRAWER
 
+	// The drawer comes from this world's graphics manager, worlds may be drawn at the same time
 	GraphicsManagerComponent *pGraphicsManager = pWorld->GetComponents().GetFirst<GraphicsManagerComponent>();
 	HELIUM_ASSERT( pGraphicsManager );
 
-	g_pBufferedDrawer = &pGraphicsManager->GetBufferedDrawer();
-	QueryComponents< SpriteComponent, TransformComponent, DrawSprite >( pWorld );
+	WorldManager* pWorldManager = WorldManager::GetInstance();
+	HELIUM_ASSERT( pWorldManager );
+
+	DrawSpritesContext context = { &pGraphicsManager->GetBufferedDrawer(), pWorldManager->GetInterpolationAlpha() };
+	QueryComponents< SpriteComponent, TransformComponent, DrawSpritesContext, DrawSprite >( pWorld, context );
 #endif
 }
 
@@ -182,4 +191,7 @@ HELIUM_DEFINE_TASK( DrawSpritesTask, (ForEachWorld< DrawSprites >), TickTypes::R
 void GameLibrary::DrawSpritesTask::DefineContract( Helium::TaskContract &rContract )
 {
 	rContract.ExecutesWithin<Helium::StandardDependencies::Render>();
+	rContract.ReadsComponents<SpriteComponent>();
+	rContract.ReadsComponents<TransformComponent>();
+	rContract.WritesComponents<GraphicsManagerComponent>();
 }
@@ -33,7 +33,8 @@ namespace GameLibrary
 		
 		void Initialize( const SpriteComponentDefinition &definition);
 
-		void Render( Helium::BufferedDrawer &rBufferedDrawer, Helium::TransformComponent &rTransform );
+		// alpha blends the transform between simulation steps, see Helium::WorldManager::GetInterpolationAlpha()
+		void Render( Helium::BufferedDrawer &rBufferedDrawer, Helium::TransformComponent &rTransform, float32_t alpha );
 
 		void SetFrame(uint32_t frame) { m_Frame = frame; m_Dirty = true;}
 		void SetFlipHorizontal( bool shouldFlip ) { m_FlipHorizontal = shouldFlip; m_Dirty = true; }
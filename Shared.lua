@@ -22,6 +22,8 @@ project( prefix .. "Engine" )
 			prefix .. "Persist",
 			prefix .. "Math",
 			prefix .. "MathSimd",
+
+			"zlib",
 		}
 
 project( prefix .. "EngineJobs" )
@@ -558,6 +560,7 @@ project( prefix .. "GameLibrary" )
 
 			"ois",
 			"mongo-c",
+			"zlib",
 		}
 
 Helium.DoGameMainProjectSettings( "PhysicsDemo" )